@@ -0,0 +1,158 @@
+// Benchmark setup:
+// - Write cache files into a local directory in the same way as on-disk cache reader does, i.e. write into a temporary
+// file and rename, with blocking IO and batched io_uring submissions respectively;
+// - Read all cache files back with both IO engines;
+// - Compare IOPS (files per second) and CPU time spent per GiB for both IO engines.
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "io_uring.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+
+namespace duckdb {
+
+namespace {
+
+constexpr idx_t BENCHMARK_FILE_COUNT = 4096;
+constexpr idx_t BENCHMARK_FILE_SIZE = 64 * 1024;
+constexpr idx_t BENCHMARK_BATCH_SIZE = 64;
+const std::string BENCHMARK_DIRECTORY = "/tmp/duckdb_cache_httpfs_io_benchmark";
+
+std::string GetCacheFilePath(idx_t file_idx) {
+	return StringUtil::Format("%s/%llu", BENCHMARK_DIRECTORY, file_idx);
+}
+
+// Get user and system CPU time consumed by the current process, in seconds.
+double GetCpuSeconds() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+	       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+void ResetBenchmarkDirectory() {
+	LocalFileSystem local_filesystem {};
+	if (local_filesystem.DirectoryExists(BENCHMARK_DIRECTORY)) {
+		local_filesystem.RemoveDirectory(BENCHMARK_DIRECTORY);
+	}
+	local_filesystem.CreateDirectory(BENCHMARK_DIRECTORY);
+}
+
+void WriteFilesSync(const std::string &content) {
+	LocalFileSystem local_filesystem {};
+	for (idx_t file_idx = 0; file_idx < BENCHMARK_FILE_COUNT; ++file_idx) {
+		const auto filepath = GetCacheFilePath(file_idx);
+		const auto temp_filepath = filepath + ".tmp";
+		{
+			auto file_handle = local_filesystem.OpenFile(temp_filepath, FileOpenFlags::FILE_FLAGS_WRITE |
+			                                                                FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			local_filesystem.Write(*file_handle, const_cast<char *>(content.data()), content.length(),
+			                       /*location=*/0);
+		}
+		local_filesystem.MoveFile(temp_filepath, filepath);
+	}
+}
+
+void ReadFilesSync(std::string &buffer) {
+	LocalFileSystem local_filesystem {};
+	for (idx_t file_idx = 0; file_idx < BENCHMARK_FILE_COUNT; ++file_idx) {
+		auto file_handle = local_filesystem.OpenFile(GetCacheFilePath(file_idx), FileOpenFlags::FILE_FLAGS_READ);
+		local_filesystem.Read(*file_handle, const_cast<char *>(buffer.data()), buffer.length(), /*location=*/0);
+	}
+}
+
+void WriteFilesWithIoUring(const std::string &content) {
+	for (idx_t batch_start = 0; batch_start < BENCHMARK_FILE_COUNT; batch_start += BENCHMARK_BATCH_SIZE) {
+		vector<IoUringWriteRequest> requests;
+		requests.reserve(BENCHMARK_BATCH_SIZE);
+		for (idx_t file_idx = batch_start; file_idx < batch_start + BENCHMARK_BATCH_SIZE; ++file_idx) {
+			const auto filepath = GetCacheFilePath(file_idx);
+			requests.emplace_back(IoUringWriteRequest {
+			    .temp_filepath = filepath + ".tmp",
+			    .filepath = filepath,
+			    .data = content.data(),
+			    .length = content.length(),
+			});
+		}
+		IoUringWriteFiles(requests, /*sync=*/false);
+		for (const auto &cur_request : requests) {
+			if (cur_request.result < 0) {
+				throw IOException("Failed to write file %s with io_uring", cur_request.filepath);
+			}
+		}
+	}
+}
+
+void ReadFilesWithIoUring(vector<std::string> &buffers) {
+	for (idx_t batch_start = 0; batch_start < BENCHMARK_FILE_COUNT; batch_start += BENCHMARK_BATCH_SIZE) {
+		vector<IoUringReadRequest> requests;
+		requests.reserve(BENCHMARK_BATCH_SIZE);
+		for (idx_t file_idx = batch_start; file_idx < batch_start + BENCHMARK_BATCH_SIZE; ++file_idx) {
+			auto &cur_buffer = buffers[file_idx - batch_start];
+			requests.emplace_back(IoUringReadRequest {
+			    .filepath = GetCacheFilePath(file_idx),
+			    .buffer = const_cast<char *>(cur_buffer.data()),
+			    .length = cur_buffer.length(),
+			});
+		}
+		IoUringReadFiles(requests);
+		for (const auto &cur_request : requests) {
+			if (cur_request.result != static_cast<int64_t>(cur_request.length)) {
+				throw IOException("Failed to read file %s with io_uring", cur_request.filepath);
+			}
+		}
+	}
+}
+
+// Run [func] and print its IOPS and CPU time per GiB.
+template <typename Func>
+void RunAndReport(const std::string &description, Func &&func) {
+	const auto start_millisec = GetSteadyNowMilliSecSinceEpoch();
+	const double start_cpu_sec = GetCpuSeconds();
+	func();
+	const double cpu_sec = GetCpuSeconds() - start_cpu_sec;
+	const auto elapsed_millisec = GetSteadyNowMilliSecSinceEpoch() - start_millisec;
+
+	const double total_gib = static_cast<double>(BENCHMARK_FILE_COUNT * BENCHMARK_FILE_SIZE) / (1024 * 1024 * 1024);
+	const double iops = BENCHMARK_FILE_COUNT * 1000.0 / (elapsed_millisec == 0 ? 1 : elapsed_millisec);
+	std::cout << description << " " << BENCHMARK_FILE_COUNT << " files takes " << elapsed_millisec
+	          << " milliseconds, IOPS is " << iops << ", CPU time per GiB is " << cpu_sec / total_gib << " seconds"
+	          << std::endl;
+}
+
+void BenchmarkLocalCacheIo() {
+	const std::string content(BENCHMARK_FILE_SIZE, 'a');
+
+	ResetBenchmarkDirectory();
+	RunAndReport("Writing with sync IO engine", [&]() { WriteFilesSync(content); });
+	RunAndReport("Reading with sync IO engine", [&]() {
+		std::string buffer(BENCHMARK_FILE_SIZE, '\0');
+		ReadFilesSync(buffer);
+	});
+
+	if (!IsIoUringAvailable()) {
+		std::cout << "io_uring is not available, skip benchmarking io_uring IO engine" << std::endl;
+		return;
+	}
+
+	ResetBenchmarkDirectory();
+	RunAndReport("Writing with io_uring IO engine", [&]() { WriteFilesWithIoUring(content); });
+	RunAndReport("Reading with io_uring IO engine", [&]() {
+		vector<std::string> buffers(BENCHMARK_BATCH_SIZE, std::string(BENCHMARK_FILE_SIZE, '\0'));
+		ReadFilesWithIoUring(buffers);
+	});
+}
+
+} // namespace
+
+} // namespace duckdb
+
+int main(int argc, char **argv) {
+	duckdb::BenchmarkLocalCacheIo();
+	return 0;
+}
@@ -0,0 +1,100 @@
+// Benchmark setup:
+// - Populate in-memory LRU cache with blocks, so all lookups hit cache;
+// - Concurrently look up random keys from multiple threads, and compare throughput of single-lock cache and sharded
+// cache with different thread count.
+
+#include "cache_filesystem_config.hpp"
+#include "duckdb/common/exception.hpp"
+#include "in_mem_cache_block.hpp"
+#include "shared_lru_cache.hpp"
+#include "time_utils.hpp"
+
+#include <array>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace duckdb {
+
+namespace {
+
+constexpr idx_t BENCHMARK_KEY_COUNT = 4096;
+constexpr idx_t BENCHMARK_LOOKUP_PER_THREAD = 1000000;
+constexpr std::array<idx_t, 7> BENCHMARK_THREAD_COUNTS {1, 2, 4, 8, 16, 32, 64};
+
+InMemCacheBlock GetBlockKey(idx_t key_idx) {
+	InMemCacheBlock block_key;
+	block_key.fname = "s3://duckdb-cache-fs/lineitem.parquet";
+	block_key.start_off = key_idx * DEFAULT_CACHE_BLOCK_SIZE;
+	block_key.blk_size = DEFAULT_CACHE_BLOCK_SIZE;
+	return block_key;
+}
+
+// Look up random cached keys from [thread_count] threads, and return the number of lookups per second.
+template <typename CacheType>
+double GetLookupThroughput(CacheType &cache, idx_t thread_count) {
+	const auto start = GetSteadyNowMilliSecSinceEpoch();
+
+	vector<std::future<idx_t>> futures;
+	futures.reserve(thread_count);
+	for (idx_t thd_idx = 0; thd_idx < thread_count; ++thd_idx) {
+		futures.emplace_back(std::async(std::launch::async, [&cache, thd_idx]() {
+			std::mt19937_64 rand_engine {thd_idx};
+			std::uniform_int_distribution<idx_t> distribution {0, BENCHMARK_KEY_COUNT - 1};
+			idx_t hit_count = 0;
+			for (idx_t idx = 0; idx < BENCHMARK_LOOKUP_PER_THREAD; ++idx) {
+				hit_count += cache.Get(GetBlockKey(distribution(rand_engine))) != nullptr;
+			}
+			return hit_count;
+		}));
+	}
+	for (auto &cur_future : futures) {
+		const idx_t hit_count = cur_future.get();
+		if (hit_count != BENCHMARK_LOOKUP_PER_THREAD) {
+			throw InternalException("Expects all lookups to hit cache, but only %llu out of %llu hit", hit_count,
+			                        BENCHMARK_LOOKUP_PER_THREAD);
+		}
+	}
+
+	const auto end = GetSteadyNowMilliSecSinceEpoch();
+	const auto duration_millisec = MaxValue<uint64_t>(end - start, 1);
+	return static_cast<double>(thread_count * BENCHMARK_LOOKUP_PER_THREAD) * 1000 / duration_millisec;
+}
+
+template <typename CacheType>
+void PopulateCache(CacheType &cache) {
+	for (idx_t idx = 0; idx < BENCHMARK_KEY_COUNT; ++idx) {
+		cache.Put(GetBlockKey(idx), make_shared_ptr<std::string>("value"));
+	}
+}
+
+void BenchmarkLruCache() {
+	using SingleLockCache =
+	    ThreadSafeSharedLruCache<InMemCacheBlock, std::string, InMemCacheBlockHash, InMemCacheBlockEqual>;
+	using ShardedCache =
+	    ThreadSafeShardedSharedLruCache<InMemCacheBlock, std::string, InMemCacheBlockHash, InMemCacheBlockEqual>;
+
+	SingleLockCache single_lock_cache {/*max_entries=*/0, /*timeout_millisec=*/0};
+	ShardedCache sharded_cache {DEFAULT_CACHE_SHARD_COUNT, /*max_entries=*/0, /*timeout_millisec=*/0};
+	PopulateCache(single_lock_cache);
+	PopulateCache(sharded_cache);
+
+	for (const idx_t cur_thread_count : BENCHMARK_THREAD_COUNTS) {
+		const double single_lock_throughput = GetLookupThroughput(single_lock_cache, cur_thread_count);
+		const double sharded_throughput = GetLookupThroughput(sharded_cache, cur_thread_count);
+		std::cout << "With " << cur_thread_count << " threads, single-lock cache serves " << single_lock_throughput
+		          << " lookups per second, sharded cache with " << sharded_cache.ShardCount() << " shards serves "
+		          << sharded_throughput << " lookups per second" << std::endl;
+	}
+}
+
+} // namespace
+
+} // namespace duckdb
+
+int main(int argc, char **argv) {
+	duckdb::BenchmarkLruCache();
+	return 0;
+}
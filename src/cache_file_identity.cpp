@@ -0,0 +1,111 @@
+#include "cache_file_identity.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "crypto.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "no_destructor.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Min number of interned paths before expired identities are pruned.
+constexpr idx_t MIN_PRUNE_THRESHOLD = 1024;
+
+struct CacheFileIdentityPool {
+	std::mutex mu;
+	std::unordered_map<std::string, weak_ptr<const CacheFileIdentity>> identities;
+	uint64_t next_path_id = 0;
+	// Expired identities are pruned when the pool grows to the threshold, which is then doubled over live identities,
+	// so the amortized cost of pruning for each intern is constant.
+	idx_t prune_threshold = MIN_PRUNE_THRESHOLD;
+};
+
+CacheFileIdentityPool &GetCacheFileIdentityPool() {
+	static NoDestructor<CacheFileIdentityPool> pool;
+	return *pool;
+}
+
+// Convert SHA256 value to hex string.
+std::string Sha256ToHexString(const duckdb::hash_bytes &sha256) {
+	static constexpr char kHexChars[] = "0123456789abcdef";
+	std::string result;
+	// SHA256 has 32 byte, we encode 2 chars for each byte of SHA256.
+	result.reserve(64);
+
+	for (unsigned char byte : sha256) {
+		result += kHexChars[byte >> 4];  // Get high 4 bits
+		result += kHexChars[byte & 0xF]; // Get low 4 bits
+	}
+	return result;
+}
+
+// Remove expired identities from [pool], whose mutex should be held.
+void PruneExpiredIdentities(CacheFileIdentityPool &pool) {
+	for (auto iter = pool.identities.begin(); iter != pool.identities.end();) {
+		if (iter->second.expired()) {
+			iter = pool.identities.erase(iter);
+			continue;
+		}
+		++iter;
+	}
+	pool.prune_threshold = MaxValue<idx_t>(pool.identities.size() * 2, MIN_PRUNE_THRESHOLD);
+}
+
+} // namespace
+
+// Cache filenames start with the hash of their remote file, so all cache files for one remote file are placed under one
+// shard directory.
+std::string GetCacheFnamePrefix(const std::string &path) {
+	duckdb::hash_bytes path_sha256_val;
+	duckdb::sha256(path.data(), path.length(), path_sha256_val);
+	return StringUtil::Format("%s-%s", Sha256ToHexString(path_sha256_val), StringUtil::GetFileName(path));
+}
+
+shared_ptr<const CacheFileIdentity> InternCacheFileIdentity(const std::string &path) {
+	auto &pool = GetCacheFileIdentityPool();
+	{
+		std::lock_guard<std::mutex> lck(pool.mu);
+		auto iter = pool.identities.find(path);
+		if (iter != pool.identities.end()) {
+			auto identity = iter->second.lock();
+			if (identity != nullptr) {
+				return identity;
+			}
+		}
+	}
+
+	// Hash the path out of critical section, concurrent interns for the same path resolve to the first inserted one.
+	auto new_identity = make_shared_ptr<CacheFileIdentity>();
+	new_identity->path = path;
+	new_identity->cache_fname_prefix = GetCacheFnamePrefix(path);
+
+	std::lock_guard<std::mutex> lck(pool.mu);
+	auto &interned_identity = pool.identities[path];
+	auto identity = interned_identity.lock();
+	if (identity != nullptr) {
+		return identity;
+	}
+	new_identity->path_id = pool.next_path_id++;
+	interned_identity = new_identity;
+	if (pool.identities.size() >= pool.prune_threshold) {
+		PruneExpiredIdentities(pool);
+	}
+	return new_identity;
+}
+
+idx_t GetInternedCacheFileIdentityCount() {
+	auto &pool = GetCacheFileIdentityPool();
+	std::lock_guard<std::mutex> lck(pool.mu);
+	idx_t identity_count = 0;
+	for (const auto &cur_identity : pool.identities) {
+		if (!cur_identity.second.expired()) {
+			++identity_count;
+		}
+	}
+	return identity_count;
+}
+
+} // namespace duckdb
@@ -1,8 +1,10 @@
 #include "cache_filesystem.hpp"
 
 #include "cache_filesystem_config.hpp"
+#include "crc32c.hpp"
 #include "disk_cache_reader.hpp"
 #include "in_memory_cache_reader.hpp"
+#include "io_executor.hpp"
 #include "noop_cache_reader.hpp"
 #include "temp_profile_collector.hpp"
 
@@ -10,7 +12,10 @@ namespace duckdb {
 
 CacheFileSystemHandle::CacheFileSystemHandle(unique_ptr<FileHandle> internal_file_handle_p, CacheFileSystem &fs)
     : FileHandle(fs, internal_file_handle_p->GetPath(), internal_file_handle_p->GetFlags()),
-      internal_file_handle(std::move(internal_file_handle_p)) {
+      internal_file_handle(std::move(internal_file_handle_p)),
+      cache_file_identity(InternCacheFileIdentity(internal_file_handle->GetPath())),
+      footer_prefetch_eligible(ShouldPrefetchFooter(internal_file_handle->GetPath())),
+      sequential_read_tracker(g_cache_block_size, g_max_read_ahead_block_count) {
 }
 
 FileSystem *CacheFileSystemHandle::GetInternalFileSystem() const {
@@ -19,6 +24,9 @@ FileSystem *CacheFileSystemHandle::GetInternalFileSystem() const {
 }
 
 CacheFileSystemHandle::~CacheFileSystemHandle() {
+	// Read-ahead tasks swallow their failures, so waiting doesn't throw.
+	read_ahead_tasks.Wait();
+
 	// For read file handles, we place them back to file handle cache if file handle enabled.
 	if (flags.OpenForReading()) {
 		auto &cache_filesystem = file_system.Cast<CacheFileSystem>();
@@ -53,7 +61,8 @@ void CacheFileSystem::SetMetadataCache() {
 		return;
 	}
 	if (metadata_cache == nullptr) {
-		metadata_cache = make_uniq<MetadataCache>(g_max_metadata_cache_entry, g_metadata_cache_entry_timeout_millisec);
+		metadata_cache = make_uniq<MetadataCache>(g_cache_shard_count, g_max_metadata_cache_entry,
+		                                          g_metadata_cache_entry_timeout_millisec);
 	}
 }
 
@@ -63,7 +72,8 @@ void CacheFileSystem::SetGlobCache() {
 		return;
 	}
 	if (glob_cache == nullptr) {
-		glob_cache = make_uniq<GlobCache>(g_max_glob_cache_entry, g_glob_cache_entry_timeout_millisec);
+		glob_cache =
+		    make_uniq<GlobCache>(g_cache_shard_count, g_max_glob_cache_entry, g_glob_cache_entry_timeout_millisec);
 	}
 }
 
@@ -213,6 +223,7 @@ void CacheFileSystem::InitializeGlobalConfig(optional_ptr<FileOpener> opener) {
 	SetMetadataCache();
 	SetFileHandleCache();
 	SetGlobCache();
+	IoExecutor::Get().SetThreadCount(GetIoThreadCount());
 	D_ASSERT(profile_collector != nullptr);
 	cache_reader_manager.GetCacheReader()->SetProfileCollector(profile_collector.get());
 }
@@ -251,7 +262,9 @@ unique_ptr<FileHandle> CacheFileSystem::OpenFile(const string &path, FileOpenFla
                                                  optional_ptr<FileOpener> opener) {
 	InitializeGlobalConfig(opener);
 	if (flags.OpenForReading()) {
-		return GetOrCreateFileHandleForRead(path, flags, opener);
+		auto file_handle = GetOrCreateFileHandleForRead(path, flags, opener);
+		PrefetchFooter(*file_handle);
+		return file_handle;
 	}
 
 	// Otherwise, we do nothing (i.e. profiling) but wrapping it with cache file handle wrapper.
@@ -260,50 +273,123 @@ unique_ptr<FileHandle> CacheFileSystem::OpenFile(const string &path, FileOpenFla
 }
 
 void CacheFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	ReadImpl(handle, buffer, nr_bytes, location);
+	const auto file_size = GetFileSize(handle);
+	ReadImpl(handle, buffer, nr_bytes, location, file_size);
 }
 int64_t CacheFileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
 	const idx_t offset = handle.SeekPosition();
-	const int64_t bytes_read = ReadImpl(handle, buffer, nr_bytes, offset);
+	const auto file_size = GetFileSize(handle);
+	const int64_t bytes_read = ReadImpl(handle, buffer, nr_bytes, offset, file_size);
 	Seek(handle, offset + bytes_read);
+	// Stream reads (i.e. CSV and JSON scans) are usually sequential, so read ahead to overlap remote latency with
+	// processing on the caller side.
+	ReadAhead(handle, offset, bytes_read, file_size);
 	return bytes_read;
 }
 
-int64_t CacheFileSystem::GetFileSize(FileHandle &handle) {
-	auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
+void CacheFileSystem::ReadAhead(FileHandle &handle, idx_t location, idx_t bytes_read, idx_t file_size) {
+	auto &cache_handle = handle.Cast<CacheFileSystemHandle>();
+	std::lock_guard<std::mutex> lck(cache_handle.read_ahead_mutex);
+	const auto read_ahead_range = cache_handle.sequential_read_tracker.RecordRead(location, bytes_read, file_size);
+	if (read_ahead_range.bytes_to_read == 0) {
+		return;
+	}
+
+	SubmitPrefetch(cache_handle, read_ahead_range.start_offset, read_ahead_range.bytes_to_read, file_size);
+}
+
+void CacheFileSystem::PrefetchFooter(FileHandle &handle) {
+	auto &cache_handle = handle.Cast<CacheFileSystemHandle>();
+	if (!cache_handle.IsFooterPrefetchEligible()) {
+		return;
+	}
+	const idx_t file_size = GetFileSize(handle);
+	const idx_t footer_start_offset = GetFooterRegionStartOffset(file_size);
+	if (footer_start_offset >= file_size) {
+		return;
+	}
+
+	// Footer is read right after file open, which joins the ongoing prefetch instead of issuing two dependent remote
+	// requests (footer length, then footer content).
+	std::lock_guard<std::mutex> lck(cache_handle.read_ahead_mutex);
+	SubmitPrefetch(cache_handle, footer_start_offset, file_size - footer_start_offset, file_size);
+}
+
+void CacheFileSystem::SubmitPrefetch(CacheFileSystemHandle &handle, idx_t start_offset, idx_t bytes_to_read,
+                                     idx_t file_size) {
+	handle.read_ahead_tasks.ReleaseFinishedTasks();
+	auto *cache_reader = cache_reader_manager.GetCacheReader();
+	handle.read_ahead_tasks.Submit([cache_reader, &handle, start_offset, bytes_to_read, file_size]() {
+		// Prefetch is best effort, failures are left for later reads on the range to surface.
+		try {
+			cache_reader->Prefetch(handle, start_offset, bytes_to_read, file_size);
+		} catch (...) {
+		}
+	});
+}
 
+int64_t CacheFileSystem::GetFileSize(FileHandle &handle) {
 	// Stat without cache involved.
 	if (metadata_cache == nullptr) {
+		auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
 		return internal_filesystem->GetFileSize(*disk_cache_handle.internal_file_handle);
 	}
 
 	// Stat with cache.
 	bool metadata_cache_hit = true;
-	auto metadata =
-	    metadata_cache->GetOrCreate(disk_cache_handle.internal_file_handle->GetPath(),
-	                                [this, &disk_cache_handle, &metadata_cache_hit](const string & /*unused*/) {
-		                                metadata_cache_hit = false;
-		                                const int64_t file_size =
-		                                    internal_filesystem->GetFileSize(*disk_cache_handle.internal_file_handle);
-		                                auto file_metadata = make_shared_ptr<FileMetadata>();
-		                                file_metadata->file_size = file_size;
-		                                return file_metadata;
-	                                });
+	auto metadata = GetFileMetadataImpl(handle, metadata_cache_hit);
 	const BaseProfileCollector::CacheAccess cache_access = metadata_cache_hit
 	                                                           ? BaseProfileCollector::CacheAccess::kCacheHit
 	                                                           : BaseProfileCollector::CacheAccess::kCacheMiss;
 	GetProfileCollector()->RecordCacheAccess(BaseProfileCollector::CacheEntity::kMetadata, cache_access);
 	return metadata->file_size;
 }
-int64_t CacheFileSystem::ReadImpl(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	const auto file_size = GetFileSize(handle);
 
+shared_ptr<const CacheFileSystem::FileMetadata> CacheFileSystem::GetFileMetadata(FileHandle &handle) {
+	bool metadata_cache_hit = true;
+	return GetFileMetadataImpl(handle, metadata_cache_hit);
+}
+
+shared_ptr<const CacheFileSystem::FileMetadata> CacheFileSystem::GetFileMetadataImpl(FileHandle &handle,
+                                                                                     bool &metadata_cache_hit) {
+	auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
+	auto stat_file = [this, &disk_cache_handle]() {
+		auto file_metadata = make_shared_ptr<FileMetadata>();
+		file_metadata->file_size = internal_filesystem->GetFileSize(*disk_cache_handle.internal_file_handle);
+		file_metadata->last_modified =
+		    internal_filesystem->GetLastModifiedTime(*disk_cache_handle.internal_file_handle);
+		// Upper half hashes file size, and lower half hashes last modification timestamp.
+		const int64_t last_modified = static_cast<int64_t>(file_metadata->last_modified);
+		file_metadata->version_tag =
+		    (static_cast<uint64_t>(Crc32c(reinterpret_cast<const char *>(&file_metadata->file_size),
+		                                  sizeof(file_metadata->file_size)))
+		     << 32) |
+		    Crc32c(reinterpret_cast<const char *>(&last_modified), sizeof(last_modified));
+		return file_metadata;
+	};
+
+	// Stat without cache involved.
+	if (metadata_cache == nullptr) {
+		metadata_cache_hit = false;
+		return stat_file();
+	}
+
+	// Stat with cache.
+	return metadata_cache->GetOrCreate(disk_cache_handle.internal_file_handle->GetPath(),
+	                                   [&stat_file, &metadata_cache_hit](const string & /*unused*/) {
+		                                   metadata_cache_hit = false;
+		                                   return stat_file();
+	                                   });
+}
+
+int64_t CacheFileSystem::ReadImpl(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location,
+                                  idx_t file_size) {
 	// No more bytes to read.
-	if (location >= static_cast<idx_t>(file_size)) {
+	if (location >= file_size) {
 		return 0;
 	}
 
-	const int64_t bytes_to_read = MinValue<int64_t>(nr_bytes, file_size - location);
+	const int64_t bytes_to_read = MinValue<int64_t>(nr_bytes, static_cast<int64_t>(file_size - location));
 	cache_reader_manager.GetCacheReader()->ReadAndCache(handle, static_cast<char *>(buffer), location, bytes_to_read,
 	                                                    file_size);
 
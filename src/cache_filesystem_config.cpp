@@ -1,10 +1,16 @@
 #include "cache_filesystem_config.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <csignal>
 #include <utility>
 
 #include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+#include "filesystem_utils.hpp"
+#include "thread_utils.hpp"
 
 namespace duckdb {
 
@@ -14,7 +20,10 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener) {
 		if (!g_test_cache_type->empty()) {
 			*g_cache_type = *g_test_cache_type;
 		}
-		LocalFileSystem::CreateLocal()->CreateDirectory(*g_on_disk_cache_directory);
+		auto local_filesystem = LocalFileSystem::CreateLocal();
+		for (const auto &cur_directory : GetOnDiskCacheDirectories()) {
+			local_filesystem->CreateDirectory(cur_directory);
+		}
 		return;
 	}
 
@@ -43,6 +52,23 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener) {
 		g_cache_block_size = cache_block_size;
 	}
 
+	// Check and update max remote request size if necessary.
+	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_remote_request_size", val);
+	const auto max_remote_request_size = val.GetValue<uint64_t>();
+	if (max_remote_request_size > 0) {
+		g_max_remote_request_size = max_remote_request_size;
+	}
+
+	// Check and update max read-ahead block count.
+	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_read_ahead_block_count", val);
+	g_max_read_ahead_block_count = val.GetValue<uint64_t>();
+
+	// Check and update footer prefetch configurations.
+	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_footer_prefetch_size", val);
+	g_footer_prefetch_size = val.GetValue<uint64_t>();
+	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_footer_prefetch_file_pattern", val);
+	*g_footer_prefetch_file_pattern = val.ToString();
+
 	// Check and update profile collector type if necessary, only assign if valid.
 	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_profile_type", val);
 	auto profile_type_string = val.ToString();
@@ -54,6 +80,17 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener) {
 	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_fanout_subrequest", val);
 	g_max_subrequest_count = val.GetValue<uint64_t>();
 
+	// Check and update configuration for IO executor thread count.
+	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_io_thread_count", val);
+	g_io_thread_count = val.GetValue<uint64_t>();
+
+	// Check and update LRU cache shard count if necessary.
+	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_cache_shard_count", val);
+	const auto cache_shard_count = val.GetValue<uint64_t>();
+	if (cache_shard_count > 0) {
+		g_cache_shard_count = cache_shard_count;
+	}
+
 	// Check and update configurations to ignore SIGPIPE if necessary.
 	FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_ignore_sigpipe", val);
 	const bool ignore_sigpipe = val.GetValue<bool>();
@@ -74,7 +111,10 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener) {
 		auto new_on_disk_cache_directory = val.ToString();
 		if (new_on_disk_cache_directory != *g_on_disk_cache_directory) {
 			*g_on_disk_cache_directory = std::move(new_on_disk_cache_directory);
-			LocalFileSystem::CreateLocal()->CreateDirectory(*g_on_disk_cache_directory);
+			auto local_filesystem = LocalFileSystem::CreateLocal();
+			for (const auto &cur_directory : GetOnDiskCacheDirectories()) {
+				local_filesystem->CreateDirectory(cur_directory);
+			}
 		}
 
 		// Check and update min bytes for disk cache.
@@ -83,6 +123,60 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener) {
 		if (disk_cache_min_bytes > 0) {
 			g_min_disk_bytes_for_cache = disk_cache_min_bytes;
 		}
+
+		// Check and update max bytes for disk cache.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_disk_cache_bytes", val);
+		g_max_disk_cache_bytes = val.GetValue<uint64_t>();
+
+		// Check and update weighting for striped cache directories.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_weight_by_capacity", val);
+		g_disk_cache_weight_by_capacity = val.GetValue<bool>();
+
+		// Check and update memory cap for background cache file writes.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_write_back_max_bytes", val);
+		g_disk_cache_write_back_max_bytes = val.GetValue<uint64_t>();
+
+		// Check and update durability mode for cache files, only assign if valid.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_durability", val);
+		auto durability_string = val.ToString();
+		if (ALL_DISK_CACHE_DURABILITY_MODES->find(durability_string) != ALL_DISK_CACHE_DURABILITY_MODES->end()) {
+			*g_disk_cache_durability = std::move(durability_string);
+		}
+
+		// Check and update layout for on-disk cache, only assign if valid.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_layout", val);
+		auto layout_string = val.ToString();
+		if (ALL_DISK_CACHE_LAYOUTS->find(layout_string) != ALL_DISK_CACHE_LAYOUTS->end()) {
+			*g_disk_cache_layout = std::move(layout_string);
+		}
+
+		// Check and update IO engine for on-disk cache files, only assign if valid.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_io_engine", val);
+		auto io_engine_string = val.ToString();
+		if (ALL_DISK_CACHE_IO_ENGINES->find(io_engine_string) != ALL_DISK_CACHE_IO_ENGINES->end()) {
+			*g_disk_cache_io_engine = std::move(io_engine_string);
+		}
+
+		// Check and update compression for cache blocks, only assign if valid.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_compression", val);
+		auto compression_string = val.ToString();
+		if (ALL_DISK_CACHE_COMPRESSIONS->find(compression_string) != ALL_DISK_CACHE_COMPRESSIONS->end()) {
+			*g_disk_cache_compression = std::move(compression_string);
+		}
+
+		// Check and update max bytes for memory-mapped cache files.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_max_mapped_bytes", val);
+		const auto max_mapped_bytes = val.GetValue<uint64_t>();
+		if (max_mapped_bytes > 0) {
+			g_disk_cache_max_mapped_bytes = max_mapped_bytes;
+		}
+
+		// Check and update segment file size.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_disk_cache_segment_size", val);
+		const auto segment_size = val.GetValue<uint64_t>();
+		if (segment_size > 0) {
+			g_disk_cache_segment_size = segment_size;
+		}
 	}
 
 	//===--------------------------------------------------------------------===//
@@ -91,11 +185,31 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener) {
 
 	// Check and update configurations for in-memory cache type.
 	if (*g_cache_type == *IN_MEM_CACHE_TYPE) {
-		// Check and update max cache block count.
+		// Check and update max cache bytes.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_in_mem_cache_bytes", val);
+		const auto in_mem_cache_bytes = val.GetValue<uint64_t>();
+		if (in_mem_cache_bytes > 0) {
+			g_max_in_mem_cache_bytes = in_mem_cache_bytes;
+		}
+
+		// Deprecated block count based config, which is translated into byte budget with current block size.
 		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_in_mem_cache_block_count", val);
 		const auto in_mem_block_count = val.GetValue<uint64_t>();
 		if (in_mem_block_count > 0) {
-			g_max_in_mem_cache_block_count = in_mem_block_count;
+			g_max_in_mem_cache_bytes = in_mem_block_count * g_cache_block_size;
+		}
+
+		// Memory limit percentage based budget has the highest priority.
+		FileOpener::TryGetCurrentSetting(opener, "cache_httpfs_max_in_mem_cache_memory_percentage", val);
+		const auto in_mem_memory_percentage = val.GetValue<double>();
+		auto context = opener->TryGetClientContext();
+		if (in_mem_memory_percentage > 0 && context != nullptr) {
+			const idx_t memory_limit = DBConfig::GetConfig(*context).options.maximum_memory;
+			const auto in_mem_cache_bytes_by_percentage =
+			    static_cast<idx_t>(static_cast<double>(memory_limit) * in_mem_memory_percentage / 100);
+			if (in_mem_cache_bytes_by_percentage > 0) {
+				g_max_in_mem_cache_bytes = in_mem_cache_bytes_by_percentage;
+			}
 		}
 
 		// Check and update in-memory data block caxche timeout.
@@ -166,16 +280,31 @@ void ResetGlobalConfig() {
 
 	// Global configuration.
 	g_cache_block_size = DEFAULT_CACHE_BLOCK_SIZE;
+	g_max_remote_request_size = DEFAULT_MAX_REMOTE_REQUEST_SIZE;
+	g_max_read_ahead_block_count = DEFAULT_MAX_READ_AHEAD_BLOCK_COUNT;
+	g_footer_prefetch_size = DEFAULT_FOOTER_PREFETCH_SIZE;
+	*g_footer_prefetch_file_pattern = *DEFAULT_FOOTER_PREFETCH_FILE_PATTERN;
 	*g_cache_type = *DEFAULT_CACHE_TYPE;
 	*g_profile_type = *DEFAULT_PROFILE_TYPE;
 	g_max_subrequest_count = DEFAULT_MAX_SUBREQUEST_COUNT;
+	g_io_thread_count = DEFAULT_IO_THREAD_COUNT;
+	g_cache_shard_count = DEFAULT_CACHE_SHARD_COUNT;
 
 	// On-disk cache configuration.
 	*g_on_disk_cache_directory = *DEFAULT_ON_DISK_CACHE_DIRECTORY;
 	g_min_disk_bytes_for_cache = DEFAULT_MIN_DISK_BYTES_FOR_CACHE;
+	g_max_disk_cache_bytes = DEFAULT_MAX_DISK_CACHE_BYTES;
+	g_disk_cache_weight_by_capacity = DEFAULT_DISK_CACHE_WEIGHT_BY_CAPACITY;
+	g_disk_cache_write_back_max_bytes = DEFAULT_DISK_CACHE_WRITE_BACK_MAX_BYTES;
+	*g_disk_cache_durability = *DEFAULT_DISK_CACHE_DURABILITY;
+	*g_disk_cache_layout = *DEFAULT_DISK_CACHE_LAYOUT;
+	*g_disk_cache_io_engine = *DEFAULT_DISK_CACHE_IO_ENGINE;
+	*g_disk_cache_compression = *DEFAULT_DISK_CACHE_COMPRESSION;
+	g_disk_cache_max_mapped_bytes = DEFAULT_DISK_CACHE_MAX_MAPPED_BYTES;
+	g_disk_cache_segment_size = DEFAULT_DISK_CACHE_SEGMENT_SIZE;
 
 	// In-memory cache configuration.
-	g_max_in_mem_cache_block_count = DEFAULT_MAX_IN_MEM_CACHE_BLOCK_COUNT;
+	g_max_in_mem_cache_bytes = DEFAULT_MAX_IN_MEM_CACHE_BYTES;
 	g_in_mem_cache_block_timeout_millisec = DEFAULT_IN_MEM_BLOCK_CACHE_TIMEOUT_MILLISEC;
 
 	// Metadata cache configuration.
@@ -198,13 +327,60 @@ void ResetGlobalConfig() {
 }
 
 uint64_t GetThreadCountForSubrequests(uint64_t io_request_count) {
+	// Subrequests are executed by the shared IO executor, so the number of concurrent subrequests is never more than
+	// its thread count.
+	const uint64_t io_thread_count = GetIoThreadCount();
 	if (g_max_subrequest_count == 0) {
-		// Different platforms have different limits on the number of threads, use 1000 as the hard cap, above which
-		// also increases context switch overhead.
-		static constexpr uint64_t MAX_THREAD_COUNT = 1024;
-		return MinValue<uint64_t>(io_request_count, MAX_THREAD_COUNT);
+		return MinValue<uint64_t>(io_request_count, io_thread_count);
 	}
-	return MinValue<uint64_t>(io_request_count, g_max_subrequest_count);
+	return MinValue<uint64_t>(MinValue<uint64_t>(io_request_count, g_max_subrequest_count), io_thread_count);
+}
+
+uint64_t GetIoThreadCount() {
+	if (g_io_thread_count > 0) {
+		return g_io_thread_count;
+	}
+	// IO threads spend most of their time waiting for remote storage rather than CPU, so oversubscribe cores.
+	static constexpr uint64_t IO_THREAD_PER_CORE = 8;
+	static constexpr uint64_t MIN_IO_THREAD_COUNT = 64;
+	static const uint64_t default_io_thread_count =
+	    MaxValue<uint64_t>(GetCpuCoreCount() * IO_THREAD_PER_CORE, MIN_IO_THREAD_COUNT);
+	return default_io_thread_count;
+}
+
+vector<std::string> GetOnDiskCacheDirectories() {
+	vector<std::string> directories;
+	for (auto &cur_directory : StringUtil::Split(*g_on_disk_cache_directory, ',')) {
+		StringUtil::Trim(cur_directory);
+		while (cur_directory.length() > 1 && cur_directory.back() == '/') {
+			cur_directory.pop_back();
+		}
+		if (cur_directory.empty() ||
+		    std::find(directories.begin(), directories.end(), cur_directory) != directories.end()) {
+			continue;
+		}
+		directories.emplace_back(std::move(cur_directory));
+	}
+	return directories;
+}
+
+bool ShouldPrefetchFooter(const std::string &path) {
+	if (g_footer_prefetch_size == 0) {
+		return false;
+	}
+	if (StringUtil::EndsWith(StringUtil::Lower(path), ".parquet")) {
+		return true;
+	}
+	return !g_footer_prefetch_file_pattern->empty() && MatchGlobPattern(path, *g_footer_prefetch_file_pattern);
+}
+
+idx_t GetFooterRegionStartOffset(idx_t file_size) {
+	const idx_t footer_start_offset = file_size > g_footer_prefetch_size ? file_size - g_footer_prefetch_size : 0;
+	return footer_start_offset / g_cache_block_size * g_cache_block_size;
+}
+
+bool IsFooterBlock(bool footer_prefetch_eligible, idx_t block_start_offset, idx_t file_size) {
+	return footer_prefetch_eligible && block_start_offset >= GetFooterRegionStartOffset(file_size);
 }
 
 } // namespace duckdb
@@ -13,6 +13,7 @@
 #include "duckdb/common/opener_file_system.hpp"
 #include "duckdb/main/extension_util.hpp"
 #include "fake_filesystem.hpp"
+#include "filesystem_utils.hpp"
 #include "hffs.hpp"
 #include "httpfs_extension.hpp"
 #include "s3fs.hpp"
@@ -28,8 +29,10 @@ static shared_ptr<DatabaseInstance> duckdb_instance;
 static void ClearAllCache(const DataChunk &args, ExpressionState &state, Vector &result) {
 	// Special handle local disk cache clear, since it's possible disk cache reader hasn't been initialized.
 	auto local_filesystem = LocalFileSystem::CreateLocal();
-	local_filesystem->RemoveDirectory(*g_on_disk_cache_directory);
-	local_filesystem->CreateDirectory(*g_on_disk_cache_directory);
+	for (const auto &cur_directory : GetOnDiskCacheDirectories()) {
+		local_filesystem->RemoveDirectory(cur_directory);
+		local_filesystem->CreateDirectory(cur_directory);
+	}
 
 	// Clear data block cache for all initialized cache readers.
 	CacheReaderManager::Get().ClearCache();
@@ -63,15 +66,21 @@ static void ClearCacheForFile(const DataChunk &args, ExpressionState &state, Vec
 
 // Get on-disk data cache file size for all cache filesystems.
 static void GetOnDiskDataCacheSize(const DataChunk &args, ExpressionState &state, Vector &result) {
-	auto local_filesystem = LocalFileSystem::CreateLocal();
-
+	// Cache files could be written in background, wait for them so the size reflects all finished reads.
 	int64_t total_cache_size = 0;
-	local_filesystem->ListFiles(
-	    *g_on_disk_cache_directory, [&local_filesystem, &total_cache_size](const string &fname, bool /*unused*/) {
-		    const string file_path = StringUtil::Format("%s/%s", *g_on_disk_cache_directory, fname);
-		    auto file_handle = local_filesystem->OpenFile(file_path, FileOpenFlags::FILE_FLAGS_READ);
-		    total_cache_size += local_filesystem->GetFileSize(*file_handle);
-	    });
+	auto &cache_reader_manager = CacheReaderManager::Get();
+	for (auto *cur_cache_reader : cache_reader_manager.GetCacheReaders()) {
+		cur_cache_reader->Flush();
+		total_cache_size += static_cast<int64_t>(cur_cache_reader->GetOnDiskCacheBytes());
+	}
+
+	// Special handle local disk cache, since cache files could be left by earlier processes before disk cache reader
+	// gets initialized.
+	if (!cache_reader_manager.IsDiskCacheReaderInitialized()) {
+		for (const auto &cur_directory : GetOnDiskCacheDirectories()) {
+			total_cache_size += static_cast<int64_t>(GetFileSizeUnder(cur_directory));
+		}
+	}
 	result.Reference(Value(total_cache_size));
 }
 
@@ -198,6 +207,28 @@ static void LoadInternal(DatabaseInstance &instance) {
 	    "Block size for cache, applies to both in-memory cache filesystem and on-disk cache filesystem. It's worth "
 	    "noting for on-disk filesystem, all existing cache files are invalidated after config update.",
 	    LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_CACHE_BLOCK_SIZE));
+	config.AddExtensionOption(
+	    "cache_httpfs_max_remote_request_size",
+	    "Max number of bytes for a single remote read request. Consecutive uncached blocks are merged into one range "
+	    "request up to the size, and split back into blocks for caching. By default 16MiB; set it to "
+	    "[cache_httpfs_cache_block_size] to issue one remote request per block.",
+	    LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_REMOTE_REQUEST_SIZE));
+	config.AddExtensionOption(
+	    "cache_httpfs_max_read_ahead_block_count",
+	    "Max number of cache blocks to read ahead for sequential reads on a file handle. Read-ahead window starts "
+	    "small and grows as blocks read ahead get consumed. By default 16; set it to 0 to disable read-ahead.",
+	    LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_READ_AHEAD_BLOCK_COUNT));
+	config.AddExtensionOption(
+	    "cache_httpfs_footer_prefetch_size",
+	    "Number of bytes at the tail of a parquet file to prefetch into data cache on file open, so footer and "
+	    "metadata reads hit cache. Footer blocks have higher retention priority than other data blocks, in in-memory "
+	    "cache and in on-disk cache under file layout. By default 1MiB; set it to 0 to disable footer prefetch.",
+	    LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_FOOTER_PREFETCH_SIZE));
+	config.AddExtensionOption(
+	    "cache_httpfs_footer_prefetch_file_pattern",
+	    "Glob pattern for files to prefetch footer on open besides parquet files, with `*` and `?` wildcards "
+	    "supported. By default empty, which only applies to parquet files.",
+	    LogicalType::VARCHAR, *DEFAULT_FOOTER_PREFETCH_FILE_PATTERN);
 	config.AddExtensionOption(
 	    "cache_httpfs_profile_type",
 	    "Profiling type for cached filesystem. There're three options available: `noop`, `temp`, and `duckdb`. `temp` "
@@ -210,6 +241,16 @@ static void LoadInternal(DatabaseInstance &instance) {
 	    "config [cache_httpfs_cache_block_size]. The setting limits the maximum request to issue for a single "
 	    "filesystem read request. 0 means no limit, by default we set no limit.",
 	    LogicalType::BIGINT, 0);
+	config.AddExtensionOption(
+	    "cache_httpfs_io_thread_count",
+	    "Number of threads for the IO executor, which is shared by all cache filesystems to perform parallel "
+	    "subrequests. 0 means decided by CPU core count, by default 8 threads per core and at least 64 threads.",
+	    LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_IO_THREAD_COUNT));
+	config.AddExtensionOption("cache_httpfs_cache_shard_count",
+	                          "Number of independently locked LRU shards for in-memory data cache, metadata cache and "
+	                          "glob cache, which reduces lock contention under concurrent access. It's worth noting it "
+	                          "should be set before cache creation, otherwise there's no affect.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_CACHE_SHARD_COUNT));
 	config.AddExtensionOption(
 	    "cache_httpfs_ignore_sigpipe",
 	    "Whether to ignore SIGPIPE for the extension. By default not ignored. Once ignored, it cannot be reverted.",
@@ -217,7 +258,10 @@ static void LoadInternal(DatabaseInstance &instance) {
 
 	// On disk cache config.
 	// TODO(hjiang): Add a new configurable for on-disk cache staleness.
-	config.AddExtensionOption("cache_httpfs_cache_directory", "The disk cache directory that stores cached data",
+	config.AddExtensionOption("cache_httpfs_cache_directory",
+	                          "The disk cache directory that stores cached data; a comma-separated list of directories "
+	                          "(i.e. on separate local devices) stripes cache files across them by consistent hashing, "
+	                          "a directory which fails or fills up is taken out of rotation for a while.",
 	                          LogicalType::VARCHAR, *DEFAULT_ON_DISK_CACHE_DIRECTORY);
 	config.AddExtensionOption("cache_httpfs_min_disk_bytes_for_cache",
 	                          "Min number of bytes on disk for the cache filesystem to enable on-disk cache; if left "
@@ -225,16 +269,78 @@ static void LoadInternal(DatabaseInstance &instance) {
 	                          "By default, 5% disk space will be reserved for other usage. When min disk bytes "
 	                          "specified with a positive value, the default value will be overriden.",
 	                          LogicalType::UBIGINT, 0);
+	config.AddExtensionOption("cache_httpfs_max_disk_cache_bytes",
+	                          "Max number of bytes for on-disk cache files; when exceeded, least recently used cache "
+	                          "files are evicted until usage drops under 90% of the capacity. By default 0, which "
+	                          "means no limit.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_DISK_CACHE_BYTES));
+	config.AddExtensionOption("cache_httpfs_disk_cache_weight_by_capacity",
+	                          "Whether to stripe cache files across multiple cache directories proportionally to the "
+	                          "capacity of their filesystems, and split max disk cache bytes the same way; by default "
+	                          "directories are weighted evenly.",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(DEFAULT_DISK_CACHE_WEIGHT_BY_CAPACITY));
+	config.AddExtensionOption("cache_httpfs_disk_cache_write_back_max_bytes",
+	                          "Max number of bytes held by on-disk cache files pending to write in background, so "
+	                          "cache population doesn't block reads; cache fills exceeding the cap are dropped. 0 "
+	                          "means cache files are written synchronously on the read path. By default 256MiB.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_DISK_CACHE_WRITE_BACK_MAX_BYTES));
+	config.AddExtensionOption("cache_httpfs_disk_cache_durability",
+	                          "Durability mode for on-disk cache files. There're three options available: `strict` "
+	                          "syncs every cache file before it's visible; `batched` syncs the filesystem for cache "
+	                          "directory every few seconds; `none` never syncs. Cache files left corrupted by crash "
+	                          "are discarded at read, which only leads to re-fetch. By default `strict`.",
+	                          LogicalType::VARCHAR, *DEFAULT_DISK_CACHE_DURABILITY);
+	config.AddExtensionOption("cache_httpfs_disk_cache_layout",
+	                          "Layout for on-disk cache. There're three options available: `file` caches every block "
+	                          "in a separate file; `segment` appends blocks into large segment files, so a cache hit "
+	                          "costs one positional read and no per-block file is created; `mirror` caches every "
+	                          "remote file in a local sparse file at native offsets, so consecutive cached blocks are "
+	                          "read at once. Cache files of one layout are invisible to the others. By default `file`.",
+	                          LogicalType::VARCHAR, *DEFAULT_DISK_CACHE_LAYOUT);
+	config.AddExtensionOption("cache_httpfs_disk_cache_io_engine",
+	                          "IO engine for on-disk cache files under file layout. There're four options available: "
+	                          "`sync` opens, reads and writes cache files with blocking IO one block after another; "
+	                          "`io_uring` batches cache file IO for all blocks of one request, and for cache files "
+	                          "drained together from background writes, into io_uring submissions, which is only "
+	                          "available on Linux, and falls back to `sync` if io_uring is unavailable; `direct` "
+	                          "reads and writes cache files with direct IO bypassing page cache, so cached bytes don't "
+	                          "occupy host memory twice; `mmap` serves cache hits by copying from memory-mapped cache "
+	                          "files without read syscalls. By default `sync`.",
+	                          LogicalType::VARCHAR, *DEFAULT_DISK_CACHE_IO_ENGINE);
+	config.AddExtensionOption("cache_httpfs_disk_cache_compression",
+	                          "Compression for on-disk cache blocks under file layout. There're two options available: "
+	                          "`none` stores blocks as is; `zstd` compresses blocks with zstd before they're written, "
+	                          "and blocks which don't compress well are stored raw, so compressible files (i.e. CSV "
+	                          "and JSON) take less disk space and get a higher hit rate. By default `none`.",
+	                          LogicalType::VARCHAR, *DEFAULT_DISK_CACHE_COMPRESSION);
+	config.AddExtensionOption("cache_httpfs_disk_cache_max_mapped_bytes",
+	                          "Max number of bytes for cache files kept memory-mapped under `mmap` IO engine, least "
+	                          "recently used mappings are unmapped once exceeded. By default 1GiB.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_DISK_CACHE_MAX_MAPPED_BYTES));
+	config.AddExtensionOption("cache_httpfs_disk_cache_segment_size",
+	                          "Max number of bytes for a segment file under segment layout; space is reclaimed at "
+	                          "segment granularity. By default 1GiB. It's worth noting it should be set before the "
+	                          "first cache access under segment layout, otherwise there's no affect.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_DISK_CACHE_SEGMENT_SIZE));
 
 	// In-memory cache config.
+	config.AddExtensionOption("cache_httpfs_max_in_mem_cache_bytes",
+	                          "Max number of bytes for in-memory caches for all cache filesystems, so users are able "
+	                          "to configure the maximum memory consumption. It's worth noting it should be set only "
+	                          "once before all filesystem access, otherwise there's no affect.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_IN_MEM_CACHE_BYTES));
+	config.AddExtensionOption("cache_httpfs_max_in_mem_cache_memory_percentage",
+	                          "Percentage of duckdb memory limit used as in-memory cache budget; when positive, it "
+	                          "overrides cache_httpfs_max_in_mem_cache_bytes. By default 0, which means disabled.",
+	                          LogicalType::DOUBLE, Value::DOUBLE(DEFAULT_MAX_IN_MEM_CACHE_MEMORY_PERCENTAGE));
 	config.AddExtensionOption("cache_httpfs_max_in_mem_cache_block_count",
-	                          "Max in-memory cache block count for in-memory caches for all cache filesystems, so "
-	                          "users are able to configure the maximum memory consumption. It's worth noting it "
-	                          "should be set only once before all filesystem access, otherwise there's no affect.",
-	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_MAX_IN_MEM_CACHE_BLOCK_COUNT));
+	                          "Deprecated, use cache_httpfs_max_in_mem_cache_bytes instead. When positive, the "
+	                          "in-memory cache budget is (block count * cache block size).",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
 	config.AddExtensionOption("cache_httpfs_in_mem_cache_block_timeout_millisec",
-	                          "Data block cache entry timeout in milliseconds.", LogicalTypeId::UBIGINT,
-	                          Value::UBIGINT(DEFAULT_IN_MEM_BLOCK_CACHE_TIMEOUT_MILLISEC));
+	                          "Data block cache entry timeout in milliseconds. Blocks are keyed by remote file "
+	                          "version, so overwritten files don't require short timeouts.",
+	                          LogicalTypeId::UBIGINT, Value::UBIGINT(DEFAULT_IN_MEM_BLOCK_CACHE_TIMEOUT_MILLISEC));
 
 	// Metadata cache config.
 	config.AddExtensionOption("cache_httpfs_enable_metadata_cache",
@@ -243,8 +349,9 @@ static void LoadInternal(DatabaseInstance &instance) {
 	config.AddExtensionOption("cache_httpfs_metadata_cache_entry_size", "Max cache size for metadata LRU cache.",
 	                          LogicalTypeId::UBIGINT, Value::UBIGINT(DEFAULT_MAX_METADATA_CACHE_ENTRY));
 	config.AddExtensionOption("cache_httpfs_metadata_cache_entry_timeout_millisec",
-	                          "Cache entry timeout in milliseconds for metadata LRU cache.", LogicalTypeId::UBIGINT,
-	                          Value::UBIGINT(DEFAULT_METADATA_CACHE_ENTRY_TIMEOUT_MILLISEC));
+	                          "Cache entry timeout in milliseconds for metadata LRU cache, which bounds how long an "
+	                          "overwritten remote file could be served from cache.",
+	                          LogicalTypeId::UBIGINT, Value::UBIGINT(DEFAULT_METADATA_CACHE_ENTRY_TIMEOUT_MILLISEC));
 
 	// File handle cache config.
 	config.AddExtensionOption("cache_httpfs_enable_file_handle_cache",
@@ -311,6 +418,12 @@ static void LoadInternal(DatabaseInstance &instance) {
 	// Register cache access metrics.
 	ExtensionUtil::RegisterFunction(instance, GetCacheAccessInfoQueryFunc());
 
+	// Register IO executor metrics.
+	ExtensionUtil::RegisterFunction(instance, GetIoExecutorStatsQueryFunc());
+
+	// Register disk cache compression metrics.
+	ExtensionUtil::RegisterFunction(instance, GetDiskCacheCompressionStatsQueryFunc());
+
 	// Create default cache directory.
 	LocalFileSystem::CreateLocal()->CreateDirectory(*DEFAULT_ON_DISK_CACHE_DIRECTORY);
 
@@ -0,0 +1,152 @@
+#include "cache_read_chunk.hpp"
+
+#include <cstring>
+#include <exception>
+
+#include "cache_filesystem_config.hpp"
+#include "io_executor.hpp"
+#include "utils/include/resize_uninitialized.hpp"
+
+namespace duckdb {
+
+char *CacheReadChunk::GetAddressToReadTo() {
+	if (IsFullyRequested()) {
+		return requested_start_addr;
+	}
+	if (content.empty()) {
+		content = CreateResizeUninitializedString(chunk_size);
+	}
+	return const_cast<char *>(content.data());
+}
+
+void CacheReadChunk::CopyBufferToRequestedMemory() {
+	if (!content.empty()) {
+		CopyBufferToRequestedMemory(content);
+	}
+}
+
+void CacheReadChunk::CopyBufferToRequestedMemory(const string &buffer) const {
+	CopyBufferToRequestedMemory(buffer.data());
+}
+
+void CacheReadChunk::CopyBufferToRequestedMemory(const char *buffer) const {
+	const idx_t delta_offset = requested_start_offset - aligned_start_offset;
+	std::memmove(requested_start_addr, buffer + delta_offset, bytes_to_copy);
+}
+
+vector<CacheReadChunk> SplitIntoCacheReadChunks(char *buffer, idx_t requested_start_offset,
+                                                idx_t requested_bytes_to_read, idx_t file_size, idx_t block_size) {
+	vector<CacheReadChunk> cache_read_chunks;
+	if (requested_bytes_to_read == 0) {
+		return cache_read_chunks;
+	}
+
+	const idx_t requested_end_offset = requested_start_offset + requested_bytes_to_read;
+	const idx_t aligned_start_offset = requested_start_offset / block_size * block_size;
+	// Aligned offset for the block which contains the last requested byte.
+	const idx_t aligned_last_chunk_offset = (requested_end_offset - 1) / block_size * block_size;
+	cache_read_chunks.reserve((aligned_last_chunk_offset - aligned_start_offset) / block_size + 1);
+
+	// Indicate the memory address to copy to for each chunk.
+	char *addr_to_write = buffer;
+	for (idx_t io_start_offset = aligned_start_offset; io_start_offset <= aligned_last_chunk_offset;
+	     io_start_offset += block_size) {
+		CacheReadChunk cache_read_chunk;
+		cache_read_chunk.requested_start_addr = addr_to_write;
+		cache_read_chunk.aligned_start_offset = io_start_offset;
+		cache_read_chunk.requested_start_offset = MaxValue<idx_t>(io_start_offset, requested_start_offset);
+		// All chunks are of block size, except the last one of the file.
+		cache_read_chunk.chunk_size = MinValue<idx_t>(block_size, file_size - io_start_offset);
+		// The first chunk might not start at aligned offset, and the last chunk might not end at block boundary.
+		const idx_t chunk_requested_end_offset = MinValue<idx_t>(io_start_offset + block_size, requested_end_offset);
+		cache_read_chunk.bytes_to_copy = chunk_requested_end_offset - cache_read_chunk.requested_start_offset;
+
+		addr_to_write += cache_read_chunk.bytes_to_copy;
+		cache_read_chunks.emplace_back(std::move(cache_read_chunk));
+	}
+	return cache_read_chunks;
+}
+
+char *RemoteReadRange::GetAddressToReadTo() {
+	for (const auto *cur_chunk : chunks) {
+		if (!cur_chunk->IsFullyRequested()) {
+			if (content.empty()) {
+				content = CreateResizeUninitializedString(size);
+			}
+			return const_cast<char *>(content.data());
+		}
+	}
+	return chunks.front()->requested_start_addr;
+}
+
+void RemoteReadRange::CopyBufferToRequestedMemory() {
+	if (content.empty()) {
+		return;
+	}
+	for (const auto *cur_chunk : chunks) {
+		const idx_t delta_offset = cur_chunk->requested_start_offset - start_offset;
+		std::memmove(cur_chunk->requested_start_addr, content.data() + delta_offset, cur_chunk->bytes_to_copy);
+	}
+}
+
+const char *RemoteReadRange::GetChunkData(const CacheReadChunk &chunk) const {
+	if (!content.empty()) {
+		return content.data() + (chunk.aligned_start_offset - start_offset);
+	}
+	return chunk.requested_start_addr;
+}
+
+vector<RemoteReadRange> CoalesceCacheReadChunks(const vector<CacheReadChunk *> &chunks, idx_t max_request_size) {
+	vector<RemoteReadRange> ranges;
+	for (auto *cur_chunk : chunks) {
+		if (!ranges.empty()) {
+			auto &last_range = ranges.back();
+			const bool is_consecutive = last_range.start_offset + last_range.size == cur_chunk->aligned_start_offset;
+			if (is_consecutive && last_range.size + cur_chunk->chunk_size <= max_request_size) {
+				last_range.chunks.emplace_back(cur_chunk);
+				last_range.size += cur_chunk->chunk_size;
+				continue;
+			}
+		}
+		RemoteReadRange new_range;
+		new_range.chunks.emplace_back(cur_chunk);
+		new_range.start_offset = cur_chunk->aligned_start_offset;
+		new_range.size = cur_chunk->chunk_size;
+		ranges.emplace_back(std::move(new_range));
+	}
+	return ranges;
+}
+
+void ExecuteRemoteReadRanges(vector<RemoteReadRange> &ranges, const std::function<void(RemoteReadRange &)> &func) {
+	if (ranges.empty()) {
+		return;
+	}
+	if (ranges.size() == 1) {
+		func(ranges[0]);
+		return;
+	}
+
+	const idx_t task_count = GetThreadCountForSubrequests(ranges.size());
+	IoTaskGroup io_tasks;
+	for (idx_t task_idx = 0; task_idx < task_count; ++task_idx) {
+		io_tasks.Submit([&ranges, &func, task_idx, task_count]() {
+			// Execute all assigned ranges even if some of them fail, so no range is left unprocessed.
+			std::exception_ptr first_exception;
+			for (idx_t range_idx = task_idx; range_idx < ranges.size(); range_idx += task_count) {
+				try {
+					func(ranges[range_idx]);
+				} catch (...) {
+					if (first_exception == nullptr) {
+						first_exception = std::current_exception();
+					}
+				}
+			}
+			if (first_exception != nullptr) {
+				std::rethrow_exception(first_exception);
+			}
+		});
+	}
+	io_tasks.Wait();
+}
+
+} // namespace duckdb
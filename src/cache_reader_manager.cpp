@@ -59,6 +59,10 @@ vector<BaseCacheReader *> CacheReaderManager::GetCacheReaders() const {
 	return cache_readers;
 }
 
+bool CacheReaderManager::IsDiskCacheReaderInitialized() const {
+	return on_disk_cache_reader != nullptr;
+}
+
 void CacheReaderManager::ClearCache() {
 	if (noop_cache_reader != nullptr) {
 		noop_cache_reader->ClearCache();
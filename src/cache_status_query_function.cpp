@@ -14,6 +14,8 @@
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/extension_util.hpp"
+#include "io_executor.hpp"
+#include "time_utils.hpp"
 
 namespace duckdb {
 
@@ -129,6 +131,11 @@ struct CacheAccessInfoData : public GlobalTableFunctionState {
 	// Index-ed by [CacheEntity].
 	vector<CacheAccessInfo> cache_access_info;
 
+	// Data cache capacity and usage aggregated from all cache readers, only valid if any cache reader budgets its data
+	// cache.
+	bool has_data_cache_usage = false;
+	DataCacheUsage data_cache_usage;
+
 	// Used to record the progress of emission.
 	uint64_t offset = 0;
 };
@@ -138,8 +145,8 @@ unique_ptr<FunctionData> CacheAccessInfoQueryFuncBind(ClientContext &context, Ta
 	D_ASSERT(return_types.empty());
 	D_ASSERT(names.empty());
 
-	return_types.reserve(3);
-	names.reserve(3);
+	return_types.reserve(6);
+	names.reserve(6);
 
 	// Cache type.
 	return_types.emplace_back(LogicalType::VARCHAR);
@@ -153,6 +160,18 @@ unique_ptr<FunctionData> CacheAccessInfoQueryFuncBind(ClientContext &context, Ta
 	return_types.emplace_back(LogicalType::UBIGINT);
 	names.emplace_back("cache_miss_count");
 
+	// Deduplicated cache miss count.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("cache_dedup_miss_count");
+
+	// Cache capacity in bytes, only available for data cache with a byte budget.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("cache_capacity_bytes");
+
+	// Cache usage in bytes, only available for data cache with a byte budget.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("cache_usage_bytes");
+
 	return nullptr;
 }
 
@@ -181,7 +200,19 @@ unique_ptr<GlobalTableFunctionState> CacheAccessInfoQueryFuncInit(ClientContext
 			auto &cur_cache_access_info = cache_access_info[idx];
 			aggregated_cache_access_infos[idx].cache_hit_count += cur_cache_access_info.cache_hit_count;
 			aggregated_cache_access_infos[idx].cache_miss_count += cur_cache_access_info.cache_miss_count;
+			aggregated_cache_access_infos[idx].cache_dedup_miss_count += cur_cache_access_info.cache_dedup_miss_count;
+		}
+	}
+
+	// Get data cache capacity and usage from all initialized cache readers.
+	for (auto *cur_cache_reader : cache_readers) {
+		DataCacheUsage cur_data_cache_usage;
+		if (!cur_cache_reader->GetDataCacheUsage(cur_data_cache_usage)) {
+			continue;
 		}
+		result->has_data_cache_usage = true;
+		result->data_cache_usage.capacity_bytes += cur_data_cache_usage.capacity_bytes;
+		result->data_cache_usage.used_bytes += cur_data_cache_usage.used_bytes;
 	}
 
 	return std::move(result);
@@ -198,6 +229,8 @@ void CacheAccessInfoQueryTableFunc(ClientContext &context, TableFunctionInput &d
 	// Start filling in the result buffer.
 	idx_t count = 0;
 	while (data.offset < data.cache_access_info.size() && count < STANDARD_VECTOR_SIZE) {
+		const bool is_data_cache = data.offset == static_cast<idx_t>(BaseProfileCollector::CacheEntity::kData);
+		const bool has_cache_usage = is_data_cache && data.has_data_cache_usage;
 		auto &entry = data.cache_access_info[data.offset++];
 		idx_t col = 0;
 
@@ -210,11 +243,182 @@ void CacheAccessInfoQueryTableFunc(ClientContext &context, TableFunctionInput &d
 		// Cache miss count.
 		output.SetValue(col++, count, Value::BIGINT(NumericCast<uint64_t>(entry.cache_miss_count)));
 
+		// Deduplicated cache miss count.
+		output.SetValue(col++, count, Value::BIGINT(NumericCast<uint64_t>(entry.cache_dedup_miss_count)));
+
+		// Cache capacity in bytes.
+		output.SetValue(col++, count,
+		                has_cache_usage ? Value::BIGINT(NumericCast<uint64_t>(data.data_cache_usage.capacity_bytes))
+		                                : Value());
+
+		// Cache usage in bytes.
+		output.SetValue(col++, count,
+		                has_cache_usage ? Value::BIGINT(NumericCast<uint64_t>(data.data_cache_usage.used_bytes))
+		                                : Value());
+
 		count++;
 	}
 	output.SetCardinality(count);
 }
 
+//===--------------------------------------------------------------------===//
+// IO executor stats query function
+//===--------------------------------------------------------------------===//
+
+struct IoExecutorStatsData : public GlobalTableFunctionState {
+	IoExecutorStats io_executor_stats;
+
+	// Whether the only row has been emitted.
+	bool finished = false;
+};
+
+unique_ptr<FunctionData> IoExecutorStatsQueryFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(4);
+	names.reserve(4);
+
+	// Number of IO threads.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("thread_count");
+
+	// Number of IO threads executing tasks.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("busy_thread_count");
+
+	// Number of tasks waiting in the queue.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("pending_task_count");
+
+	// Number of tasks finished.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("completed_task_count");
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> IoExecutorStatsQueryFuncInit(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+	auto result = make_uniq<IoExecutorStatsData>();
+	result->io_executor_stats = IoExecutor::Get().GetStats();
+	return std::move(result);
+}
+
+void IoExecutorStatsQueryTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<IoExecutorStatsData>();
+	if (data.finished) {
+		return;
+	}
+	data.finished = true;
+
+	const auto &stats = data.io_executor_stats;
+	idx_t col = 0;
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.thread_count));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.busy_thread_count));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.pending_task_count));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.completed_task_count));
+	output.SetCardinality(1);
+}
+
+//===--------------------------------------------------------------------===//
+// Disk cache compression stats query function
+//===--------------------------------------------------------------------===//
+
+struct DiskCacheCompressionStatsData : public GlobalTableFunctionState {
+	// Compression stats aggregated from all cache readers.
+	DiskCacheCompressionStats compression_stats;
+
+	// Whether the only row has been emitted.
+	bool finished = false;
+};
+
+unique_ptr<FunctionData> DiskCacheCompressionStatsQueryFuncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                                vector<LogicalType> &return_types,
+                                                                vector<string> &names) {
+	D_ASSERT(return_types.empty());
+	D_ASSERT(names.empty());
+
+	return_types.reserve(7);
+	names.reserve(7);
+
+	// Number of cache blocks written with compression enabled.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("written_block_count");
+
+	// Number of cache blocks stored compressed, others don't compress well and are stored raw.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("compressed_block_count");
+
+	// Number of payload bytes before compression.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("raw_bytes");
+
+	// Number of payload bytes stored in cache files.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("stored_bytes");
+
+	// Ratio of raw bytes to stored bytes.
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("compression_ratio");
+
+	// Number of cache blocks decompressed on cache hit.
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("decompressed_block_count");
+
+	// Average time spent to decompress a cache block in microseconds.
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("avg_decompression_micros");
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> DiskCacheCompressionStatsQueryFuncInit(ClientContext &context,
+                                                                            TableFunctionInitInput &input) {
+	auto result = make_uniq<DiskCacheCompressionStatsData>();
+	auto &aggregated_stats = result->compression_stats;
+	for (auto *cur_cache_reader : CacheReaderManager::Get().GetCacheReaders()) {
+		DiskCacheCompressionStats cur_stats;
+		if (!cur_cache_reader->GetDiskCacheCompressionStats(cur_stats)) {
+			continue;
+		}
+		aggregated_stats.written_block_count += cur_stats.written_block_count;
+		aggregated_stats.compressed_block_count += cur_stats.compressed_block_count;
+		aggregated_stats.raw_bytes += cur_stats.raw_bytes;
+		aggregated_stats.stored_bytes += cur_stats.stored_bytes;
+		aggregated_stats.decompressed_block_count += cur_stats.decompressed_block_count;
+		aggregated_stats.decompression_nanosec += cur_stats.decompression_nanosec;
+	}
+	return std::move(result);
+}
+
+void DiskCacheCompressionStatsQueryTableFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &data = data_p.global_state->Cast<DiskCacheCompressionStatsData>();
+	if (data.finished) {
+		return;
+	}
+	data.finished = true;
+
+	const auto &stats = data.compression_stats;
+	const double compression_ratio =
+	    stats.stored_bytes == 0 ? 1.0 : static_cast<double>(stats.raw_bytes) / static_cast<double>(stats.stored_bytes);
+	const double avg_decompression_micros =
+	    stats.decompressed_block_count == 0
+	        ? 0.0
+	        : static_cast<double>(stats.decompression_nanosec) / static_cast<double>(kMicrosToNanos) /
+	              static_cast<double>(stats.decompressed_block_count);
+	idx_t col = 0;
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.written_block_count));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.compressed_block_count));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.raw_bytes));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.stored_bytes));
+	output.SetValue(col++, /*index=*/0, Value::DOUBLE(compression_ratio));
+	output.SetValue(col++, /*index=*/0, Value::UBIGINT(stats.decompressed_block_count));
+	output.SetValue(col++, /*index=*/0, Value::DOUBLE(avg_decompression_micros));
+	output.SetCardinality(1);
+}
+
 } // namespace
 
 TableFunction GetDataCacheStatusQueryFunc() {
@@ -235,4 +439,23 @@ TableFunction GetCacheAccessInfoQueryFunc() {
 	return cache_access_info_query_func;
 }
 
+TableFunction GetIoExecutorStatsQueryFunc() {
+	TableFunction io_executor_stats_query_func {/*name=*/"cache_httpfs_io_executor_stats_query",
+	                                            /*arguments=*/ {},
+	                                            /*function=*/IoExecutorStatsQueryTableFunc,
+	                                            /*bind=*/IoExecutorStatsQueryFuncBind,
+	                                            /*init_global=*/IoExecutorStatsQueryFuncInit};
+	return io_executor_stats_query_func;
+}
+
+TableFunction GetDiskCacheCompressionStatsQueryFunc() {
+	TableFunction disk_cache_compression_stats_query_func {
+	    /*name=*/"cache_httpfs_disk_cache_compression_stats_query",
+	    /*arguments=*/ {},
+	    /*function=*/DiskCacheCompressionStatsQueryTableFunc,
+	    /*bind=*/DiskCacheCompressionStatsQueryFuncBind,
+	    /*init_global=*/DiskCacheCompressionStatsQueryFuncInit};
+	return disk_cache_compression_stats_query_func;
+}
+
 } // namespace duckdb
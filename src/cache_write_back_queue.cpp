@@ -0,0 +1,94 @@
+#include "cache_write_back_queue.hpp"
+
+#include <utility>
+
+namespace duckdb {
+
+CacheWriteBackQueue::CacheWriteBackQueue(idx_t thread_count, idx_t max_batch_count_p, WriteFunc write_func_p)
+    : max_batch_count(max_batch_count_p), write_func(std::move(write_func_p)),
+      thread_pool(thread_count, "cache_writer") {
+}
+
+CacheWriteBackQueue::~CacheWriteBackQueue() {
+	Flush();
+}
+
+bool CacheWriteBackQueue::Submit(const std::string &cache_file, shared_ptr<const std::string> content,
+                                 idx_t max_pending_bytes, CacheFileRetention retention) {
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		if (pending_writes.find(cache_file) != pending_writes.end()) {
+			return true;
+		}
+		if (pending_bytes + content->length() > max_pending_bytes) {
+			++dropped_count;
+			return false;
+		}
+		pending_bytes += content->length();
+		pending_writes.emplace(cache_file, content);
+		queued_writes.emplace_back(PendingWrite {
+		    .cache_file = cache_file,
+		    .content = std::move(content),
+		    .retention = retention,
+		});
+	}
+
+	// One task per submission, tasks which find all cache files taken by earlier batches return directly.
+	thread_pool.Push([this]() { WriteQueuedCacheFiles(); });
+	return true;
+}
+
+void CacheWriteBackQueue::WriteQueuedCacheFiles() {
+	vector<PendingWrite> cur_pending_writes;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		while (!queued_writes.empty() && cur_pending_writes.size() < max_batch_count) {
+			cur_pending_writes.emplace_back(std::move(queued_writes.front()));
+			queued_writes.pop_front();
+		}
+	}
+	if (cur_pending_writes.empty()) {
+		return;
+	}
+
+	try {
+		write_func(cur_pending_writes);
+	} catch (...) {
+		// Cache population is best-effort, blocks would be fetched from remote storage on the next access.
+	}
+
+	std::lock_guard<std::mutex> lck(mu);
+	for (const auto &cur_pending_write : cur_pending_writes) {
+		pending_writes.erase(cur_pending_write.cache_file);
+		pending_bytes -= cur_pending_write.content->length();
+	}
+	if (pending_writes.empty()) {
+		flush_cv.notify_all();
+	}
+}
+
+shared_ptr<const std::string> CacheWriteBackQueue::GetPendingContent(const std::string &cache_file) const {
+	std::lock_guard<std::mutex> lck(mu);
+	auto iter = pending_writes.find(cache_file);
+	if (iter == pending_writes.end()) {
+		return nullptr;
+	}
+	return iter->second;
+}
+
+void CacheWriteBackQueue::Flush() {
+	std::unique_lock<std::mutex> lck(mu);
+	flush_cv.wait(lck, [this]() { return pending_writes.empty(); });
+}
+
+idx_t CacheWriteBackQueue::GetPendingBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return pending_bytes;
+}
+
+idx_t CacheWriteBackQueue::GetDroppedCount() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return dropped_count;
+}
+
+} // namespace duckdb
@@ -0,0 +1,105 @@
+#include "disk_cache_block_footer.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+#include "crc32c.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Magic number for every cache block footer, used to detect torn or garbage footers.
+constexpr uint32_t DISK_CACHE_BLOCK_FOOTER_MAGIC = 0x42464843; // "CHFB"
+
+// Bumped on incompatible format change, cache files in other versions are discarded.
+// - Version 1: payload is always stored raw.
+// - Version 2: payload is stored raw or compressed, as recorded in footer.
+constexpr uint8_t DISK_CACHE_BLOCK_FORMAT_VERSION = 2;
+
+uint32_t GetFooterChecksum(const DiskCacheBlockFooter &footer) {
+	return Crc32c(reinterpret_cast<const char *>(&footer), offsetof(DiskCacheBlockFooter, footer_crc32c));
+}
+
+} // namespace
+
+bool operator==(const RemoteFileIdentity &lhs, const RemoteFileIdentity &rhs) {
+	return lhs.file_size == rhs.file_size && lhs.last_modified == rhs.last_modified &&
+	       lhs.version_hash == rhs.version_hash;
+}
+
+bool operator!=(const RemoteFileIdentity &lhs, const RemoteFileIdentity &rhs) {
+	return !(lhs == rhs);
+}
+
+void EncodeDiskCacheBlockFooter(const char *payload, idx_t payload_length, const RemoteFileIdentity &remote_identity,
+                                char *footer) {
+	EncodeDiskCacheBlockFooter(payload, payload_length, DiskCacheBlockCodec::kNone, payload_length, remote_identity,
+	                           footer);
+}
+
+void EncodeDiskCacheBlockFooter(const char *stored, idx_t stored_length, DiskCacheBlockCodec codec,
+                                idx_t payload_length, const RemoteFileIdentity &remote_identity, char *footer) {
+	DiskCacheBlockFooter block_footer {
+	    .magic = DISK_CACHE_BLOCK_FOOTER_MAGIC,
+	    .version = DISK_CACHE_BLOCK_FORMAT_VERSION,
+	    .codec = static_cast<uint8_t>(codec),
+	    .footer_size = static_cast<uint16_t>(DISK_CACHE_BLOCK_FOOTER_SIZE),
+	    .payload_length = static_cast<uint64_t>(payload_length),
+	    .remote_file_size = static_cast<uint64_t>(remote_identity.file_size),
+	    .remote_last_modified = remote_identity.last_modified,
+	    .remote_version_hash = remote_identity.version_hash,
+	    .stored_crc32c = Crc32c(stored, stored_length),
+	};
+	block_footer.footer_crc32c = GetFooterChecksum(block_footer);
+	std::memcpy(footer, &block_footer, sizeof(block_footer));
+}
+
+bool DecodeDiskCacheBlockFooter(const char *footer, DiskCacheBlockFooter &decoded) {
+	std::memcpy(&decoded, footer, sizeof(decoded));
+	return decoded.magic == DISK_CACHE_BLOCK_FOOTER_MAGIC && decoded.version == DISK_CACHE_BLOCK_FORMAT_VERSION &&
+	       decoded.codec <= static_cast<uint8_t>(DiskCacheBlockCodec::kZstd) &&
+	       decoded.footer_size == DISK_CACHE_BLOCK_FOOTER_SIZE && decoded.footer_crc32c == GetFooterChecksum(decoded);
+}
+
+RemoteFileIdentity GetRemoteFileIdentity(const DiskCacheBlockFooter &footer) {
+	return RemoteFileIdentity {
+	    .file_size = static_cast<idx_t>(footer.remote_file_size),
+	    .last_modified = footer.remote_last_modified,
+	    .version_hash = footer.remote_version_hash,
+	};
+}
+
+bool IsDiskCacheBlockStoredLengthMatched(const DiskCacheBlockFooter &footer, idx_t stored_length) {
+	if (footer.codec == static_cast<uint8_t>(DiskCacheBlockCodec::kNone)) {
+		return footer.payload_length == stored_length;
+	}
+	return stored_length < footer.payload_length;
+}
+
+bool IsDiskCacheBlockFooterMatched(const char *footer, idx_t payload_length,
+                                   const RemoteFileIdentity &remote_identity) {
+	DiskCacheBlockFooter decoded;
+	if (!DecodeDiskCacheBlockFooter(footer, decoded)) {
+		return false;
+	}
+	return decoded.payload_length == payload_length && GetRemoteFileIdentity(decoded) == remote_identity;
+}
+
+bool IsValidDiskCacheBlock(const char *payload, idx_t payload_length, const char *footer,
+                           const RemoteFileIdentity &remote_identity) {
+	return IsValidDiskCacheBlock(payload, payload_length, footer, payload_length, remote_identity);
+}
+
+bool IsValidDiskCacheBlock(const char *stored, idx_t stored_length, const char *footer, idx_t payload_length,
+                           const RemoteFileIdentity &remote_identity) {
+	if (!IsDiskCacheBlockFooterMatched(footer, payload_length, remote_identity)) {
+		return false;
+	}
+	DiskCacheBlockFooter decoded;
+	std::memcpy(&decoded, footer, sizeof(decoded));
+	return IsDiskCacheBlockStoredLengthMatched(decoded, stored_length) &&
+	       decoded.stored_crc32c == Crc32c(stored, stored_length);
+}
+
+} // namespace duckdb
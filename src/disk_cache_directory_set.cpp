@@ -0,0 +1,116 @@
+#include "disk_cache_directory_set.hpp"
+
+#include <cmath>
+#include <utility>
+
+#include "crc32c.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/helper.hpp"
+#include "time_utils.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Finalizer of splitmix64, which spreads every input bit over all output bits.
+uint64_t MixHash(uint64_t value) {
+	value += 0x9E3779B97F4A7C15ULL;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+uint64_t HashString(const std::string &value) {
+	return MixHash(Crc32c(value.data(), value.length()));
+}
+
+} // namespace
+
+DiskCacheDirectorySet::DiskCacheDirectorySet(vector<std::string> directories_p, vector<double> weights_p,
+                                             int64_t rejoin_interval_millisec_p)
+    : directories(std::move(directories_p)), weights(std::move(weights_p)),
+      rejoin_interval_millisec(rejoin_interval_millisec_p),
+      rejoin_timestamps(new std::atomic<int64_t>[directories.size()]) {
+	D_ASSERT(!directories.empty());
+	D_ASSERT(weights.empty() || weights.size() == directories.size());
+	if (weights.empty()) {
+		weights.assign(directories.size(), 1.0);
+	}
+	seeds.reserve(directories.size());
+	for (idx_t idx = 0; idx < directories.size(); ++idx) {
+		D_ASSERT(weights[idx] > 0);
+		overall_weight += weights[idx];
+		seeds.emplace_back(HashString(directories[idx]));
+		rejoin_timestamps[idx].store(0);
+	}
+}
+
+idx_t DiskCacheDirectorySet::PickDirectory(const std::string &cache_fname) const {
+	if (directories.size() == 1) {
+		return 0;
+	}
+
+	// Weighted rendezvous hashing: each directory draws a uniform number in (0, 1) from the hash, and scores by
+	// `-weight / ln(draw)`, so the chance for a directory to win is proportional to its weight.
+	const uint64_t fname_hash = HashString(cache_fname);
+	idx_t preferred_directory_idx = 0;
+	double preferred_score = -1;
+	optional_idx rotated_directory_idx;
+	double rotated_score = -1;
+	for (idx_t idx = 0; idx < directories.size(); ++idx) {
+		const uint64_t cur_hash = MixHash(fname_hash ^ seeds[idx]);
+		const double cur_draw = (static_cast<double>(cur_hash >> 11) + 0.5) / static_cast<double>(1ULL << 53);
+		const double cur_score = -weights[idx] / std::log(cur_draw);
+		if (cur_score > preferred_score) {
+			preferred_score = cur_score;
+			preferred_directory_idx = idx;
+		}
+		if (cur_score > rotated_score && IsInRotation(idx)) {
+			rotated_score = cur_score;
+			rotated_directory_idx = idx;
+		}
+	}
+	return rotated_directory_idx.IsValid() ? rotated_directory_idx.GetIndex() : preferred_directory_idx;
+}
+
+optional_idx DiskCacheDirectorySet::FindDirectory(const std::string &filepath) const {
+	// Directories could be nested, so the innermost one holds the file.
+	optional_idx directory_idx;
+	idx_t directory_length = 0;
+	for (idx_t idx = 0; idx < directories.size(); ++idx) {
+		const auto &cur_directory = directories[idx];
+		if (cur_directory.length() < directory_length || filepath.length() <= cur_directory.length() ||
+		    filepath.compare(0, cur_directory.length(), cur_directory) != 0) {
+			continue;
+		}
+		if (cur_directory.back() != '/' && filepath[cur_directory.length()] != '/') {
+			continue;
+		}
+		directory_idx = idx;
+		directory_length = cur_directory.length();
+	}
+	return directory_idx;
+}
+
+void DiskCacheDirectorySet::TakeOutOfRotation(idx_t directory_idx) {
+	D_ASSERT(directory_idx < directories.size());
+	rejoin_timestamps[directory_idx].store(GetSteadyNowMilliSecSinceEpoch() + rejoin_interval_millisec);
+}
+
+bool DiskCacheDirectorySet::IsInRotation(idx_t directory_idx) const {
+	D_ASSERT(directory_idx < directories.size());
+	const int64_t rejoin_timestamp = rejoin_timestamps[directory_idx].load();
+	return rejoin_timestamp == 0 || rejoin_timestamp <= GetSteadyNowMilliSecSinceEpoch();
+}
+
+idx_t DiskCacheDirectorySet::GetCapacityBytes(idx_t directory_idx, idx_t overall_capacity_bytes) const {
+	D_ASSERT(directory_idx < directories.size());
+	if (overall_capacity_bytes == 0) {
+		return 0;
+	}
+	// Every directory gets at least one byte, so the share doesn't turn into no limit.
+	const double capacity_bytes = static_cast<double>(overall_capacity_bytes) * weights[directory_idx] / overall_weight;
+	return MaxValue<idx_t>(static_cast<idx_t>(capacity_bytes), 1);
+}
+
+} // namespace duckdb
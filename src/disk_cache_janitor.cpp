@@ -0,0 +1,275 @@
+#include "disk_cache_janitor.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "cache_filesystem_config.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "filesystem_utils.hpp"
+#include "thread_utils.hpp"
+#include "time_utils.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Length of the rate limit window for cache file deletions.
+constexpr int64_t REMOVAL_WINDOW_MILLISEC = 1000;
+
+// Exclusive lock on the lock file for a cache directory, which is released on destruction.
+class DirectoryLock {
+public:
+	explicit DirectoryLock(const std::string &lock_filepath) {
+		fd = open(lock_filepath.data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (fd < 0) {
+			return;
+		}
+		if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+			close(fd);
+			fd = -1;
+			is_held_by_others = true;
+		}
+	}
+
+	DirectoryLock(const DirectoryLock &) = delete;
+	DirectoryLock &operator=(const DirectoryLock &) = delete;
+
+	~DirectoryLock() {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+
+	// Return whether the lock is held by another janitor. A lock file failing to open (i.e. parent directory doesn't
+	// exist) is not treated as held, eviction within the current process is still safe.
+	bool IsHeldByOthers() const {
+		return is_held_by_others;
+	}
+
+private:
+	int fd = -1;
+	bool is_held_by_others = false;
+};
+
+void AppendCacheFiles(vector<std::string> cache_files, vector<std::string> &target) {
+	target.insert(target.end(), std::make_move_iterator(cache_files.begin()),
+	              std::make_move_iterator(cache_files.end()));
+}
+
+// Get bytes counted against capacity for [lru_index], including cache files evicted but not deleted yet.
+idx_t GetOccupiedBytes(const DiskCacheLruIndex &lru_index) {
+	return lru_index.GetUsedBytes() + lru_index.GetPendingDeletionBytes();
+}
+
+} // namespace
+
+DiskCacheJanitor::DiskCacheJanitor(double high_watermark_ratio_p, idx_t max_removals_per_second_p,
+                                   int64_t interval_millisec_p)
+    : high_watermark_ratio(high_watermark_ratio_p), max_removals_per_second(max_removals_per_second_p),
+      interval_millisec(interval_millisec_p), janitor_thread([this]() { Run(); }) {
+}
+
+DiskCacheJanitor::~DiskCacheJanitor() {
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		stopped = true;
+	}
+	janitor_cv.notify_all();
+	janitor_thread.join();
+}
+
+void DiskCacheJanitor::AddDirectory(const std::string &cache_directory, shared_ptr<DiskCacheLruIndex> lru_index) {
+	std::lock_guard<std::mutex> lck(mu);
+	directories[cache_directory].lru_index = std::move(lru_index);
+}
+
+void DiskCacheJanitor::ClearDirectories() {
+	std::lock_guard<std::mutex> lck(mu);
+	for (auto &cur_directory : directories) {
+		cur_directory.second.lru_index = nullptr;
+	}
+}
+
+void DiskCacheJanitor::RemoveCacheFiles(const std::string &cache_directory, vector<std::string> cache_files) {
+	if (cache_files.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		AppendCacheFiles(std::move(cache_files), directories[cache_directory].pending_removals);
+		wake_requested = true;
+	}
+	janitor_cv.notify_one();
+}
+
+void DiskCacheJanitor::MaybeWake(const DiskCacheLruIndex &lru_index) {
+	const idx_t capacity_bytes = lru_index.GetCapacityBytes();
+	if (capacity_bytes == 0 ||
+	    GetOccupiedBytes(lru_index) <= static_cast<idx_t>(capacity_bytes * high_watermark_ratio)) {
+		return;
+	}
+	Wake();
+}
+
+void DiskCacheJanitor::Wake() {
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		wake_requested = true;
+	}
+	janitor_cv.notify_one();
+}
+
+void DiskCacheJanitor::Flush() {
+	std::unique_lock<std::mutex> lck(mu);
+	const uint64_t target_pass_count = ++requested_pass_count;
+	janitor_cv.notify_one();
+	pass_cv.wait(lck, [this, target_pass_count]() { return stopped || completed_pass_count >= target_pass_count; });
+}
+
+std::string DiskCacheJanitor::GetLockFilepath(const std::string &cache_directory) {
+	std::string directory = cache_directory;
+	while (directory.length() > 1 && directory.back() == '/') {
+		directory.pop_back();
+	}
+	return StringUtil::Format("%s.cache_httpfs_janitor_lock", directory);
+}
+
+void DiskCacheJanitor::Run() {
+	SetThreadName("cache_janitor");
+	std::unique_lock<std::mutex> lck(mu);
+	while (true) {
+		janitor_cv.wait_for(lck, std::chrono::milliseconds(interval_millisec), [this]() {
+			return stopped || wake_requested || requested_pass_count > completed_pass_count;
+		});
+		if (stopped) {
+			break;
+		}
+		wake_requested = false;
+		const uint64_t cur_pass_count = requested_pass_count;
+
+		// Take a snapshot of all directories, so deletions happen outside of critical section.
+		struct DirectoryToClean {
+			std::string cache_directory;
+			shared_ptr<DiskCacheLruIndex> lru_index;
+			vector<std::string> pending_removals;
+		};
+		vector<DirectoryToClean> directories_to_clean;
+		for (auto iter = directories.begin(); iter != directories.end();) {
+			auto &cur_state = iter->second;
+			if (cur_state.lru_index == nullptr && cur_state.pending_removals.empty()) {
+				iter = directories.erase(iter);
+				continue;
+			}
+			directories_to_clean.emplace_back(DirectoryToClean {
+			    .cache_directory = iter->first,
+			    .lru_index = cur_state.lru_index,
+			    .pending_removals = std::move(cur_state.pending_removals),
+			});
+			cur_state.pending_removals.clear();
+			++iter;
+		}
+
+		lck.unlock();
+		for (auto &cur_directory : directories_to_clean) {
+			cur_directory.pending_removals = CleanDirectory(cur_directory.cache_directory, cur_directory.lru_index,
+			                                                std::move(cur_directory.pending_removals));
+		}
+		lck.lock();
+
+		// Cache files left to delete are picked up by the next pass.
+		for (auto &cur_directory : directories_to_clean) {
+			AppendCacheFiles(std::move(cur_directory.pending_removals),
+			                 directories[cur_directory.cache_directory].pending_removals);
+		}
+		completed_pass_count = cur_pass_count;
+		pass_cv.notify_all();
+	}
+	pass_cv.notify_all();
+}
+
+vector<std::string> DiskCacheJanitor::CleanDirectory(const std::string &cache_directory,
+                                                     const shared_ptr<DiskCacheLruIndex> &lru_index,
+                                                     vector<std::string> pending_removals) {
+	DirectoryLock directory_lock {GetLockFilepath(cache_directory)};
+	if (directory_lock.IsHeldByOthers()) {
+		return pending_removals;
+	}
+
+	vector<std::string> cache_files_to_remove = std::move(pending_removals);
+	if (lru_index != nullptr) {
+		const idx_t capacity_bytes = lru_index->GetCapacityBytes();
+		if (capacity_bytes != 0 &&
+		    GetOccupiedBytes(*lru_index) > static_cast<idx_t>(capacity_bytes * high_watermark_ratio)) {
+			AppendCacheFiles(lru_index->EvictCacheFiles(), cache_files_to_remove);
+		}
+		// After cache file deletion, disk space is only reclaimed when the last reference to the file goes away, so
+		// available space is checked again at the next pass.
+		if (!CanCacheOnDisk(cache_directory)) {
+			const time_t stale_timestamp = std::time(nullptr) - static_cast<time_t>(CACHE_FILE_STALENESS_SECOND);
+			AppendCacheFiles(lru_index->RemoveStaleCacheFiles(stale_timestamp), cache_files_to_remove);
+		}
+	}
+
+	for (idx_t idx = 0; idx < cache_files_to_remove.size(); ++idx) {
+		const auto &cur_cache_file = cache_files_to_remove[idx];
+		// A cache file could be fetched and cached again after it's evicted, which should be kept.
+		if (lru_index != nullptr && lru_index->HasCacheFile(cur_cache_file)) {
+			continue;
+		}
+		if (!AcquireRemovalQuota()) {
+			return vector<std::string>(std::make_move_iterator(cache_files_to_remove.begin() + idx),
+			                           std::make_move_iterator(cache_files_to_remove.end()));
+		}
+		// Deletion is best-effort, a cache file failing to delete is indexed again on the next index load.
+		std::remove(cur_cache_file.data());
+		if (lru_index != nullptr) {
+			lru_index->MarkCacheFileDeleted(cur_cache_file);
+		}
+	}
+	return {};
+}
+
+bool DiskCacheJanitor::AcquireRemovalQuota() {
+	if (max_removals_per_second == 0) {
+		return true;
+	}
+	// Flushers wait for all pending deletions, which are not throttled so a flush takes as long as the deletions
+	// themselves.
+	std::unique_lock<std::mutex> lck(mu);
+	if (requested_pass_count > completed_pass_count) {
+		return true;
+	}
+	const int64_t now = GetSteadyNowMilliSecSinceEpoch();
+	if (now - removal_window_start_millisec >= REMOVAL_WINDOW_MILLISEC) {
+		removal_window_start_millisec = now;
+		removal_window_count = 0;
+	}
+	if (removal_window_count < max_removals_per_second) {
+		++removal_window_count;
+		return true;
+	}
+
+	// Wait for the next window, which is interrupted by stop or a flush request.
+	const auto wait_millisec = removal_window_start_millisec + REMOVAL_WINDOW_MILLISEC - now;
+	janitor_cv.wait_for(lck, std::chrono::milliseconds(wait_millisec),
+	                    [this]() { return stopped || requested_pass_count > completed_pass_count; });
+	if (stopped) {
+		return false;
+	}
+	if (requested_pass_count > completed_pass_count) {
+		return true;
+	}
+	removal_window_start_millisec = GetSteadyNowMilliSecSinceEpoch();
+	removal_window_count = 1;
+	return true;
+}
+
+} // namespace duckdb
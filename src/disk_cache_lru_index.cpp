@@ -0,0 +1,501 @@
+#include "disk_cache_lru_index.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache_filesystem_config.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/uuid.hpp"
+#include "resize_uninitialized.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Magic number at the start of every journal record, used to detect torn or garbage records.
+constexpr uint32_t JOURNAL_RECORD_MAGIC = 0x58494843; // "CHIX"
+
+enum class JournalOp : uint32_t {
+	kAdd = 1,
+	kRemove = 2,
+	kAddFooter = 3,
+};
+
+// Get the op to record an addition for cache file of [retention] class.
+JournalOp GetAdditionOp(CacheFileRetention retention) {
+	return retention == CacheFileRetention::kFooter ? JournalOp::kAddFooter : JournalOp::kAdd;
+}
+
+struct JournalRecordHeader {
+	uint32_t magic = 0;
+	uint32_t op = 0;
+	uint64_t file_size = 0;
+	int64_t last_access_timestamp = 0;
+	uint64_t key_length = 0;
+};
+static_assert(sizeof(JournalRecordHeader) == 32, "Journal record header is expected to be 32 bytes.");
+
+// Journal is checkpointed once its records exceed twice the live entries, and at least the threshold.
+constexpr idx_t MIN_JOURNAL_RECORDS_FOR_CHECKPOINT = 4096;
+
+// Accesses are persisted in one batch once this many cache files are touched, or the interval elapses since the last
+// batch, whichever comes first.
+constexpr idx_t JOURNAL_TOUCH_BATCH_SIZE = 1024;
+constexpr time_t JOURNAL_TOUCH_BATCH_INTERVAL_SECOND = 60;
+
+// Serialize a journal record into [buffer].
+void SerializeJournalRecord(JournalOp op, const std::string &cache_file, idx_t file_size,
+                            time_t last_access_timestamp, std::string &buffer) {
+	const JournalRecordHeader header {
+	    .magic = JOURNAL_RECORD_MAGIC,
+	    .op = static_cast<uint32_t>(op),
+	    .file_size = static_cast<uint64_t>(file_size),
+	    .last_access_timestamp = static_cast<int64_t>(last_access_timestamp),
+	    .key_length = static_cast<uint64_t>(cache_file.length()),
+	};
+	buffer.append(reinterpret_cast<const char *>(&header), sizeof(header));
+	buffer.append(cache_file);
+}
+
+} // namespace
+
+DiskCacheLruIndex::DiskCacheLruIndex(idx_t capacity_bytes_p, double low_watermark_ratio_p,
+                                     std::string journal_filepath_p)
+    : low_watermark_ratio(low_watermark_ratio_p), journal_filepath(std::move(journal_filepath_p)),
+      local_filesystem(LocalFileSystem::CreateLocal()), capacity_bytes(capacity_bytes_p) {
+}
+
+DiskCacheLruIndex::~DiskCacheLruIndex() {
+	std::lock_guard<std::mutex> lck(mu);
+	// Pending accesses are appended instead of checkpointed, so records appended by other processes are kept.
+	if (!touched_cache_files.empty()) {
+		PersistTouchedImpl(std::time(nullptr));
+	}
+	CloseJournalImpl();
+}
+
+void DiskCacheLruIndex::LoadJournal(const std::unordered_set<std::string> &existing_cache_files) {
+	D_ASSERT(!journal_filepath.empty());
+	std::lock_guard<std::mutex> lck(mu);
+
+	// Journal is best-effort, a journal failing to read is treated as empty.
+	std::string content;
+	try {
+		auto file_handle = local_filesystem->OpenFile(
+		    journal_filepath, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (file_handle != nullptr) {
+			content = CreateResizeUninitializedString(static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle)));
+			local_filesystem->Read(*file_handle, const_cast<char *>(content.data()), content.length(),
+			                       /*location=*/0);
+		}
+	} catch (...) {
+		content.clear();
+	}
+
+	// Records are replayed in append order, so later records override earlier ones for the same cache file.
+	idx_t record_offset = 0;
+	while (record_offset + sizeof(JournalRecordHeader) <= content.length()) {
+		JournalRecordHeader header;
+		memcpy(&header, content.data() + record_offset, sizeof(header));
+		const idx_t record_size = sizeof(JournalRecordHeader) + header.key_length;
+		if (header.magic != JOURNAL_RECORD_MAGIC || record_offset + record_size > content.length()) {
+			break;
+		}
+		std::string cache_file = content.substr(record_offset + sizeof(JournalRecordHeader), header.key_length);
+		record_offset += record_size;
+
+		auto iter = entries.find(cache_file);
+		if (iter != entries.end()) {
+			RemoveImpl(iter);
+		}
+		const bool is_addition = header.op == static_cast<uint32_t>(JournalOp::kAdd) ||
+		                         header.op == static_cast<uint32_t>(JournalOp::kAddFooter);
+		if (is_addition && existing_cache_files.find(cache_file) != existing_cache_files.end()) {
+			const auto retention = header.op == static_cast<uint32_t>(JournalOp::kAddFooter)
+			                           ? CacheFileRetention::kFooter
+			                           : CacheFileRetention::kData;
+			AddImpl(cache_file, header.file_size, static_cast<time_t>(header.last_access_timestamp), retention);
+		}
+	}
+
+	// Compact replayed records, so the journal only holds live entries.
+	CheckpointImpl();
+}
+
+vector<std::string> DiskCacheLruIndex::AddCacheFile(const std::string &cache_file, idx_t file_size,
+                                                    CacheFileRetention retention) {
+	return AddCacheFile(cache_file, file_size, std::time(nullptr), retention);
+}
+
+vector<std::string> DiskCacheLruIndex::AddCacheFile(const std::string &cache_file, idx_t file_size,
+                                                    time_t last_access_timestamp, CacheFileRetention retention) {
+	std::lock_guard<std::mutex> lck(mu);
+
+	auto iter = entries.find(cache_file);
+	if (iter != entries.end()) {
+		RemoveImpl(iter);
+	}
+	AddImpl(cache_file, file_size, last_access_timestamp, retention);
+	AppendJournalImpl(/*is_addition=*/true, cache_file, entries.at(cache_file));
+
+	vector<std::string> cache_files_to_evict;
+	if (capacity_bytes != 0 && used_bytes + pending_deletion_bytes > capacity_bytes) {
+		cache_files_to_evict = EvictImpl();
+	}
+	MaybeCheckpointImpl();
+	return cache_files_to_evict;
+}
+
+vector<std::string> DiskCacheLruIndex::EvictCacheFiles() {
+	std::lock_guard<std::mutex> lck(mu);
+	auto cache_files_to_evict = EvictImpl();
+	MaybeCheckpointImpl();
+	return cache_files_to_evict;
+}
+
+void DiskCacheLruIndex::MarkCacheFileDeleted(const std::string &cache_file) {
+	std::lock_guard<std::mutex> lck(mu);
+	auto iter = pending_deletions.find(cache_file);
+	if (iter == pending_deletions.end()) {
+		return;
+	}
+	pending_deletion_bytes -= iter->second;
+	pending_deletions.erase(iter);
+}
+
+bool DiskCacheLruIndex::HasCacheFile(const std::string &cache_file) const {
+	std::lock_guard<std::mutex> lck(mu);
+	return entries.find(cache_file) != entries.end();
+}
+
+bool DiskCacheLruIndex::TouchCacheFile(const std::string &cache_file) {
+	std::lock_guard<std::mutex> lck(mu);
+	auto iter = entries.find(cache_file);
+	if (iter == entries.end()) {
+		return false;
+	}
+	const time_t now = std::time(nullptr);
+	iter->second.last_access_timestamp = now;
+	auto &cur_lru_list = GetLruList(iter->second.retention);
+	cur_lru_list.splice(cur_lru_list.begin(), cur_lru_list, iter->second.lru_iterator);
+
+	// Access recency is persisted lazily, so cache hits don't issue a journal write each.
+	if (journal_fd < 0) {
+		return true;
+	}
+	touched_cache_files.emplace(cache_file);
+	if (touched_cache_files.size() >= JOURNAL_TOUCH_BATCH_SIZE ||
+	    now - last_touch_persist_timestamp >= JOURNAL_TOUCH_BATCH_INTERVAL_SECOND) {
+		PersistTouchedImpl(now);
+		MaybeCheckpointImpl();
+	}
+	return true;
+}
+
+void DiskCacheLruIndex::RemoveCacheFile(const std::string &cache_file) {
+	std::lock_guard<std::mutex> lck(mu);
+	auto iter = entries.find(cache_file);
+	if (iter == entries.end()) {
+		return;
+	}
+	RemoveImpl(iter);
+	MaybeCheckpointImpl();
+}
+
+vector<std::string> DiskCacheLruIndex::RemoveCacheFilesWithPrefix(const std::string &prefix) {
+	std::lock_guard<std::mutex> lck(mu);
+	vector<std::string> removed_cache_files;
+	auto iter = entries.lower_bound(prefix);
+	while (iter != entries.end() && iter->first.compare(0, prefix.length(), prefix) == 0) {
+		removed_cache_files.emplace_back(iter->first);
+		auto next_iter = std::next(iter);
+		RemoveImpl(iter);
+		iter = next_iter;
+	}
+	MaybeCheckpointImpl();
+	return removed_cache_files;
+}
+
+vector<std::string> DiskCacheLruIndex::RemoveStaleCacheFiles(time_t stale_timestamp) {
+	std::lock_guard<std::mutex> lck(mu);
+	// Access timestamps are non-increasing along LRU lists, so stale cache files are all at their tails.
+	vector<std::string> removed_cache_files;
+	for (auto *cur_lru_list : {&lru_list, &footer_lru_list}) {
+		while (!cur_lru_list->empty()) {
+			auto iter = entries.find(cur_lru_list->back());
+			if (iter->second.last_access_timestamp >= stale_timestamp) {
+				break;
+			}
+			removed_cache_files.emplace_back(iter->first);
+			EvictEntryImpl(iter);
+		}
+	}
+	MaybeCheckpointImpl();
+	return removed_cache_files;
+}
+
+void DiskCacheLruIndex::Clear() {
+	std::lock_guard<std::mutex> lck(mu);
+	entries.clear();
+	lru_list.clear();
+	footer_lru_list.clear();
+	touched_cache_files.clear();
+	pending_deletions.clear();
+	used_bytes = 0;
+	footer_bytes = 0;
+	pending_deletion_bytes = 0;
+	if (journal_fd >= 0) {
+		CheckpointImpl();
+	}
+}
+
+void DiskCacheLruIndex::SetCapacityBytes(idx_t capacity_bytes_p) {
+	std::lock_guard<std::mutex> lck(mu);
+	capacity_bytes = capacity_bytes_p;
+}
+
+vector<std::string> DiskCacheLruIndex::GetCacheFiles() const {
+	std::lock_guard<std::mutex> lck(mu);
+	vector<std::string> cache_files;
+	cache_files.reserve(entries.size());
+	for (const auto &cur_entry : entries) {
+		cache_files.emplace_back(cur_entry.first);
+	}
+	return cache_files;
+}
+
+idx_t DiskCacheLruIndex::GetCapacityBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return capacity_bytes;
+}
+
+idx_t DiskCacheLruIndex::GetUsedBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return used_bytes;
+}
+
+idx_t DiskCacheLruIndex::GetPendingDeletionBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return pending_deletion_bytes;
+}
+
+idx_t DiskCacheLruIndex::GetCacheFileCount() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return entries.size();
+}
+
+idx_t DiskCacheLruIndex::GetFooterBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return footer_bytes;
+}
+
+std::list<std::string> &DiskCacheLruIndex::GetLruList(CacheFileRetention retention) {
+	return retention == CacheFileRetention::kFooter ? footer_lru_list : lru_list;
+}
+
+void DiskCacheLruIndex::AddImpl(const std::string &cache_file, idx_t file_size, time_t last_access_timestamp,
+                                CacheFileRetention retention) {
+	// A cache file re-cached after eviction replaces the one pending deletion, which is then kept on disk.
+	auto pending_iter = pending_deletions.find(cache_file);
+	if (pending_iter != pending_deletions.end()) {
+		pending_deletion_bytes -= pending_iter->second;
+		pending_deletions.erase(pending_iter);
+	}
+
+	// Cache files are mostly added as the most recently used one, so the position is searched from list head.
+	auto &cur_lru_list = GetLruList(retention);
+	auto position = cur_lru_list.begin();
+	while (position != cur_lru_list.end() && entries.at(*position).last_access_timestamp > last_access_timestamp) {
+		++position;
+	}
+	auto lru_iterator = cur_lru_list.emplace(position, cache_file);
+	entries.emplace(cache_file, Entry {
+	                                .file_size = file_size,
+	                                .last_access_timestamp = last_access_timestamp,
+	                                .retention = retention,
+	                                .lru_iterator = lru_iterator,
+	                            });
+	used_bytes += file_size;
+	if (retention == CacheFileRetention::kFooter) {
+		footer_bytes += file_size;
+	}
+}
+
+vector<std::string> DiskCacheLruIndex::EvictImpl() {
+	vector<std::string> cache_files_to_evict;
+	if (capacity_bytes == 0) {
+		return cache_files_to_evict;
+	}
+	// At least one cache file of each retention class is kept, so a newly accessed cache file is never evicted by
+	// itself.
+	const auto low_watermark_bytes = static_cast<idx_t>(capacity_bytes * low_watermark_ratio);
+	const auto footer_capacity_bytes = static_cast<idx_t>(capacity_bytes * DISK_CACHE_FOOTER_CAPACITY_RATIO);
+	// Cache files evicted earlier still occupy disk space until they're deleted, so they count against capacity.
+	const idx_t prior_pending_deletion_bytes = pending_deletion_bytes;
+	while (used_bytes + prior_pending_deletion_bytes > low_watermark_bytes) {
+		const bool can_evict_data = lru_list.size() > 1;
+		const bool can_evict_footer = footer_lru_list.size() > 1;
+		std::list<std::string> *victim_lru_list = nullptr;
+		if (can_evict_footer && (footer_bytes > footer_capacity_bytes || !can_evict_data)) {
+			victim_lru_list = &footer_lru_list;
+		} else if (can_evict_data) {
+			victim_lru_list = &lru_list;
+		} else {
+			break;
+		}
+		auto stale_iter = entries.find(victim_lru_list->back());
+		cache_files_to_evict.emplace_back(stale_iter->first);
+		EvictEntryImpl(stale_iter);
+	}
+	return cache_files_to_evict;
+}
+
+void DiskCacheLruIndex::EvictEntryImpl(std::map<std::string, Entry>::iterator iter) {
+	const idx_t file_size = iter->second.file_size;
+	if (pending_deletions.emplace(iter->first, file_size).second) {
+		pending_deletion_bytes += file_size;
+	}
+	RemoveImpl(iter);
+}
+
+void DiskCacheLruIndex::RemoveImpl(std::map<std::string, Entry>::iterator iter) {
+	AppendJournalImpl(/*is_addition=*/false, iter->first, iter->second);
+	touched_cache_files.erase(iter->first);
+	used_bytes -= iter->second.file_size;
+	if (iter->second.retention == CacheFileRetention::kFooter) {
+		footer_bytes -= iter->second.file_size;
+	}
+	GetLruList(iter->second.retention).erase(iter->second.lru_iterator);
+	entries.erase(iter);
+}
+
+void DiskCacheLruIndex::AppendJournalImpl(bool is_addition, const std::string &cache_file, const Entry &entry) {
+	if (journal_fd < 0) {
+		return;
+	}
+	std::string record;
+	SerializeJournalRecord(is_addition ? GetAdditionOp(entry.retention) : JournalOp::kRemove, cache_file,
+	                       entry.file_size, entry.last_access_timestamp, record);
+	WriteJournalImpl(record, /*record_count=*/1);
+}
+
+void DiskCacheLruIndex::PersistTouchedImpl(time_t now) {
+	// An access is persisted as an addition record carrying the latest access timestamp, which replaces the cache
+	// file's earlier records on replay.
+	std::string records;
+	for (const auto &cur_cache_file : touched_cache_files) {
+		const auto &entry = entries.at(cur_cache_file);
+		SerializeJournalRecord(GetAdditionOp(entry.retention), cur_cache_file, entry.file_size,
+		                       entry.last_access_timestamp, records);
+	}
+	const idx_t record_count = touched_cache_files.size();
+	touched_cache_files.clear();
+	last_touch_persist_timestamp = now;
+	WriteJournalImpl(records, record_count);
+}
+
+void DiskCacheLruIndex::WriteJournalImpl(const std::string &records, idx_t record_count) {
+	if (journal_fd < 0 || records.empty()) {
+		return;
+	}
+	// Another process could have replaced the journal with its checkpoint, records appended to the replaced file are
+	// never replayed.
+	struct stat journal_stat;
+	if (stat(journal_filepath.data(), &journal_stat) != 0 || journal_stat.st_dev != journal_device ||
+	    journal_stat.st_ino != journal_inode) {
+		OpenJournalImpl();
+		if (journal_fd < 0) {
+			return;
+		}
+	}
+	// Journal is best-effort, on IO failure the index lives in memory only, and gets rebuilt from cache directory on
+	// next load. A torn record left by partial write stops replay at it.
+	const ssize_t written_bytes = write(journal_fd, records.data(), records.length());
+	if (written_bytes != static_cast<ssize_t>(records.length())) {
+		CloseJournalImpl();
+		return;
+	}
+	journal_record_count += record_count;
+}
+
+void DiskCacheLruIndex::OpenJournalImpl() {
+	CloseJournalImpl();
+	// Journal is opened for append, so records from all processes sharing it land at its tail instead of overwriting
+	// each other.
+	journal_fd = open(journal_filepath.data(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+	if (journal_fd < 0) {
+		return;
+	}
+	struct stat journal_stat;
+	if (fstat(journal_fd, &journal_stat) != 0) {
+		CloseJournalImpl();
+		return;
+	}
+	journal_device = journal_stat.st_dev;
+	journal_inode = journal_stat.st_ino;
+}
+
+void DiskCacheLruIndex::CloseJournalImpl() {
+	if (journal_fd >= 0) {
+		close(journal_fd);
+		journal_fd = -1;
+	}
+}
+
+void DiskCacheLruIndex::MaybeCheckpointImpl() {
+	if (journal_fd < 0) {
+		return;
+	}
+	if (journal_record_count < MIN_JOURNAL_RECORDS_FOR_CHECKPOINT || journal_record_count < 2 * entries.size()) {
+		return;
+	}
+	CheckpointImpl();
+}
+
+void DiskCacheLruIndex::CheckpointImpl() {
+	// Live entries are written from the least recently used one, so LRU order is restored on replay.
+	std::string content;
+	for (const auto *cur_lru_list : {&lru_list, &footer_lru_list}) {
+		for (auto iter = cur_lru_list->rbegin(); iter != cur_lru_list->rend(); ++iter) {
+			const auto &entry = entries.at(*iter);
+			SerializeJournalRecord(GetAdditionOp(entry.retention), *iter, entry.file_size,
+			                       entry.last_access_timestamp, content);
+		}
+	}
+
+	// Checkpoint persists access recency for all entries, including pending touched ones.
+	touched_cache_files.clear();
+	last_touch_persist_timestamp = std::time(nullptr);
+
+	// Write into a temporary file then atomically move, so a crash during checkpoint leaves the old journal intact;
+	// temporary file is uniquely named, so concurrent checkpoints from multiple processes don't collide.
+	CloseJournalImpl();
+	const auto temp_journal_filepath =
+	    StringUtil::Format("%s.%s.tmp", journal_filepath, UUID::ToString(UUID::GenerateRandomUUID()));
+	try {
+		{
+			auto file_handle = local_filesystem->OpenFile(temp_journal_filepath,
+			                                              FileOpenFlags::FILE_FLAGS_WRITE |
+			                                                  FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			local_filesystem->Write(*file_handle, const_cast<char *>(content.data()), content.length(),
+			                        /*location=*/0);
+		}
+		local_filesystem->MoveFile(temp_journal_filepath, journal_filepath);
+	} catch (...) {
+		std::remove(temp_journal_filepath.data());
+		return;
+	}
+	OpenJournalImpl();
+	journal_record_count = entries.size();
+}
+
+} // namespace duckdb
@@ -0,0 +1,420 @@
+#include "disk_cache_mirror_store.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "cache_filesystem_config.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "scope_guard.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Mirror files are named as `<mirror-key>.cache_httpfs_mirror` under cache directory, with bitmap files named as
+// `<mirror-key>.cache_httpfs_mirror_bitmap`.
+constexpr const char *MIRROR_FILE_SUFFIX = ".cache_httpfs_mirror";
+constexpr const char *BITMAP_FILE_SUFFIX = ".cache_httpfs_mirror_bitmap";
+
+// Bitmap file starts with the block size it's written with.
+constexpr idx_t BITMAP_HEADER_SIZE = sizeof(uint64_t);
+
+// Block id in LRU index, formatted as `<mirror-key>@<block-index>`.
+constexpr char BLOCK_ID_SEPARATOR = '@';
+
+std::string GetBlockId(const std::string &mirror_key, idx_t block_idx) {
+	return StringUtil::Format("%s%c%llu", mirror_key, BLOCK_ID_SEPARATOR, block_idx);
+}
+
+// Delete the given file, which could have been deleted by cache directory clearance.
+void RemoveMirrorFile(const string &filepath) {
+	if (std::remove(filepath.data()) != 0 && errno != ENOENT) {
+		throw IOException("Fails to delete mirror file %s because %s", filepath, strerror(errno));
+	}
+}
+
+} // namespace
+
+DiskCacheMirrorStore::DiskCacheMirrorStore(std::string cache_directory_p, idx_t block_size_p, idx_t capacity_bytes_p)
+    : cache_directory(std::move(cache_directory_p)), block_size(block_size_p),
+      local_filesystem(LocalFileSystem::CreateLocal()),
+      file_handle_cache(DISK_CACHE_MIRROR_MAX_OPEN_FILES, /*timeout_millisec=*/0),
+      lru_index(capacity_bytes_p, DISK_CACHE_EVICTION_LOW_WATERMARK_RATIO) {
+	LoadExistingMirrorFiles();
+}
+
+bool DiskCacheMirrorStore::IsMirrorFile(const std::string &fname) {
+	return StringUtil::EndsWith(fname, MIRROR_FILE_SUFFIX) || StringUtil::EndsWith(fname, BITMAP_FILE_SUFFIX);
+}
+
+bool DiskCacheMirrorStore::IsBlockCached(const std::string &mirror_key, idx_t block_offset) const {
+	std::lock_guard<std::mutex> lck(mu);
+	auto mirror_file = GetMirrorFileImpl(mirror_key);
+	return mirror_file != nullptr && IsBlockSetImpl(*mirror_file, block_offset / block_size);
+}
+
+void DiskCacheMirrorStore::WriteBlock(const std::string &mirror_key, idx_t block_offset, const char *data,
+                                      idx_t length, bool sync) {
+	D_ASSERT(block_offset % block_size == 0);
+	D_ASSERT(length > 0 && length <= block_size);
+	const idx_t block_idx = block_offset / block_size;
+
+	shared_ptr<MirrorFile> mirror_file;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		mirror_file = GetMirrorFileImpl(mirror_key);
+		if (mirror_file == nullptr) {
+			// Bitmap file is recreated along with the mirror file, so stale content is never referenced.
+			auto bitmap_file_handle = local_filesystem->OpenFile(
+			    GetBitmapFilepath(mirror_key), FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE |
+			                                       FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			uint64_t header = static_cast<uint64_t>(block_size);
+			local_filesystem->Write(*bitmap_file_handle, &header, BITMAP_HEADER_SIZE, /*location=*/0);
+			file_handle_cache.Put(GetBitmapFilepath(mirror_key), std::move(bitmap_file_handle));
+			mirror_file = make_shared_ptr<MirrorFile>();
+			mirror_files.emplace(mirror_key, mirror_file);
+		}
+	}
+
+	vector<std::string> block_ids_to_evict;
+	{
+		std::shared_lock<std::shared_timed_mutex> io_lck(mirror_file->io_mutex);
+		auto file_handle = GetFileHandle(GetMirrorFilepath(mirror_key));
+		local_filesystem->Write(*file_handle, const_cast<char *>(data), length, block_offset);
+		if (sync) {
+			file_handle->Sync();
+		}
+
+		// Publish the block only after it's written, so readers never observe partial content.
+		{
+			std::lock_guard<std::mutex> lck(mu);
+			// The mirror file could have been removed or evicted during write, which leaves the block unreferenced.
+			if (GetMirrorFileImpl(mirror_key) != mirror_file) {
+				return;
+			}
+			if (!IsBlockSetImpl(*mirror_file, block_idx)) {
+				UpdateBitmapImpl(mirror_key, *mirror_file, block_idx, /*is_set=*/true);
+			}
+			mirror_file->end_offset = MaxValue<idx_t>(mirror_file->end_offset, block_offset + length);
+			block_ids_to_evict = lru_index.AddCacheFile(GetBlockId(mirror_key, block_idx), length);
+		}
+		if (sync) {
+			GetFileHandle(GetBitmapFilepath(mirror_key))->Sync();
+		}
+	}
+
+	// Hole punching requires exclusive access to mirror files, so it happens after releasing the shared lock.
+	EvictBlocks(block_ids_to_evict, sync);
+}
+
+bool DiskCacheMirrorStore::Read(const std::string &mirror_key, idx_t offset, idx_t length, char *buffer) {
+	D_ASSERT(offset % block_size == 0);
+	if (length == 0) {
+		return false;
+	}
+	const idx_t start_block_idx = offset / block_size;
+	const idx_t end_block_idx = (offset + length - 1) / block_size;
+
+	shared_ptr<MirrorFile> mirror_file;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		mirror_file = GetMirrorFileImpl(mirror_key);
+		if (mirror_file == nullptr) {
+			return false;
+		}
+	}
+
+	// Hold shared lock during read, so covered blocks are not punched concurrently.
+	std::shared_lock<std::shared_timed_mutex> io_lck(mirror_file->io_mutex);
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		if (GetMirrorFileImpl(mirror_key) != mirror_file || offset + length > mirror_file->end_offset) {
+			return false;
+		}
+		for (idx_t cur_block_idx = start_block_idx; cur_block_idx <= end_block_idx; ++cur_block_idx) {
+			if (!IsBlockSetImpl(*mirror_file, cur_block_idx)) {
+				return false;
+			}
+		}
+	}
+
+	auto file_handle = GetFileHandle(GetMirrorFilepath(mirror_key));
+	local_filesystem->Read(*file_handle, buffer, length, offset);
+	for (idx_t cur_block_idx = start_block_idx; cur_block_idx <= end_block_idx; ++cur_block_idx) {
+		lru_index.TouchCacheFile(GetBlockId(mirror_key, cur_block_idx));
+	}
+	return true;
+}
+
+void DiskCacheMirrorStore::Remove(const std::string &mirror_key) {
+	shared_ptr<MirrorFile> mirror_file;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		mirror_file = GetMirrorFileImpl(mirror_key);
+		if (mirror_file == nullptr) {
+			return;
+		}
+	}
+
+	std::unique_lock<std::shared_timed_mutex> io_lck(mirror_file->io_mutex);
+	std::lock_guard<std::mutex> lck(mu);
+	if (GetMirrorFileImpl(mirror_key) != mirror_file) {
+		return;
+	}
+	const idx_t block_count = mirror_file->block_bitmap.size() * 8;
+	for (idx_t cur_block_idx = 0; cur_block_idx < block_count; ++cur_block_idx) {
+		if (IsBlockSetImpl(*mirror_file, cur_block_idx)) {
+			lru_index.RemoveCacheFile(GetBlockId(mirror_key, cur_block_idx));
+		}
+	}
+	mirror_files.erase(mirror_key);
+	DeleteMirrorFilesImpl(mirror_key);
+}
+
+void DiskCacheMirrorStore::RemoveByPrefix(const std::string &prefix) {
+	vector<std::string> mirror_keys_to_remove;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		for (const auto &cur_mirror_file : mirror_files) {
+			if (StringUtil::StartsWith(cur_mirror_file.first, prefix)) {
+				mirror_keys_to_remove.emplace_back(cur_mirror_file.first);
+			}
+		}
+	}
+	for (const auto &cur_mirror_key : mirror_keys_to_remove) {
+		Remove(cur_mirror_key);
+	}
+}
+
+void DiskCacheMirrorStore::Clear() {
+	std::lock_guard<std::mutex> lck(mu);
+	for (const auto &cur_mirror_file : mirror_files) {
+		DeleteMirrorFilesImpl(cur_mirror_file.first);
+	}
+	mirror_files.clear();
+	lru_index.Clear();
+	file_handle_cache.Clear();
+}
+
+void DiskCacheMirrorStore::SetCapacityBytes(idx_t capacity_bytes_p) {
+	lru_index.SetCapacityBytes(capacity_bytes_p);
+}
+
+vector<DiskCacheMirrorStore::EntryInfo> DiskCacheMirrorStore::GetEntries() const {
+	std::lock_guard<std::mutex> lck(mu);
+	vector<EntryInfo> entries;
+	for (const auto &cur_mirror_file : mirror_files) {
+		const auto &mirror_file = *cur_mirror_file.second;
+		const idx_t block_count = mirror_file.block_bitmap.size() * 8;
+		for (idx_t cur_block_idx = 0; cur_block_idx < block_count; ++cur_block_idx) {
+			if (!IsBlockSetImpl(mirror_file, cur_block_idx)) {
+				continue;
+			}
+			const idx_t block_offset = cur_block_idx * block_size;
+			entries.emplace_back(EntryInfo {
+			    .mirror_key = cur_mirror_file.first,
+			    .mirror_filepath = GetMirrorFilepath(cur_mirror_file.first),
+			    .block_offset = block_offset,
+			    .block_length = MinValue<idx_t>(block_size, mirror_file.end_offset - block_offset),
+			});
+		}
+	}
+	return entries;
+}
+
+idx_t DiskCacheMirrorStore::GetCapacityBytes() const {
+	return lru_index.GetCapacityBytes();
+}
+
+idx_t DiskCacheMirrorStore::GetUsedBytes() const {
+	return lru_index.GetUsedBytes();
+}
+
+std::string DiskCacheMirrorStore::GetMirrorFilepath(const std::string &mirror_key) const {
+	return StringUtil::Format("%s/%s%s", cache_directory, mirror_key, MIRROR_FILE_SUFFIX);
+}
+
+std::string DiskCacheMirrorStore::GetBitmapFilepath(const std::string &mirror_key) const {
+	return StringUtil::Format("%s/%s%s", cache_directory, mirror_key, BITMAP_FILE_SUFFIX);
+}
+
+shared_ptr<FileHandle> DiskCacheMirrorStore::GetFileHandle(const std::string &filepath) {
+	auto file_handle = file_handle_cache.Get(filepath);
+	if (file_handle != nullptr) {
+		return file_handle;
+	}
+	file_handle = shared_ptr<FileHandle>(local_filesystem->OpenFile(
+	    filepath,
+	    FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE));
+	file_handle_cache.Put(filepath, file_handle);
+	return file_handle;
+}
+
+shared_ptr<DiskCacheMirrorStore::MirrorFile>
+DiskCacheMirrorStore::GetMirrorFileImpl(const std::string &mirror_key) const {
+	auto iter = mirror_files.find(mirror_key);
+	if (iter == mirror_files.end()) {
+		return nullptr;
+	}
+	return iter->second;
+}
+
+bool DiskCacheMirrorStore::IsBlockSetImpl(const MirrorFile &mirror_file, idx_t block_idx) {
+	const idx_t byte_idx = block_idx / 8;
+	if (byte_idx >= mirror_file.block_bitmap.size()) {
+		return false;
+	}
+	return (mirror_file.block_bitmap[byte_idx] >> (block_idx % 8)) & 1;
+}
+
+void DiskCacheMirrorStore::UpdateBitmapImpl(const std::string &mirror_key, MirrorFile &mirror_file, idx_t block_idx,
+                                            bool is_set) {
+	const idx_t byte_idx = block_idx / 8;
+	if (byte_idx >= mirror_file.block_bitmap.size()) {
+		mirror_file.block_bitmap.resize(byte_idx + 1, 0);
+	}
+	auto &bitmap_byte = mirror_file.block_bitmap[byte_idx];
+	if (is_set) {
+		bitmap_byte |= static_cast<uint8_t>(1 << (block_idx % 8));
+		++mirror_file.cached_block_count;
+	} else {
+		bitmap_byte &= static_cast<uint8_t>(~(1 << (block_idx % 8)));
+		--mirror_file.cached_block_count;
+	}
+
+	// Written under lock, so concurrent updates on the same byte are persisted in order.
+	auto bitmap_file_handle = GetFileHandle(GetBitmapFilepath(mirror_key));
+	local_filesystem->Write(*bitmap_file_handle, &bitmap_byte, /*nr_bytes=*/1, BITMAP_HEADER_SIZE + byte_idx);
+}
+
+void DiskCacheMirrorStore::EvictBlocks(const vector<std::string> &block_ids, bool sync) {
+	for (const auto &cur_block_id : block_ids) {
+		// Evicted blocks count against capacity until they're reclaimed here.
+		SCOPE_EXIT {
+			lru_index.MarkCacheFileDeleted(cur_block_id);
+		};
+		const auto separator_pos = cur_block_id.rfind(BLOCK_ID_SEPARATOR);
+		const auto mirror_key = cur_block_id.substr(0, separator_pos);
+		const idx_t block_idx = StringUtil::ToUnsigned(cur_block_id.substr(separator_pos + 1));
+
+		shared_ptr<MirrorFile> mirror_file;
+		{
+			std::lock_guard<std::mutex> lck(mu);
+			mirror_file = GetMirrorFileImpl(mirror_key);
+			if (mirror_file == nullptr) {
+				continue;
+			}
+		}
+
+		std::unique_lock<std::shared_timed_mutex> io_lck(mirror_file->io_mutex);
+		const idx_t block_offset = block_idx * block_size;
+		idx_t block_length = 0;
+		{
+			std::lock_guard<std::mutex> lck(mu);
+			if (GetMirrorFileImpl(mirror_key) != mirror_file || !IsBlockSetImpl(*mirror_file, block_idx)) {
+				continue;
+			}
+			block_length = MinValue<idx_t>(block_size, mirror_file->end_offset - block_offset);
+			UpdateBitmapImpl(mirror_key, *mirror_file, block_idx, /*is_set=*/false);
+			if (mirror_file->cached_block_count == 0) {
+				mirror_files.erase(mirror_key);
+				DeleteMirrorFilesImpl(mirror_key);
+				continue;
+			}
+		}
+
+		// Bitmap is persisted before punching hole, so a set bit never refers to a punched block after crash.
+		if (sync) {
+			GetFileHandle(GetBitmapFilepath(mirror_key))->Sync();
+		}
+		// Space is not reclaimed on filesystems which don't support hole punching, until the mirror file is deleted.
+		local_filesystem->Trim(*GetFileHandle(GetMirrorFilepath(mirror_key)), block_offset, block_length);
+	}
+}
+
+void DiskCacheMirrorStore::DeleteMirrorFilesImpl(const std::string &mirror_key) {
+	const auto mirror_filepath = GetMirrorFilepath(mirror_key);
+	const auto bitmap_filepath = GetBitmapFilepath(mirror_key);
+	file_handle_cache.Delete(mirror_filepath);
+	file_handle_cache.Delete(bitmap_filepath);
+	RemoveMirrorFile(mirror_filepath);
+	RemoveMirrorFile(bitmap_filepath);
+}
+
+void DiskCacheMirrorStore::LoadExistingMirrorFiles() {
+	vector<std::string> mirror_keys;
+	vector<std::string> orphan_filepaths;
+	local_filesystem->ListFiles(cache_directory, [&](const string &fname, bool /*unused*/) {
+		if (StringUtil::EndsWith(fname, BITMAP_FILE_SUFFIX)) {
+			mirror_keys.emplace_back(fname.substr(0, fname.length() - strlen(BITMAP_FILE_SUFFIX)));
+		}
+	});
+
+	vector<std::string> block_ids_to_evict;
+	std::unique_lock<std::mutex> lck(mu);
+	for (const auto &cur_mirror_key : mirror_keys) {
+		auto bitmap_file_handle = local_filesystem->OpenFile(GetBitmapFilepath(cur_mirror_key),
+		                                                     FileOpenFlags::FILE_FLAGS_READ);
+		auto mirror_file_handle =
+		    local_filesystem->OpenFile(GetMirrorFilepath(cur_mirror_key),
+		                               FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		const idx_t bitmap_file_size = static_cast<idx_t>(local_filesystem->GetFileSize(*bitmap_file_handle));
+		uint64_t header = 0;
+		if (bitmap_file_size >= BITMAP_HEADER_SIZE) {
+			local_filesystem->Read(*bitmap_file_handle, &header, BITMAP_HEADER_SIZE, /*location=*/0);
+		}
+		// Bitmap written with another block size, or left without mirror file, is discarded along with its blocks.
+		if (header != block_size || mirror_file_handle == nullptr) {
+			DeleteMirrorFilesImpl(cur_mirror_key);
+			continue;
+		}
+
+		auto mirror_file = make_shared_ptr<MirrorFile>();
+		mirror_file->end_offset = static_cast<idx_t>(local_filesystem->GetFileSize(*mirror_file_handle));
+		vector<uint8_t> block_bitmap(bitmap_file_size - BITMAP_HEADER_SIZE, 0);
+		if (!block_bitmap.empty()) {
+			local_filesystem->Read(*bitmap_file_handle, block_bitmap.data(), block_bitmap.size(),
+			                       BITMAP_HEADER_SIZE);
+		}
+		mirror_file->block_bitmap.resize(block_bitmap.size(), 0);
+		for (idx_t cur_block_idx = 0; cur_block_idx < block_bitmap.size() * 8; ++cur_block_idx) {
+			const idx_t block_offset = cur_block_idx * block_size;
+			// Blocks beyond mirror file size are left by crash before their content gets persisted.
+			if (!((block_bitmap[cur_block_idx / 8] >> (cur_block_idx % 8)) & 1) ||
+			    block_offset >= mirror_file->end_offset) {
+				continue;
+			}
+			mirror_file->block_bitmap[cur_block_idx / 8] |= static_cast<uint8_t>(1 << (cur_block_idx % 8));
+			++mirror_file->cached_block_count;
+			auto evicted_block_ids = lru_index.AddCacheFile(
+			    GetBlockId(cur_mirror_key, cur_block_idx),
+			    MinValue<idx_t>(block_size, mirror_file->end_offset - block_offset));
+			block_ids_to_evict.insert(block_ids_to_evict.end(), evicted_block_ids.begin(), evicted_block_ids.end());
+		}
+		mirror_files.emplace(cur_mirror_key, std::move(mirror_file));
+	}
+
+	// Mirror files without bitmap files are left by crash or concurrent removal, which cannot be referenced.
+	local_filesystem->ListFiles(cache_directory, [&](const string &fname, bool /*unused*/) {
+		if (!StringUtil::EndsWith(fname, MIRROR_FILE_SUFFIX)) {
+			return;
+		}
+		const auto mirror_key = fname.substr(0, fname.length() - strlen(MIRROR_FILE_SUFFIX));
+		if (mirror_files.find(mirror_key) == mirror_files.end()) {
+			orphan_filepaths.emplace_back(GetMirrorFilepath(mirror_key));
+		}
+	});
+	for (const auto &cur_filepath : orphan_filepaths) {
+		RemoveMirrorFile(cur_filepath);
+	}
+	lck.unlock();
+
+	// Blocks exceeding capacity (i.e. capacity lowered since last run) are evicted after load.
+	EvictBlocks(block_ids_to_evict, /*sync=*/false);
+}
+
+} // namespace duckdb
@@ -4,104 +4,129 @@
 // - To avoid data race (open the file after deletion), read threads should open the file directly, instead of check
 // existence and open, which guarantees even the file get deleted due to staleness, read threads still get a snapshot.
 
-#include "crypto.hpp"
+#include "cache_file_identity.hpp"
+#include "cache_read_chunk.hpp"
 #include "disk_cache_reader.hpp"
+#include "duckdb/common/limits.hpp"
 #include "duckdb/common/local_file_system.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/thread.hpp"
 #include "duckdb/common/types/uuid.hpp"
+#include "direct_io.hpp"
+#include "disk_cache_block_footer.hpp"
+#include "disk_cache_janitor.hpp"
+#include "io_uring.hpp"
+#include "scope_guard.hpp"
 #include "utils/include/filesystem_utils.hpp"
 #include "utils/include/resize_uninitialized.hpp"
-#include "utils/include/thread_pool.hpp"
-#include "utils/include/thread_utils.hpp"
+#include "utils/include/time_utils.hpp"
+#include "zstd_compression.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <iterator>
+#include <system_error>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
-#include <utime.h>
 
 namespace duckdb {
 
 namespace {
 
-// All read requests are split into chunks, and executed in parallel.
-// A [CacheReadChunk] represents a chunked IO request and its corresponding partial IO request.
-struct CacheReadChunk {
-	// Requested memory address and file offset to read from for current chunk.
-	char *requested_start_addr = nullptr;
-	idx_t requested_start_offset = 0;
-	// Block size aligned [requested_start_offset].
-	idx_t aligned_start_offset = 0;
+// Number of leading cache filename characters which key the shard directories, two characters for each level.
+constexpr idx_t CACHE_FILE_SHARD_PREFIX_LENGTH = 4;
 
-	// Number of bytes for the chunk for IO operations, apart from the last chunk it's always cache block size.
-	idx_t chunk_size = 0;
+// Suffix for temporary files, which are written in shard directories then atomically moved to cache files.
+constexpr const char *LOCAL_CACHE_TEMP_FILE_SUFFIX = ".httpfs_local_cache";
 
-	// Always allocate block size of memory for first and last chunk.
-	// For middle chunks, [content] is not allocated, and bytes directly reading into [requested_start_addr] to save
-	// memory allocation.
-	string content;
-	// Number of bytes to copy from [content] to requested memory address.
-	idx_t bytes_to_copy = 0;
+// Max number of decimal digits for an unsigned 64-bit integer.
+constexpr idx_t MAX_UINT64_DIGITS = 20;
 
-	// For first or last blocks, [content] is always allocated and bytes are read into [content] first then copied to
-	// user-provided buffer. Otherwise (middle block), bytes are directly read into user-provided buffer to save memory
-	// allocation.
-	char *GetAddressToReadTo() const {
-		return content.empty() ? requested_start_addr : const_cast<char *>(content.data());
-	}
-
-	// Copy from [content] to application-provided buffer.
-	void CopyBufferToRequestedMemory() {
-		if (!content.empty()) {
-			const idx_t delta_offset = requested_start_offset - aligned_start_offset;
-			std::memmove(requested_start_addr, const_cast<char *>(content.data()) + delta_offset, bytes_to_copy);
-		}
-	}
-};
-
-// Convert SHA256 value to hex string.
-string Sha256ToHexString(const duckdb::hash_bytes &sha256) {
-	static constexpr char kHexChars[] = "0123456789abcdef";
-	std::string result;
-	// SHA256 has 32 byte, we encode 2 chars for each byte of SHA256.
-	result.reserve(64);
+// Get the shard directory for cache file [fname] under [cache_directory], formatted as
+// `<cache-directory>/<fname[0:2]>/<fname[2:4]>`. Cache filenames start with the hash of their remote file, so cache
+// files are spread across a fan-out directory tree, and no single directory holds too many entries to list or look up.
+string GetCacheFileShardDirectory(const string &cache_directory, const string &fname) {
+	D_ASSERT(fname.length() >= CACHE_FILE_SHARD_PREFIX_LENGTH);
+	return StringUtil::Format("%s/%s/%s", cache_directory, fname.substr(0, 2), fname.substr(2, 2));
+}
 
-	for (unsigned char byte : sha256) {
-		result += kHexChars[byte >> 4];  // Get high 4 bits
-		result += kHexChars[byte & 0xF]; // Get low 4 bits
-	}
-	return result;
+// Append decimal representation of [value] to [str].
+void AppendUnsigned(string &str, uint64_t value) {
+	char buffer[MAX_UINT64_DIGITS];
+	const auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+	D_ASSERT(res.ec == std::errc());
+	str.append(buffer, res.ptr - buffer);
 }
 
-// Get local cache filename for the given [remote_file].
+// Get local cache filename for the block at [start_offset] with [bytes_to_read] bytes of the remote file with
+// [file_identity] at [version_tag].
+//
+// Cache filename is formatted as `<filename-sha256>-<filename>-<version-tag>-<start-offset>-<block-size>`, and placed
+// under the shard directory keyed by the sha256 prefix. So we could get all cache files for one remote file under one
+// directory, and get all cache files with commands like `find`. Cache files for an overwritten remote file are never
+// looked up again, and age out by eviction.
 //
-// Cache filename is formatted as `<cache-directory>/<filename-sha256>.<filename>`. So we could get all cache files
-// under one directory, and get all cache files with commands like `ls`.
+// The filename prefix is precomputed along with file identity, so the filename is built with one allocation.
 //
 // Considering the naming format, it's worth noting it might _NOT_ work for local files, including mounted filesystems.
-string GetLocalCacheFile(const string &cache_directory, const string &remote_file, idx_t start_offset,
-                         idx_t bytes_to_read) {
-	duckdb::hash_bytes remote_file_sha256_val;
-	duckdb::sha256(remote_file.data(), remote_file.length(), remote_file_sha256_val);
-	const string remote_file_sha256_str = Sha256ToHexString(remote_file_sha256_val);
+string GetLocalCacheFname(const CacheFileIdentity &file_identity, uint64_t version_tag, idx_t start_offset,
+                          idx_t bytes_to_read) {
+	string cache_fname;
+	cache_fname.reserve(file_identity.cache_fname_prefix.length() + 3 * (MAX_UINT64_DIGITS + 1));
+	cache_fname.append(file_identity.cache_fname_prefix);
+	const uint64_t fname_values[] = {version_tag, start_offset, bytes_to_read};
+	for (uint64_t cur_value : fname_values) {
+		cache_fname.push_back('-');
+		AppendUnsigned(cache_fname, cur_value);
+	}
+	return cache_fname;
+}
 
-	const string fname = StringUtil::GetFileName(remote_file);
-	return StringUtil::Format("%s/%s-%s-%llu-%llu", cache_directory, remote_file_sha256_str, fname, start_offset,
-	                          bytes_to_read);
+// Get local cache filepath for [cache_fname] under [cache_directory], formatted as
+// `<cache-directory>/<shard-directory>/<cache-fname>`.
+string GetLocalCacheFile(const string &cache_directory, const string &cache_fname) {
+	D_ASSERT(cache_fname.length() >= CACHE_FILE_SHARD_PREFIX_LENGTH);
+	string local_cache_file;
+	local_cache_file.reserve(cache_directory.length() + CACHE_FILE_SHARD_PREFIX_LENGTH + cache_fname.length() + 3);
+	local_cache_file.append(cache_directory);
+	local_cache_file.push_back('/');
+	local_cache_file.append(cache_fname, 0, 2);
+	local_cache_file.push_back('/');
+	local_cache_file.append(cache_fname, 2, 2);
+	local_cache_file.push_back('/');
+	local_cache_file.append(cache_fname);
+	return local_cache_file;
+}
+
+// Get the cache directory holding [local_cache_file], which is placed two levels of shard directories below.
+string GetCacheDirectory(const string &local_cache_file) {
+	auto separator_pos = local_cache_file.rfind('/');
+	for (idx_t idx = 0; idx < 2 && separator_pos != string::npos && separator_pos > 0; ++idx) {
+		separator_pos = local_cache_file.rfind('/', separator_pos - 1);
+	}
+	D_ASSERT(separator_pos != string::npos);
+	return local_cache_file.substr(0, MaxValue<idx_t>(separator_pos, 1));
 }
 
 // Get remote file information from the given local cache [fname].
 std::tuple<std::string /*remote_filename*/, uint64_t /*start_offset*/, uint64_t /*end_offset*/>
 GetRemoteFileInfo(const std::string &fname) {
-	// [fname] is formatted as <hash>-<remote-fname>-<start-offset>-<block-size>
+	// [fname] is formatted as <hash>-<remote-fname>-<version-tag>-<start-offset>-<block-size>
 	vector<string> tokens = StringUtil::Split(fname, "-");
-	D_ASSERT(tokens.size() >= 4);
+	D_ASSERT(tokens.size() >= 5);
 
 	// Get tokens for remote paths.
 	vector<string> remote_path_tokens;
-	remote_path_tokens.reserve(tokens.size() - 3);
+	remote_path_tokens.reserve(tokens.size() - 4);
 
-	for (idx_t idx = 1; idx < tokens.size() - 2; ++idx) {
+	for (idx_t idx = 1; idx < tokens.size() - 3; ++idx) {
 		remote_path_tokens.emplace_back(std::move(tokens[idx]));
 	}
 	string remote_filename = StringUtil::Join(remote_path_tokens, "/");
@@ -114,200 +139,1284 @@ GetRemoteFileInfo(const std::string &fname) {
 	return std::make_tuple(std::move(remote_filename), start_offset, start_offset + block_size);
 }
 
-// Used to delete on-disk cache files, which returns the file prefix for the given [remote_file].
-string GetLocalCacheFilePrefix(const string &remote_file) {
-	duckdb::hash_bytes remote_file_sha256_val;
-	duckdb::sha256(remote_file.data(), remote_file.length(), remote_file_sha256_val);
-	const string remote_file_sha256_str = Sha256ToHexString(remote_file_sha256_val);
+// Get mirror key for the remote file with [file_identity] at [version_tag], which prefixes cache filenames of its
+// blocks, so each version is mirrored into its own file.
+string GetMirrorKey(const CacheFileIdentity &file_identity, uint64_t version_tag) {
+	return StringUtil::Format("%s-%llu", file_identity.cache_fname_prefix, version_tag);
+}
+
+// Return whether blocks are cached in segment files instead of separate cache files.
+bool UseSegmentLayout() {
+	return *g_disk_cache_layout == *SEGMENT_DISK_CACHE_LAYOUT;
+}
+
+// Return whether blocks are cached in per-object mirror files instead of separate cache files.
+bool UseMirrorLayout() {
+	return *g_disk_cache_layout == *MIRROR_DISK_CACHE_LAYOUT;
+}
+
+// Return whether [fname] under cache directory is managed by segment store or mirror store, rather than a cache file
+// under file layout.
+bool IsStoreManagedFile(const string &fname) {
+	return DiskCacheSegmentStore::IsSegmentFile(fname) || DiskCacheMirrorStore::IsMirrorFile(fname);
+}
 
-	const string fname = StringUtil::GetFileName(remote_file);
-	return StringUtil::Format("%s.%s", remote_file_sha256_str, fname);
+// Get mirror key and block offset for the given [local_cache_file], which is formatted as
+// `<shard-directory>/<mirror-key>-<start-offset>-<block-size>`.
+std::pair<string, idx_t> GetMirrorBlock(const string &local_cache_file) {
+	const auto fname = StringUtil::GetFileName(local_cache_file);
+	const auto block_size_pos = fname.rfind('-');
+	const auto start_offset_pos = fname.rfind('-', block_size_pos - 1);
+	const idx_t start_offset =
+	    StringUtil::ToUnsigned(fname.substr(start_offset_pos + 1, block_size_pos - start_offset_pos - 1));
+	return std::make_pair(fname.substr(0, start_offset_pos), start_offset);
 }
 
-// Attempt to cache [chunk] to local filesystem, if there's sufficient disk space available.
-void CacheLocal(const CacheReadChunk &chunk, FileSystem &local_filesystem, const FileHandle &handle,
-                const string &cache_directory, const string &local_cache_file) {
-	// Skip local cache if insufficient disk space.
+// Delete evicted [cache_files]; multiple threads could attempt to delete the same file, so tolerate non-existent file.
+void RemoveEvictedCacheFiles(const vector<string> &cache_files) {
+	for (const auto &cur_cache_file : cache_files) {
+		if (std::remove(cur_cache_file.data()) != 0 && errno != ENOENT) {
+			throw IOException("Fails to delete evicted cache file %s because %s", cur_cache_file, strerror(errno));
+		}
+	}
+}
+
+// Get journal filepath for the index of [cache_directory]. It's placed next to the cache directory rather than inside,
+// so the directory only holds cache files, and directory clearance doesn't remove the journal in use.
+string GetIndexJournalFilepath(const string &cache_directory) {
+	string directory = cache_directory;
+	while (directory.length() > 1 && directory.back() == '/') {
+		directory.pop_back();
+	}
+	return StringUtil::Format("%s.cache_httpfs_index", directory);
+}
+
+// Create [shard_directory] along with its parent directory, if they don't exist.
+void CreateShardDirectory(FileSystem &local_filesystem, const string &shard_directory) {
+	if (local_filesystem.DirectoryExists(shard_directory)) {
+		return;
+	}
+	// Directory creation tolerates existing directory, so concurrent creation on the same shard is fine.
+	local_filesystem.CreateDirectory(shard_directory.substr(0, shard_directory.rfind('/')));
+	local_filesystem.CreateDirectory(shard_directory);
+}
+
+// Move cache files in flat layout (i.e. placed right under [cache_directory] by older versions) into their shard
+// directories, so existing cache survives the layout change. Multiple processes could migrate the same cache directory,
+// so tolerate non-existent file.
+void MigrateFlatCacheFiles(FileSystem &local_filesystem, const string &cache_directory,
+                           const vector<string> &flat_cache_fnames) {
+	for (const auto &cur_fname : flat_cache_fnames) {
+		const auto shard_directory = GetCacheFileShardDirectory(cache_directory, cur_fname);
+		CreateShardDirectory(local_filesystem, shard_directory);
+		const auto source = StringUtil::Format("%s/%s", cache_directory, cur_fname);
+		const auto target = StringUtil::Format("%s/%s", shard_directory, cur_fname);
+		if (std::rename(source.data(), target.data()) != 0 && errno != ENOENT) {
+			throw IOException("Fails to migrate cache file %s to %s because %s", source, target, strerror(errno));
+		}
+	}
+}
+
+// List all cache files under shard directories of [cache_directory], after migrating cache files in flat layout.
+std::unordered_set<string> ListExistingCacheFiles(FileSystem &local_filesystem, const string &cache_directory) {
+	// Directory entries are collected before any filesystem mutation, which are not allowed during listing.
+	vector<string> flat_cache_fnames;
+	vector<string> shard_parent_directories;
+	local_filesystem.ListFiles(cache_directory, [&](const string &fname, bool is_dir) {
+		if (is_dir) {
+			shard_parent_directories.emplace_back(StringUtil::Format("%s/%s", cache_directory, fname));
+		} else if (!IsStoreManagedFile(fname) && fname.length() >= CACHE_FILE_SHARD_PREFIX_LENGTH) {
+			flat_cache_fnames.emplace_back(fname);
+		}
+	});
+
+	vector<string> shard_directories;
+	for (const auto &cur_parent_directory : shard_parent_directories) {
+		local_filesystem.ListFiles(cur_parent_directory, [&](const string &fname, bool is_dir) {
+			if (is_dir) {
+				shard_directories.emplace_back(StringUtil::Format("%s/%s", cur_parent_directory, fname));
+			}
+		});
+	}
+
+	// Temporary files are either being written, or left by crash; neither of them is a cache file.
+	std::unordered_set<string> existing_cache_files;
+	for (const auto &cur_shard_directory : shard_directories) {
+		local_filesystem.ListFiles(cur_shard_directory, [&](const string &fname, bool is_dir) {
+			if (!is_dir && !StringUtil::EndsWith(fname, LOCAL_CACHE_TEMP_FILE_SUFFIX)) {
+				existing_cache_files.emplace(StringUtil::Format("%s/%s", cur_shard_directory, fname));
+			}
+		});
+	}
+
+	MigrateFlatCacheFiles(local_filesystem, cache_directory, flat_cache_fnames);
+	for (const auto &cur_fname : flat_cache_fnames) {
+		existing_cache_files.emplace(StringUtil::Format(
+		    "%s/%s", GetCacheFileShardDirectory(cache_directory, cur_fname), cur_fname));
+	}
+	return existing_cache_files;
+}
+
+// Load existing cache files under [cache_directory] into [lru_index], and return cache files to evict if they exceed
+// capacity.
+//
+// Sizes and access recency are restored from the index journal; only cache files missing in the journal (i.e. written
+// right before crash, migrated from flat layout, or on the first load) are opened for their sizes, and their last
+// modification timestamps are taken as last access. Journal entries whose cache files no longer exist are dropped.
+//
+// Cache files missing in the journal are indexed only if they end with a valid block footer, others (i.e. torn by
+// crash, or written in an incompatible format) are returned to evict as well.
+vector<string> LoadExistingCacheFiles(FileSystem &local_filesystem, const string &cache_directory,
+                                      DiskCacheLruIndex &lru_index) {
+	auto existing_cache_files = ListExistingCacheFiles(local_filesystem, cache_directory);
+	lru_index.LoadJournal(existing_cache_files);
+	for (const auto &cur_cache_file : lru_index.GetCacheFiles()) {
+		existing_cache_files.erase(cur_cache_file);
+	}
+
+	struct CacheFileInfo {
+		string filepath;
+		idx_t file_size = 0;
+		time_t last_mod_time = 0;
+	};
+	vector<CacheFileInfo> cache_files;
+	vector<string> cache_files_to_evict;
+	for (const auto &filepath : existing_cache_files) {
+		// Cache files could be deleted concurrently, tolerate non-existent file.
+		auto file_handle = local_filesystem.OpenFile(filepath, FileOpenFlags::FILE_FLAGS_READ |
+		                                                           FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (file_handle == nullptr) {
+			continue;
+		}
+		const idx_t file_size = static_cast<idx_t>(local_filesystem.GetFileSize(*file_handle));
+		if (file_size < DISK_CACHE_BLOCK_FOOTER_SIZE) {
+			cache_files_to_evict.emplace_back(filepath);
+			continue;
+		}
+		char footer[DISK_CACHE_BLOCK_FOOTER_SIZE];
+		local_filesystem.Read(*file_handle, footer, DISK_CACHE_BLOCK_FOOTER_SIZE,
+		                      /*location=*/file_size - DISK_CACHE_BLOCK_FOOTER_SIZE);
+		DiskCacheBlockFooter decoded_footer;
+		if (!DecodeDiskCacheBlockFooter(footer, decoded_footer) ||
+		    !IsDiskCacheBlockStoredLengthMatched(decoded_footer, file_size - DISK_CACHE_BLOCK_FOOTER_SIZE)) {
+			cache_files_to_evict.emplace_back(filepath);
+			continue;
+		}
+		cache_files.emplace_back(CacheFileInfo {
+		    .filepath = filepath,
+		    .file_size = file_size,
+		    .last_mod_time = local_filesystem.GetLastModifiedTime(*file_handle),
+		});
+	}
+	std::sort(cache_files.begin(), cache_files.end(), [](const CacheFileInfo &lhs, const CacheFileInfo &rhs) {
+		return lhs.last_mod_time < rhs.last_mod_time;
+	});
+
+	for (const auto &cur_cache_file : cache_files) {
+		auto cur_cache_files_to_evict =
+		    lru_index.AddCacheFile(cur_cache_file.filepath, cur_cache_file.file_size, cur_cache_file.last_mod_time);
+		cache_files_to_evict.insert(cache_files_to_evict.end(),
+		                            std::make_move_iterator(cur_cache_files_to_evict.begin()),
+		                            std::make_move_iterator(cur_cache_files_to_evict.end()));
+	}
+	return cache_files_to_evict;
+}
+
+// Return whether cache files are accessed with batched io_uring submissions, which only applies to file layout.
+bool UseIoUring() {
+	return *g_disk_cache_io_engine == *IO_URING_DISK_CACHE_IO_ENGINE && !UseSegmentLayout() && !UseMirrorLayout() &&
+	       IsIoUringAvailable();
+}
+
+// Return whether cache files are accessed with direct IO bypassing page cache, which only applies to file layout.
+bool UseDirectIo() {
+	return *g_disk_cache_io_engine == *DIRECT_DISK_CACHE_IO_ENGINE && !UseSegmentLayout() && !UseMirrorLayout() &&
+	       IsDirectIoSupported();
+}
+
+// Return whether cache hits are served from memory mappings of cache files, which only applies to file layout.
+bool UseMmap() {
+	return *g_disk_cache_io_engine == *MMAP_DISK_CACHE_IO_ENGINE && !UseSegmentLayout() && !UseMirrorLayout() &&
+	       IsMmapSupported();
+}
+
+// Remove [local_cache_file] which fails validation from local filesystem and [lru_index]. Cache files are not
+// necessarily synced before they're visible, so they could be left truncated or torn by crash; remote files could also
+// be overwritten after they're cached. Such cache files are discarded so the block gets fetched and cached again.
+void RemoveInvalidCacheFile(const string &local_cache_file, DiskCacheLruIndex &lru_index) {
+	if (std::remove(local_cache_file.data()) != 0 && errno != ENOENT) {
+		throw IOException("Fails to delete invalid cache file %s because %s", local_cache_file, strerror(errno));
+	}
+	lru_index.RemoveCacheFile(local_cache_file);
+}
+
+// Get identity of the remote file behind [handle] for cache lookups, which is precomputed on handle open.
+const CacheFileIdentity &GetFileIdentity(FileHandle &handle) {
+	return *handle.Cast<CacheFileSystemHandle>().GetCacheFileIdentity();
+}
+
+// Get identity of the remote file behind [handle] with [file_size] bytes, which cache blocks are keyed by and validated
+// against. It's taken from metadata cache, so it's captured once per file open rather than per read.
+RemoteFileIdentity GetRemoteFileIdentity(FileHandle &handle, idx_t file_size) {
+	const auto metadata = handle.file_system.Cast<CacheFileSystem>().GetFileMetadata(handle);
+	return RemoteFileIdentity {
+	    .file_size = file_size,
+	    .last_modified = static_cast<int64_t>(metadata->last_modified),
+	    .version_hash = metadata->version_tag,
+	};
+}
+
+// Get a unique temporary filepath for [local_cache_file] in its shard directory, so the later move doesn't cross
+// filesystems.
+string GetLocalCacheTempFile(const string &local_cache_file) {
+	return StringUtil::Format("%s.%s%s", local_cache_file, UUID::ToString(UUID::GenerateRandomUUID()),
+	                          LOCAL_CACHE_TEMP_FILE_SUFFIX);
+}
+
+// Attempt to cache [cache_files] along with their footers under [cache_directory], and return whether there's
+// sufficient disk space available to do so. Cache files are synced before they're visible if [sync_cache_file]; with
+// [use_io_uring], all cache files are written in batched io_uring submissions instead of one after another; with
+// [use_direct_io], cache files are written bypassing page cache.
+//
+// Cache files are never deleted here, evicted ones are handed over to [janitor] instead.
+bool CacheLocal(const vector<CacheFileContent> &cache_files, FileSystem &local_filesystem,
+                const string &cache_directory, DiskCacheLruIndex &lru_index, DiskCacheJanitor &janitor,
+                bool sync_cache_file, bool use_io_uring, bool use_direct_io) {
+	// Skip local cache if insufficient disk space, and let janitor evict stale cache files in background.
 	// It's worth noting it's not a strict check since there could be concurrent check and write operation (RMW
 	// operation), but it's acceptable since min available disk space reservation is an order of magnitude bigger than
 	// cache chunk size.
 	if (!CanCacheOnDisk(cache_directory)) {
-		// After cache file eviction and file deletion request we cannot perform a cache dump operation immediately,
-		// because on unix platform files are only deleted physically when their last reference count goes away.
-		EvictStaleCacheFiles(local_filesystem, cache_directory);
+		janitor.Wake();
+		return false;
+	}
+	// Janitor evicts ahead of capacity once the new cache files push disk usage over the high watermark.
+	SCOPE_EXIT {
+		janitor.MaybeWake(lru_index);
+	};
+
+	for (const auto &cur_cache_file : cache_files) {
+		const auto fname = StringUtil::GetFileName(cur_cache_file.local_cache_file);
+		CreateShardDirectory(local_filesystem, GetCacheFileShardDirectory(cache_directory, fname));
+	}
+
+	if (use_io_uring) {
+		vector<IoUringWriteRequest> write_requests;
+		write_requests.reserve(cache_files.size());
+		for (const auto &cur_cache_file : cache_files) {
+			write_requests.emplace_back(IoUringWriteRequest {
+			    .temp_filepath = GetLocalCacheTempFile(cur_cache_file.local_cache_file),
+			    .filepath = cur_cache_file.local_cache_file,
+			    .data = cur_cache_file.data,
+			    .length = cur_cache_file.size,
+			    .trailer = cur_cache_file.footer,
+			    .trailer_length = DISK_CACHE_BLOCK_FOOTER_SIZE,
+			});
+		}
+		IoUringWriteFiles(write_requests, sync_cache_file);
+
+		// Written cache files are indexed before reporting failure, so they're accounted for eviction.
+		const IoUringWriteRequest *failed_request = nullptr;
+		for (const auto &cur_request : write_requests) {
+			if (cur_request.result < 0) {
+				failed_request = &cur_request;
+				continue;
+			}
+			const idx_t file_size = cur_request.length + cur_request.trailer_length;
+			janitor.RemoveCacheFiles(cache_directory, lru_index.AddCacheFile(cur_request.filepath, file_size));
+		}
+		if (failed_request != nullptr) {
+			throw IOException("Fails to write cache file %s because %s", failed_request->filepath,
+			                  strerror(static_cast<int>(-failed_request->result)));
+		}
+		return true;
+	}
+
+	for (const auto &cur_cache_file : cache_files) {
+		// Dump to a temporary location at local filesystem.
+		const auto local_temp_file = GetLocalCacheTempFile(cur_cache_file.local_cache_file);
+		if (use_direct_io) {
+			DirectIoWriteFile(local_temp_file, cur_cache_file.data, cur_cache_file.size, sync_cache_file,
+			                  cur_cache_file.footer, DISK_CACHE_BLOCK_FOOTER_SIZE);
+		} else {
+			auto file_handle = local_filesystem.OpenFile(
+			    local_temp_file, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			local_filesystem.Write(*file_handle, const_cast<char *>(cur_cache_file.data),
+			                       /*nr_bytes=*/cur_cache_file.size,
+			                       /*location=*/0);
+			local_filesystem.Write(*file_handle, const_cast<char *>(cur_cache_file.footer),
+			                       /*nr_bytes=*/DISK_CACHE_BLOCK_FOOTER_SIZE,
+			                       /*location=*/cur_cache_file.size);
+			if (sync_cache_file) {
+				file_handle->Sync();
+			}
+		}
+
+		// Then atomically move to the target postion to prevent data corruption due to concurrent write.
+		local_filesystem.MoveFile(/*source=*/local_temp_file,
+		                          /*target=*/cur_cache_file.local_cache_file);
+
+		// Evict least recently used cache files if the new one makes disk cache exceed its capacity, which happens only
+		// if writes outpace janitor.
+		janitor.RemoveCacheFiles(cache_directory,
+		                         lru_index.AddCacheFile(cur_cache_file.local_cache_file,
+		                                                cur_cache_file.size + DISK_CACHE_BLOCK_FOOTER_SIZE,
+		                                                cur_cache_file.retention));
+	}
+	return true;
+}
+
+} // namespace
+
+DiskCacheReader::DiskCacheReader()
+    : local_filesystem(LocalFileSystem::CreateLocal()), last_sync_millisec(GetSteadyNowMilliSecSinceEpoch()) {
+	janitor = make_uniq<DiskCacheJanitor>(DISK_CACHE_EVICTION_HIGH_WATERMARK_RATIO,
+	                                      DISK_CACHE_JANITOR_MAX_REMOVALS_PER_SECOND,
+	                                      DISK_CACHE_JANITOR_INTERVAL_MILLISEC);
+	write_back_queue = make_uniq<CacheWriteBackQueue>(
+	    DISK_CACHE_WRITE_BACK_THREAD_COUNT, DISK_CACHE_WRITE_BACK_MAX_BATCH_COUNT,
+	    [this](const vector<CacheWriteBackQueue::PendingWrite> &pending_writes) {
+		    // Pending content is the block followed by its encoded footer. Blocks are written together, so they could
+		    // share batched submissions.
+		    vector<CacheFileContent> cache_files;
+		    cache_files.reserve(pending_writes.size());
+		    for (const auto &cur_pending_write : pending_writes) {
+			    const auto &content = *cur_pending_write.content;
+			    const idx_t block_size = content.length() - DISK_CACHE_BLOCK_FOOTER_SIZE;
+			    cache_files.emplace_back(CacheFileContent {
+			        .data = content.data(),
+			        .size = block_size,
+			        .footer = content.data() + block_size,
+			        .local_cache_file = cur_pending_write.cache_file,
+			        .retention = cur_pending_write.retention,
+			    });
+		    }
+		    WriteCacheFiles(cache_files);
+	    });
+}
+
+void DiskCacheReader::WriteCacheFiles(const vector<CacheFileContent> &cache_files) {
+	const bool sync_cache_file = *g_disk_cache_durability == *STRICT_DISK_CACHE_DURABILITY;
+	auto cur_directory_set = GetDirectorySet();
+	if (UseSegmentLayout()) {
+		if (CanCacheOnDisk(cur_directory_set->GetDirectories()[0])) {
+			auto cur_segment_store = GetSegmentStore();
+			for (const auto &cur_cache_file : cache_files) {
+				cur_segment_store->Append(StringUtil::GetFileName(cur_cache_file.local_cache_file), cur_cache_file.data,
+				                          cur_cache_file.size, sync_cache_file);
+			}
+		}
+	} else if (UseMirrorLayout()) {
+		if (CanCacheOnDisk(cur_directory_set->GetDirectories()[0])) {
+			auto cur_mirror_store = GetMirrorStore();
+			for (const auto &cur_cache_file : cache_files) {
+				const auto mirror_block = GetMirrorBlock(cur_cache_file.local_cache_file);
+				cur_mirror_store->WriteBlock(mirror_block.first, mirror_block.second, cur_cache_file.data,
+				                             cur_cache_file.size, sync_cache_file);
+			}
+		}
+	} else if (*g_disk_cache_compression == *ZSTD_DISK_CACHE_COMPRESSION) {
+		// Blocks are compressed right before they're written, so content pending to write in background stays raw and
+		// is served as is.
+		vector<string> compressed_contents;
+		CacheLocalStriped(*cur_directory_set, CompressCacheFiles(cache_files, compressed_contents), sync_cache_file);
+	} else {
+		CacheLocalStriped(*cur_directory_set, cache_files, sync_cache_file);
+	}
+	if (*g_disk_cache_durability != *BATCHED_DISK_CACHE_DURABILITY) {
 		return;
 	}
 
-	// Dump to a temporary location at local filesystem.
-	const auto fname = StringUtil::GetFileName(handle.GetPath());
-	const auto local_temp_file = StringUtil::Format("%s%s.%s.httpfs_local_cache", cache_directory, fname,
-	                                                UUID::ToString(UUID::GenerateRandomUUID()));
+	// Only one writer syncs the filesystem within each interval, others skip.
+	const int64_t now = GetSteadyNowMilliSecSinceEpoch();
+	int64_t last_sync = last_sync_millisec.load();
+	if (now - last_sync < static_cast<int64_t>(DISK_CACHE_SYNC_INTERVAL_MILLISEC)) {
+		return;
+	}
+	if (!last_sync_millisec.compare_exchange_strong(last_sync, now)) {
+		return;
+	}
+	for (const auto &cur_directory : cur_directory_set->GetDirectories()) {
+		SyncFileSystem(cur_directory);
+	}
+}
+
+void DiskCacheReader::CacheLocalStriped(DiskCacheDirectorySet &directory_set,
+                                        const vector<CacheFileContent> &cache_files, bool sync_cache_file) {
+	// Cache files are grouped by the directory they're placed under, so each directory keeps batched submissions.
+	vector<string> cache_directories;
+	vector<vector<CacheFileContent>> cache_files_by_directory;
+	for (const auto &cur_cache_file : cache_files) {
+		auto cur_directory = GetCacheDirectory(cur_cache_file.local_cache_file);
+		const auto iter = std::find(cache_directories.begin(), cache_directories.end(), cur_directory);
+		if (iter != cache_directories.end()) {
+			cache_files_by_directory[std::distance(cache_directories.begin(), iter)].emplace_back(cur_cache_file);
+			continue;
+		}
+		cache_directories.emplace_back(std::move(cur_directory));
+		cache_files_by_directory.emplace_back(vector<CacheFileContent> {cur_cache_file});
+	}
+
+	// A directory which fills up or fails is taken out of rotation, so later blocks are placed on other directories
+	// instead of being dropped. Blocks for other directories are still written on failure, and the first failure is
+	// reported afterwards.
+	const bool use_io_uring = UseIoUring();
+	const bool use_direct_io = UseDirectIo();
+	std::exception_ptr write_exception;
+	for (idx_t idx = 0; idx < cache_directories.size(); ++idx) {
+		const auto &cur_directory = cache_directories[idx];
+		const auto &cur_cache_files = cache_files_by_directory[idx];
+		// Directory could be removed from config after the blocks got placed.
+		const auto directory_idx = directory_set.FindDirectory(cur_cache_files[0].local_cache_file);
+		if (!directory_idx.IsValid()) {
+			continue;
+		}
+		bool is_cached = false;
+		try {
+			is_cached = CacheLocal(cur_cache_files, *local_filesystem, cur_directory, *GetLruIndex(cur_directory),
+			                       *janitor, sync_cache_file, use_io_uring, use_direct_io);
+		} catch (...) {
+			if (write_exception == nullptr) {
+				write_exception = std::current_exception();
+			}
+		}
+		if (!is_cached) {
+			directory_set.TakeOutOfRotation(directory_idx.GetIndex());
+		}
+	}
+	if (write_exception != nullptr) {
+		std::rethrow_exception(write_exception);
+	}
+}
+
+vector<CacheFileContent> DiskCacheReader::CompressCacheFiles(const vector<CacheFileContent> &cache_files,
+                                                             vector<string> &compressed_contents) {
+	DiskCacheCompressionStats cur_compression_stats;
+	vector<CacheFileContent> contents_to_write;
+	contents_to_write.reserve(cache_files.size());
+	// Reserved ahead, so returned contents don't get invalidated by reallocation.
+	compressed_contents.reserve(cache_files.size());
+	for (const auto &cur_cache_file : cache_files) {
+		++cur_compression_stats.written_block_count;
+		cur_compression_stats.raw_bytes += cur_cache_file.size;
+
+		// Compressed payload has to fit in the bytes left after minimum saving, so compression bails out early for
+		// incompressible blocks.
+		const idx_t capacity =
+		    cur_cache_file.size - static_cast<idx_t>(cur_cache_file.size * DISK_CACHE_MIN_COMPRESSION_SAVING_RATIO);
+		auto content = CreateResizeUninitializedString(capacity + DISK_CACHE_BLOCK_FOOTER_SIZE);
+		const idx_t compressed_length = ZstdCompress(cur_cache_file.data, cur_cache_file.size,
+		                                             DISK_CACHE_ZSTD_COMPRESSION_LEVEL, &content[0], capacity);
+		if (compressed_length == 0 || compressed_length >= cur_cache_file.size) {
+			cur_compression_stats.stored_bytes += cur_cache_file.size;
+			contents_to_write.emplace_back(cur_cache_file);
+			continue;
+		}
+
+		// Footer is re-encoded for compressed payload, with the remote file identity it's cached for.
+		DiskCacheBlockFooter raw_footer;
+		const bool is_footer_valid = DecodeDiskCacheBlockFooter(cur_cache_file.footer, raw_footer);
+		D_ASSERT(is_footer_valid);
+		EncodeDiskCacheBlockFooter(content.data(), compressed_length, DiskCacheBlockCodec::kZstd, cur_cache_file.size,
+		                           GetRemoteFileIdentity(raw_footer), &content[compressed_length]);
+		content.resize(compressed_length + DISK_CACHE_BLOCK_FOOTER_SIZE);
+		compressed_contents.emplace_back(std::move(content));
+		const auto &cur_content = compressed_contents.back();
+		contents_to_write.emplace_back(CacheFileContent {
+		    .data = cur_content.data(),
+		    .size = compressed_length,
+		    .footer = cur_content.data() + compressed_length,
+		    .local_cache_file = cur_cache_file.local_cache_file,
+		    .retention = cur_cache_file.retention,
+		});
+		++cur_compression_stats.compressed_block_count;
+		cur_compression_stats.stored_bytes += compressed_length;
+	}
+
+	std::lock_guard<std::mutex> lck(compression_stats_mutex);
+	compression_stats.written_block_count += cur_compression_stats.written_block_count;
+	compression_stats.compressed_block_count += cur_compression_stats.compressed_block_count;
+	compression_stats.raw_bytes += cur_compression_stats.raw_bytes;
+	compression_stats.stored_bytes += cur_compression_stats.stored_bytes;
+	return contents_to_write;
+}
+
+bool DiskCacheReader::GetDiskCacheCompressionStats(DiskCacheCompressionStats &compression_stats_out) const {
+	std::lock_guard<std::mutex> lck(compression_stats_mutex);
+	compression_stats_out = compression_stats;
+	return true;
+}
+
+void DiskCacheReader::Flush() {
+	write_back_queue->Flush();
+	janitor->Flush();
+}
+
+shared_ptr<DiskCacheDirectorySet> DiskCacheReader::GetDirectorySet() const {
+	std::lock_guard<std::mutex> lck(lru_index_mutex);
+	return GetDirectorySetImpl();
+}
+
+shared_ptr<DiskCacheDirectorySet> DiskCacheReader::GetDirectorySetImpl() const {
+	if (directory_set != nullptr && directory_set_config == *g_on_disk_cache_directory &&
+	    directory_set_weight_by_capacity == g_disk_cache_weight_by_capacity) {
+		return directory_set;
+	}
+	directory_set_config = *g_on_disk_cache_directory;
+	directory_set_weight_by_capacity = g_disk_cache_weight_by_capacity;
+	auto directories = GetOnDiskCacheDirectories();
+	if (directories.empty()) {
+		directories.emplace_back(*DEFAULT_ON_DISK_CACHE_DIRECTORY);
+	}
+
+	// Directories are weighted by the overall space of their filesystems; inaccessible ones get the least weight.
+	vector<double> weights;
+	if (directory_set_weight_by_capacity) {
+		for (const auto &cur_directory : directories) {
+			const bool is_accessible = FileSystem::GetAvailableDiskSpace(cur_directory).IsValid();
+			const idx_t capacity_bytes = is_accessible ? GetOverallFileSystemDiskSpace(cur_directory) : 0;
+			weights.emplace_back(static_cast<double>(MaxValue<idx_t>(capacity_bytes, 1)));
+		}
+	}
+	directory_set = make_shared_ptr<DiskCacheDirectorySet>(std::move(directories), std::move(weights),
+	                                                       DISK_CACHE_DIRECTORY_REJOIN_INTERVAL_MILLISEC);
+	// Indexes are reloaded for new directories, so capacity shares are re-assigned.
+	lru_indexes.clear();
+	janitor->ClearDirectories();
+	return directory_set;
+}
+
+shared_ptr<DiskCacheLruIndex> DiskCacheReader::GetLruIndex(const string &cache_directory) const {
+	vector<string> cache_files_to_evict;
+	shared_ptr<DiskCacheLruIndex> cur_lru_index;
 	{
-		auto file_handle = local_filesystem.OpenFile(local_temp_file, FileOpenFlags::FILE_FLAGS_WRITE |
-		                                                                  FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
-		local_filesystem.Write(*file_handle, chunk.GetAddressToReadTo(),
-		                       /*nr_bytes=*/chunk.chunk_size,
-		                       /*location=*/0);
-		file_handle->Sync();
+		std::lock_guard<std::mutex> lck(lru_index_mutex);
+		auto cur_directory_set = GetDirectorySetImpl();
+		const auto &directories = cur_directory_set->GetDirectories();
+		const auto directory_iter = std::find(directories.begin(), directories.end(), cache_directory);
+		// Directory could be removed from config after cache files got placed, which gets the overall capacity.
+		const idx_t capacity_bytes =
+		    directory_iter == directories.end()
+		        ? g_max_disk_cache_bytes
+		        : cur_directory_set->GetCapacityBytes(std::distance(directories.begin(), directory_iter),
+		                                              g_max_disk_cache_bytes);
+		auto &lru_index = lru_indexes[cache_directory];
+		if (lru_index == nullptr) {
+			lru_index = make_shared_ptr<DiskCacheLruIndex>(capacity_bytes, DISK_CACHE_EVICTION_LOW_WATERMARK_RATIO,
+			                                               GetIndexJournalFilepath(cache_directory));
+			cache_files_to_evict = LoadExistingCacheFiles(*local_filesystem, cache_directory, *lru_index);
+			janitor->AddDirectory(cache_directory, lru_index);
+		}
+		lru_index->SetCapacityBytes(capacity_bytes);
+		cur_lru_index = lru_index;
 	}
+	janitor->RemoveCacheFiles(cache_directory, std::move(cache_files_to_evict));
+	return cur_lru_index;
+}
 
-	// Then atomically move to the target postion to prevent data corruption due to concurrent write.
-	local_filesystem.MoveFile(/*source=*/local_temp_file,
-	                          /*target=*/local_cache_file);
+vector<shared_ptr<DiskCacheLruIndex>> DiskCacheReader::GetLruIndexes() const {
+	return GetLruIndexes(*GetDirectorySet());
 }
 
-} // namespace
+vector<shared_ptr<DiskCacheLruIndex>>
+DiskCacheReader::GetLruIndexes(const DiskCacheDirectorySet &cur_directory_set) const {
+	vector<shared_ptr<DiskCacheLruIndex>> cur_lru_indexes;
+	for (const auto &cur_directory : cur_directory_set.GetDirectories()) {
+		cur_lru_indexes.emplace_back(GetLruIndex(cur_directory));
+	}
+	return cur_lru_indexes;
+}
 
-DiskCacheReader::DiskCacheReader() : local_filesystem(LocalFileSystem::CreateLocal()) {
+shared_ptr<DiskCacheLruIndex> DiskCacheReader::GetLruIndex(const LocalCacheContext &context,
+                                                           const string &local_cache_file) const {
+	const auto directory_idx = context.directory_set->FindDirectory(local_cache_file);
+	if (directory_idx.IsValid() && directory_idx.GetIndex() < context.lru_indexes.size()) {
+		return context.lru_indexes[directory_idx.GetIndex()];
+	}
+	return GetLruIndex(GetCacheDirectory(local_cache_file));
+}
+
+DiskCacheReader::LocalCacheContext DiskCacheReader::GetLocalCacheContext() const {
+	LocalCacheContext context;
+	context.directory_set = GetDirectorySet();
+	if (UseSegmentLayout()) {
+		context.segment_store = GetSegmentStore();
+	} else if (!UseMirrorLayout()) {
+		// Indexes are loaded before the first lookup, so cache files in flat layout have been migrated to shard
+		// directories.
+		context.lru_indexes = GetLruIndexes(*context.directory_set);
+	}
+	return context;
+}
+
+string DiskCacheReader::GetLocalCacheFilepath(const DiskCacheDirectorySet &cur_directory_set,
+                                              const CacheFileIdentity &file_identity, uint64_t version_tag,
+                                              idx_t start_offset, idx_t bytes_to_read) const {
+	const auto cache_fname = GetLocalCacheFname(file_identity, version_tag, start_offset, bytes_to_read);
+	// Segment and mirror stores only live under the first directory.
+	const idx_t directory_idx =
+	    UseSegmentLayout() || UseMirrorLayout() ? 0 : cur_directory_set.PickDirectory(cache_fname);
+	return GetLocalCacheFile(cur_directory_set.GetDirectories()[directory_idx], cache_fname);
+}
+
+void DiskCacheReader::AssignLocalCacheFilepaths(const DiskCacheDirectorySet &cur_directory_set, FileHandle &handle,
+                                                uint64_t version_tag, vector<CacheReadChunk> &cache_read_chunks) const {
+	const auto &file_identity = GetFileIdentity(handle);
+	for (auto &cur_chunk : cache_read_chunks) {
+		cur_chunk.local_cache_file = GetLocalCacheFilepath(cur_directory_set, file_identity, version_tag,
+		                                                   cur_chunk.aligned_start_offset, cur_chunk.chunk_size);
+	}
+}
+
+shared_ptr<DiskCacheSegmentStore> DiskCacheReader::GetSegmentStore() const {
+	const auto cache_directory = GetDirectorySet()->GetDirectories()[0];
+	std::lock_guard<std::mutex> lck(segment_store_mutex);
+	if (segment_store == nullptr || segment_store_directory != cache_directory) {
+		segment_store_directory = cache_directory;
+		segment_store = make_shared_ptr<DiskCacheSegmentStore>(segment_store_directory, g_disk_cache_segment_size,
+		                                                       g_max_disk_cache_bytes);
+	}
+	segment_store->SetCapacityBytes(g_max_disk_cache_bytes);
+	return segment_store;
+}
+
+shared_ptr<DiskCacheReader::MappedFileCache> DiskCacheReader::GetMappedFileCache() const {
+	std::lock_guard<std::mutex> lck(mapped_file_cache_mutex);
+	if (mapped_file_cache == nullptr || mapped_file_cache->MaxTotalWeight() != g_disk_cache_max_mapped_bytes) {
+		mapped_file_cache = make_shared_ptr<MappedFileCache>(
+		    DISK_CACHE_MAX_MAPPED_FILES, /*timeout_millisec=*/0, g_disk_cache_max_mapped_bytes,
+		    [](const MappedFile &mapped_file) { return mapped_file.GetSize(); });
+	}
+	return mapped_file_cache;
+}
+
+shared_ptr<DiskCacheMirrorStore> DiskCacheReader::GetMirrorStore() const {
+	const auto cache_directory = GetDirectorySet()->GetDirectories()[0];
+	std::lock_guard<std::mutex> lck(mirror_store_mutex);
+	// Bitmaps are indexed by cache block size, so mirror files are reloaded on block size change.
+	if (mirror_store == nullptr || mirror_store_directory != cache_directory ||
+	    mirror_store->GetBlockSize() != g_cache_block_size) {
+		mirror_store_directory = cache_directory;
+		mirror_store = make_shared_ptr<DiskCacheMirrorStore>(mirror_store_directory, g_cache_block_size,
+		                                                     g_max_disk_cache_bytes);
+	}
+	mirror_store->SetCapacityBytes(g_max_disk_cache_bytes);
+	return mirror_store;
+}
+
+bool DiskCacheReader::GetDataCacheUsage(DataCacheUsage &data_cache_usage) const {
+	if (g_max_disk_cache_bytes == 0) {
+		return false;
+	}
+	if (UseSegmentLayout()) {
+		auto cur_segment_store = GetSegmentStore();
+		data_cache_usage = DataCacheUsage {
+		    .capacity_bytes = cur_segment_store->GetCapacityBytes(),
+		    .used_bytes = cur_segment_store->GetUsedBytes(),
+		};
+		return true;
+	}
+	if (UseMirrorLayout()) {
+		auto cur_mirror_store = GetMirrorStore();
+		data_cache_usage = DataCacheUsage {
+		    .capacity_bytes = cur_mirror_store->GetCapacityBytes(),
+		    .used_bytes = cur_mirror_store->GetUsedBytes(),
+		};
+		return true;
+	}
+	data_cache_usage = DataCacheUsage {};
+	for (const auto &cur_lru_index : GetLruIndexes()) {
+		data_cache_usage.capacity_bytes += cur_lru_index->GetCapacityBytes();
+		data_cache_usage.used_bytes += cur_lru_index->GetUsedBytes();
+	}
+	return true;
+}
+
+idx_t DiskCacheReader::GetOnDiskCacheBytes() const {
+	if (UseSegmentLayout()) {
+		return GetSegmentStore()->GetUsedBytes();
+	}
+	if (UseMirrorLayout()) {
+		return GetMirrorStore()->GetUsedBytes();
+	}
+	idx_t used_bytes = 0;
+	for (const auto &cur_lru_index : GetLruIndexes()) {
+		used_bytes += cur_lru_index->GetUsedBytes();
+	}
+	return used_bytes;
 }
 
 vector<DataCacheEntryInfo> DiskCacheReader::GetCacheEntriesInfo() const {
+	write_back_queue->Flush();
 	vector<DataCacheEntryInfo> cache_entries_info;
-	local_filesystem->ListFiles(
-	    *g_on_disk_cache_directory, [&cache_entries_info](const std::string &fname, bool /*unused*/) {
-		    auto remote_file_info = GetRemoteFileInfo(fname);
-		    cache_entries_info.emplace_back(DataCacheEntryInfo {
-		        .cache_filepath = StringUtil::Format("%s/%s", *g_on_disk_cache_directory, fname),
-		        .remote_filename = std::get<0>(remote_file_info),
-		        .start_offset = std::get<1>(remote_file_info),
-		        .end_offset = std::get<2>(remote_file_info),
-		        .cache_type = "on-disk",
-		    });
-	    });
+	if (UseSegmentLayout()) {
+		for (auto &cur_entry : GetSegmentStore()->GetEntries()) {
+			auto remote_file_info = GetRemoteFileInfo(cur_entry.key);
+			cache_entries_info.emplace_back(DataCacheEntryInfo {
+			    .cache_filepath = std::move(cur_entry.segment_filepath),
+			    .remote_filename = std::get<0>(remote_file_info),
+			    .start_offset = std::get<1>(remote_file_info),
+			    .end_offset = std::get<2>(remote_file_info),
+			    .cache_type = "on-disk",
+			});
+		}
+		return cache_entries_info;
+	}
+	if (UseMirrorLayout()) {
+		for (auto &cur_entry : GetMirrorStore()->GetEntries()) {
+			auto remote_file_info = GetRemoteFileInfo(StringUtil::Format(
+			    "%s-%llu-%llu", cur_entry.mirror_key, cur_entry.block_offset, cur_entry.block_length));
+			cache_entries_info.emplace_back(DataCacheEntryInfo {
+			    .cache_filepath = std::move(cur_entry.mirror_filepath),
+			    .remote_filename = std::get<0>(remote_file_info),
+			    .start_offset = std::get<1>(remote_file_info),
+			    .end_offset = std::get<2>(remote_file_info),
+			    .cache_type = "on-disk",
+			});
+		}
+		return cache_entries_info;
+	}
+	for (const auto &cur_lru_index : GetLruIndexes()) {
+		for (auto &cur_cache_file : cur_lru_index->GetCacheFiles()) {
+			auto remote_file_info = GetRemoteFileInfo(StringUtil::GetFileName(cur_cache_file));
+			cache_entries_info.emplace_back(DataCacheEntryInfo {
+			    .cache_filepath = std::move(cur_cache_file),
+			    .remote_filename = std::get<0>(remote_file_info),
+			    .start_offset = std::get<1>(remote_file_info),
+			    .end_offset = std::get<2>(remote_file_info),
+			    .cache_type = "on-disk",
+			});
+		}
+	}
 	return cache_entries_info;
 }
 
 void DiskCacheReader::ReadAndCache(FileHandle &handle, char *buffer, idx_t requested_start_offset,
                                    idx_t requested_bytes_to_read, idx_t file_size) {
-	const idx_t block_size = g_cache_block_size;
-	const idx_t aligned_start_offset = requested_start_offset / block_size * block_size;
-	const idx_t aligned_last_chunk_offset =
-	    (requested_start_offset + requested_bytes_to_read) / block_size * block_size;
-	const idx_t subrequest_count = (aligned_last_chunk_offset - aligned_start_offset) / block_size + 1;
-
-	// Indicate the meory address to copy to for each IO operation
-	char *addr_to_write = buffer;
-	// Used to calculate bytes to copy for last chunk.
-	idx_t already_read_bytes = 0;
-	// Threads to parallelly perform IO.
-	ThreadPool io_threads(GetThreadCountForSubrequests(subrequest_count));
-
-	// To improve IO performance, we split requested bytes (after alignment) into multiple chunks and fetch them in
-	// parallel.
-	for (idx_t io_start_offset = aligned_start_offset; io_start_offset <= aligned_last_chunk_offset;
-	     io_start_offset += block_size) {
-		CacheReadChunk cache_read_chunk;
-		cache_read_chunk.requested_start_addr = addr_to_write;
-		cache_read_chunk.aligned_start_offset = io_start_offset;
-		cache_read_chunk.requested_start_offset = requested_start_offset;
-
-		// Implementation-wise, middle chunks are easy to handle -- read in [block_size], and copy the whole chunk to
-		// the requested memory address; but the first and last chunk require special handling. For first chunk,
-		// requested start offset might not be aligned with block size; for the last chunk, we might not need to copy
-		// the whole [block_size] of memory.
-		//
-		// Case-1: If there's only one chunk, which serves as both the first chunk and the last one.
-		if (io_start_offset == aligned_start_offset && io_start_offset == aligned_last_chunk_offset) {
-			cache_read_chunk.chunk_size = MinValue<idx_t>(block_size, file_size - io_start_offset);
-			cache_read_chunk.content = CreateResizeUninitializedString(cache_read_chunk.chunk_size);
-			cache_read_chunk.bytes_to_copy = requested_bytes_to_read;
-		}
-		// Case-2: First chunk.
-		else if (io_start_offset == aligned_start_offset) {
-			const idx_t delta_offset = requested_start_offset - aligned_start_offset;
-			addr_to_write += block_size - delta_offset;
-			already_read_bytes += block_size - delta_offset;
-
-			cache_read_chunk.chunk_size = block_size;
-			cache_read_chunk.content = CreateResizeUninitializedString(block_size);
-			cache_read_chunk.bytes_to_copy = block_size - delta_offset;
-		}
-		// Case-3: Last chunk.
-		else if (io_start_offset == aligned_last_chunk_offset) {
-			cache_read_chunk.chunk_size = MinValue<idx_t>(block_size, file_size - io_start_offset);
-			cache_read_chunk.content = CreateResizeUninitializedString(cache_read_chunk.chunk_size);
-			cache_read_chunk.bytes_to_copy = requested_bytes_to_read - already_read_bytes;
-		}
-		// Case-4: Middle chunks.
-		else {
-			addr_to_write += block_size;
-			already_read_bytes += block_size;
-
-			cache_read_chunk.bytes_to_copy = block_size;
-			cache_read_chunk.chunk_size = block_size;
-		}
-
-		// Update read offset for next chunk read.
-		requested_start_offset = io_start_offset + block_size;
-
-		// Perform read operation in parallel.
-		io_threads.Push([this, &handle, block_size, cache_read_chunk = std::move(cache_read_chunk)]() mutable {
-			SetThreadName("RdCachRdThd");
-
-			// Check local cache first, see if we could do a cached read.
-			const auto local_cache_file =
-			    GetLocalCacheFile(*g_on_disk_cache_directory, handle.GetPath(), cache_read_chunk.aligned_start_offset,
-			                      cache_read_chunk.chunk_size);
-
-			// Attempt to open the file directly, so a successfully opened file handle won't be deleted by cleanup
-			// thread and lead to data race.
-			auto file_handle = local_filesystem->OpenFile(
-			    local_cache_file, FileOpenFlags::FILE_FLAGS_READ | FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
-			if (file_handle != nullptr) {
-				profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
-				                                     BaseProfileCollector::CacheAccess::kCacheHit);
-				void *addr = !cache_read_chunk.content.empty() ? const_cast<char *>(cache_read_chunk.content.data())
-				                                               : cache_read_chunk.requested_start_addr;
-				local_filesystem->Read(*file_handle, addr, cache_read_chunk.chunk_size, /*location=*/0);
-				cache_read_chunk.CopyBufferToRequestedMemory();
-
-				// Update access and modification timestamp for the cache file, so it won't get evicted.
-				const int ret_code = utime(local_cache_file.data(), /*times=*/nullptr);
-				// It's possible the cache file has been requested to delete by eviction thread, so `ENOENT` is a
-				// tolarable error.
-				if (ret_code != 0 && errno != ENOENT) {
-					throw IOException("Fails to update %s's access and modification timestamp because %s",
-					                  local_cache_file, strerror(errno));
+	auto cache_read_chunks = SplitIntoCacheReadChunks(buffer, requested_start_offset, requested_bytes_to_read,
+	                                                  file_size, g_cache_block_size);
+	const auto remote_identity = GetRemoteFileIdentity(handle, file_size);
+	const auto context = GetLocalCacheContext();
+	AssignLocalCacheFilepaths(*context.directory_set, handle, remote_identity.version_hash, cache_read_chunks);
+
+	// Probe local cache for all chunks on the caller thread, cache hits are served directly without dispatching to IO
+	// executor, so a warm read only costs a file open and a local read.
+	vector<CacheReadChunk *> cache_miss_chunks;
+	if (UseMirrorLayout()) {
+		cache_miss_chunks = ReadFromMirrorFile(handle, remote_identity, cache_read_chunks);
+	} else if (UseIoUring()) {
+		cache_miss_chunks = ReadFromLocalCacheWithIoUring(context, remote_identity, cache_read_chunks);
+	} else {
+		for (auto &cur_chunk : cache_read_chunks) {
+			bool is_cache_hit = false;
+			try {
+				is_cache_hit = ReadFromLocalCache(context, remote_identity, cur_chunk);
+			} catch (const IOException &) {
+				if (!TakeFailedDirectoryOutOfRotation(cur_chunk.local_cache_file)) {
+					throw;
 				}
-				return;
 			}
+			if (!is_cache_hit) {
+				cache_miss_chunks.emplace_back(&cur_chunk);
+			}
+		}
+	}
+
+	// Fallback to remote access then local filesystem write for cache misses.
+	FetchCacheMisses(handle, remote_identity, std::move(cache_miss_chunks), /*skip_in_flight=*/false);
+}
+
+void DiskCacheReader::Prefetch(FileHandle &handle, idx_t start_offset, idx_t bytes_to_read, idx_t file_size) {
+	// Prefetched blocks are only cached locally, so read into a scratch buffer.
+	auto buffer = CreateResizeUninitializedString(bytes_to_read);
+	auto cache_read_chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), start_offset, bytes_to_read,
+	                                                  file_size, g_cache_block_size);
+	const auto remote_identity = GetRemoteFileIdentity(handle, file_size);
+	AssignLocalCacheFilepaths(*GetDirectorySet(), handle, remote_identity.version_hash, cache_read_chunks);
+
+	// Existence check is only a hint to skip cached blocks, no content is read from local cache files.
+	vector<CacheReadChunk *> cache_miss_chunks;
+	for (auto &cur_chunk : cache_read_chunks) {
+		if (!IsCachedLocally(cur_chunk.local_cache_file)) {
+			cache_miss_chunks.emplace_back(&cur_chunk);
+		}
+	}
+	// Prefetch runs on IO threads, which never wait for blocks led by others, since their fetches could be queued
+	// behind the waiting IO thread. Prefetch is best-effort, so such blocks are skipped.
+	FetchCacheMisses(handle, remote_identity, std::move(cache_miss_chunks), /*skip_in_flight=*/true);
+}
+
+void DiskCacheReader::FetchCacheMisses(FileHandle &handle, const RemoteFileIdentity &remote_identity,
+                                       vector<CacheReadChunk *> cache_miss_chunks, bool skip_in_flight) {
+	// Concurrent misses on the same block are deduplicated, only the first requester fetches the block while others
+	// wait for its completion.
+	while (!cache_miss_chunks.empty()) {
+		vector<CacheReadChunk *> chunks_to_fetch;
+		vector<std::pair<CacheReadChunk *, shared_ptr<InFlightBlocks::Flight>>> chunks_to_wait;
+		for (auto *cur_chunk : cache_miss_chunks) {
+			auto join_res = in_flight_blocks.Join(cur_chunk->local_cache_file);
+			if (join_res.is_leader) {
+				chunks_to_fetch.emplace_back(cur_chunk);
+			} else if (!skip_in_flight) {
+				chunks_to_wait.emplace_back(cur_chunk, std::move(join_res.flight));
+			}
+		}
 
-			// We suffer a cache loss, fallback to remote access then local filesystem write.
+		// Consecutive cache misses are merged into one remote range request.
+		auto remote_read_ranges = CoalesceCacheReadChunks(chunks_to_fetch, g_max_remote_request_size);
+		ExecuteRemoteReadRanges(remote_read_ranges,
+		                        [this, &handle, &remote_identity](RemoteReadRange &remote_read_range) {
+			                        FetchAndCacheLocal(handle, remote_identity, remote_read_range);
+		                        });
+
+		// Wait for blocks fetched by other requesters, retry by ourselves if they fail.
+		cache_miss_chunks.clear();
+		for (auto &cur_chunk_to_wait : chunks_to_wait) {
+			auto *cur_chunk = cur_chunk_to_wait.first;
+			auto block = in_flight_blocks.Wait(*cur_chunk_to_wait.second);
+			if (block == nullptr) {
+				cache_miss_chunks.emplace_back(cur_chunk);
+				continue;
+			}
 			profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
-			                                     BaseProfileCollector::CacheAccess::kCacheMiss);
-			auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
-			auto *internal_filesystem = disk_cache_handle.GetInternalFileSystem();
+			                                     BaseProfileCollector::CacheAccess::kCacheDedupMiss);
+			cur_chunk->CopyBufferToRequestedMemory(*block);
+		}
+	}
+}
+
+void DiskCacheReader::FetchAndCacheLocal(FileHandle &handle, const RemoteFileIdentity &remote_identity,
+                                         RemoteReadRange &remote_read_range) {
+	const auto &chunks = remote_read_range.chunks;
+
+	// Unblock requesters waiting for blocks led by current request on failure, which retry by themselves.
+	idx_t completed_chunk_count = 0;
+	SCOPE_EXIT {
+		for (idx_t idx = completed_chunk_count; idx < chunks.size(); ++idx) {
+			in_flight_blocks.Complete(chunks[idx]->local_cache_file, []() { return nullptr; });
+		}
+	};
+
+	auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
+	auto *internal_filesystem = disk_cache_handle.GetInternalFileSystem();
+
+	const string oper_id = profile_collector->GenerateOperId();
+	profile_collector->RecordOperationStart(BaseProfileCollector::IoOperation::kRead, oper_id);
+	internal_filesystem->Read(*disk_cache_handle.internal_file_handle, remote_read_range.GetAddressToReadTo(),
+	                          remote_read_range.size, remote_read_range.start_offset);
+	profile_collector->RecordOperationEnd(BaseProfileCollector::IoOperation::kRead, oper_id);
+
+	// Copy to destination buffer, if bytes are read into [content] buffer rather than user-provided buffer.
+	remote_read_range.CopyBufferToRequestedMemory();
+
+	// Share fetched blocks with waiting requesters first, so they're not blocked by local cache file write.
+	for (; completed_chunk_count < chunks.size(); ++completed_chunk_count) {
+		const auto *cur_chunk = chunks[completed_chunk_count];
+		in_flight_blocks.Complete(cur_chunk->local_cache_file, [&remote_read_range, cur_chunk]() {
+			return make_shared_ptr<string>(remote_read_range.GetChunkData(*cur_chunk), cur_chunk->chunk_size);
+		});
+	}
+
+	// Split range into blocks, and attempt to cache them locally along with their footers.
+	const bool footer_prefetch_eligible = disk_cache_handle.IsFooterPrefetchEligible();
+	vector<CacheFileContent> cache_files_to_write;
+	string footers;
+	if (g_disk_cache_write_back_max_bytes == 0) {
+		footers = CreateResizeUninitializedString(chunks.size() * DISK_CACHE_BLOCK_FOOTER_SIZE);
+	}
+	for (idx_t idx = 0; idx < chunks.size(); ++idx) {
+		const auto *cur_chunk = chunks[idx];
+		const char *cur_chunk_data = remote_read_range.GetChunkData(*cur_chunk);
+		profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+		                                     BaseProfileCollector::CacheAccess::kCacheMiss);
+		// Footer blocks are retained over other blocks, so scans over column data don't evict them.
+		const bool is_footer_block =
+		    IsFooterBlock(footer_prefetch_eligible, cur_chunk->aligned_start_offset, remote_identity.file_size);
+		const auto retention = is_footer_block ? CacheFileRetention::kFooter : CacheFileRetention::kData;
+		if (g_disk_cache_write_back_max_bytes == 0) {
+			char *cur_footer = &footers[idx * DISK_CACHE_BLOCK_FOOTER_SIZE];
+			EncodeDiskCacheBlockFooter(cur_chunk_data, cur_chunk->chunk_size, remote_identity, cur_footer);
+			cache_files_to_write.emplace_back(CacheFileContent {
+			    .data = cur_chunk_data,
+			    .size = cur_chunk->chunk_size,
+			    .footer = cur_footer,
+			    .local_cache_file = cur_chunk->local_cache_file,
+			    .retention = retention,
+			});
+			continue;
+		}
+		// Cache file is written in background, which is dropped rather than blocking the read under memory pressure.
+		auto content = CreateResizeUninitializedString(cur_chunk->chunk_size + DISK_CACHE_BLOCK_FOOTER_SIZE);
+		std::memcpy(&content[0], cur_chunk_data, cur_chunk->chunk_size);
+		EncodeDiskCacheBlockFooter(cur_chunk_data, cur_chunk->chunk_size, remote_identity,
+		                           &content[cur_chunk->chunk_size]);
+		write_back_queue->Submit(cur_chunk->local_cache_file, make_shared_ptr<const string>(std::move(content)),
+		                         g_disk_cache_write_back_max_bytes, retention);
+	}
+
+	// Blocks of the range are written synchronously together, so they could share batched submissions.
+	if (!cache_files_to_write.empty()) {
+		WriteCacheFiles(cache_files_to_write);
+	}
+}
+
+bool DiskCacheReader::TakeFailedDirectoryOutOfRotation(const string &local_cache_file) {
+	auto cur_directory_set = GetDirectorySet();
+	const auto directory_idx = cur_directory_set->FindDirectory(local_cache_file);
+	if (cur_directory_set->GetDirectoryCount() == 1 || !directory_idx.IsValid()) {
+		return false;
+	}
+	cur_directory_set->TakeOutOfRotation(directory_idx.GetIndex());
+	return true;
+}
+
+bool DiskCacheReader::ReadFromLocalCache(const LocalCacheContext &context,
+                                         const RemoteFileIdentity &remote_identity, CacheReadChunk &cache_read_chunk) {
+	const auto &local_cache_file = cache_read_chunk.local_cache_file;
+	// Segment store reads the block with one positional read, without per-block file open or timestamp update.
+	if (context.segment_store != nullptr) {
+		if (!context.segment_store->Read(StringUtil::GetFileName(local_cache_file),
+		                                 cache_read_chunk.GetAddressToReadTo(), cache_read_chunk.chunk_size)) {
+			return ReadFromPendingWrite(local_cache_file, cache_read_chunk);
+		}
+		profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+		                                     BaseProfileCollector::CacheAccess::kCacheHit);
+		cache_read_chunk.CopyBufferToRequestedMemory();
+		return true;
+	}
+
+	auto cur_lru_index = GetLruIndex(context, local_cache_file);
 
-			const string oper_id = profile_collector->GenerateOperId();
-			profile_collector->RecordOperationStart(BaseProfileCollector::IoOperation::kRead, oper_id);
-			internal_filesystem->Read(*disk_cache_handle.internal_file_handle, cache_read_chunk.GetAddressToReadTo(),
-			                          cache_read_chunk.chunk_size, cache_read_chunk.aligned_start_offset);
-			profile_collector->RecordOperationEnd(BaseProfileCollector::IoOperation::kRead, oper_id);
+	if (UseMmap()) {
+		return ReadFromMappedCacheFile(local_cache_file, remote_identity, cache_read_chunk, *cur_lru_index);
+	}
+
+	// Block is read straight into requested memory when possible, while its footer goes to a separate buffer.
+	char footer[DISK_CACHE_BLOCK_FOOTER_SIZE];
+
+	// Direct IO reads the whole cache file bypassing page cache, a short read indicates a truncated or compressed cache
+	// file.
+	if (UseDirectIo()) {
+		const auto bytes_read = DirectIoReadFile(local_cache_file, cache_read_chunk.GetAddressToReadTo(),
+		                                         cache_read_chunk.chunk_size, footer, DISK_CACHE_BLOCK_FOOTER_SIZE);
+		if (bytes_read < 0) {
+			return ReadFromPendingWrite(local_cache_file, cache_read_chunk);
+		}
+		if (!DecodeLocalCacheFile(static_cast<idx_t>(bytes_read), footer, remote_identity, cache_read_chunk)) {
+			RemoveInvalidCacheFile(local_cache_file, *cur_lru_index);
+			return false;
+		}
+		profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+		                                     BaseProfileCollector::CacheAccess::kCacheHit);
+		cache_read_chunk.CopyBufferToRequestedMemory();
+		cur_lru_index->TouchCacheFile(local_cache_file);
+		return true;
+	}
+
+	// Attempt to open the file directly, so a successfully opened file handle won't be deleted by cleanup thread and
+	// lead to data race.
+	auto file_handle = local_filesystem->OpenFile(local_cache_file, FileOpenFlags::FILE_FLAGS_READ |
+	                                                                    FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+	if (file_handle == nullptr) {
+		return ReadFromPendingWrite(local_cache_file, cache_read_chunk);
+	}
+
+	// Cache files longer than a raw block are discarded before read, since a short read throws. Bytes are read the same
+	// way as other IO engines, so cache file content is decoded in one place.
+	const idx_t file_size = static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle));
+	if (file_size > cache_read_chunk.chunk_size + DISK_CACHE_BLOCK_FOOTER_SIZE) {
+		file_handle.reset();
+		RemoveInvalidCacheFile(local_cache_file, *cur_lru_index);
+		return false;
+	}
+	const idx_t bytes_in_buffer = MinValue<idx_t>(file_size, cache_read_chunk.chunk_size);
+	local_filesystem->Read(*file_handle, cache_read_chunk.GetAddressToReadTo(), bytes_in_buffer, /*location=*/0);
+	local_filesystem->Read(*file_handle, footer, file_size - bytes_in_buffer, /*location=*/bytes_in_buffer);
+	if (!DecodeLocalCacheFile(file_size, footer, remote_identity, cache_read_chunk)) {
+		file_handle.reset();
+		RemoveInvalidCacheFile(local_cache_file, *cur_lru_index);
+		return false;
+	}
+
+	profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+	                                     BaseProfileCollector::CacheAccess::kCacheHit);
+	cache_read_chunk.CopyBufferToRequestedMemory();
+	// Access recency is tracked in the index rather than file timestamps, so cache hits don't issue metadata writes.
+	cur_lru_index->TouchCacheFile(local_cache_file);
+	return true;
+}
+
+bool DiskCacheReader::DecodeLocalCacheFile(idx_t file_size, const char *footer,
+                                           const RemoteFileIdentity &remote_identity,
+                                           CacheReadChunk &cache_read_chunk) {
+	char *buffer = cache_read_chunk.GetAddressToReadTo();
+	if (file_size == cache_read_chunk.chunk_size + DISK_CACHE_BLOCK_FOOTER_SIZE) {
+		return IsValidDiskCacheBlock(buffer, cache_read_chunk.chunk_size, footer, remote_identity);
+	}
+	if (file_size < DISK_CACHE_BLOCK_FOOTER_SIZE ||
+	    file_size > cache_read_chunk.chunk_size + DISK_CACHE_BLOCK_FOOTER_SIZE) {
+		return false;
+	}
+
+	// Otherwise the block is stored compressed, which is copied out of chunk buffer before decompressed into it; the
+	// compressed block along with its footer could overflow chunk buffer into footer buffer.
+	auto content = CreateResizeUninitializedString(file_size);
+	const idx_t bytes_in_buffer = MinValue<idx_t>(file_size, cache_read_chunk.chunk_size);
+	std::memcpy(&content[0], buffer, bytes_in_buffer);
+	std::memcpy(&content[bytes_in_buffer], footer, file_size - bytes_in_buffer);
+	const idx_t stored_length = file_size - DISK_CACHE_BLOCK_FOOTER_SIZE;
+	return DecompressCacheBlock(content.data(), stored_length, content.data() + stored_length, remote_identity,
+	                            cache_read_chunk, /*verify_checksum=*/true);
+}
+
+bool DiskCacheReader::DecompressCacheBlock(const char *stored, idx_t stored_length, const char *footer,
+                                           const RemoteFileIdentity &remote_identity, CacheReadChunk &cache_read_chunk,
+                                           bool verify_checksum) {
+	DiskCacheBlockFooter decoded_footer;
+	if (!DecodeDiskCacheBlockFooter(footer, decoded_footer) ||
+	    decoded_footer.codec != static_cast<uint8_t>(DiskCacheBlockCodec::kZstd)) {
+		return false;
+	}
+	const bool is_matched =
+	    verify_checksum
+	        ? IsValidDiskCacheBlock(stored, stored_length, footer, cache_read_chunk.chunk_size, remote_identity)
+	        : IsDiskCacheBlockFooterMatched(footer, cache_read_chunk.chunk_size, remote_identity);
+	if (!is_matched) {
+		return false;
+	}
+
+	const int64_t start_nanosec = GetSteadyNowNanoSecSinceEpoch();
+	if (!ZstdDecompress(stored, stored_length, cache_read_chunk.GetAddressToReadTo(), cache_read_chunk.chunk_size)) {
+		return false;
+	}
+	const int64_t decompression_nanosec = GetSteadyNowNanoSecSinceEpoch() - start_nanosec;
+
+	std::lock_guard<std::mutex> lck(compression_stats_mutex);
+	++compression_stats.decompressed_block_count;
+	compression_stats.decompression_nanosec += static_cast<uint64_t>(decompression_nanosec);
+	return true;
+}
+
+bool DiskCacheReader::ReadFromMappedCacheFile(const string &local_cache_file, const RemoteFileIdentity &remote_identity,
+                                              CacheReadChunk &cache_read_chunk, DiskCacheLruIndex &lru_index) {
+	auto cur_mapped_file_cache = GetMappedFileCache();
 
-			// Copy to destination buffer, if bytes are read into [content] buffer rather than user-provided buffer.
-			cache_read_chunk.CopyBufferToRequestedMemory();
+	// A mapping outlives its cache file, so it's only reused while the cache file is still tracked by index; otherwise
+	// the cache file could have been evicted, whose disk space is only reclaimed after unmap.
+	auto mapped_file = cur_mapped_file_cache->Get(local_cache_file);
+	if (mapped_file != nullptr && !lru_index.TouchCacheFile(local_cache_file)) {
+		cur_mapped_file_cache->Delete(local_cache_file);
+		mapped_file = nullptr;
+	}
+
+	const bool is_newly_mapped = mapped_file == nullptr;
+	if (is_newly_mapped) {
+		mapped_file = shared_ptr<MappedFile>(MappedFile::Open(local_cache_file));
+		if (mapped_file == nullptr) {
+			return ReadFromPendingWrite(local_cache_file, cache_read_chunk);
+		}
+	}
+
+	// Cache files are immutable once visible, so stored checksum is only verified when they get mapped; later accesses
+	// only check the footer, in case remote file has been overwritten since the cache file got mapped. Blocks stored
+	// compressed are shorter than raw ones, which are decompressed into chunk buffer on every access.
+	const char *mapped_data = mapped_file->GetData();
+	const idx_t mapped_size = mapped_file->GetSize();
+	const bool is_compressed = mapped_size != cache_read_chunk.chunk_size + DISK_CACHE_BLOCK_FOOTER_SIZE;
+	bool is_valid = false;
+	if (!is_compressed) {
+		const char *footer = mapped_data + cache_read_chunk.chunk_size;
+		is_valid = is_newly_mapped
+		               ? IsValidDiskCacheBlock(mapped_data, cache_read_chunk.chunk_size, footer, remote_identity)
+		               : IsDiskCacheBlockFooterMatched(footer, cache_read_chunk.chunk_size, remote_identity);
+	} else if (mapped_size >= DISK_CACHE_BLOCK_FOOTER_SIZE) {
+		const idx_t stored_length = mapped_size - DISK_CACHE_BLOCK_FOOTER_SIZE;
+		is_valid = DecompressCacheBlock(mapped_data, stored_length, mapped_data + stored_length, remote_identity,
+		                                cache_read_chunk, /*verify_checksum=*/is_newly_mapped);
+	}
+	if (!is_valid) {
+		if (!is_newly_mapped) {
+			cur_mapped_file_cache->Delete(local_cache_file);
+		}
+		RemoveInvalidCacheFile(local_cache_file, lru_index);
+		return false;
+	}
+	if (is_newly_mapped) {
+		cur_mapped_file_cache->Put(local_cache_file, mapped_file);
+		lru_index.TouchCacheFile(local_cache_file);
+	}
+
+	profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+	                                     BaseProfileCollector::CacheAccess::kCacheHit);
+	if (is_compressed) {
+		cache_read_chunk.CopyBufferToRequestedMemory();
+		return true;
+	}
+	// Only the requested bytes are copied from mapped memory straight into requested memory, even for partially
+	// requested chunks.
+	cache_read_chunk.CopyBufferToRequestedMemory(mapped_data);
+	return true;
+}
 
-			// Attempt to cache file locally.
-			CacheLocal(cache_read_chunk, *local_filesystem, handle, *g_on_disk_cache_directory, local_cache_file);
+vector<CacheReadChunk *> DiskCacheReader::ReadFromLocalCacheWithIoUring(const LocalCacheContext &context,
+                                                                       const RemoteFileIdentity &remote_identity,
+                                                                       vector<CacheReadChunk> &cache_read_chunks) {
+	// Opens, reads and closes for all blocks are issued in batched submissions, rather than one block after another.
+	// Each block and its footer are read in one operation into separate buffers, compressed blocks are shorter and only
+	// fill the leading bytes.
+	auto footers = CreateResizeUninitializedString(cache_read_chunks.size() * DISK_CACHE_BLOCK_FOOTER_SIZE);
+	vector<IoUringReadRequest> read_requests;
+	read_requests.reserve(cache_read_chunks.size());
+	for (idx_t idx = 0; idx < cache_read_chunks.size(); ++idx) {
+		auto &cur_chunk = cache_read_chunks[idx];
+		read_requests.emplace_back(IoUringReadRequest {
+		    .filepath = cur_chunk.local_cache_file,
+		    .buffer = cur_chunk.GetAddressToReadTo(),
+		    .length = cur_chunk.chunk_size,
+		    .trailer = &footers[idx * DISK_CACHE_BLOCK_FOOTER_SIZE],
+		    .trailer_length = DISK_CACHE_BLOCK_FOOTER_SIZE,
 		});
 	}
-	io_threads.Wait();
+	IoUringReadFiles(read_requests);
+
+	vector<CacheReadChunk *> cache_miss_chunks;
+	for (idx_t idx = 0; idx < cache_read_chunks.size(); ++idx) {
+		auto &cur_chunk = cache_read_chunks[idx];
+		const auto &cur_request = read_requests[idx];
+		if (cur_request.result == -ENOENT) {
+			if (!ReadFromPendingWrite(cur_request.filepath, cur_chunk)) {
+				cache_miss_chunks.emplace_back(&cur_chunk);
+			}
+			continue;
+		}
+		if (cur_request.result < 0) {
+			if (TakeFailedDirectoryOutOfRotation(cur_request.filepath)) {
+				cache_miss_chunks.emplace_back(&cur_chunk);
+				continue;
+			}
+			throw IOException("Fails to read cache file %s because %s", cur_request.filepath,
+			                  strerror(static_cast<int>(-cur_request.result)));
+		}
+
+		auto cur_lru_index = GetLruIndex(context, cur_request.filepath);
+		if (!DecodeLocalCacheFile(static_cast<idx_t>(cur_request.result), cur_request.trailer, remote_identity,
+		                          cur_chunk)) {
+			RemoveInvalidCacheFile(cur_request.filepath, *cur_lru_index);
+			cache_miss_chunks.emplace_back(&cur_chunk);
+			continue;
+		}
+
+		profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+		                                     BaseProfileCollector::CacheAccess::kCacheHit);
+		cur_chunk.CopyBufferToRequestedMemory();
+		cur_lru_index->TouchCacheFile(cur_request.filepath);
+	}
+	return cache_miss_chunks;
+}
+
+vector<CacheReadChunk *> DiskCacheReader::ReadFromMirrorFile(FileHandle &handle,
+                                                            const RemoteFileIdentity &remote_identity,
+                                                            vector<CacheReadChunk> &cache_read_chunks) {
+	auto cur_mirror_store = GetMirrorStore();
+	const auto mirror_key = GetMirrorKey(GetFileIdentity(handle), remote_identity.version_hash);
+
+	vector<CacheReadChunk *> cached_chunks;
+	vector<CacheReadChunk *> cache_miss_chunks;
+	for (auto &cur_chunk : cache_read_chunks) {
+		if (cur_mirror_store->IsBlockCached(mirror_key, cur_chunk.aligned_start_offset)) {
+			cached_chunks.emplace_back(&cur_chunk);
+			continue;
+		}
+		if (!ReadFromPendingWrite(cur_chunk.local_cache_file, cur_chunk)) {
+			cache_miss_chunks.emplace_back(&cur_chunk);
+		}
+	}
+
+	// Consecutive cached blocks reside at their native offsets in the mirror file, so they're read at once.
+	auto local_read_ranges = CoalesceCacheReadChunks(cached_chunks, NumericLimits<idx_t>::Maximum());
+	for (auto &cur_range : local_read_ranges) {
+		// Blocks could have been evicted after existence check, which are treated as cache misses.
+		if (!cur_mirror_store->Read(mirror_key, cur_range.start_offset, cur_range.size,
+		                            cur_range.GetAddressToReadTo())) {
+			cache_miss_chunks.insert(cache_miss_chunks.end(), cur_range.chunks.begin(), cur_range.chunks.end());
+			continue;
+		}
+		cur_range.CopyBufferToRequestedMemory();
+		for (idx_t idx = 0; idx < cur_range.chunks.size(); ++idx) {
+			profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+			                                     BaseProfileCollector::CacheAccess::kCacheHit);
+		}
+	}
+
+	// Cache misses are fetched in file offset order, so consecutive ones get merged into one remote request.
+	std::sort(cache_miss_chunks.begin(), cache_miss_chunks.end(),
+	          [](const CacheReadChunk *lhs, const CacheReadChunk *rhs) {
+		          return lhs->aligned_start_offset < rhs->aligned_start_offset;
+	          });
+	return cache_miss_chunks;
+}
+
+bool DiskCacheReader::ReadFromPendingWrite(const string &local_cache_file, CacheReadChunk &cache_read_chunk) {
+	// The block could have been fetched, but its cache file is still pending to write.
+	auto pending_content = write_back_queue->GetPendingContent(local_cache_file);
+	if (pending_content == nullptr) {
+		return false;
+	}
+	profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+	                                     BaseProfileCollector::CacheAccess::kCacheHit);
+	cache_read_chunk.CopyBufferToRequestedMemory(*pending_content);
+	return true;
+}
+
+bool DiskCacheReader::IsCachedLocally(const string &local_cache_file) const {
+	if (UseSegmentLayout()) {
+		return GetSegmentStore()->Contains(StringUtil::GetFileName(local_cache_file));
+	}
+	if (UseMirrorLayout()) {
+		const auto mirror_block = GetMirrorBlock(local_cache_file);
+		return GetMirrorStore()->IsBlockCached(mirror_block.first, mirror_block.second);
+	}
+	return local_filesystem->FileExists(local_cache_file);
 }
 
 void DiskCacheReader::ClearCache() {
-	local_filesystem->RemoveDirectory(*g_on_disk_cache_directory);
-	// Create an empty directory, otherwise later read access errors.
-	local_filesystem->CreateDirectory(*g_on_disk_cache_directory);
+	// Wait for pending writes, otherwise they could re-create cache files after clearance; and pending deletions,
+	// otherwise they could delete cache files re-created after clearance.
+	Flush();
+	for (const auto &cur_directory : GetDirectorySet()->GetDirectories()) {
+		local_filesystem->RemoveDirectory(cur_directory);
+		// Create an empty directory, otherwise later read access errors.
+		local_filesystem->CreateDirectory(cur_directory);
+		GetLruIndex(cur_directory)->Clear();
+	}
+	GetMappedFileCache()->Clear();
+	if (UseSegmentLayout()) {
+		GetSegmentStore()->Clear();
+	}
+	if (UseMirrorLayout()) {
+		GetMirrorStore()->Clear();
+	}
 }
 
 void DiskCacheReader::ClearCache(const string &fname) {
-	const string cache_file_prefix = GetLocalCacheFilePrefix(fname);
-	local_filesystem->ListFiles(*g_on_disk_cache_directory, [&](const string &cur_file, bool /*unused*/) {
-		if (StringUtil::StartsWith(cur_file, cache_file_prefix)) {
-			const string filepath = StringUtil::Format("%s/%s", *g_on_disk_cache_directory, cur_file);
-			local_filesystem->RemoveFile(filepath);
-		}
-	});
+	write_back_queue->Flush();
+	// Cache files for all versions of the remote file share the filename prefix.
+	const string cache_file_prefix = GetCacheFnamePrefix(fname);
+	if (UseSegmentLayout()) {
+		GetSegmentStore()->RemoveByPrefix(cache_file_prefix);
+		return;
+	}
+	if (UseMirrorLayout()) {
+		GetMirrorStore()->RemoveByPrefix(cache_file_prefix);
+		return;
+	}
+	// Blocks of one remote file are striped across all directories.
+	for (const auto &cur_directory : GetDirectorySet()->GetDirectories()) {
+		const auto cache_filepath_prefix = GetLocalCacheFile(cur_directory, cache_file_prefix);
+		GetMappedFileCache()->Clear(
+		    [&cache_filepath_prefix](const string &key) { return StringUtil::StartsWith(key, cache_filepath_prefix); });
+		RemoveEvictedCacheFiles(GetLruIndex(cur_directory)->RemoveCacheFilesWithPrefix(cache_filepath_prefix));
+	}
 }
 
 } // namespace duckdb
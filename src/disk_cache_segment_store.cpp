@@ -0,0 +1,427 @@
+#include "disk_cache_segment_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache_filesystem_config.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "resize_uninitialized.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Segment files are named as `<segment-id>.cache_httpfs_segment` under cache directory.
+constexpr const char *SEGMENT_FILE_SUFFIX = ".cache_httpfs_segment";
+constexpr mode_t SEGMENT_FILE_MODE = 0644;
+
+// Magic number at the start of every record, used to detect torn or garbage records.
+constexpr uint32_t SEGMENT_RECORD_MAGIC = 0x47534843; // "CHSG"
+
+struct SegmentRecordHeader {
+	uint32_t magic = 0;
+	uint32_t key_length = 0;
+	uint64_t data_length = 0;
+};
+static_assert(sizeof(SegmentRecordHeader) == 16, "Segment record header is expected to be 16 bytes.");
+
+idx_t GetRecordSize(idx_t key_length, idx_t data_length) {
+	return sizeof(SegmentRecordHeader) + key_length + data_length;
+}
+
+string GetSegmentFilepath(const string &cache_directory, idx_t segment_id) {
+	return StringUtil::Format("%s/%llu%s", cache_directory, segment_id, SEGMENT_FILE_SUFFIX);
+}
+
+// Delete the given segment files, which could have been deleted by cache directory clearance.
+void RemoveSegmentFiles(const vector<string> &filepaths) {
+	for (const auto &cur_filepath : filepaths) {
+		if (std::remove(cur_filepath.data()) != 0 && errno != ENOENT) {
+			throw IOException("Fails to delete segment file %s because %s", cur_filepath, strerror(errno));
+		}
+	}
+}
+
+} // namespace
+
+DiskCacheSegmentStore::DiskCacheSegmentStore(std::string cache_directory_p, idx_t segment_size_p,
+                                             idx_t capacity_bytes_p)
+    : cache_directory(std::move(cache_directory_p)), segment_size(segment_size_p),
+      local_filesystem(LocalFileSystem::CreateLocal()), capacity_bytes(capacity_bytes_p),
+      compaction_thread_pool(/*thread_num=*/1, "segment_compact") {
+	LoadExistingSegments();
+}
+
+DiskCacheSegmentStore::~DiskCacheSegmentStore() {
+	WaitForCompaction();
+}
+
+bool DiskCacheSegmentStore::IsSegmentFile(const std::string &fname) {
+	if (!StringUtil::EndsWith(fname, SEGMENT_FILE_SUFFIX)) {
+		return false;
+	}
+	const idx_t id_length = fname.length() - strlen(SEGMENT_FILE_SUFFIX);
+	if (id_length == 0) {
+		return false;
+	}
+	return std::all_of(fname.begin(), fname.begin() + id_length, [](char c) { return c >= '0' && c <= '9'; });
+}
+
+void DiskCacheSegmentStore::Append(const std::string &key, const char *data, idx_t length, bool sync) {
+	AppendImpl(key, data, length, sync, /*expected_segment=*/nullptr);
+}
+
+void DiskCacheSegmentStore::AppendImpl(const std::string &key, const char *data, idx_t length, bool sync,
+                                       const Segment *expected_segment) {
+	const auto is_expected_location = [&]() {
+		if (expected_segment == nullptr) {
+			return true;
+		}
+		auto iter = index.find(key);
+		return iter != index.end() && iter->second.segment.get() == expected_segment;
+	};
+
+	// Assemble the whole record, so it's written with one syscall.
+	const idx_t record_size = GetRecordSize(key.length(), length);
+	auto record = CreateResizeUninitializedString(record_size);
+	const SegmentRecordHeader header {
+	    .magic = SEGMENT_RECORD_MAGIC,
+	    .key_length = static_cast<uint32_t>(key.length()),
+	    .data_length = static_cast<uint64_t>(length),
+	};
+	memcpy(&record[0], &header, sizeof(header));
+	memcpy(&record[sizeof(header)], key.data(), key.length());
+	memcpy(&record[sizeof(header) + key.length()], data, length);
+
+	// Reserve space in the active segment, so concurrent appends write to disjoint ranges without holding the lock.
+	shared_ptr<Segment> segment;
+	idx_t record_offset = 0;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		if (!is_expected_location()) {
+			return;
+		}
+		if (active_segment == nullptr ||
+		    (active_segment->size > 0 && active_segment->size + record_size > segment_size)) {
+			CreateActiveSegmentImpl();
+		}
+		segment = active_segment;
+		record_offset = segment->size;
+		segment->size += record_size;
+		used_bytes += record_size;
+	}
+
+	local_filesystem->Write(*segment->file_handle, const_cast<char *>(record.data()), record_size, record_offset);
+	if (sync) {
+		segment->file_handle->Sync();
+	}
+
+	// Publish the record only after it's written, so readers never observe partial content.
+	vector<string> segment_files_to_delete;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		// The segment could have been evicted or deleted by clearance during write, which leaves the record
+		// unreferenced.
+		auto segment_iter = segments.find(segment->segment_id);
+		if (segment_iter == segments.end() || segment_iter->second != segment) {
+			return;
+		}
+		if (!is_expected_location()) {
+			return;
+		}
+		auto iter = index.find(key);
+		if (iter != index.end()) {
+			RemoveImpl(iter, segment_files_to_delete);
+		}
+		index.emplace(key, Location {
+		                       .segment = segment,
+		                       .record_offset = record_offset,
+		                       .data_offset = record_offset + sizeof(SegmentRecordHeader) + key.length(),
+		                       .length = length,
+		                   });
+		segment->live_bytes += record_size;
+		segment->keys.emplace_back(key);
+		EvictImpl(segment_files_to_delete);
+	}
+	RemoveSegmentFiles(segment_files_to_delete);
+}
+
+bool DiskCacheSegmentStore::Read(const std::string &key, char *buffer, idx_t length) const {
+	Location location;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		auto iter = index.find(key);
+		if (iter == index.end()) {
+			return false;
+		}
+		location = iter->second;
+	}
+	if (location.length != length) {
+		return false;
+	}
+
+	// Segment file handle is kept alive by [location], even if the segment gets deleted concurrently.
+	local_filesystem->Read(*location.segment->file_handle, buffer, length, location.data_offset);
+	return true;
+}
+
+bool DiskCacheSegmentStore::Contains(const std::string &key) const {
+	std::lock_guard<std::mutex> lck(mu);
+	return index.find(key) != index.end();
+}
+
+void DiskCacheSegmentStore::RemoveByPrefix(const std::string &prefix) {
+	vector<string> segment_files_to_delete;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		vector<std::string> keys_to_remove;
+		for (const auto &cur_entry : index) {
+			if (StringUtil::StartsWith(cur_entry.first, prefix)) {
+				keys_to_remove.emplace_back(cur_entry.first);
+			}
+		}
+		for (const auto &cur_key : keys_to_remove) {
+			auto iter = index.find(cur_key);
+			if (iter != index.end()) {
+				RemoveImpl(iter, segment_files_to_delete);
+			}
+		}
+	}
+	RemoveSegmentFiles(segment_files_to_delete);
+}
+
+void DiskCacheSegmentStore::Clear() {
+	vector<string> segment_files_to_delete;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		for (const auto &cur_segment : segments) {
+			segment_files_to_delete.emplace_back(cur_segment.second->filepath);
+		}
+		segments.clear();
+		index.clear();
+		active_segment = nullptr;
+		used_bytes = 0;
+	}
+	RemoveSegmentFiles(segment_files_to_delete);
+}
+
+void DiskCacheSegmentStore::SetCapacityBytes(idx_t capacity_bytes_p) {
+	std::lock_guard<std::mutex> lck(mu);
+	capacity_bytes = capacity_bytes_p;
+}
+
+void DiskCacheSegmentStore::WaitForCompaction() {
+	compaction_thread_pool.Wait();
+}
+
+vector<DiskCacheSegmentStore::EntryInfo> DiskCacheSegmentStore::GetEntries() const {
+	std::lock_guard<std::mutex> lck(mu);
+	vector<EntryInfo> entries;
+	entries.reserve(index.size());
+	for (const auto &cur_entry : index) {
+		entries.emplace_back(EntryInfo {
+		    .key = cur_entry.first,
+		    .segment_filepath = cur_entry.second.segment->filepath,
+		});
+	}
+	return entries;
+}
+
+idx_t DiskCacheSegmentStore::GetCapacityBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return capacity_bytes;
+}
+
+idx_t DiskCacheSegmentStore::GetUsedBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return used_bytes;
+}
+
+idx_t DiskCacheSegmentStore::GetEntryCount() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return index.size();
+}
+
+idx_t DiskCacheSegmentStore::GetSegmentCount() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return segments.size();
+}
+
+void DiskCacheSegmentStore::CreateActiveSegmentImpl() {
+	// Segment ids are only allocated within the process, so segment file is created exclusively, and the next id is
+	// taken if another process sharing the cache directory has created a segment with the same id.
+	auto segment = make_shared_ptr<Segment>();
+	while (true) {
+		segment->segment_id = next_segment_id++;
+		segment->filepath = GetSegmentFilepath(cache_directory, segment->segment_id);
+		const int fd = open(segment->filepath.data(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, SEGMENT_FILE_MODE);
+		if (fd >= 0) {
+			close(fd);
+			break;
+		}
+		if (errno != EEXIST) {
+			throw IOException("Fails to create segment file %s because %s", segment->filepath, strerror(errno));
+		}
+	}
+	segment->file_handle = local_filesystem->OpenFile(segment->filepath, FileOpenFlags::FILE_FLAGS_READ |
+	                                                                         FileOpenFlags::FILE_FLAGS_WRITE);
+	segments.emplace(segment->segment_id, segment);
+	active_segment = std::move(segment);
+}
+
+void DiskCacheSegmentStore::LoadExistingSegments() {
+	vector<idx_t> segment_ids;
+	local_filesystem->ListFiles(cache_directory, [&segment_ids](const string &fname, bool /*unused*/) {
+		if (IsSegmentFile(fname)) {
+			const idx_t id_length = fname.length() - strlen(SEGMENT_FILE_SUFFIX);
+			segment_ids.emplace_back(StringUtil::ToUnsigned(fname.substr(0, id_length)));
+		}
+	});
+	std::sort(segment_ids.begin(), segment_ids.end());
+
+	std::unique_lock<std::mutex> lck(mu);
+	for (const idx_t cur_segment_id : segment_ids) {
+		auto segment = make_shared_ptr<Segment>();
+		segment->segment_id = cur_segment_id;
+		segment->filepath = GetSegmentFilepath(cache_directory, cur_segment_id);
+		segment->file_handle = local_filesystem->OpenFile(segment->filepath, FileOpenFlags::FILE_FLAGS_READ);
+		segment->size = static_cast<idx_t>(local_filesystem->GetFileSize(*segment->file_handle));
+
+		// Records are scanned in append order, so later records override earlier ones for the same key.
+		idx_t record_offset = 0;
+		while (record_offset + sizeof(SegmentRecordHeader) <= segment->size) {
+			SegmentRecordHeader header;
+			local_filesystem->Read(*segment->file_handle, &header, sizeof(header), record_offset);
+			const idx_t record_size = GetRecordSize(header.key_length, header.data_length);
+			if (header.magic != SEGMENT_RECORD_MAGIC || header.key_length == 0 ||
+			    record_offset + record_size > segment->size) {
+				break;
+			}
+			string key(header.key_length, '\0');
+			local_filesystem->Read(*segment->file_handle, &key[0], header.key_length,
+			                       record_offset + sizeof(SegmentRecordHeader));
+
+			auto iter = index.find(key);
+			if (iter != index.end()) {
+				auto &stale_location = iter->second;
+				stale_location.segment->live_bytes -=
+				    stale_location.data_offset + stale_location.length - stale_location.record_offset;
+				index.erase(iter);
+			}
+			index.emplace(key, Location {
+			                       .segment = segment,
+			                       .record_offset = record_offset,
+			                       .data_offset = record_offset + sizeof(SegmentRecordHeader) + header.key_length,
+			                       .length = header.data_length,
+			                   });
+			segment->live_bytes += record_size;
+			segment->keys.emplace_back(std::move(key));
+			record_offset += record_size;
+		}
+
+		// Bytes after the last valid record are left unreferenced, which are reclaimed along with the segment.
+		used_bytes += segment->size;
+		next_segment_id = cur_segment_id + 1;
+		segments.emplace(cur_segment_id, std::move(segment));
+	}
+	vector<string> segment_files_to_delete;
+	EvictImpl(segment_files_to_delete);
+	lck.unlock();
+	RemoveSegmentFiles(segment_files_to_delete);
+}
+
+void DiskCacheSegmentStore::RemoveImpl(std::unordered_map<std::string, Location>::iterator iter,
+                                       vector<std::string> &segment_files_to_delete) {
+	auto segment = iter->second.segment;
+	segment->live_bytes -= iter->second.data_offset + iter->second.length - iter->second.record_offset;
+	index.erase(iter);
+
+	// Active segment is still being appended, and segment under compaction will be deleted afterwards.
+	if (segment == active_segment || segment->compacting) {
+		return;
+	}
+	if (segment->live_bytes == 0) {
+		DeleteSegmentImpl(segment, segment_files_to_delete);
+		return;
+	}
+	if (segment->live_bytes < segment->size * DISK_CACHE_SEGMENT_COMPACTION_RATIO) {
+		segment->compacting = true;
+		compaction_thread_pool.Push([this, segment]() { CompactSegment(segment); });
+	}
+}
+
+void DiskCacheSegmentStore::EvictImpl(vector<std::string> &segment_files_to_delete) {
+	while (capacity_bytes > 0 && used_bytes > capacity_bytes && segments.size() > 1) {
+		auto oldest_segment = segments.begin()->second;
+		if (oldest_segment == active_segment) {
+			break;
+		}
+		DeleteSegmentImpl(oldest_segment, segment_files_to_delete);
+	}
+}
+
+void DiskCacheSegmentStore::DeleteSegmentImpl(const shared_ptr<Segment> &segment,
+                                              vector<std::string> &segment_files_to_delete) {
+	for (const auto &cur_key : segment->keys) {
+		auto iter = index.find(cur_key);
+		if (iter != index.end() && iter->second.segment == segment) {
+			index.erase(iter);
+		}
+	}
+	used_bytes -= segment->size;
+	segments.erase(segment->segment_id);
+	if (active_segment == segment) {
+		active_segment = nullptr;
+	}
+	segment_files_to_delete.emplace_back(segment->filepath);
+}
+
+void DiskCacheSegmentStore::CompactSegment(shared_ptr<Segment> segment) {
+	vector<std::pair<std::string, Location>> live_records;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		for (const auto &cur_key : segment->keys) {
+			auto iter = index.find(cur_key);
+			if (iter != index.end() && iter->second.segment == segment) {
+				live_records.emplace_back(cur_key, iter->second);
+			}
+		}
+	}
+
+	try {
+		for (const auto &cur_record : live_records) {
+			const auto &location = cur_record.second;
+			auto content = CreateResizeUninitializedString(location.length);
+			local_filesystem->Read(*segment->file_handle, const_cast<char *>(content.data()), location.length,
+			                       location.data_offset);
+			AppendImpl(cur_record.first, content.data(), location.length, /*sync=*/false, segment.get());
+		}
+	} catch (...) {
+		// Compaction is best-effort, leave the segment as it is and retry at the next removal.
+		std::lock_guard<std::mutex> lck(mu);
+		segment->compacting = false;
+		return;
+	}
+
+	// Live records have been rewritten, records left in the segment are either removed or updated concurrently.
+	vector<string> segment_files_to_delete;
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		auto segment_iter = segments.find(segment->segment_id);
+		if (segment_iter != segments.end() && segment_iter->second == segment) {
+			DeleteSegmentImpl(segment, segment_files_to_delete);
+		}
+	}
+	RemoveSegmentFiles(segment_files_to_delete);
+}
+
+} // namespace duckdb
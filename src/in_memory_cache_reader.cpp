@@ -1,15 +1,16 @@
 #include "in_memory_cache_reader.hpp"
 
+#include "cache_read_chunk.hpp"
 #include "crypto.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/thread.hpp"
 #include "duckdb/common/types/uuid.hpp"
+#include "scope_guard.hpp"
 #include "utils/include/resize_uninitialized.hpp"
 #include "utils/include/filesystem_utils.hpp"
-#include "utils/include/thread_pool.hpp"
-#include "utils/include/thread_utils.hpp"
 
 #include <cstdint>
+#include <iterator>
 #include <utility>
 #include <utime.h>
 
@@ -17,133 +18,198 @@ namespace duckdb {
 
 namespace {
 
-// All read requests are split into chunks, and executed in parallel.
-// A [CacheReadChunk] represents a chunked IO request and its corresponding partial IO request.
-struct CacheReadChunk {
-	// Requested memory address and file offset to read from for current chunk.
-	char *requested_start_addr = nullptr;
-	idx_t requested_start_offset = 0;
-	// Block size aligned [requested_start_offset].
-	idx_t aligned_start_offset = 0;
-
-	// Number of bytes for the chunk for IO operations, apart from the last chunk it's always cache block size.
-	idx_t chunk_size = 0;
-
-	// Number of bytes to copy from [content] to requested memory address.
-	idx_t bytes_to_copy = 0;
-
-	// Copy from [content] to application-provided buffer.
-	void CopyBufferToRequestedMemory(const std::string &content) {
-		const idx_t delta_offset = requested_start_offset - aligned_start_offset;
-		std::memmove(requested_start_addr, const_cast<char *>(content.data()) + delta_offset, bytes_to_copy);
-	}
-};
+// Get version tag of the remote file behind [handle], which cache blocks are keyed by.
+uint64_t GetVersionTag(FileHandle &handle) {
+	return handle.file_system.Cast<CacheFileSystem>().GetFileMetadata(handle)->version_tag;
+}
+
+// Get cache block key for [cache_read_chunk] of the remote file behind [handle] at [version_tag], which shares file
+// identity with the handle rather than copying remote path.
+InMemCacheBlock GetBlockKey(FileHandle &handle, uint64_t version_tag, const CacheReadChunk &cache_read_chunk) {
+	InMemCacheBlock block_key;
+	block_key.file_identity = handle.Cast<CacheFileSystemHandle>().GetCacheFileIdentity();
+	block_key.version_tag = version_tag;
+	block_key.start_off = cache_read_chunk.aligned_start_offset;
+	block_key.blk_size = cache_read_chunk.chunk_size;
+	return block_key;
+}
 
 } // namespace
 
 void InMemoryCacheReader::ReadAndCache(FileHandle &handle, char *buffer, idx_t requested_start_offset,
                                        idx_t requested_bytes_to_read, idx_t file_size) {
-	std::call_once(cache_init_flag, [this]() {
-		cache = make_uniq<InMemCache>(g_max_in_mem_cache_block_count, g_in_mem_cache_block_timeout_millisec);
-	});
+	InitCacheIfNecessary();
 
-	const idx_t block_size = g_cache_block_size;
-	const idx_t aligned_start_offset = requested_start_offset / block_size * block_size;
-	const idx_t aligned_last_chunk_offset =
-	    (requested_start_offset + requested_bytes_to_read) / block_size * block_size;
-	const idx_t subrequest_count = (aligned_last_chunk_offset - aligned_start_offset) / block_size + 1;
-
-	// Indicate the meory address to copy to for each IO operation
-	char *addr_to_write = buffer;
-	// Used to calculate bytes to copy for last chunk.
-	idx_t already_read_bytes = 0;
-	// Threads to parallelly perform IO.
-	ThreadPool io_threads(GetThreadCountForSubrequests(subrequest_count));
-
-	// To improve IO performance, we split requested bytes (after alignment) into
-	// multiple chunks and fetch them in parallel.
-	for (idx_t io_start_offset = aligned_start_offset; io_start_offset <= aligned_last_chunk_offset;
-	     io_start_offset += block_size) {
-		CacheReadChunk cache_read_chunk;
-		cache_read_chunk.requested_start_addr = addr_to_write;
-		cache_read_chunk.aligned_start_offset = io_start_offset;
-		cache_read_chunk.requested_start_offset = requested_start_offset;
-
-		// Implementation-wise, middle chunks are easy to handle -- read in [block_size], and copy the whole chunk to
-		// the requested memory address; but the first and last chunk require special handling.
-		// For first chunk, requested start offset might not be aligned with block size; for the last chunk, we might
-		// not need to copy the whole [block_size] of memory.
-		//
-		// Case-1: If there's only one chunk, which serves as both the first chunk and the last one.
-		if (io_start_offset == aligned_start_offset && io_start_offset == aligned_last_chunk_offset) {
-			cache_read_chunk.chunk_size = MinValue<idx_t>(block_size, file_size - io_start_offset);
-			cache_read_chunk.bytes_to_copy = requested_bytes_to_read;
-		}
-		// Case-2: First chunk.
-		else if (io_start_offset == aligned_start_offset) {
-			const idx_t delta_offset = requested_start_offset - aligned_start_offset;
-			addr_to_write += block_size - delta_offset;
-			already_read_bytes += block_size - delta_offset;
-
-			cache_read_chunk.chunk_size = block_size;
-			cache_read_chunk.bytes_to_copy = block_size - delta_offset;
+	auto cache_read_chunks = SplitIntoCacheReadChunks(buffer, requested_start_offset, requested_bytes_to_read,
+	                                                  file_size, g_cache_block_size);
+	const uint64_t version_tag = GetVersionTag(handle);
+	const bool footer_prefetch_eligible = handle.Cast<CacheFileSystemHandle>().IsFooterPrefetchEligible();
+
+	// Probe cache for all chunks on the caller thread, cache hits are served directly without dispatching to IO
+	// executor, so a warm read only costs a hash lookup and a memory copy.
+	vector<CacheReadChunk *> cache_miss_chunks;
+	for (auto &cur_chunk : cache_read_chunks) {
+		const auto block_key = GetBlockKey(handle, version_tag, cur_chunk);
+		auto cache_block = GetCacheForBlock(block_key, footer_prefetch_eligible, file_size).Get(block_key);
+		if (cache_block == nullptr) {
+			cache_miss_chunks.emplace_back(&cur_chunk);
+			continue;
 		}
-		// Case-3: Last chunk.
-		else if (io_start_offset == aligned_last_chunk_offset) {
-			cache_read_chunk.chunk_size = MinValue<idx_t>(block_size, file_size - io_start_offset);
-			cache_read_chunk.bytes_to_copy = requested_bytes_to_read - already_read_bytes;
+		profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+		                                     BaseProfileCollector::CacheAccess::kCacheHit);
+		cur_chunk.CopyBufferToRequestedMemory(*cache_block);
+	}
+
+	// Fallback to remote access then in-memory cache write for cache misses.
+	FetchCacheMisses(handle, version_tag, std::move(cache_miss_chunks), file_size, /*skip_in_flight=*/false);
+}
+
+void InMemoryCacheReader::Prefetch(FileHandle &handle, idx_t start_offset, idx_t bytes_to_read, idx_t file_size) {
+	InitCacheIfNecessary();
+
+	// Prefetched blocks are only placed into in-memory cache, so read into a scratch buffer.
+	auto buffer = CreateResizeUninitializedString(bytes_to_read);
+	auto cache_read_chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), start_offset, bytes_to_read,
+	                                                  file_size, g_cache_block_size);
+	const uint64_t version_tag = GetVersionTag(handle);
+	const bool footer_prefetch_eligible = handle.Cast<CacheFileSystemHandle>().IsFooterPrefetchEligible();
+
+	vector<CacheReadChunk *> cache_miss_chunks;
+	for (auto &cur_chunk : cache_read_chunks) {
+		const auto block_key = GetBlockKey(handle, version_tag, cur_chunk);
+		if (GetCacheForBlock(block_key, footer_prefetch_eligible, file_size).Get(block_key) == nullptr) {
+			cache_miss_chunks.emplace_back(&cur_chunk);
 		}
-		// Case-4: Middle chunks.
-		else {
-			addr_to_write += block_size;
-			already_read_bytes += block_size;
+	}
+	// Prefetch runs on IO threads, which never wait for blocks led by others, since their fetches could be queued
+	// behind the waiting IO thread. Prefetch is best-effort, so such blocks are skipped.
+	FetchCacheMisses(handle, version_tag, std::move(cache_miss_chunks), file_size, /*skip_in_flight=*/true);
+}
+
+namespace {
+
+// Min number of blocks each cache shard is able to hold, otherwise a small budget split into too many shards deviates
+// too much from LRU eviction.
+constexpr idx_t MIN_BLOCKS_PER_CACHE_SHARD = 4;
+
+// Get the number of shards for in-memory cache with [cache_bytes] budget.
+idx_t GetShardCount(idx_t cache_bytes) {
+	const idx_t max_shard_count = cache_bytes / (g_cache_block_size * MIN_BLOCKS_PER_CACHE_SHARD);
+	return MaxValue<idx_t>(MinValue<idx_t>(g_cache_shard_count, max_shard_count), 1);
+}
 
-			cache_read_chunk.bytes_to_copy = block_size;
-			cache_read_chunk.chunk_size = block_size;
+} // namespace
+
+void InMemoryCacheReader::InitCacheIfNecessary() {
+	std::call_once(cache_init_flag, [this]() {
+		// Blocks are weighed by their actual buffer capacity, so the overall memory consumption is capped by the byte
+		// budget, which is split between footer region and the rest.
+		auto block_weigher = [](const string &block) {
+			return block.capacity();
+		};
+		// A footer region unable to hold a single block would never cache anything, so footer blocks share the data
+		// region instead.
+		idx_t footer_cache_bytes = static_cast<idx_t>(g_max_in_mem_cache_bytes * IN_MEM_FOOTER_CACHE_RATIO);
+		if (footer_cache_bytes < g_cache_block_size) {
+			footer_cache_bytes = 0;
 		}
+		const idx_t data_cache_bytes = MaxValue<idx_t>(g_max_in_mem_cache_bytes - footer_cache_bytes, 1);
+		cache = make_uniq<InMemCache>(GetShardCount(data_cache_bytes), /*max_entries=*/0,
+		                              g_in_mem_cache_block_timeout_millisec, data_cache_bytes, block_weigher);
+		if (footer_cache_bytes > 0) {
+			footer_cache =
+			    make_uniq<InMemCache>(GetShardCount(footer_cache_bytes), /*max_entries=*/0,
+			                          g_in_mem_cache_block_timeout_millisec, footer_cache_bytes, block_weigher);
+		}
+	});
+}
 
-		// Update read offset for next chunk read.
-		requested_start_offset = io_start_offset + block_size;
-
-		// Perform read operation in parallel.
-		io_threads.Push([this, &handle, block_size, cache_read_chunk = std::move(cache_read_chunk)]() mutable {
-			SetThreadName("RdCachRdThd");
-
-			// Check local cache first, see if we could do a cached read.
-			InMemCacheBlock block_key;
-			block_key.fname = handle.GetPath();
-			block_key.start_off = cache_read_chunk.aligned_start_offset;
-			block_key.blk_size = cache_read_chunk.chunk_size;
-			auto cache_block = cache->Get(block_key);
-
-			if (cache_block != nullptr) {
-				profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
-				                                     BaseProfileCollector::CacheAccess::kCacheHit);
-				cache_read_chunk.CopyBufferToRequestedMemory(*cache_block);
-				return;
+InMemoryCacheReader::InMemCache &InMemoryCacheReader::GetCacheForBlock(const InMemCacheBlock &block_key,
+                                                                       bool footer_prefetch_eligible, idx_t file_size) {
+	if (footer_cache != nullptr && IsFooterBlock(footer_prefetch_eligible, block_key.start_off, file_size)) {
+		return *footer_cache;
+	}
+	return *cache;
+}
+
+void InMemoryCacheReader::FetchCacheMisses(FileHandle &handle, uint64_t version_tag,
+                                           vector<CacheReadChunk *> cache_miss_chunks, idx_t file_size,
+                                           bool skip_in_flight) {
+	// Concurrent misses on the same block are deduplicated, only the first requester fetches the block while others
+	// wait for its completion.
+	while (!cache_miss_chunks.empty()) {
+		vector<CacheReadChunk *> chunks_to_fetch;
+		vector<std::pair<CacheReadChunk *, shared_ptr<InFlightBlocks::Flight>>> chunks_to_wait;
+		for (auto *cur_chunk : cache_miss_chunks) {
+			auto join_res = in_flight_blocks.Join(GetBlockKey(handle, version_tag, *cur_chunk));
+			if (join_res.is_leader) {
+				chunks_to_fetch.emplace_back(cur_chunk);
+			} else if (!skip_in_flight) {
+				chunks_to_wait.emplace_back(cur_chunk, std::move(join_res.flight));
 			}
+		}
 
-			// We suffer a cache loss, fallback to remote access then local filesystem write.
+		// Consecutive cache misses are merged into one remote range request.
+		auto remote_read_ranges = CoalesceCacheReadChunks(chunks_to_fetch, g_max_remote_request_size);
+		ExecuteRemoteReadRanges(remote_read_ranges,
+		                        [this, &handle, version_tag, file_size](RemoteReadRange &remote_read_range) {
+			                        FetchAndCacheInMem(handle, version_tag, remote_read_range, file_size);
+		                        });
+
+		// Wait for blocks fetched by other requesters, retry by ourselves if they fail.
+		cache_miss_chunks.clear();
+		for (auto &cur_chunk_to_wait : chunks_to_wait) {
+			auto *cur_chunk = cur_chunk_to_wait.first;
+			auto block = in_flight_blocks.Wait(*cur_chunk_to_wait.second);
+			if (block == nullptr) {
+				cache_miss_chunks.emplace_back(cur_chunk);
+				continue;
+			}
 			profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
-			                                     BaseProfileCollector::CacheAccess::kCacheMiss);
-			auto content = CreateResizeUninitializedString(cache_read_chunk.chunk_size);
-			auto &in_mem_cache_handle = handle.Cast<CacheFileSystemHandle>();
-			auto *internal_filesystem = in_mem_cache_handle.GetInternalFileSystem();
-
-			const string oper_id = profile_collector->GenerateOperId();
-			profile_collector->RecordOperationStart(BaseProfileCollector::IoOperation::kRead, oper_id);
-			internal_filesystem->Read(*in_mem_cache_handle.internal_file_handle, const_cast<char *>(content.data()),
-			                          content.length(), cache_read_chunk.aligned_start_offset);
-			profile_collector->RecordOperationEnd(BaseProfileCollector::IoOperation::kRead, oper_id);
-
-			// Copy to destination buffer.
-			cache_read_chunk.CopyBufferToRequestedMemory(content);
-
-			// Attempt to cache file locally.
-			cache->Put(std::move(block_key), make_shared_ptr<std::string>(std::move(content)));
-		});
+			                                     BaseProfileCollector::CacheAccess::kCacheDedupMiss);
+			cur_chunk->CopyBufferToRequestedMemory(*block);
+		}
+	}
+}
+
+void InMemoryCacheReader::FetchAndCacheInMem(FileHandle &handle, uint64_t version_tag,
+                                             RemoteReadRange &remote_read_range, idx_t file_size) {
+	vector<InMemCacheBlock> block_keys;
+	block_keys.reserve(remote_read_range.chunks.size());
+	for (const auto *cur_chunk : remote_read_range.chunks) {
+		block_keys.emplace_back(GetBlockKey(handle, version_tag, *cur_chunk));
+	}
+
+	// Unblock requesters waiting for blocks led by current request on failure, which retry by themselves.
+	idx_t completed_chunk_count = 0;
+	SCOPE_EXIT {
+		for (idx_t idx = completed_chunk_count; idx < block_keys.size(); ++idx) {
+			in_flight_blocks.Complete(block_keys[idx], []() { return nullptr; });
+		}
+	};
+
+	auto &in_mem_cache_handle = handle.Cast<CacheFileSystemHandle>();
+	auto *internal_filesystem = in_mem_cache_handle.GetInternalFileSystem();
+
+	const string oper_id = profile_collector->GenerateOperId();
+	profile_collector->RecordOperationStart(BaseProfileCollector::IoOperation::kRead, oper_id);
+	internal_filesystem->Read(*in_mem_cache_handle.internal_file_handle, remote_read_range.GetAddressToReadTo(),
+	                          remote_read_range.size, remote_read_range.start_offset);
+	profile_collector->RecordOperationEnd(BaseProfileCollector::IoOperation::kRead, oper_id);
+
+	// Copy to destination buffer, if bytes are read into [content] buffer rather than user-provided buffer.
+	remote_read_range.CopyBufferToRequestedMemory();
+
+	// Split range into blocks, place them into in-memory cache, and share them with waiting requesters.
+	for (; completed_chunk_count < block_keys.size(); ++completed_chunk_count) {
+		const auto *cur_chunk = remote_read_range.chunks[completed_chunk_count];
+		profile_collector->RecordCacheAccess(BaseProfileCollector::CacheEntity::kData,
+		                                     BaseProfileCollector::CacheAccess::kCacheMiss);
+		auto content = make_shared_ptr<std::string>(remote_read_range.GetChunkData(*cur_chunk), cur_chunk->chunk_size);
+		GetCacheForBlock(block_keys[completed_chunk_count], in_mem_cache_handle.IsFooterPrefetchEligible(), file_size)
+		    .Put(block_keys[completed_chunk_count], content);
+		in_flight_blocks.Complete(block_keys[completed_chunk_count], [&content]() { return content; });
 	}
-	io_threads.Wait();
 }
 
 vector<DataCacheEntryInfo> InMemoryCacheReader::GetCacheEntriesInfo() const {
@@ -152,12 +218,17 @@ vector<DataCacheEntryInfo> InMemoryCacheReader::GetCacheEntriesInfo() const {
 	}
 
 	auto keys = cache->Keys();
+	if (footer_cache != nullptr) {
+		auto footer_keys = footer_cache->Keys();
+		keys.insert(keys.end(), std::make_move_iterator(footer_keys.begin()),
+		            std::make_move_iterator(footer_keys.end()));
+	}
 	vector<DataCacheEntryInfo> cache_entries_info;
 	cache_entries_info.reserve(keys.size());
 	for (auto &cur_key : keys) {
 		cache_entries_info.emplace_back(DataCacheEntryInfo {
 		    .cache_filepath = "(no disk cache)",
-		    .remote_filename = std::move(cur_key.fname),
+		    .remote_filename = cur_key.file_identity->path,
 		    .start_offset = cur_key.start_off,
 		    .end_offset = cur_key.start_off + cur_key.blk_size,
 		    .cache_type = "in-mem",
@@ -166,15 +237,44 @@ vector<DataCacheEntryInfo> InMemoryCacheReader::GetCacheEntriesInfo() const {
 	return cache_entries_info;
 }
 
+bool InMemoryCacheReader::GetDataCacheUsage(DataCacheUsage &data_cache_usage) const {
+	// Cache is not initialized before first access, report the configured budget.
+	if (cache == nullptr) {
+		data_cache_usage = DataCacheUsage {
+		    .capacity_bytes = g_max_in_mem_cache_bytes,
+		    .used_bytes = 0,
+		};
+		return true;
+	}
+	data_cache_usage = DataCacheUsage {
+	    .capacity_bytes = cache->MaxTotalWeight(),
+	    .used_bytes = cache->TotalWeight(),
+	};
+	if (footer_cache != nullptr) {
+		data_cache_usage.capacity_bytes += footer_cache->MaxTotalWeight();
+		data_cache_usage.used_bytes += footer_cache->TotalWeight();
+	}
+	return true;
+}
+
 void InMemoryCacheReader::ClearCache() {
 	if (cache != nullptr) {
 		cache->Clear();
+		if (footer_cache != nullptr) {
+			footer_cache->Clear();
+		}
 	}
 }
 
 void InMemoryCacheReader::ClearCache(const string &fname) {
 	if (cache != nullptr) {
-		cache->Clear([&fname](const InMemCacheBlock &block) { return block.fname == fname; });
+		auto is_fname_block = [&fname](const InMemCacheBlock &block) {
+			return block.file_identity->path == fname;
+		};
+		cache->Clear(is_fname_block);
+		if (footer_cache != nullptr) {
+			footer_cache->Clear(is_fname_block);
+		}
 	}
 }
 
@@ -26,10 +26,38 @@ public:
 	virtual void ReadAndCache(FileHandle &handle, char *buffer, idx_t requested_start_offset,
 	                          idx_t requested_bytes_to_read, idx_t file_size) = 0;
 
+	// Read [bytes_to_read] bytes starting at [start_offset] from [handle] into cache in advance, so later reads on the
+	// range hit cache. By default it's a no-op, for cache readers which don't cache anything.
+	virtual void Prefetch(FileHandle &handle, idx_t start_offset, idx_t bytes_to_read, idx_t file_size) {
+	}
+
 	// Get status information for all cache entries for the current cache reader. Entries are returned in a random
 	// order.
 	virtual vector<DataCacheEntryInfo> GetCacheEntriesInfo() const = 0;
 
+	// Get capacity and usage in bytes for data cache into [data_cache_usage], return false if the cache reader doesn't
+	// budget its data cache.
+	virtual bool GetDataCacheUsage(DataCacheUsage &data_cache_usage) const {
+		return false;
+	}
+
+	// Get the number of bytes for data blocks cached on local disk, which is tracked without filesystem access. By
+	// default 0, for cache readers which don't cache on local disk.
+	virtual idx_t GetOnDiskCacheBytes() const {
+		return 0;
+	}
+
+	// Get compression stats for cache blocks into [compression_stats], return false if the cache reader doesn't
+	// compress cache blocks.
+	virtual bool GetDiskCacheCompressionStats(DiskCacheCompressionStats &compression_stats) const {
+		return false;
+	}
+
+	// Block until cache population in background finishes, so cache entries are visible via cache status. By default
+	// it's a no-op, for cache readers which populate cache synchronously.
+	virtual void Flush() {
+	}
+
 	// Clear all cache.
 	virtual void ClearCache() = 0;
 
@@ -25,6 +25,9 @@ public:
 	enum class CacheAccess {
 		kCacheHit,
 		kCacheMiss,
+		// Cache miss which is served by another ongoing fetch for the same entry, without issuing its own IO operation.
+		kCacheDedupMiss,
+		kUnknown,
 	};
 	enum class IoOperation {
 		kOpen,
@@ -33,6 +36,7 @@ public:
 		kUnknown,
 	};
 	static constexpr auto kCacheEntityCount = static_cast<size_t>(CacheEntity::kUnknown);
+	static constexpr auto kCacheAccessCount = static_cast<size_t>(CacheAccess::kUnknown);
 	static constexpr auto kIoOperationCount = static_cast<size_t>(IoOperation::kUnknown);
 
 	BaseProfileCollector() = default;
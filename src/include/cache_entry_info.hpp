@@ -21,8 +21,29 @@ struct CacheAccessInfo {
 	std::string cache_type;
 	uint64_t cache_hit_count = 0;
 	uint64_t cache_miss_count = 0;
+	// Cache misses served by another ongoing fetch, which don't issue IO operations by themselves.
+	uint64_t cache_dedup_miss_count = 0;
 };
 
 bool operator<(const CacheAccessInfo &lhs, const CacheAccessInfo &rhs);
 
+// Memory budget and consumption for data cache, which applies to cache readers with a byte budget.
+struct DataCacheUsage {
+	uint64_t capacity_bytes = 0;
+	uint64_t used_bytes = 0;
+};
+
+// Compression stats for on-disk cache blocks, which applies to cache readers compressing cache blocks.
+struct DiskCacheCompressionStats {
+	// Number of cache blocks written with compression enabled, and those stored compressed among them.
+	uint64_t written_block_count = 0;
+	uint64_t compressed_block_count = 0;
+	// Number of payload bytes for cache blocks written with compression enabled, before and after compression.
+	uint64_t raw_bytes = 0;
+	uint64_t stored_bytes = 0;
+	// Number of cache blocks decompressed on cache hit, and overall time spent on decompression in nanoseconds.
+	uint64_t decompressed_block_count = 0;
+	uint64_t decompression_nanosec = 0;
+};
+
 } // namespace duckdb
@@ -0,0 +1,38 @@
+// Identity of a remote file for cache lookups, which is computed once when a cache file handle is opened, and shared
+// by all block lookups on the handle; so building cache keys for each block doesn't hash, format or copy the remote
+// path.
+//
+// Identities are interned by path: all live identities for one path are the same object with the same path id, so
+// in-memory cache keys compare and hash path ids instead of paths. An identity is released once no file handle or cache
+// entry references it, and a later intern for the path gets a new path id.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+struct CacheFileIdentity {
+	// Remote file path.
+	std::string path;
+	// Id which is unique among all live identities.
+	uint64_t path_id = 0;
+	// Prefix of on-disk cache filenames for the remote file, formatted as `<path-sha256>-<filename>`.
+	std::string cache_fname_prefix;
+};
+
+// Get the prefix of on-disk cache filenames for remote file [path] without interning it, which matches the prefix of
+// its identity.
+std::string GetCacheFnamePrefix(const std::string &path);
+
+// Get the interned identity for remote file [path].
+shared_ptr<const CacheFileIdentity> InternCacheFileIdentity(const std::string &path);
+
+// Get the number of interned identities which are still alive, which is exposed for testing.
+idx_t GetInternedCacheFileIdentityCount();
+
+} // namespace duckdb
@@ -4,10 +4,13 @@
 
 #include "base_cache_reader.hpp"
 #include "base_profile_collector.hpp"
+#include "cache_file_identity.hpp"
 #include "cache_reader_manager.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/unique_ptr.hpp"
 #include "exclusive_multi_lru_cache.hpp"
+#include "io_executor.hpp"
+#include "sequential_read_tracker.hpp"
 #include "shared_lru_cache.hpp"
 
 #include <mutex>
@@ -51,11 +54,47 @@ public:
 	// Get internal filesystem for cache filesystem.
 	FileSystem *GetInternalFileSystem() const;
 
+	// Get identity of the remote file for cache lookups, which is computed once on handle open.
+	const shared_ptr<const CacheFileIdentity> &GetCacheFileIdentity() const {
+		return cache_file_identity;
+	}
+
+	// Get whether footer of the remote file is prefetched and retained, which is decided once on handle open so block
+	// lookups don't match the path again.
+	bool IsFooterPrefetchEligible() const {
+		return footer_prefetch_eligible;
+	}
+
 	unique_ptr<FileHandle> internal_file_handle;
+
+private:
+	friend class CacheFileSystem;
+
+	shared_ptr<const CacheFileIdentity> cache_file_identity;
+	// Identities are shared by all handles for one path, while footer prefetch settings could change between opens, so
+	// the decision is kept on the handle.
+	bool footer_prefetch_eligible;
+	// Protects [sequential_read_tracker] and [read_ahead_tasks].
+	std::mutex read_ahead_mutex;
+	// Tracks stream reads on the handle to decide what to read ahead.
+	SequentialReadTracker sequential_read_tracker;
+	// Ongoing read-ahead and footer prefetch tasks, which access [internal_file_handle] and must finish before it's
+	// released.
+	IoTaskGroup read_ahead_tasks;
 };
 
 class CacheFileSystem : public FileSystem {
 public:
+	// Metadata of remote files, which gets cached in-memory.
+	struct FileMetadata {
+		int64_t file_size = 0;
+		time_t last_modified = 0;
+		// Tag for the version of remote file, which changes once the file gets overwritten, so cache blocks keyed by
+		// it never match stale content. Filesystems don't expose version tags (i.e. ETag) yet, so it's derived from
+		// file size and last modification timestamp.
+		uint64_t version_tag = 0;
+	};
+
 	explicit CacheFileSystem(unique_ptr<FileSystem> internal_filesystem_p)
 	    : internal_filesystem(std::move(internal_filesystem_p)), cache_reader_manager(CacheReaderManager::Get()) {
 	}
@@ -74,6 +113,9 @@ public:
 	}
 	// Get file size, which gets cached in-memory.
 	int64_t GetFileSize(FileHandle &handle);
+	// Get file metadata, which gets cached in-memory. Unlike [GetFileSize], access is not recorded in profile, since
+	// it's looked up by cache readers for every read.
+	shared_ptr<const FileMetadata> GetFileMetadata(FileHandle &handle);
 	// Get cache reader manager.
 	shared_ptr<CacheReaderManager> GetCacheReaderManager();
 	// Get the internal filesystem for cache filesystem.
@@ -106,9 +148,9 @@ public:
 		auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
 		return internal_filesystem->Trim(*disk_cache_handle.internal_file_handle, offset_bytes, length_bytes);
 	}
+	// Get last modification timestamp, which gets cached in-memory along with file size.
 	time_t GetLastModifiedTime(FileHandle &handle) override {
-		auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
-		return internal_filesystem->GetLastModifiedTime(*disk_cache_handle.internal_file_handle);
+		return GetFileMetadata(handle)->last_modified;
 	}
 	FileType GetFileType(FileHandle &handle) override {
 		auto &disk_cache_handle = handle.Cast<CacheFileSystemHandle>();
@@ -197,10 +239,6 @@ public:
 private:
 	friend class CacheFileSystemHandle;
 
-	struct FileMetadata {
-		int64_t file_size = 0;
-	};
-
 	struct FileHandleCacheKey {
 		string path;
 		FileOpenFlags flags; // flags have parallel access enabled.
@@ -222,13 +260,27 @@ private:
 		}
 	};
 
+	// Get file metadata for the given [handle], and set [metadata_cache_hit] to whether it's served from cache.
+	shared_ptr<const FileMetadata> GetFileMetadataImpl(FileHandle &handle, bool &metadata_cache_hit);
+
 	// Initialize global configurations and global objects (i.e. metadata cache, profiler, etc) in a thread-safe manner.
 	void InitializeGlobalConfig(optional_ptr<FileOpener> opener);
 
-	// Read from [location] on [nr_bytes] for the given [handle] into [buffer].
+	// Read from [location] on [nr_bytes] for the given [handle] into [buffer], whose file size is [file_size].
 	// Return the actual number of bytes to read.
 	// It's worth noting file offset won't be updated.
-	int64_t ReadImpl(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	int64_t ReadImpl(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location, idx_t file_size);
+
+	// Record a stream read of [bytes_read] bytes at [location] for the given [handle], and read ahead in the background
+	// if it's detected as sequential access.
+	void ReadAhead(FileHandle &handle, idx_t location, idx_t bytes_read, idx_t file_size);
+
+	// Prefetch footer region in the background for the given read [handle] if applicable.
+	void PrefetchFooter(FileHandle &handle);
+
+	// Prefetch [bytes_to_read] bytes at [start_offset] into data cache in the background for the given [handle], whose
+	// read-ahead mutex should be held.
+	void SubmitPrefetch(CacheFileSystemHandle &handle, idx_t start_offset, idx_t bytes_to_read, idx_t file_size);
 
 	// Internal implementation for glob operation.
 	vector<string> GlobImpl(const string &path, FileOpener *opener);
@@ -268,7 +320,7 @@ private:
 	// Used to profile operations.
 	unique_ptr<BaseProfileCollector> profile_collector;
 	// Metadata cache, which maps from file name to metadata.
-	using MetadataCache = ThreadSafeSharedLruConstCache<string, FileMetadata>;
+	using MetadataCache = ThreadSafeShardedSharedLruConstCache<string, FileMetadata>;
 	unique_ptr<MetadataCache> metadata_cache;
 	// File handle cache, which maps from file name to uncached file handle.
 	// Cache is used here to avoid HEAD HTTP request on read operations.
@@ -276,7 +328,7 @@ private:
 	                                                         FileHandleCacheKeyEqual>;
 	unique_ptr<FileHandleCache> file_handle_cache;
 	// Glob cache, which maps from path to filenames.
-	using GlobCache = ThreadSafeSharedLruConstCache<string, vector<string>>;
+	using GlobCache = ThreadSafeShardedSharedLruConstCache<string, vector<string>>;
 	unique_ptr<GlobCache> glob_cache;
 };
 
@@ -7,6 +7,7 @@
 
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
 #include "no_destructor.hpp"
 #include "size_literals.hpp"
 
@@ -30,10 +31,62 @@ inline const NoDestructor<std::string> PERSISTENT_PROFILE_TYPE {"duckdb"};
 inline const NoDestructor<std::unordered_set<std::string>> ALL_PROFILE_TYPES {*NOOP_PROFILE_TYPE, *TEMP_PROFILE_TYPE,
                                                                               *PERSISTENT_PROFILE_TYPE};
 
+// Every on-disk cache file is fsync-ed before it's visible, so cache files are intact after crash.
+inline const NoDestructor<std::string> STRICT_DISK_CACHE_DURABILITY {"strict"};
+// Cache files are not fsync-ed individually, instead the filesystem for cache directory is synced periodically.
+inline const NoDestructor<std::string> BATCHED_DISK_CACHE_DURABILITY {"batched"};
+// Cache files are never fsync-ed, those left corrupted by crash are detected and discarded at read.
+inline const NoDestructor<std::string> NONE_DISK_CACHE_DURABILITY {"none"};
+inline const NoDestructor<std::unordered_set<std::string>> ALL_DISK_CACHE_DURABILITY_MODES {
+    *STRICT_DISK_CACHE_DURABILITY, *BATCHED_DISK_CACHE_DURABILITY, *NONE_DISK_CACHE_DURABILITY};
+
+// Every block is cached in a separate file.
+inline const NoDestructor<std::string> FILE_DISK_CACHE_LAYOUT {"file"};
+// Blocks are appended into large segment files, see [DiskCacheSegmentStore].
+inline const NoDestructor<std::string> SEGMENT_DISK_CACHE_LAYOUT {"segment"};
+// Every remote object is cached in a local sparse file with blocks at native offsets, see [DiskCacheMirrorStore].
+inline const NoDestructor<std::string> MIRROR_DISK_CACHE_LAYOUT {"mirror"};
+inline const NoDestructor<std::unordered_set<std::string>> ALL_DISK_CACHE_LAYOUTS {
+    *FILE_DISK_CACHE_LAYOUT, *SEGMENT_DISK_CACHE_LAYOUT, *MIRROR_DISK_CACHE_LAYOUT};
+
+// Cache files are opened, read, written and moved with blocking IO, one block after another.
+inline const NoDestructor<std::string> SYNC_DISK_CACHE_IO_ENGINE {"sync"};
+// Cache file IO for all blocks of one request is batched into io_uring submissions, only available on Linux; it falls
+// back to blocking IO if io_uring is unavailable.
+inline const NoDestructor<std::string> IO_URING_DISK_CACHE_IO_ENGINE {"io_uring"};
+// Cache files are read and written with blocking direct IO (i.e. O_DIRECT) bypassing kernel page cache, so cached bytes
+// don't take host memory besides buffer pool and in-memory cache; it falls back to blocking buffered IO if direct IO is
+// unsupported.
+inline const NoDestructor<std::string> DIRECT_DISK_CACHE_IO_ENGINE {"direct"};
+// Cache hits are copied straight into requested memory from read-only memory mappings of cache files, which are kept
+// in a bounded LRU cache, so warm reads skip read syscalls and intermediate buffers; cache files are written with
+// blocking IO. It falls back to blocking IO if memory mapping is unsupported.
+inline const NoDestructor<std::string> MMAP_DISK_CACHE_IO_ENGINE {"mmap"};
+inline const NoDestructor<std::unordered_set<std::string>> ALL_DISK_CACHE_IO_ENGINES {
+    *SYNC_DISK_CACHE_IO_ENGINE, *IO_URING_DISK_CACHE_IO_ENGINE, *DIRECT_DISK_CACHE_IO_ENGINE,
+    *MMAP_DISK_CACHE_IO_ENGINE};
+
+// Cache block payload is stored as is.
+inline const NoDestructor<std::string> NONE_DISK_CACHE_COMPRESSION {"none"};
+// Cache block payload is compressed with zstd before written to cache files under file layout, and stored raw if it
+// doesn't compress well.
+inline const NoDestructor<std::string> ZSTD_DISK_CACHE_COMPRESSION {"zstd"};
+inline const NoDestructor<std::unordered_set<std::string>> ALL_DISK_CACHE_COMPRESSIONS {*NONE_DISK_CACHE_COMPRESSION,
+                                                                                        *ZSTD_DISK_CACHE_COMPRESSION};
+
 //===--------------------------------------------------------------------===//
 // Default configuration
 //===--------------------------------------------------------------------===//
 inline const idx_t DEFAULT_CACHE_BLOCK_SIZE = 64_KiB;
+// Consecutive cache-missed blocks are merged into one remote range request, which is capped by the size.
+inline const idx_t DEFAULT_MAX_REMOTE_REQUEST_SIZE = 16_MiB;
+// Max number of blocks to read ahead for sequential reads on a file handle, 0 means read-ahead disabled.
+inline const idx_t DEFAULT_MAX_READ_AHEAD_BLOCK_COUNT = 16;
+// Number of bytes at the tail of parquet files (and files matching footer prefetch pattern) to prefetch on file open,
+// which covers footer and metadata; 0 means footer prefetch disabled.
+inline const idx_t DEFAULT_FOOTER_PREFETCH_SIZE = 1_MiB;
+// Glob pattern for files to prefetch footer besides parquet files, empty means no extra files.
+inline const NoDestructor<std::string> DEFAULT_FOOTER_PREFETCH_FILE_PATTERN {""};
 inline const NoDestructor<std::string> DEFAULT_ON_DISK_CACHE_DIRECTORY {"/tmp/duckdb_cache_httpfs_cache"};
 
 // Default to use on-disk cache filesystem.
@@ -43,8 +96,98 @@ inline NoDestructor<std::string> DEFAULT_CACHE_TYPE {*ON_DISK_CACHE_TYPE};
 // filesystems. The value here is the decimal representation for percentage value; for example, 0.05 means 5%.
 inline constexpr double MIN_DISK_SPACE_PERCENTAGE_FOR_CACHE = 0.05;
 
-// Maximum in-memory cache block number, which caps the overall memory consumption as (block size * max block count).
-inline constexpr idx_t DEFAULT_MAX_IN_MEM_CACHE_BLOCK_COUNT = 256;
+// Max number of bytes for on-disk cache files, least recently used cache files are evicted when exceeded; 0 means no
+// limit, and cache files are only evicted by staleness when disk space is insufficient.
+inline constexpr idx_t DEFAULT_MAX_DISK_CACHE_BYTES = 0;
+
+// Whether cache files are striped across multiple cache directories proportionally to the capacity of their
+// filesystems, rather than evenly.
+inline constexpr bool DEFAULT_DISK_CACHE_WEIGHT_BY_CAPACITY = false;
+
+// Duration in milliseconds for a cache directory to stay out of rotation, after it fails or fills up.
+inline constexpr int64_t DISK_CACHE_DIRECTORY_REJOIN_INTERVAL_MILLISEC = 60LL * 1000 /*60sec*/;
+
+// Max number of bytes held by cache files pending to write in background; cache fills exceeding the cap are dropped
+// instead of blocking reads. 0 means cache files are written synchronously on the read path.
+inline const idx_t DEFAULT_DISK_CACHE_WRITE_BACK_MAX_BYTES = 256_MiB;
+
+// Default durability mode for on-disk cache files, which syncs every cache file.
+inline NoDestructor<std::string> DEFAULT_DISK_CACHE_DURABILITY {*STRICT_DISK_CACHE_DURABILITY};
+
+// Min interval in milliseconds between two filesystem syncs for cache directory, under batched durability mode.
+inline constexpr idx_t DISK_CACHE_SYNC_INTERVAL_MILLISEC = 5ULL * 1000 /*5sec*/;
+
+// Default layout for on-disk cache, which caches every block in a separate file.
+inline NoDestructor<std::string> DEFAULT_DISK_CACHE_LAYOUT {*FILE_DISK_CACHE_LAYOUT};
+
+// Default IO engine for on-disk cache files under file layout, which uses blocking IO.
+inline NoDestructor<std::string> DEFAULT_DISK_CACHE_IO_ENGINE {*SYNC_DISK_CACHE_IO_ENGINE};
+
+// Default compression for on-disk cache blocks, which stores them raw; remote files in columnar formats are usually
+// compressed already.
+inline NoDestructor<std::string> DEFAULT_DISK_CACHE_COMPRESSION {*NONE_DISK_CACHE_COMPRESSION};
+
+// Compression level for zstd compressed cache blocks, which favors (de)compression speed over ratio.
+inline constexpr int DISK_CACHE_ZSTD_COMPRESSION_LEVEL = 1;
+
+// A cache block is stored compressed only if compression saves at least the ratio of its bytes, otherwise the block is
+// stored raw, so incompressible blocks don't pay for decompression on every cache hit.
+inline constexpr double DISK_CACHE_MIN_COMPRESSION_SAVING_RATIO = 0.125;
+
+// Max number of bytes for cache files kept memory-mapped under mmap IO engine.
+inline const idx_t DEFAULT_DISK_CACHE_MAX_MAPPED_BYTES = 1_GiB;
+
+// Max number of cache files kept memory-mapped under mmap IO engine, which caps the number of memory mappings.
+inline constexpr idx_t DISK_CACHE_MAX_MAPPED_FILES = 16384;
+
+// Max number of bytes for a segment file under segment layout.
+inline const idx_t DEFAULT_DISK_CACHE_SEGMENT_SIZE = 1_GiB;
+
+// A sealed segment file gets compacted, once the ratio of its live bytes drops under the threshold.
+inline constexpr double DISK_CACHE_SEGMENT_COMPACTION_RATIO = 0.5;
+
+// Max number of file handles kept open for mirror files under mirror layout, which caps file descriptor usage.
+inline constexpr idx_t DISK_CACHE_MIRROR_MAX_OPEN_FILES = 256;
+
+// Number of background threads to write on-disk cache files.
+inline constexpr idx_t DISK_CACHE_WRITE_BACK_THREAD_COUNT = 4;
+
+// Max number of on-disk cache files written together by one background thread.
+inline constexpr idx_t DISK_CACHE_WRITE_BACK_MAX_BATCH_COUNT = 64;
+
+// When on-disk cache exceeds its capacity, cache files are evicted until overall bytes drop under the ratio of
+// capacity.
+inline constexpr double DISK_CACHE_EVICTION_LOW_WATERMARK_RATIO = 0.9;
+
+// Share of on-disk cache capacity retained for footer blocks; beyond it, footer blocks are evicted the same way as
+// other cache files.
+inline constexpr double DISK_CACHE_FOOTER_CAPACITY_RATIO = 0.25;
+
+// Background janitor starts evicting cache files once on-disk cache exceeds the ratio of capacity, ahead of writers
+// hitting capacity.
+inline constexpr double DISK_CACHE_EVICTION_HIGH_WATERMARK_RATIO = 0.95;
+
+// Max number of cache files deleted by background janitor per second.
+inline constexpr idx_t DISK_CACHE_JANITOR_MAX_REMOVALS_PER_SECOND = 1000;
+
+// Interval in milliseconds between two background janitor passes, unless it's woken up by writers.
+inline constexpr int64_t DISK_CACHE_JANITOR_INTERVAL_MILLISEC = 1000;
+
+// Maximum number of bytes for in-memory cache, which caps the overall memory consumption of cached blocks, measured by
+// the actual capacity of block buffers.
+inline const idx_t DEFAULT_MAX_IN_MEM_CACHE_BYTES = 16_MiB;
+
+// Percentage of duckdb memory limit used as in-memory cache budget, which overrides the byte budget when positive; 0
+// means disabled.
+inline constexpr double DEFAULT_MAX_IN_MEM_CACHE_MEMORY_PERCENTAGE = 0;
+
+// Ratio of in-memory cache budget reserved for footer blocks, which are kept in a separate high-priority region so they
+// don't get evicted by column data.
+inline constexpr double IN_MEM_FOOTER_CACHE_RATIO = 0.25;
+
+// Number of independently locked LRU shards for in-memory block cache, metadata cache and glob cache, which reduces
+// lock contention among concurrent accessors.
+inline constexpr idx_t DEFAULT_CACHE_SHARD_COUNT = 16;
 
 // Default timeout in seconds for in-memory block cache entries.
 inline constexpr idx_t DEFAULT_IN_MEM_BLOCK_CACHE_TIMEOUT_MILLISEC = 3600ULL * 1000 /*1hour*/;
@@ -76,6 +219,10 @@ inline NoDestructor<std::string> DEFAULT_PROFILE_TYPE {*NOOP_PROFILE_TYPE};
 // Default max number of parallel subrequest for a single filesystem read request. 0 means no limit.
 inline uint64_t DEFAULT_MAX_SUBREQUEST_COUNT = 0;
 
+// Default number of threads for the IO executor shared by all cache readers. 0 means decided by CPU core count, see
+// [GetIoThreadCount].
+inline uint64_t DEFAULT_IO_THREAD_COUNT = 0;
+
 // Default enable metadata cache.
 inline bool DEFAULT_ENABLE_METADATA_CACHE = true;
 
@@ -98,17 +245,33 @@ inline idx_t DEFAULT_MIN_DISK_BYTES_FOR_CACHE = 0;
 
 // Global configuration.
 inline idx_t g_cache_block_size = DEFAULT_CACHE_BLOCK_SIZE;
+inline idx_t g_max_remote_request_size = DEFAULT_MAX_REMOTE_REQUEST_SIZE;
+inline idx_t g_max_read_ahead_block_count = DEFAULT_MAX_READ_AHEAD_BLOCK_COUNT;
+inline idx_t g_footer_prefetch_size = DEFAULT_FOOTER_PREFETCH_SIZE;
+inline NoDestructor<std::string> g_footer_prefetch_file_pattern {*DEFAULT_FOOTER_PREFETCH_FILE_PATTERN};
 inline bool g_ignore_sigpipe = DEFAULT_IGNORE_SIGPIPE;
 inline NoDestructor<std::string> g_cache_type {*DEFAULT_CACHE_TYPE};
 inline NoDestructor<std::string> g_profile_type {*DEFAULT_PROFILE_TYPE};
 inline uint64_t g_max_subrequest_count = DEFAULT_MAX_SUBREQUEST_COUNT;
+inline uint64_t g_io_thread_count = DEFAULT_IO_THREAD_COUNT;
+inline idx_t g_cache_shard_count = DEFAULT_CACHE_SHARD_COUNT;
 
 // On-disk cache configuration.
+// Comma-separated list of cache directories, which cache files are striped across.
 inline NoDestructor<std::string> g_on_disk_cache_directory {*DEFAULT_ON_DISK_CACHE_DIRECTORY};
 inline idx_t g_min_disk_bytes_for_cache = DEFAULT_MIN_DISK_BYTES_FOR_CACHE;
+inline idx_t g_max_disk_cache_bytes = DEFAULT_MAX_DISK_CACHE_BYTES;
+inline bool g_disk_cache_weight_by_capacity = DEFAULT_DISK_CACHE_WEIGHT_BY_CAPACITY;
+inline idx_t g_disk_cache_write_back_max_bytes = DEFAULT_DISK_CACHE_WRITE_BACK_MAX_BYTES;
+inline NoDestructor<std::string> g_disk_cache_durability {*DEFAULT_DISK_CACHE_DURABILITY};
+inline NoDestructor<std::string> g_disk_cache_layout {*DEFAULT_DISK_CACHE_LAYOUT};
+inline NoDestructor<std::string> g_disk_cache_io_engine {*DEFAULT_DISK_CACHE_IO_ENGINE};
+inline NoDestructor<std::string> g_disk_cache_compression {*DEFAULT_DISK_CACHE_COMPRESSION};
+inline idx_t g_disk_cache_max_mapped_bytes = DEFAULT_DISK_CACHE_MAX_MAPPED_BYTES;
+inline idx_t g_disk_cache_segment_size = DEFAULT_DISK_CACHE_SEGMENT_SIZE;
 
 // In-memory cache configuration.
-inline idx_t g_max_in_mem_cache_block_count = DEFAULT_MAX_IN_MEM_CACHE_BLOCK_COUNT;
+inline idx_t g_max_in_mem_cache_bytes = DEFAULT_MAX_IN_MEM_CACHE_BYTES;
 inline idx_t g_in_mem_cache_block_timeout_millisec = DEFAULT_IN_MEM_BLOCK_CACHE_TIMEOUT_MILLISEC;
 
 // Metadata cache configuration.
@@ -143,7 +306,25 @@ void SetGlobalConfig(optional_ptr<FileOpener> opener);
 // Reset all global cache filesystem configuration.
 void ResetGlobalConfig();
 
+// Get on-disk cache directories listed in [g_on_disk_cache_directory], with whitespaces, trailing slashes, empty and
+// duplicate entries stripped.
+vector<std::string> GetOnDiskCacheDirectories();
+
 // Get concurrent IO sub-request count.
 uint64_t GetThreadCountForSubrequests(uint64_t io_request_count);
 
+// Get the number of threads for the process-wide IO executor.
+uint64_t GetIoThreadCount();
+
+// Return whether to prefetch footer on open for the file at [path].
+bool ShouldPrefetchFooter(const std::string &path);
+
+// Get the block-aligned start offset of footer region for a file with [file_size] bytes, which is prefetched on open.
+idx_t GetFooterRegionStartOffset(idx_t file_size);
+
+// Return whether the block starting at [block_start_offset] lies in the footer region of a file with [file_size] bytes,
+// which has higher cache retention priority. [footer_prefetch_eligible] is the result of [ShouldPrefetchFooter] for the
+// file, which is computed once on file open.
+bool IsFooterBlock(bool footer_prefetch_eligible, idx_t block_start_offset, idx_t file_size);
+
 } // namespace duckdb
@@ -0,0 +1,89 @@
+// All read requests are split into block-size aligned chunks, which are either served from cache, or fetched from
+// remote storage in parallel.
+//
+// A [CacheReadChunk] represents a chunked IO request and its corresponding partial IO request.
+// A [RemoteReadRange] represents a remote range request, which covers consecutive cache-missed chunks, so remote
+// request size is decoupled from cache block size.
+
+#pragma once
+
+#include <functional>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+struct CacheReadChunk {
+	// Requested memory address and file offset to read from for current chunk.
+	char *requested_start_addr = nullptr;
+	idx_t requested_start_offset = 0;
+	// Block size aligned [requested_start_offset].
+	idx_t aligned_start_offset = 0;
+
+	// Number of bytes for the chunk for IO operations, apart from the last chunk it's always cache block size.
+	idx_t chunk_size = 0;
+	// Number of bytes to copy to requested memory address.
+	idx_t bytes_to_copy = 0;
+
+	// Only allocated for partially requested chunks (usually the first and last chunk), to which bytes are read first
+	// then copied to requested memory address. For fully requested chunks, bytes are directly read into
+	// [requested_start_addr] to save memory allocation and copy.
+	string content;
+
+	// Local cache filepath for the chunk under on-disk cache, which is resolved once per read and shared by cache
+	// lookup, in-flight deduplication and cache write.
+	string local_cache_file;
+
+	// Whether the whole chunk is requested.
+	bool IsFullyRequested() const {
+		return requested_start_offset == aligned_start_offset && bytes_to_copy == chunk_size;
+	}
+
+	// Get the memory address to read the whole chunk into, [content] is allocated if necessary.
+	char *GetAddressToReadTo();
+
+	// Copy from [content] to requested memory address, no-op if bytes are directly read into requested memory.
+	void CopyBufferToRequestedMemory();
+
+	// Copy the requested part of [buffer], which holds the whole chunk, to requested memory address.
+	void CopyBufferToRequestedMemory(const string &buffer) const;
+	void CopyBufferToRequestedMemory(const char *buffer) const;
+};
+
+// Split the requested range into block-size aligned chunks, ordered by file offset.
+vector<CacheReadChunk> SplitIntoCacheReadChunks(char *buffer, idx_t requested_start_offset,
+                                                idx_t requested_bytes_to_read, idx_t file_size, idx_t block_size);
+
+struct RemoteReadRange {
+	// Consecutive chunks covered by the range, ordered by file offset.
+	vector<CacheReadChunk *> chunks;
+	// File offset and number of bytes for the range request.
+	idx_t start_offset = 0;
+	idx_t size = 0;
+
+	// Only allocated if any chunk is partially requested; otherwise bytes are directly read into requested memory,
+	// which is contiguous for all chunks.
+	string content;
+
+	// Get the memory address to read the whole range into, [content] is allocated if necessary.
+	char *GetAddressToReadTo();
+
+	// Copy from [content] to requested memory address for all chunks, no-op if bytes are directly read into requested
+	// memory.
+	void CopyBufferToRequestedMemory();
+
+	// Get the start address for [chunk] within the range, only valid after the range has been read.
+	const char *GetChunkData(const CacheReadChunk &chunk) const;
+};
+
+// Merge consecutive [chunks] into range requests, each of which is at most [max_request_size] bytes, unless a single
+// chunk is already larger.
+vector<RemoteReadRange> CoalesceCacheReadChunks(const vector<CacheReadChunk *> &chunks, idx_t max_request_size);
+
+// Execute [func] on all [ranges], and rethrow the first exception if any after all ranges are processed.
+// A single range doesn't benefit from parallelism, so it's executed on the caller thread; otherwise ranges are
+// dispatched to the IO executor, with at most [GetThreadCountForSubrequests] of them in flight.
+void ExecuteRemoteReadRanges(vector<RemoteReadRange> &ranges, const std::function<void(RemoteReadRange &)> &func);
+
+} // namespace duckdb
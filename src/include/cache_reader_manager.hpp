@@ -26,6 +26,9 @@ public:
 	// Initialize disk cache reader if uninitialized.
 	void InitializeDiskCacheReader();
 
+	// Return whether disk cache reader is initialized.
+	bool IsDiskCacheReaderInitialized() const;
+
 	// Clear cache for all cache readers.
 	void ClearCache();
 
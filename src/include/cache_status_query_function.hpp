@@ -12,4 +12,10 @@ TableFunction GetDataCacheStatusQueryFunc();
 // Get the table function to query cache access status.
 TableFunction GetCacheAccessInfoQueryFunc();
 
+// Get the table function to query IO executor status.
+TableFunction GetIoExecutorStatsQueryFunc();
+
+// Get the table function to query compression stats for on-disk cache blocks.
+TableFunction GetDiskCacheCompressionStatsQueryFunc();
+
 } // namespace duckdb
@@ -0,0 +1,88 @@
+// A bounded queue which writes cache files in background threads, so cache population is kept off the read critical
+// path.
+//
+// Memory held by pending writes is capped: a cache fill which doesn't fit is dropped instead of blocking the reader,
+// since cache population is best-effort. Content of pending writes is still accessible, so reads on a block which has
+// been fetched but not yet written don't go to remote storage again.
+//
+// Background threads drain pending writes in submission order and in batches, so writes backed up behind disk IO share
+// batched submissions (i.e. io_uring) rather than being written one by one.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "disk_cache_lru_index.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+#include "thread_pool.hpp"
+
+namespace duckdb {
+
+class CacheWriteBackQueue {
+public:
+	struct PendingWrite {
+		std::string cache_file;
+		shared_ptr<const std::string> content;
+		CacheFileRetention retention = CacheFileRetention::kData;
+	};
+
+	// Write content of all [pending_writes] into their cache files; exceptions are swallowed since cache population is
+	// best-effort.
+	using WriteFunc = std::function<void(const vector<PendingWrite> &pending_writes)>;
+
+	// @param max_batch_count_p: Max number of pending writes handed to [write_func_p] at once.
+	CacheWriteBackQueue(idx_t thread_count, idx_t max_batch_count_p, WriteFunc write_func_p);
+
+	CacheWriteBackQueue(const CacheWriteBackQueue &) = delete;
+	CacheWriteBackQueue &operator=(const CacheWriteBackQueue &) = delete;
+
+	// Block until all pending writes finish.
+	~CacheWriteBackQueue();
+
+	// Enqueue [content] to write into [cache_file] of [retention] class. Return false if the write is dropped, because
+	// pending bytes would exceed [max_pending_bytes]. Writes for a cache file already pending are merged.
+	bool Submit(const std::string &cache_file, shared_ptr<const std::string> content, idx_t max_pending_bytes,
+	            CacheFileRetention retention = CacheFileRetention::kData);
+
+	// Get content pending to write into [cache_file], or nullptr if there's none.
+	shared_ptr<const std::string> GetPendingContent(const std::string &cache_file) const;
+
+	// Block until there are no pending writes.
+	void Flush();
+
+	// Get the number of bytes pending to write.
+	idx_t GetPendingBytes() const;
+
+	// Get the number of writes dropped due to memory cap.
+	idx_t GetDroppedCount() const;
+
+private:
+	// Write a batch of queued cache files, and remove them from pending writes; no-op if they've been taken by other
+	// threads.
+	void WriteQueuedCacheFiles();
+
+	const idx_t max_batch_count;
+	const WriteFunc write_func;
+
+	mutable std::mutex mu;
+	// Notified when all pending writes finish.
+	std::condition_variable flush_cv;
+	// Maps from cache file to the content pending to write.
+	std::unordered_map<std::string, shared_ptr<const std::string>> pending_writes;
+	// Pending writes not yet taken by any thread, in submission order.
+	std::deque<PendingWrite> queued_writes;
+	idx_t pending_bytes = 0;
+	idx_t dropped_count = 0;
+
+	// Declared last, so worker threads are joined before other members get destructed.
+	ThreadPool thread_pool;
+};
+
+} // namespace duckdb
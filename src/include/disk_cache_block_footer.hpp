@@ -0,0 +1,100 @@
+// Self-describing format for on-disk cache files under file layout.
+//
+// Each cache file is formatted as `<stored-payload><footer>`, where the fixed-size footer records magic, format
+// version, codec the payload is stored with, identity of the remote file (size, last modification timestamp and
+// version tag hash), payload length, CRC32C for the stored payload and CRC32C for the footer itself. Metadata is placed
+// after the payload rather than before, so the payload stays at file offset 0: it's read straight into requested
+// memory, memory mapped at page boundary, and aligned for direct IO.
+//
+// Payload is stored either raw, or compressed when it saves enough space; the length of stored payload is implied by
+// cache file size, and checksum covers stored bytes, so corruption is detected before decompression.
+//
+// A cache file is served only if its footer is intact, matches the remote file being read, and the stored payload
+// matches its checksum; otherwise (i.e. torn write, truncation by crash, bit rot, or remote file overwritten) it's
+// treated as a cache miss. Cache files are also indexed from their footers on startup, without trusting filenames
+// alone.
+
+#pragma once
+
+#include <cstdint>
+
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+// Identity of the remote file which a cache block is fetched from, used to tell whether the cache block is stale.
+struct RemoteFileIdentity {
+	idx_t file_size = 0;
+	// Last modification timestamp in seconds since epoch, 0 if unknown.
+	int64_t last_modified = 0;
+	// Version tag of the remote file, which is derived from ETag if exposed by filesystem, otherwise from file size and
+	// last modification timestamp; 0 if unknown.
+	uint64_t version_hash = 0;
+};
+
+bool operator==(const RemoteFileIdentity &lhs, const RemoteFileIdentity &rhs);
+bool operator!=(const RemoteFileIdentity &lhs, const RemoteFileIdentity &rhs);
+
+// Codec which cache block payload is stored with.
+enum class DiskCacheBlockCodec : uint8_t {
+	kNone = 0,
+	kZstd = 1,
+};
+
+struct DiskCacheBlockFooter {
+	uint32_t magic = 0;
+	uint8_t version = 0;
+	// Value of [DiskCacheBlockCodec].
+	uint8_t codec = 0;
+	uint16_t footer_size = 0;
+	// Number of bytes for the block before compression.
+	uint64_t payload_length = 0;
+	uint64_t remote_file_size = 0;
+	int64_t remote_last_modified = 0;
+	uint64_t remote_version_hash = 0;
+	// Checksum for the payload as stored, which is compressed payload if stored compressed.
+	uint32_t stored_crc32c = 0;
+	// Checksum for all preceding fields, so a torn footer is detected before the payload checksum gets computed.
+	uint32_t footer_crc32c = 0;
+};
+static_assert(sizeof(DiskCacheBlockFooter) == 48, "Disk cache block footer is expected to be 48 bytes.");
+
+// Number of bytes for the footer at the end of every cache file.
+inline constexpr idx_t DISK_CACHE_BLOCK_FOOTER_SIZE = sizeof(DiskCacheBlockFooter);
+
+// Encode the footer for [payload_length] bytes of [payload] fetched from [remote_identity] and stored raw into
+// [footer], which holds [DISK_CACHE_BLOCK_FOOTER_SIZE] bytes.
+void EncodeDiskCacheBlockFooter(const char *payload, idx_t payload_length, const RemoteFileIdentity &remote_identity,
+                                char *footer);
+
+// Encode the footer for a block with [payload_length] bytes fetched from [remote_identity], which is stored as
+// [stored_length] bytes of [stored] with [codec], into [footer].
+void EncodeDiskCacheBlockFooter(const char *stored, idx_t stored_length, DiskCacheBlockCodec codec,
+                                idx_t payload_length, const RemoteFileIdentity &remote_identity, char *footer);
+
+// Decode [footer] into [decoded], return false if it's torn, or written in a different format version.
+bool DecodeDiskCacheBlockFooter(const char *footer, DiskCacheBlockFooter &decoded);
+
+// Get identity of the remote file which the block described by [footer] is fetched from.
+RemoteFileIdentity GetRemoteFileIdentity(const DiskCacheBlockFooter &footer);
+
+// Return whether [footer] describes a block stored as [stored_length] bytes, i.e. raw payload is stored as is, and
+// compressed payload is shorter than raw payload.
+bool IsDiskCacheBlockStoredLengthMatched(const DiskCacheBlockFooter &footer, idx_t stored_length);
+
+// Return whether [footer] is intact, and describes a block with [payload_length] bytes fetched from [remote_identity].
+// Payload checksum is not verified, which is cheap enough to check on every access.
+bool IsDiskCacheBlockFooterMatched(const char *footer, idx_t payload_length, const RemoteFileIdentity &remote_identity);
+
+// Return whether [payload_length] bytes of [payload] and their [footer] form a valid cache block fetched from
+// [remote_identity] and stored raw, including payload checksum verification.
+bool IsValidDiskCacheBlock(const char *payload, idx_t payload_length, const char *footer,
+                           const RemoteFileIdentity &remote_identity);
+
+// Return whether [stored_length] bytes of [stored] and their [footer] form a valid cache block with [payload_length]
+// bytes fetched from [remote_identity], whether it's stored raw or compressed, including checksum verification for
+// stored bytes.
+bool IsValidDiskCacheBlock(const char *stored, idx_t stored_length, const char *footer, idx_t payload_length,
+                           const RemoteFileIdentity &remote_identity);
+
+} // namespace duckdb
@@ -0,0 +1,75 @@
+// Set of on-disk cache directories, which stripes cache files across directories (i.e. on separate local devices), so
+// cache capacity and read bandwidth add up without a RAID.
+//
+// Cache files are placed by weighted rendezvous hashing on their filenames: every directory scores each filename by
+// hashing it along with the directory path, and the one with the highest score holds the cache file. Placement only
+// depends on filename and directory paths, so it's stable across restarts and directory reordering; adding or removing
+// a directory only moves cache files from or to that directory. Directories with higher weights (i.e. larger devices)
+// win proportionally more cache files.
+//
+// A directory that fails or fills up is taken out of rotation for a while, and cache files it would hold are placed
+// on the next preferred directory meanwhile; cache files placed elsewhere are left for eviction after it rejoins. If
+// all directories are out of rotation, cache files are placed as if they're all in rotation.
+//
+// The set is thread-safe.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+class DiskCacheDirectorySet {
+public:
+	// @param directories_p: Cache directories, which should be non-empty.
+	// @param weights_p: Positive weights for [directories_p] respectively, empty means all directories weigh the same.
+	// @param rejoin_interval_millisec_p: Duration for a directory to stay out of rotation.
+	DiskCacheDirectorySet(vector<std::string> directories_p, vector<double> weights_p,
+	                      int64_t rejoin_interval_millisec_p);
+
+	// Disable copy and move.
+	DiskCacheDirectorySet(const DiskCacheDirectorySet &) = delete;
+	DiskCacheDirectorySet &operator=(const DiskCacheDirectorySet &) = delete;
+
+	// Get the index of directory to hold cache file [cache_fname].
+	idx_t PickDirectory(const std::string &cache_fname) const;
+
+	// Get the index of directory which [filepath] is placed under, which is invalid if it's not under any directory.
+	optional_idx FindDirectory(const std::string &filepath) const;
+
+	// Take the directory at [directory_idx] out of rotation, which rejoins after rejoin interval.
+	void TakeOutOfRotation(idx_t directory_idx);
+
+	// Return whether the directory at [directory_idx] is in rotation.
+	bool IsInRotation(idx_t directory_idx) const;
+
+	// Get the share of [overall_capacity_bytes] for the directory at [directory_idx] by its weight, 0 (i.e. no limit)
+	// stays 0.
+	idx_t GetCapacityBytes(idx_t directory_idx, idx_t overall_capacity_bytes) const;
+
+	const vector<std::string> &GetDirectories() const {
+		return directories;
+	}
+	idx_t GetDirectoryCount() const {
+		return directories.size();
+	}
+
+private:
+	const vector<std::string> directories;
+	vector<double> weights;
+	double overall_weight = 0;
+	// Hash seeds derived from directory paths.
+	vector<uint64_t> seeds;
+	const int64_t rejoin_interval_millisec;
+	// Steady clock timestamps when directories rejoin rotation, 0 means in rotation.
+	std::unique_ptr<std::atomic<int64_t>[]> rejoin_timestamps;
+};
+
+} // namespace duckdb
@@ -0,0 +1,118 @@
+// A background janitor which evicts on-disk cache files under file layout, so readers and IO workers never scan cache
+// directories or delete cache files in the middle of a read.
+//
+// Each pass goes over all tracked cache directories:
+// - Once used bytes of a directory exceed the high watermark of its capacity, least recently used cache files are
+//   evicted until used bytes drop under the low watermark, so writers rarely hit capacity themselves.
+// - On insufficient disk space, cache files not accessed within the staleness threshold are evicted.
+// - Cache files evicted elsewhere (i.e. by writers overshooting capacity, or invalid ones found on index load) are
+//   handed over to delete.
+// Deletions are rate-limited, so eviction bursts don't compete with cache reads and writes for disk bandwidth; while a
+// flush is pending they're not, so flushers (i.e. cache clearance) never wait on the rate limit.
+//
+// A pass over a directory holds an exclusive lock on a lock file next to it, so at most one janitor evicts a cache
+// directory at a time across processes; a directory locked by another process is skipped until the next pass.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "disk_cache_lru_index.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+class DiskCacheJanitor {
+public:
+	// @param high_watermark_ratio_p: Eviction starts once used bytes exceed (capacity * ratio).
+	// @param max_removals_per_second_p: Max number of cache files deleted per second, 0 means no limit.
+	// @param interval_millisec_p: Interval between two passes, unless the janitor is woken up.
+	DiskCacheJanitor(double high_watermark_ratio_p, idx_t max_removals_per_second_p, int64_t interval_millisec_p);
+
+	// Disable copy and move.
+	DiskCacheJanitor(const DiskCacheJanitor &) = delete;
+	DiskCacheJanitor &operator=(const DiskCacheJanitor &) = delete;
+
+	// Stop the janitor thread. Cache files still pending to delete are left on disk, which are indexed again on the
+	// next index load.
+	~DiskCacheJanitor();
+
+	// Track [lru_index] for cache files under [cache_directory], which replaces the previous one.
+	void AddDirectory(const std::string &cache_directory, shared_ptr<DiskCacheLruIndex> lru_index);
+
+	// Stop tracking all cache directories; cache files already handed over are still deleted.
+	void ClearDirectories();
+
+	// Hand over [cache_files] under [cache_directory] to delete in background, which should no longer be tracked by its
+	// index.
+	void RemoveCacheFiles(const std::string &cache_directory, vector<std::string> cache_files);
+
+	// Wake up the janitor for a pass, if used bytes of [lru_index] exceed the high watermark.
+	void MaybeWake(const DiskCacheLruIndex &lru_index);
+
+	// Wake up the janitor for a pass.
+	void Wake();
+
+	// Block until a pass started after the call finishes, which deletes all pending cache files without rate limit.
+	void Flush();
+
+	// Get the lock filepath for [cache_directory], which is placed next to the directory rather than inside, so
+	// directory clearance doesn't remove the lock in use.
+	static std::string GetLockFilepath(const std::string &cache_directory);
+
+private:
+	struct DirectoryState {
+		// Index for cache files under the directory, nullptr if the directory is no longer tracked.
+		shared_ptr<DiskCacheLruIndex> lru_index;
+		// Cache files handed over to delete.
+		vector<std::string> pending_removals;
+	};
+
+	// Main loop for the janitor thread.
+	void Run();
+
+	// Evict cache files under [cache_directory] tracked by [lru_index], and delete them along with
+	// [pending_removals]. Return cache files left to delete, because the directory is locked by another process or the
+	// janitor is stopped.
+	vector<std::string> CleanDirectory(const std::string &cache_directory,
+	                                   const shared_ptr<DiskCacheLruIndex> &lru_index,
+	                                   vector<std::string> pending_removals);
+
+	// Block until one more deletion is allowed by rate limit, or a flush is requested; return false if the janitor is
+	// stopped meanwhile.
+	bool AcquireRemovalQuota();
+
+	const double high_watermark_ratio;
+	const idx_t max_removals_per_second;
+	const int64_t interval_millisec;
+
+	std::mutex mu;
+	// Notifies the janitor thread on wake-up and stop.
+	std::condition_variable janitor_cv;
+	// Notifies flushers on pass completion.
+	std::condition_variable pass_cv;
+	bool stopped = false;
+	bool wake_requested = false;
+	// Number of passes requested by flushers, and completed by the janitor thread.
+	uint64_t requested_pass_count = 0;
+	uint64_t completed_pass_count = 0;
+	// Maps from cache directory to its state.
+	std::unordered_map<std::string, DirectoryState> directories;
+
+	// Steady clock timestamp for the current rate limit window, and deletions within it; only accessed by the janitor
+	// thread.
+	int64_t removal_window_start_millisec = 0;
+	idx_t removal_window_count = 0;
+
+	// Declared last, so the thread starts after other members get initialized.
+	std::thread janitor_thread;
+};
+
+} // namespace duckdb
@@ -0,0 +1,197 @@
+// In-memory index for on-disk cache files, which tracks their sizes and access recency, so the overall disk usage is
+// capped without scanning the cache directory or querying filesystem stats on every write.
+//
+// Eviction happens in batches: once overall bytes exceed capacity, least recently used cache files are evicted until
+// overall bytes drop under the low watermark, so eviction doesn't get triggered again by the next write.
+//
+// Footer blocks are tracked in a separate LRU list, which is only evicted from once footer blocks take more than
+// [DISK_CACHE_FOOTER_CAPACITY_RATIO] of capacity, or there're no other cache files to evict; so scans over column data
+// don't evict footers, which every scan reads first.
+//
+// The index could be persisted into an append-only journal file, so it survives restarts without opening every cache
+// file. Additions and removals are appended as records, formatted as `<header (magic, op, size, last access, key
+// length)><key>`, where footer blocks are added with a separate op. Access recency is persisted lazily: touched cache
+// files are appended as addition records in batches, and at checkpoint, which rewrites the journal with all live
+// entries in LRU order, so the journal size is bounded by the number of entries. Accesses not yet persisted are lost on
+// crash, which only makes cache files look less recently used. A torn record at journal tail (i.e. left by crash)
+// terminates replay. Cache files indexed without journal are all treated as data blocks.
+//
+// Processes sharing a cache directory share its journal: records are appended in O_APPEND mode, and an appender reopens
+// the journal once another process's checkpoint replaces it. Records appended by others while a checkpoint is taken
+// get dropped, whose cache files are indexed from the cache directory on next load.
+//
+// The index is thread-safe; it only decides which cache files to evict, while file deletion is left to the caller.
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// Retention class for cache files.
+enum class CacheFileRetention : uint8_t {
+	kData = 0,
+	// Footer blocks, which are retained over data blocks.
+	kFooter = 1,
+};
+
+class DiskCacheLruIndex {
+public:
+	// @param capacity_bytes_p: Max overall bytes for cache files, 0 means no limit.
+	// @param low_watermark_ratio_p: Overall bytes are reduced to (capacity * ratio) when eviction is triggered.
+	// @param journal_filepath_p: Journal file to persist the index, empty means the index lives in memory only.
+	DiskCacheLruIndex(idx_t capacity_bytes_p, double low_watermark_ratio_p, std::string journal_filepath_p = "");
+
+	// Disable copy and move.
+	DiskCacheLruIndex(const DiskCacheLruIndex &) = delete;
+	DiskCacheLruIndex &operator=(const DiskCacheLruIndex &) = delete;
+
+	// Persist pending accesses to journal. Indexes held by the process-wide cache reader are never destroyed, whose
+	// accesses are persisted in batches instead.
+	~DiskCacheLruIndex();
+
+	// Replay the journal into index, only cache files in [existing_cache_files] are kept; then checkpoint the journal,
+	// and start appending records to it. Journal file is created if it doesn't exist.
+	void LoadJournal(const std::unordered_set<std::string> &existing_cache_files);
+
+	// Add or replace [cache_file] with [file_size] bytes as the most recently used cache file of [retention] class,
+	// and return cache files to evict if overall bytes exceed capacity.
+	vector<std::string> AddCacheFile(const std::string &cache_file, idx_t file_size,
+	                                 CacheFileRetention retention = CacheFileRetention::kData);
+
+	// Same as above, but [cache_file] was last accessed at [last_access_timestamp] (i.e. restored from its modification
+	// timestamp), so it's placed by access recency instead of as the most recently used one.
+	vector<std::string> AddCacheFile(const std::string &cache_file, idx_t file_size, time_t last_access_timestamp,
+	                                 CacheFileRetention retention = CacheFileRetention::kData);
+
+	// Mark [cache_file] as the most recently used, and return whether it's tracked. The access is persisted to journal
+	// in batches.
+	bool TouchCacheFile(const std::string &cache_file);
+
+	// Stop tracking least recently used cache files until overall bytes drop under the low watermark, and return them;
+	// no-op if there's no capacity limit. Used to evict ahead of capacity, i.e. by a background janitor.
+	vector<std::string> EvictCacheFiles();
+
+	// Mark [cache_file] returned by eviction as deleted from disk, so its bytes are no longer counted against capacity.
+	void MarkCacheFileDeleted(const std::string &cache_file);
+
+	// Return whether [cache_file] is tracked.
+	bool HasCacheFile(const std::string &cache_file) const;
+
+	// Stop tracking [cache_file], no-op if it's not tracked.
+	void RemoveCacheFile(const std::string &cache_file);
+
+	// Stop tracking cache files starting with [prefix], and return them.
+	vector<std::string> RemoveCacheFilesWithPrefix(const std::string &prefix);
+
+	// Stop tracking cache files last accessed before [stale_timestamp], and return them.
+	vector<std::string> RemoveStaleCacheFiles(time_t stale_timestamp);
+
+	// Stop tracking all cache files.
+	void Clear();
+
+	// Update capacity, which takes effect at the next addition.
+	void SetCapacityBytes(idx_t capacity_bytes_p);
+
+	// Get all tracked cache files, ordered by name.
+	vector<std::string> GetCacheFiles() const;
+
+	idx_t GetCapacityBytes() const;
+	idx_t GetUsedBytes() const;
+	// Get overall bytes for cache files evicted but not deleted yet, which still count against capacity.
+	idx_t GetPendingDeletionBytes() const;
+	idx_t GetCacheFileCount() const;
+	// Get overall bytes for footer blocks.
+	idx_t GetFooterBytes() const;
+
+private:
+	struct Entry {
+		idx_t file_size = 0;
+		// Timestamp in seconds since epoch for the last access.
+		time_t last_access_timestamp = 0;
+		CacheFileRetention retention = CacheFileRetention::kData;
+		// Position in the LRU list for [retention].
+		std::list<std::string>::iterator lru_iterator;
+	};
+
+	// Get the LRU list for cache files of [retention] class.
+	std::list<std::string> &GetLruList(CacheFileRetention retention);
+
+	// Add [cache_file] into the LRU list for [retention] by its access recency; caller should hold [mu].
+	void AddImpl(const std::string &cache_file, idx_t file_size, time_t last_access_timestamp,
+	             CacheFileRetention retention);
+
+	// Remove least recently used cache files until overall bytes drop under the low watermark, and return them; caller
+	// should hold [mu].
+	vector<std::string> EvictImpl();
+
+	// Remove the given [iter] from index; caller should hold [mu].
+	void RemoveImpl(std::map<std::string, Entry>::iterator iter);
+
+	// Remove the given [iter] from index, and count its bytes as pending deletion; caller should hold [mu].
+	void EvictEntryImpl(std::map<std::string, Entry>::iterator iter);
+
+	// Append a record for [cache_file] to journal, no-op if journal is not opened; caller should hold [mu].
+	void AppendJournalImpl(bool is_addition, const std::string &cache_file, const Entry &entry);
+
+	// Append records for all touched cache files to journal in one write; caller should hold [mu].
+	void PersistTouchedImpl(time_t now);
+
+	// Write serialized [records] at journal tail, no-op if journal is not opened; caller should hold [mu].
+	void WriteJournalImpl(const std::string &records, idx_t record_count);
+
+	// (Re)open journal for append, or leave it closed on failure; caller should hold [mu].
+	void OpenJournalImpl();
+
+	// Close journal if it's opened; caller should hold [mu].
+	void CloseJournalImpl();
+
+	// Rewrite journal with all live entries, if it has accumulated too many stale records; caller should hold [mu].
+	void MaybeCheckpointImpl();
+
+	// Rewrite journal with all live entries in LRU order; caller should hold [mu].
+	void CheckpointImpl();
+
+	const double low_watermark_ratio;
+	const std::string journal_filepath;
+	unique_ptr<FileSystem> local_filesystem;
+
+	mutable std::mutex mu;
+	idx_t capacity_bytes = 0;
+	idx_t used_bytes = 0;
+	idx_t footer_bytes = 0;
+	// Evicted cache files not deleted from disk yet, mapped to their file size.
+	std::unordered_map<std::string, idx_t> pending_deletions;
+	idx_t pending_deletion_bytes = 0;
+	// Cache files ordered from the most recently used to the least recently used, whose access timestamps are
+	// non-increasing; footer blocks are ordered in [footer_lru_list] the same way.
+	std::list<std::string> lru_list;
+	std::list<std::string> footer_lru_list;
+	// Ordered by cache file, so cache files sharing a prefix are looked up without a full iteration.
+	std::map<std::string, Entry> entries;
+	// Opened for append on journal load, and closed on IO failure, after which the index lives in memory only.
+	int journal_fd = -1;
+	// Identity of the journal file [journal_fd] refers to, which changes once another process checkpoints the journal.
+	dev_t journal_device = 0;
+	ino_t journal_inode = 0;
+	idx_t journal_record_count = 0;
+	// Cache files touched since their access recency was last persisted.
+	std::unordered_set<std::string> touched_cache_files;
+	// Timestamp in seconds since epoch, when touched cache files were last persisted.
+	time_t last_touch_persist_timestamp = 0;
+};
+
+} // namespace duckdb
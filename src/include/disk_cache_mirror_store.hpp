@@ -0,0 +1,128 @@
+// Store for on-disk cache blocks, which caches each remote object as a single local sparse file (mirror file) with
+// blocks at their native offsets, so consecutive cached blocks are read with one positional read.
+//
+// Cached blocks of a mirror file are tracked by a bitmap, which is persisted in a sidecar file, formatted as
+// `<block size><bitmap bytes>`; the bitmap is updated after block write, and before block eviction, so a set bit
+// always refers to a written block. Mirror files written with a different block size are discarded on load.
+//
+// Blocks are evicted in LRU order once overall cached bytes exceed capacity, and their space is reclaimed by punching
+// holes in the mirror file; mirror files without cached blocks are deleted.
+
+#pragma once
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "disk_cache_lru_index.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "shared_lru_cache.hpp"
+
+namespace duckdb {
+
+class DiskCacheMirrorStore {
+public:
+	struct EntryInfo {
+		// Key for the remote object.
+		std::string mirror_key;
+		// Filepath for the mirror file which holds the block.
+		std::string mirror_filepath;
+		idx_t block_offset = 0;
+		idx_t block_length = 0;
+	};
+
+	// @param cache_directory_p: Directory to place mirror files, existing mirror files are loaded on construction.
+	// @param block_size_p: Block size for cached blocks, which all blocks except the last one of an object are of.
+	// @param capacity_bytes_p: Max overall bytes for cached blocks, 0 means no limit.
+	DiskCacheMirrorStore(std::string cache_directory_p, idx_t block_size_p, idx_t capacity_bytes_p);
+
+	// Disable copy and move.
+	DiskCacheMirrorStore(const DiskCacheMirrorStore &) = delete;
+	DiskCacheMirrorStore &operator=(const DiskCacheMirrorStore &) = delete;
+
+	// Return whether the given [fname] under cache directory is a mirror file or its bitmap file.
+	static bool IsMirrorFile(const std::string &fname);
+
+	// Return whether the block at [block_offset] for [mirror_key] has been cached.
+	bool IsBlockCached(const std::string &mirror_key, idx_t block_offset) const;
+
+	// Write [length] bytes at [data] as the block at [block_offset] for [mirror_key]. Both the mirror file and bitmap
+	// file are synced before the block is visible if [sync].
+	void WriteBlock(const std::string &mirror_key, idx_t block_offset, const char *data, idx_t length, bool sync);
+
+	// Read [length] bytes at [offset] for [mirror_key] into [buffer] with one read, only if all blocks covered by the
+	// range have been cached. [offset] should be block aligned. Return whether the range is read.
+	bool Read(const std::string &mirror_key, idx_t offset, idx_t length, char *buffer);
+
+	// Remove all blocks for [mirror_key], and delete its mirror file.
+	void Remove(const std::string &mirror_key);
+
+	// Remove all blocks for mirror keys starting with [prefix], and delete their mirror files.
+	void RemoveByPrefix(const std::string &prefix);
+
+	// Remove all blocks and delete all mirror files.
+	void Clear();
+
+	// Update capacity, which takes effect at the next write.
+	void SetCapacityBytes(idx_t capacity_bytes_p);
+
+	idx_t GetBlockSize() const {
+		return block_size;
+	}
+	vector<EntryInfo> GetEntries() const;
+	idx_t GetCapacityBytes() const;
+	idx_t GetUsedBytes() const;
+
+private:
+	struct MirrorFile {
+		// Shared for block reads and writes, exclusive for hole punching, so reads never observe punched blocks.
+		std::shared_timed_mutex io_mutex;
+		// Bit i indicates whether block i has been cached.
+		vector<uint8_t> block_bitmap;
+		idx_t cached_block_count = 0;
+		// Max end offset of cached blocks, which equals object size once its last block gets cached.
+		idx_t end_offset = 0;
+	};
+
+	std::string GetMirrorFilepath(const std::string &mirror_key) const;
+	std::string GetBitmapFilepath(const std::string &mirror_key) const;
+
+	// Get cached file handle for [filepath], which is opened if not cached.
+	shared_ptr<FileHandle> GetFileHandle(const std::string &filepath);
+
+	// Get the mirror file for [mirror_key], or nullptr if it doesn't exist; caller should hold [mu].
+	shared_ptr<MirrorFile> GetMirrorFileImpl(const std::string &mirror_key) const;
+
+	// Return whether block [block_idx] is set in [mirror_file]; caller should hold [mu].
+	static bool IsBlockSetImpl(const MirrorFile &mirror_file, idx_t block_idx);
+
+	// Update bit for [block_idx] in [mirror_file] in memory and on disk; caller should hold [mu].
+	void UpdateBitmapImpl(const std::string &mirror_key, MirrorFile &mirror_file, idx_t block_idx, bool is_set);
+
+	// Evict the given [block_ids] returned by LRU index, bitmap file is synced before hole punching if [sync].
+	void EvictBlocks(const vector<std::string> &block_ids, bool sync);
+
+	// Delete mirror file and bitmap file for [mirror_key], and drop their cached file handles; caller should hold [mu].
+	void DeleteMirrorFilesImpl(const std::string &mirror_key);
+
+	// Load existing mirror files under cache directory.
+	void LoadExistingMirrorFiles();
+
+	const std::string cache_directory;
+	const idx_t block_size;
+	unique_ptr<FileSystem> local_filesystem;
+	// Caps the number of open file descriptors for mirror files and bitmap files.
+	ThreadSafeSharedLruCache<std::string, FileHandle> file_handle_cache;
+	// Tracks access recency for all cached blocks, key-ed by block id.
+	DiskCacheLruIndex lru_index;
+
+	mutable std::mutex mu;
+	std::unordered_map<std::string, shared_ptr<MirrorFile>> mirror_files;
+};
+
+} // namespace duckdb
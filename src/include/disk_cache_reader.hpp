@@ -3,15 +3,42 @@
 #pragma once
 
 #include "base_cache_reader.hpp"
+#include "cache_file_identity.hpp"
+#include "cache_read_chunk.hpp"
+#include "cache_write_back_queue.hpp"
+#include "disk_cache_block_footer.hpp"
+#include "disk_cache_directory_set.hpp"
+#include "disk_cache_janitor.hpp"
+#include "disk_cache_lru_index.hpp"
+#include "disk_cache_mirror_store.hpp"
+#include "disk_cache_segment_store.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/helper.hpp"
 #include "duckdb/common/local_file_system.hpp"
 #include "duckdb/common/unique_ptr.hpp"
 #include "cache_filesystem.hpp"
 #include "cache_filesystem_config.hpp"
+#include "mapped_file.hpp"
+#include "shared_lru_cache.hpp"
+#include "single_flight.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 namespace duckdb {
 
+// Content to cache into one local cache file.
+struct CacheFileContent {
+	const char *data = nullptr;
+	idx_t size = 0;
+	// Encoded footer with [DISK_CACHE_BLOCK_FOOTER_SIZE] bytes, which is appended to [data] under file layout.
+	const char *footer = nullptr;
+	string local_cache_file;
+	// Retention class in the LRU index under file layout.
+	CacheFileRetention retention = CacheFileRetention::kData;
+};
+
 class DiskCacheReader final : public BaseCacheReader {
 public:
 	DiskCacheReader();
@@ -26,12 +53,180 @@ public:
 
 	void ReadAndCache(FileHandle &handle, char *buffer, idx_t requested_start_offset, idx_t requested_bytes_to_read,
 	                  idx_t file_size) override;
+	void Prefetch(FileHandle &handle, idx_t start_offset, idx_t bytes_to_read, idx_t file_size) override;
 
 	vector<DataCacheEntryInfo> GetCacheEntriesInfo() const override;
+	bool GetDataCacheUsage(DataCacheUsage &data_cache_usage) const override;
+	idx_t GetOnDiskCacheBytes() const override;
+	bool GetDiskCacheCompressionStats(DiskCacheCompressionStats &compression_stats_out) const override;
+	void Flush() override;
 
 private:
+	// Ongoing remote fetches for data blocks, key-ed by local cache filepath.
+	using InFlightBlocks = SingleFlightGroup<string, string>;
+	// Memory mappings for cache files, key-ed by local cache filepath.
+	using MappedFileCache = ThreadSafeSharedLruCache<string, MappedFile>;
+
+	// Cache directories and stores resolved once per read, so per-block lookups don't go through [lru_index_mutex].
+	struct LocalCacheContext {
+		shared_ptr<DiskCacheDirectorySet> directory_set;
+		// LRU indexes for [directory_set] in directory order, only loaded under file layout.
+		vector<shared_ptr<DiskCacheLruIndex>> lru_indexes;
+		// Only loaded under segment layout.
+		shared_ptr<DiskCacheSegmentStore> segment_store;
+	};
+
+	// Attempt to serve [cache_read_chunk] from its local cache file, return whether cache hits. Cache files under file
+	// layout are only served if they're cached for [remote_identity].
+	bool ReadFromLocalCache(const LocalCacheContext &context, const RemoteFileIdentity &remote_identity,
+	                        CacheReadChunk &cache_read_chunk);
+
+	// Take the cache directory holding [local_cache_file] out of rotation on IO failure, so its blocks are treated as
+	// cache misses and cached on other directories. Return false if there's no other directory to take over, in which
+	// case the failure should be reported.
+	bool TakeFailedDirectoryOutOfRotation(const string &local_cache_file);
+
+	// Attempt to serve [cache_read_chunks] from local cache files with batched io_uring submissions, return
+	// cache-missed chunks.
+	vector<CacheReadChunk *> ReadFromLocalCacheWithIoUring(const LocalCacheContext &context,
+	                                                       const RemoteFileIdentity &remote_identity,
+	                                                       vector<CacheReadChunk> &cache_read_chunks);
+
+	// Attempt to serve [cache_read_chunk] from memory mapping of [local_cache_file], which is tracked by [lru_index];
+	// return whether cache hits.
+	bool ReadFromMappedCacheFile(const string &local_cache_file, const RemoteFileIdentity &remote_identity,
+	                             CacheReadChunk &cache_read_chunk, DiskCacheLruIndex &lru_index);
+
+	// Validate the cache file with [file_size] bytes, which has been read into the chunk buffer of [cache_read_chunk]
+	// with overflowing bytes in [footer] buffer, and decompress the block into chunk buffer if it's stored compressed.
+	// Return whether the cache file holds a valid block cached for [remote_identity].
+	bool DecodeLocalCacheFile(idx_t file_size, const char *footer, const RemoteFileIdentity &remote_identity,
+	                          CacheReadChunk &cache_read_chunk);
+
+	// Decompress the block stored compressed as [stored_length] bytes of [stored] followed by [footer] into the chunk
+	// buffer of [cache_read_chunk], return whether it's a valid block cached for [remote_identity]. Checksum for stored
+	// bytes is only verified if [verify_checksum].
+	bool DecompressCacheBlock(const char *stored, idx_t stored_length, const char *footer,
+	                          const RemoteFileIdentity &remote_identity, CacheReadChunk &cache_read_chunk,
+	                          bool verify_checksum);
+
+	// Compress payloads of [cache_files], and return contents to write for all of them; blocks are stored compressed
+	// only if compression saves at least [DISK_CACHE_MIN_COMPRESSION_SAVING_RATIO] of their bytes, others are returned
+	// as is. Compressed payloads and their footers are held by [compressed_contents].
+	vector<CacheFileContent> CompressCacheFiles(const vector<CacheFileContent> &cache_files,
+	                                            vector<string> &compressed_contents);
+
+	// Attempt to serve [cache_read_chunks] from the mirror file for [handle] at the version of [remote_identity] under
+	// mirror layout, return cache-missed chunks.
+	vector<CacheReadChunk *> ReadFromMirrorFile(FileHandle &handle, const RemoteFileIdentity &remote_identity,
+	                                            vector<CacheReadChunk> &cache_read_chunks);
+
+	// Attempt to serve [cache_read_chunk] from content pending to write into [local_cache_file], return whether cache
+	// hits.
+	bool ReadFromPendingWrite(const string &local_cache_file, CacheReadChunk &cache_read_chunk);
+
+	// Return whether [local_cache_file] has been cached, which is only a hint since it could be evicted concurrently.
+	bool IsCachedLocally(const string &local_cache_file) const;
+
+	// Fetch [cache_miss_chunks] from remote storage and cache them locally, or wait for ongoing fetches from other
+	// requesters. With [skip_in_flight], blocks being fetched by other requesters are skipped instead of waited for.
+	void FetchCacheMisses(FileHandle &handle, const RemoteFileIdentity &remote_identity,
+	                      vector<CacheReadChunk *> cache_miss_chunks, bool skip_in_flight);
+
+	// Fetch [remote_read_range] from remote storage, share fetched blocks with waiting requesters, and cache them to
+	// local filesystem along with footers for [remote_identity].
+	void FetchAndCacheLocal(FileHandle &handle, const RemoteFileIdentity &remote_identity,
+	                        RemoteReadRange &remote_read_range);
+
+	// Get the set of current cache directories, which is rebuilt on first access, cache directory or weighting change.
+	shared_ptr<DiskCacheDirectorySet> GetDirectorySet() const;
+	// Same as above, but caller should hold [lru_index_mutex].
+	shared_ptr<DiskCacheDirectorySet> GetDirectorySetImpl() const;
+
+	// Get the LRU index for [cache_directory], which is (re)loaded from its journal and existing cache files on first
+	// access or cache directory change. Its capacity is the share of max disk cache bytes for the directory.
+	shared_ptr<DiskCacheLruIndex> GetLruIndex(const string &cache_directory) const;
+
+	// Get LRU indexes for all current cache directories.
+	vector<shared_ptr<DiskCacheLruIndex>> GetLruIndexes() const;
+	// Get LRU indexes for all directories of [cur_directory_set], in directory order.
+	vector<shared_ptr<DiskCacheLruIndex>> GetLruIndexes(const DiskCacheDirectorySet &cur_directory_set) const;
+
+	// Get the LRU index tracking [local_cache_file] from [context], which falls back to index lookup if the cache file
+	// isn't placed under its directories.
+	shared_ptr<DiskCacheLruIndex> GetLruIndex(const LocalCacheContext &context, const string &local_cache_file) const;
+
+	// Resolve cache directories and stores for a read.
+	LocalCacheContext GetLocalCacheContext() const;
+
+	// Get local cache filepath for the block at [start_offset] with [bytes_to_read] bytes of the remote file with
+	// [file_identity] at [version_tag]. Under file layout, blocks are striped across directories of
+	// [cur_directory_set], otherwise they're placed under the first one.
+	string GetLocalCacheFilepath(const DiskCacheDirectorySet &cur_directory_set, const CacheFileIdentity &file_identity,
+	                             uint64_t version_tag, idx_t start_offset, idx_t bytes_to_read) const;
+
+	// Fill in local cache filepaths for all [cache_read_chunks] of the remote file behind [handle] at [version_tag].
+	void AssignLocalCacheFilepaths(const DiskCacheDirectorySet &cur_directory_set, FileHandle &handle,
+	                               uint64_t version_tag, vector<CacheReadChunk> &cache_read_chunks) const;
+
+	// Get the segment store for the first cache directory under segment layout, which is (re)built from existing
+	// segment files on first access or cache directory change.
+	shared_ptr<DiskCacheSegmentStore> GetSegmentStore() const;
+
+	// Get the mirror store for the first cache directory under mirror layout, which is (re)built from existing mirror
+	// files on first access, cache directory change or cache block size change.
+	shared_ptr<DiskCacheMirrorStore> GetMirrorStore() const;
+
+	// Get the cache for memory-mapped cache files, which is rebuilt on capacity change.
+	shared_ptr<MappedFileCache> GetMappedFileCache() const;
+
+	// Cache all [cache_files], and sync them according to durability mode.
+	void WriteCacheFiles(const vector<CacheFileContent> &cache_files);
+
+	// Cache [cache_files] under file layout into the directories of [directory_set] they're placed under; directories
+	// which fail or fill up are taken out of rotation.
+	void CacheLocalStriped(DiskCacheDirectorySet &directory_set, const vector<CacheFileContent> &cache_files,
+	                       bool sync_cache_file);
+
 	// Used to access local cache files.
 	unique_ptr<FileSystem> local_filesystem;
+	// Used to deduplicate concurrent cache misses on the same data block.
+	InFlightBlocks in_flight_blocks;
+	// Protects [directory_set], its config and [lru_indexes].
+	mutable std::mutex lru_index_mutex;
+	// Cache directories built from [directory_set_config] and [directory_set_weight_by_capacity]; late initialized on
+	// first access.
+	mutable shared_ptr<DiskCacheDirectorySet> directory_set;
+	mutable string directory_set_config;
+	mutable bool directory_set_weight_by_capacity = false;
+	// Track sizes and access recency for cache files under each cache directory, key-ed by directory; late initialized
+	// on first access.
+	mutable std::unordered_map<string, shared_ptr<DiskCacheLruIndex>> lru_indexes;
+	// Protects [segment_store] and [segment_store_directory].
+	mutable std::mutex segment_store_mutex;
+	// Holds cached blocks under [segment_store_directory] for segment layout; late initialized on first access.
+	mutable shared_ptr<DiskCacheSegmentStore> segment_store;
+	mutable string segment_store_directory;
+	// Protects [mirror_store] and [mirror_store_directory].
+	mutable std::mutex mirror_store_mutex;
+	// Holds cached blocks under [mirror_store_directory] for mirror layout; late initialized on first access.
+	mutable shared_ptr<DiskCacheMirrorStore> mirror_store;
+	mutable string mirror_store_directory;
+	// Protects [mapped_file_cache].
+	mutable std::mutex mapped_file_cache_mutex;
+	// Holds memory mappings for cache files under mmap IO engine; late initialized on first access.
+	mutable shared_ptr<MappedFileCache> mapped_file_cache;
+	// Protects [compression_stats].
+	mutable std::mutex compression_stats_mutex;
+	// Accumulated compression and decompression stats for cache blocks.
+	DiskCacheCompressionStats compression_stats;
+	// Steady clock timestamp for the last filesystem sync under batched durability mode.
+	std::atomic<int64_t> last_sync_millisec;
+	// Evicts and deletes cache files under file layout in background; declared before [write_back_queue], since
+	// pending writes hand evicted cache files over to it.
+	unique_ptr<DiskCacheJanitor> janitor;
+	// Writes cache files in background. Declared last, so pending writes finish before other members get destructed.
+	unique_ptr<CacheWriteBackQueue> write_back_queue;
 };
 
 } // namespace duckdb
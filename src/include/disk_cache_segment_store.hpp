@@ -0,0 +1,152 @@
+// Log-structured store for on-disk cache blocks, which appends blocks into large segment files instead of creating
+// one file per block, so a cache hit costs a single positional read, and filesystem metadata overhead (inode count,
+// directory size, per-file open/close) doesn't grow with the number of cached blocks.
+//
+// Each segment file is a sequence of self-describing records, formatted as
+// `<header (magic, key length, data length)><key><data>`. An in-memory index maps block key to its record location,
+// which is rebuilt by scanning segment files on startup; a torn record at segment tail (i.e. left by crash) terminates
+// the scan for its segment.
+//
+// Space is reclaimed at segment granularity:
+// - When overall segment bytes exceed capacity, the oldest segments are evicted as a whole.
+// - When the live ratio of a sealed segment drops under the compaction threshold (i.e. after cache clearance for a
+// file), its live records are rewritten to the active segment in background, and the segment file gets deleted.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "thread_pool.hpp"
+
+namespace duckdb {
+
+class DiskCacheSegmentStore {
+public:
+	struct EntryInfo {
+		// Key for the cached block.
+		std::string key;
+		// Filepath for the segment file which holds the block.
+		std::string segment_filepath;
+	};
+
+	// @param cache_directory_p: Directory to place segment files, existing segment files are loaded on construction.
+	// @param segment_size_p: Max number of bytes for a segment file, unless a single record exceeds it.
+	// @param capacity_bytes_p: Max overall bytes for segment files, 0 means no limit.
+	DiskCacheSegmentStore(std::string cache_directory_p, idx_t segment_size_p, idx_t capacity_bytes_p);
+
+	// Disable copy and move.
+	DiskCacheSegmentStore(const DiskCacheSegmentStore &) = delete;
+	DiskCacheSegmentStore &operator=(const DiskCacheSegmentStore &) = delete;
+
+	// Block until ongoing compaction finishes.
+	~DiskCacheSegmentStore();
+
+	// Return whether the given [fname] under cache directory is a segment file.
+	static bool IsSegmentFile(const std::string &fname);
+
+	// Append [length] bytes at [data] for [key], which replaces the existing block for the key. The segment file is
+	// synced before the block is visible if [sync].
+	void Append(const std::string &key, const char *data, idx_t length, bool sync);
+
+	// Read the block for [key] into [buffer], return false if the block doesn't exist or its length mismatches.
+	bool Read(const std::string &key, char *buffer, idx_t length) const;
+
+	// Return whether the block for [key] exists.
+	bool Contains(const std::string &key) const;
+
+	// Remove blocks whose keys start with [prefix], and compact segments with low live ratio in background.
+	void RemoveByPrefix(const std::string &prefix);
+
+	// Remove all blocks and delete all segment files.
+	void Clear();
+
+	// Update capacity, which takes effect at the next append.
+	void SetCapacityBytes(idx_t capacity_bytes_p);
+
+	// Block until ongoing compaction finishes.
+	void WaitForCompaction();
+
+	vector<EntryInfo> GetEntries() const;
+	idx_t GetCapacityBytes() const;
+	// Get overall bytes for segment files, including records not yet reclaimed.
+	idx_t GetUsedBytes() const;
+	idx_t GetEntryCount() const;
+	idx_t GetSegmentCount() const;
+
+private:
+	struct Segment {
+		idx_t segment_id = 0;
+		std::string filepath;
+		unique_ptr<FileHandle> file_handle;
+		// Number of bytes reserved in the segment file.
+		idx_t size = 0;
+		// Number of bytes for records still referenced by index.
+		idx_t live_bytes = 0;
+		// Keys for all records appended into the segment, which could be stale.
+		vector<std::string> keys;
+		bool compacting = false;
+	};
+
+	struct Location {
+		shared_ptr<Segment> segment;
+		// Offset of the record in segment file.
+		idx_t record_offset = 0;
+		// Offset of block data in segment file.
+		idx_t data_offset = 0;
+		idx_t length = 0;
+	};
+
+	// Append block for [key], only if [expected_segment] is nullptr or the current block for [key] still resides in
+	// it (which is used by compaction, to avoid overwriting blocks updated or removed concurrently).
+	void AppendImpl(const std::string &key, const char *data, idx_t length, bool sync,
+	                const Segment *expected_segment);
+
+	// Create a new active segment; caller should hold [mu].
+	void CreateActiveSegmentImpl();
+
+	// Load existing segment files under cache directory, and rebuild index from their records.
+	void LoadExistingSegments();
+
+	// Drop index entry for [iter], and schedule compaction for its segment if necessary; caller should hold [mu].
+	// Segment files left without live records are collected into [segment_files_to_delete].
+	void RemoveImpl(std::unordered_map<std::string, Location>::iterator iter,
+	                vector<std::string> &segment_files_to_delete);
+
+	// Evict the oldest segments until overall bytes drop under capacity, and collect their files into
+	// [segment_files_to_delete]; caller should hold [mu].
+	void EvictImpl(vector<std::string> &segment_files_to_delete);
+
+	// Drop the given [segment] with all its index entries, and collect its file into [segment_files_to_delete]. Segment
+	// files are deleted by caller after releasing [mu], so appends don't wait on unlink; caller should hold [mu].
+	void DeleteSegmentImpl(const shared_ptr<Segment> &segment, vector<std::string> &segment_files_to_delete);
+
+	// Rewrite live records in [segment] to the active segment, and delete the segment file.
+	void CompactSegment(shared_ptr<Segment> segment);
+
+	const std::string cache_directory;
+	const idx_t segment_size;
+	unique_ptr<FileSystem> local_filesystem;
+
+	mutable std::mutex mu;
+	idx_t capacity_bytes = 0;
+	// Overall bytes reserved in all segment files.
+	idx_t used_bytes = 0;
+	idx_t next_segment_id = 0;
+	// Segments ordered by creation, so the first one is the oldest.
+	std::map<idx_t, shared_ptr<Segment>> segments;
+	shared_ptr<Segment> active_segment;
+	std::unordered_map<std::string, Location> index;
+
+	// Declared last, so compaction threads are joined before other members get destructed.
+	ThreadPool compaction_thread_pool;
+};
+
+} // namespace duckdb
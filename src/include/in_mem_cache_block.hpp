@@ -8,25 +8,30 @@
 #include <string>
 #include <tuple>
 
-#include "duckdb/common/string_util.hpp"
+#include "cache_file_identity.hpp"
+#include "duckdb/common/helper.hpp"
 
 namespace duckdb {
 
 struct InMemCacheBlock {
-	std::string fname;
+	// Identity of the remote file, which is shared with the file handle, so building keys doesn't copy remote paths.
+	shared_ptr<const CacheFileIdentity> file_identity;
+	// Version tag of the remote file, so blocks of an overwritten file never match, and age out of cache.
+	uint64_t version_tag = 0;
 	idx_t start_off = 0;
 	idx_t blk_size = 0;
 };
 
 struct InMemCacheBlockEqual {
 	bool operator()(const InMemCacheBlock &lhs, const InMemCacheBlock &rhs) const {
-		return std::tie(lhs.fname, lhs.start_off, lhs.blk_size) == std::tie(rhs.fname, rhs.start_off, rhs.blk_size);
+		return std::tie(lhs.file_identity->path_id, lhs.version_tag, lhs.start_off, lhs.blk_size) ==
+		       std::tie(rhs.file_identity->path_id, rhs.version_tag, rhs.start_off, rhs.blk_size);
 	}
 };
 struct InMemCacheBlockHash {
 	std::size_t operator()(const InMemCacheBlock &key) const {
-		return std::hash<std::string> {}(key.fname) ^ std::hash<idx_t> {}(key.start_off) ^
-		       std::hash<idx_t> {}(key.blk_size);
+		return std::hash<uint64_t> {}(key.file_identity->path_id) ^ std::hash<uint64_t> {}(key.version_tag) ^
+		       std::hash<idx_t> {}(key.start_off) ^ std::hash<idx_t> {}(key.blk_size);
 	}
 };
 
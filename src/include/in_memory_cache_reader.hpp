@@ -3,6 +3,7 @@
 #pragma once
 
 #include "base_cache_reader.hpp"
+#include "cache_read_chunk.hpp"
 #include "cache_filesystem.hpp"
 #include "cache_filesystem_config.hpp"
 #include "copiable_value_lru_cache.hpp"
@@ -12,6 +13,7 @@
 #include "duckdb/common/unique_ptr.hpp"
 #include "in_mem_cache_block.hpp"
 #include "shared_lru_cache.hpp"
+#include "single_flight.hpp"
 
 namespace duckdb {
 
@@ -28,15 +30,44 @@ public:
 	void ClearCache(const string &fname) override;
 	void ReadAndCache(FileHandle &handle, char *buffer, uint64_t requested_start_offset,
 	                  uint64_t requested_bytes_to_read, uint64_t file_size) override;
+	void Prefetch(FileHandle &handle, idx_t start_offset, idx_t bytes_to_read, idx_t file_size) override;
 	vector<DataCacheEntryInfo> GetCacheEntriesInfo() const override;
+	bool GetDataCacheUsage(DataCacheUsage &data_cache_usage) const override;
 
 private:
-	using InMemCache = ThreadSafeSharedLruCache<InMemCacheBlock, string, InMemCacheBlockHash, InMemCacheBlockEqual>;
+	using InMemCache =
+	    ThreadSafeShardedSharedLruCache<InMemCacheBlock, string, InMemCacheBlockHash, InMemCacheBlockEqual>;
+	// Ongoing remote fetches for data blocks.
+	using InFlightBlocks = SingleFlightGroup<InMemCacheBlock, string, InMemCacheBlockHash, InMemCacheBlockEqual>;
+
+	// Initialize in-memory cache if not yet.
+	void InitCacheIfNecessary();
+
+	// Get the cache region for [block_key] of a file with [file_size] bytes, whose footer prefetch eligibility is
+	// [footer_prefetch_eligible].
+	InMemCache &GetCacheForBlock(const InMemCacheBlock &block_key, bool footer_prefetch_eligible, idx_t file_size);
+
+	// Fetch [cache_miss_chunks] from remote storage and place them into in-memory cache keyed by [version_tag], or wait
+	// for ongoing fetches from other requesters. With [skip_in_flight], blocks being fetched by other requesters are
+	// skipped instead of waited for.
+	void FetchCacheMisses(FileHandle &handle, uint64_t version_tag, vector<CacheReadChunk *> cache_miss_chunks,
+	                      idx_t file_size, bool skip_in_flight);
+
+	// Fetch [remote_read_range] from remote storage, place fetched blocks into in-memory cache keyed by [version_tag],
+	// and share them with waiting requesters.
+	void FetchAndCacheInMem(FileHandle &handle, uint64_t version_tag, RemoteReadRange &remote_read_range,
+	                        idx_t file_size);
 
 	// Once flag to guard against cache's initialization.
 	std::once_flag cache_init_flag;
 	// LRU cache to store blocks; late initialized after first access.
 	unique_ptr<InMemCache> cache;
+	// High-priority LRU cache region to store footer blocks, which are not evicted by other blocks; late initialized
+	// along with [cache]. It's left null when its share of the budget doesn't fit a block, and footer blocks are stored
+	// in [cache].
+	unique_ptr<InMemCache> footer_cache;
+	// Used to deduplicate concurrent cache misses on the same data block.
+	InFlightBlocks in_flight_blocks;
 };
 
 } // namespace duckdb
@@ -0,0 +1,90 @@
+// A process-wide IO executor, which is shared by all cache readers and all cache filesystem instances to perform IO
+// subrequests in parallel.
+//
+// Compared with constructing a thread pool for each read request, a long-lived executor keeps thread creation and
+// destruction off the critical path, and bounds the overall number of IO threads in the process regardless of how many
+// concurrent read requests there are.
+//
+// It's designed as singleton for the same reason as [CacheReaderManager].
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <mutex>
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+#include "thread_pool.hpp"
+
+namespace duckdb {
+
+// Snapshot of IO executor status.
+struct IoExecutorStats {
+	// Number of IO threads.
+	uint64_t thread_count = 0;
+	// Number of IO threads executing tasks.
+	uint64_t busy_thread_count = 0;
+	// Number of tasks waiting in the queue, aka queue depth.
+	uint64_t pending_task_count = 0;
+	// Number of tasks finished since the extension loaded.
+	uint64_t completed_task_count = 0;
+};
+
+class IoExecutor {
+public:
+	static IoExecutor &Get();
+
+	// Set the number of IO threads, no-op if unchanged. Tasks already submitted are not affected.
+	void SetThreadCount(uint64_t thread_count);
+
+	// Get the thread pool to submit tasks to, which is lazily initialized with [GetIoThreadCount].
+	shared_ptr<ThreadPool> GetThreadPool();
+
+	// Get current status of the IO executor.
+	IoExecutorStats GetStats() const;
+
+	// Whether current thread is an IO executor thread.
+	static bool IsIoThread();
+
+private:
+	IoExecutor() = default;
+
+	mutable std::mutex mu;
+	shared_ptr<ThreadPool> thread_pool;
+	// Number of tasks completed by thread pools which have been replaced due to thread count update.
+	uint64_t retired_completed_task_count = 0;
+};
+
+// Tracks completion for a group of tasks (usually subrequests for one read request) submitted to the IO executor.
+// Unlike [ThreadPool::Wait], it only waits for tasks within the group, so concurrent read requests don't block each
+// other.
+class IoTaskGroup {
+public:
+	IoTaskGroup();
+
+	IoTaskGroup(const IoTaskGroup &) = delete;
+	IoTaskGroup &operator=(const IoTaskGroup &) = delete;
+
+	// Block until all submitted tasks finish, because tasks are allowed to reference caller stack.
+	~IoTaskGroup();
+
+	// Submit the [task] to the IO executor.
+	// If called from an IO thread, the task is executed inline to avoid deadlock with nested waits.
+	void Submit(std::function<void()> task);
+
+	// Block until all submitted tasks finish; rethrow the first exception thrown by tasks if any.
+	void Wait();
+
+	// Stop tracking finished tasks without blocking, exceptions thrown by them are discarded. Used by long-lived groups
+	// for background tasks, which are not waited for one by one.
+	void ReleaseFinishedTasks();
+
+private:
+	// Hold the thread pool, so it stays alive even if the executor gets resized.
+	shared_ptr<ThreadPool> thread_pool;
+	vector<std::future<void>> futures;
+};
+
+} // namespace duckdb
@@ -0,0 +1,55 @@
+// Tracks access pattern on a file handle, detects sequential streams and decides what to read ahead.
+//
+// Read-ahead window adapts to how prefetched blocks get consumed:
+// - Read-ahead starts after [MIN_SEQUENTIAL_READ_COUNT] consecutive sequential reads, with a small window;
+// - Once half of the blocks read ahead get consumed, the next window is issued, with its size doubled until reaching
+// the max block count, so remote latency gets hidden behind consumer;
+// - If access pattern breaks while there're unconsumed blocks read ahead, the window is halved.
+//
+// The tracker is not thread-safe.
+
+#pragma once
+
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+// Block-aligned byte range to read ahead, empty if [bytes_to_read] is 0.
+struct ReadAheadRange {
+	idx_t start_offset = 0;
+	idx_t bytes_to_read = 0;
+};
+
+class SequentialReadTracker {
+public:
+	// [max_read_ahead_block_count] 0 disables read-ahead.
+	SequentialReadTracker(idx_t block_size, idx_t max_read_ahead_block_count);
+
+	// Record a read of [bytes_to_read] bytes at [start_offset] for a file of [file_size] bytes, and return the range
+	// to read ahead.
+	ReadAheadRange RecordRead(idx_t start_offset, idx_t bytes_to_read, idx_t file_size);
+
+	// Get the current read-ahead window in blocks.
+	idx_t GetReadAheadBlockCount() const {
+		return read_ahead_block_count;
+	}
+
+private:
+	// Min number of consecutive sequential reads to start read-ahead.
+	static constexpr idx_t MIN_SEQUENTIAL_READ_COUNT = 2;
+	// Initial read-ahead window in blocks.
+	static constexpr idx_t INITIAL_READ_AHEAD_BLOCK_COUNT = 2;
+
+	const idx_t block_size;
+	const idx_t max_read_ahead_block_count;
+	// Offset where the next sequential read starts.
+	idx_t next_read_offset = 0;
+	// Number of consecutive sequential reads, including the current one.
+	idx_t sequential_read_count = 0;
+	// Current read-ahead window in blocks, 0 if read-ahead never happens.
+	idx_t read_ahead_block_count = 0;
+	// End offset for blocks already read ahead, 0 if there's none.
+	idx_t read_ahead_end_offset = 0;
+};
+
+} // namespace duckdb
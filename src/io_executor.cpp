@@ -0,0 +1,116 @@
+#include "io_executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <utility>
+
+#include "cache_filesystem_config.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// Name for all IO threads.
+constexpr const char *IO_THREAD_NAME = "CacheHttpfsIo";
+
+// Whether current thread is executing tasks for the IO executor.
+thread_local bool g_is_io_thread = false;
+
+} // namespace
+
+/*static*/ IoExecutor &IoExecutor::Get() {
+	static auto *io_executor = new IoExecutor();
+	return *io_executor;
+}
+
+/*static*/ bool IoExecutor::IsIoThread() {
+	return g_is_io_thread;
+}
+
+void IoExecutor::SetThreadCount(uint64_t thread_count) {
+	std::lock_guard<std::mutex> lck(mu);
+	if (thread_pool != nullptr && thread_pool->GetThreadCount() == thread_count) {
+		return;
+	}
+	// Ongoing task groups hold reference to the old thread pool, which is destructed after all of them finish.
+	if (thread_pool != nullptr) {
+		retired_completed_task_count += thread_pool->GetCompletedJobCount();
+	}
+	thread_pool = make_shared_ptr<ThreadPool>(thread_count, IO_THREAD_NAME);
+}
+
+shared_ptr<ThreadPool> IoExecutor::GetThreadPool() {
+	std::lock_guard<std::mutex> lck(mu);
+	if (thread_pool == nullptr) {
+		thread_pool = make_shared_ptr<ThreadPool>(GetIoThreadCount(), IO_THREAD_NAME);
+	}
+	return thread_pool;
+}
+
+IoExecutorStats IoExecutor::GetStats() const {
+	std::lock_guard<std::mutex> lck(mu);
+	IoExecutorStats stats;
+	stats.completed_task_count = retired_completed_task_count;
+	if (thread_pool == nullptr) {
+		return stats;
+	}
+	stats.thread_count = thread_pool->GetThreadCount();
+	stats.busy_thread_count = thread_pool->GetBusyThreadCount();
+	stats.pending_task_count = thread_pool->GetPendingJobCount();
+	stats.completed_task_count += thread_pool->GetCompletedJobCount();
+	return stats;
+}
+
+IoTaskGroup::IoTaskGroup() : thread_pool(IoExecutor::Get().GetThreadPool()) {
+}
+
+IoTaskGroup::~IoTaskGroup() {
+	for (auto &cur_future : futures) {
+		if (cur_future.valid()) {
+			cur_future.wait();
+		}
+	}
+}
+
+void IoTaskGroup::Submit(std::function<void()> task) {
+	// Waiting for nested tasks on an IO thread might exhaust all IO threads, so execute inline.
+	if (IoExecutor::IsIoThread()) {
+		std::packaged_task<void()> packaged_task {std::move(task)};
+		futures.emplace_back(packaged_task.get_future());
+		packaged_task();
+		return;
+	}
+	futures.emplace_back(thread_pool->Push([task = std::move(task)]() {
+		g_is_io_thread = true;
+		task();
+	}));
+}
+
+void IoTaskGroup::Wait() {
+	// Wait for all tasks before propagating exception, since tasks might still access caller-owned memory.
+	std::exception_ptr first_exception;
+	for (auto &cur_future : futures) {
+		try {
+			cur_future.get();
+		} catch (...) {
+			if (first_exception == nullptr) {
+				first_exception = std::current_exception();
+			}
+		}
+	}
+	futures.clear();
+	if (first_exception != nullptr) {
+		std::rethrow_exception(first_exception);
+	}
+}
+
+void IoTaskGroup::ReleaseFinishedTasks() {
+	auto is_finished = [](const std::future<void> &cur_future) {
+		return cur_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	};
+	futures.erase(std::remove_if(futures.begin(), futures.end(), is_finished), futures.end());
+}
+
+} // namespace duckdb
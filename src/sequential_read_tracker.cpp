@@ -0,0 +1,61 @@
+#include "sequential_read_tracker.hpp"
+
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+SequentialReadTracker::SequentialReadTracker(idx_t block_size_p, idx_t max_read_ahead_block_count_p)
+    : block_size(block_size_p), max_read_ahead_block_count(max_read_ahead_block_count_p) {
+}
+
+ReadAheadRange SequentialReadTracker::RecordRead(idx_t start_offset, idx_t bytes_to_read, idx_t file_size) {
+	if (max_read_ahead_block_count == 0 || bytes_to_read == 0) {
+		return {};
+	}
+
+	if (sequential_read_count > 0 && start_offset == next_read_offset) {
+		++sequential_read_count;
+	} else {
+		// Access pattern breaks, blocks read ahead but not consumed are wasted, so shrink the window.
+		if (read_ahead_end_offset > next_read_offset && read_ahead_block_count > 0) {
+			read_ahead_block_count = MaxValue<idx_t>(read_ahead_block_count / 2, 1);
+		}
+		sequential_read_count = 1;
+		read_ahead_end_offset = 0;
+	}
+	next_read_offset = start_offset + bytes_to_read;
+	if (sequential_read_count < MIN_SEQUENTIAL_READ_COUNT) {
+		return {};
+	}
+
+	// All blocks till the end of file have been read ahead.
+	if (read_ahead_end_offset >= file_size) {
+		return {};
+	}
+
+	// Blocks overlapping with the current read have been fetched by the read itself.
+	idx_t read_ahead_start_offset = (next_read_offset + block_size - 1) / block_size * block_size;
+	if (read_ahead_block_count == 0) {
+		read_ahead_block_count = MinValue<idx_t>(INITIAL_READ_AHEAD_BLOCK_COUNT, max_read_ahead_block_count);
+	} else if (read_ahead_end_offset > next_read_offset) {
+		// Consumer is reading blocks read ahead, issue the next window only after half of the current one consumed.
+		if (read_ahead_end_offset - next_read_offset > read_ahead_block_count * block_size / 2) {
+			return {};
+		}
+		read_ahead_start_offset = read_ahead_end_offset;
+		read_ahead_block_count = MinValue<idx_t>(read_ahead_block_count * 2, max_read_ahead_block_count);
+	} else if (read_ahead_end_offset > 0) {
+		// Consumer catches up with read-ahead, the window is too small to hide remote latency.
+		read_ahead_block_count = MinValue<idx_t>(read_ahead_block_count * 2, max_read_ahead_block_count);
+	}
+
+	const idx_t new_read_ahead_end_offset =
+	    MinValue<idx_t>(read_ahead_start_offset + read_ahead_block_count * block_size, file_size);
+	if (read_ahead_start_offset >= new_read_ahead_end_offset) {
+		return {};
+	}
+	read_ahead_end_offset = new_read_ahead_end_offset;
+	return ReadAheadRange {read_ahead_start_offset, new_read_ahead_end_offset - read_ahead_start_offset};
+}
+
+} // namespace duckdb
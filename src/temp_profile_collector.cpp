@@ -76,7 +76,7 @@ void TempProfileCollector::RecordOperationEnd(IoOperation io_oper, const std::st
 
 void TempProfileCollector::RecordCacheAccess(CacheEntity cache_entity, CacheAccess cache_access) {
 	std::lock_guard<std::mutex> lck(stats_mutex);
-	const size_t arr_idx = static_cast<size_t>(cache_entity) * 2 + static_cast<size_t>(cache_access);
+	const size_t arr_idx = static_cast<size_t>(cache_entity) * kCacheAccessCount + static_cast<size_t>(cache_access);
 	++cache_access_count[arr_idx];
 }
 
@@ -97,10 +97,12 @@ vector<CacheAccessInfo> TempProfileCollector::GetCacheAccessInfo() const {
 	vector<CacheAccessInfo> cache_access_info;
 	cache_access_info.reserve(kCacheEntityCount);
 	for (idx_t idx = 0; idx < kCacheEntityCount; ++idx) {
+		const idx_t arr_idx = idx * kCacheAccessCount;
 		cache_access_info.emplace_back(CacheAccessInfo {
 		    .cache_type = CACHE_ENTITY_NAMES[idx],
-		    .cache_hit_count = cache_access_count[idx * 2],
-		    .cache_miss_count = cache_access_count[idx * 2 + 1],
+		    .cache_hit_count = cache_access_count[arr_idx + static_cast<size_t>(CacheAccess::kCacheHit)],
+		    .cache_miss_count = cache_access_count[arr_idx + static_cast<size_t>(CacheAccess::kCacheMiss)],
+		    .cache_dedup_miss_count = cache_access_count[arr_idx + static_cast<size_t>(CacheAccess::kCacheDedupMiss)],
 		});
 	}
 	return cache_access_info;
@@ -114,11 +116,17 @@ std::pair<std::string, uint64_t> TempProfileCollector::GetHumanReadableStats() {
 
 	// Record cache miss and cache hit count.
 	for (idx_t cur_entity_idx = 0; cur_entity_idx < kCacheEntityCount; ++cur_entity_idx) {
+		const idx_t arr_idx = cur_entity_idx * kCacheAccessCount;
 		stats = StringUtil::Format("%s\n"
 		                           "%s cache hit count = %d\n"
-		                           "%s cache miss count = %d\n",
-		                           stats, CACHE_ENTITY_NAMES[cur_entity_idx], cache_access_count[cur_entity_idx * 2],
-		                           CACHE_ENTITY_NAMES[cur_entity_idx], cache_access_count[cur_entity_idx * 2 + 1]);
+		                           "%s cache miss count = %d\n"
+		                           "%s cache deduplicated miss count = %d\n",
+		                           stats, CACHE_ENTITY_NAMES[cur_entity_idx],
+		                           cache_access_count[arr_idx + static_cast<size_t>(CacheAccess::kCacheHit)],
+		                           CACHE_ENTITY_NAMES[cur_entity_idx],
+		                           cache_access_count[arr_idx + static_cast<size_t>(CacheAccess::kCacheMiss)],
+		                           CACHE_ENTITY_NAMES[cur_entity_idx],
+		                           cache_access_count[arr_idx + static_cast<size_t>(CacheAccess::kCacheDedupMiss)]);
 	}
 
 	// Record IO operation latency.
@@ -0,0 +1,195 @@
+#include "crc32c.hpp"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+// SSE4.2 is probed at runtime, so the extension still loads on machines without it.
+#define CACHE_HTTPFS_HAS_SSE42_CRC32C 1
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+// CRC instructions are only used when the build targets them (i.e. always the case on Apple silicon).
+#define CACHE_HTTPFS_HAS_ARM_CRC32C 1
+#include <arm_acle.h>
+#endif
+
+namespace duckdb {
+
+namespace {
+
+// Reversed representation for the Castagnoli polynomial.
+constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+// Number of bytes for each of the three lanes which are checksummed in an interleaved way, so latency for the crc
+// instruction is hidden by independent dependency chains.
+constexpr idx_t CRC32C_LANE_BYTES = 1024;
+
+struct Crc32cTables {
+	// Used to extend CRC state by one byte.
+	uint32_t byte_table[256];
+	// Used to extend CRC state over [CRC32C_LANE_BYTES] zero bytes, indexed by each byte of the state.
+	uint32_t lane_shift_table[4][256];
+};
+
+// Extend raw CRC [state] (i.e. without pre and post inversion) over [length] bytes of [data].
+uint32_t ExtendPortable(const Crc32cTables &tables, uint32_t state, const char *data, idx_t length) {
+	for (idx_t idx = 0; idx < length; ++idx) {
+		state = tables.byte_table[(state ^ static_cast<uint8_t>(data[idx])) & 0xFF] ^ (state >> 8);
+	}
+	return state;
+}
+
+Crc32cTables BuildCrc32cTables() {
+	Crc32cTables tables;
+	for (uint32_t byte = 0; byte < 256; ++byte) {
+		uint32_t crc = byte;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 1) != 0 ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+		}
+		tables.byte_table[byte] = crc;
+	}
+
+	// CRC state update is linear, so shifting over zero bytes is composed from shifts of every single state bit.
+	const char zeros[CRC32C_LANE_BYTES] = {};
+	uint32_t shifted_bits[32];
+	for (int bit = 0; bit < 32; ++bit) {
+		shifted_bits[bit] = ExtendPortable(tables, uint32_t {1} << bit, zeros, CRC32C_LANE_BYTES);
+	}
+	for (int byte_idx = 0; byte_idx < 4; ++byte_idx) {
+		for (uint32_t byte = 0; byte < 256; ++byte) {
+			uint32_t shifted = 0;
+			for (int bit = 0; bit < 8; ++bit) {
+				if ((byte >> bit) & 1) {
+					shifted ^= shifted_bits[byte_idx * 8 + bit];
+				}
+			}
+			tables.lane_shift_table[byte_idx][byte] = shifted;
+		}
+	}
+	return tables;
+}
+
+const Crc32cTables &GetCrc32cTables() {
+	static const Crc32cTables tables = BuildCrc32cTables();
+	return tables;
+}
+
+#if defined(CACHE_HTTPFS_HAS_SSE42_CRC32C) || defined(CACHE_HTTPFS_HAS_ARM_CRC32C)
+
+uint64_t LoadWord(const char *data) {
+	uint64_t word;
+	std::memcpy(&word, data, sizeof(word));
+	return word;
+}
+
+// Extend raw CRC [state] over [CRC32C_LANE_BYTES] zero bytes.
+uint32_t ShiftOverLane(const Crc32cTables &tables, uint32_t state) {
+	return tables.lane_shift_table[0][state & 0xFF] ^ tables.lane_shift_table[1][(state >> 8) & 0xFF] ^
+	       tables.lane_shift_table[2][(state >> 16) & 0xFF] ^ tables.lane_shift_table[3][state >> 24];
+}
+
+#endif
+
+#if defined(CACHE_HTTPFS_HAS_SSE42_CRC32C)
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t ExtendWord(uint32_t state, uint64_t word) {
+	return static_cast<uint32_t>(_mm_crc32_u64(state, word));
+}
+#else
+__attribute__((target("sse4.2"))) uint32_t ExtendWord(uint32_t state, uint64_t word) {
+	state = _mm_crc32_u32(state, static_cast<uint32_t>(word));
+	return _mm_crc32_u32(state, static_cast<uint32_t>(word >> 32));
+}
+#endif
+
+__attribute__((target("sse4.2"))) uint32_t ExtendByte(uint32_t state, char byte) {
+	return _mm_crc32_u8(state, static_cast<uint8_t>(byte));
+}
+
+bool IsHardwareCrc32cSupportedImpl() {
+	return __builtin_cpu_supports("sse4.2");
+}
+
+#define CACHE_HTTPFS_CRC32C_TARGET __attribute__((target("sse4.2")))
+
+#elif defined(CACHE_HTTPFS_HAS_ARM_CRC32C)
+
+uint32_t ExtendWord(uint32_t state, uint64_t word) {
+	return __crc32cd(state, word);
+}
+
+uint32_t ExtendByte(uint32_t state, char byte) {
+	return __crc32cb(state, static_cast<uint8_t>(byte));
+}
+
+bool IsHardwareCrc32cSupportedImpl() {
+	return true;
+}
+
+#define CACHE_HTTPFS_CRC32C_TARGET
+
+#endif
+
+#ifdef CACHE_HTTPFS_CRC32C_TARGET
+
+CACHE_HTTPFS_CRC32C_TARGET uint32_t ExtendHardware(const Crc32cTables &tables, uint32_t state, const char *data,
+                                                   idx_t length) {
+	// Lanes are checksummed from zero state, and combined by shifting the preceding state over lane length.
+	while (length >= 3 * CRC32C_LANE_BYTES) {
+		uint32_t state1 = 0;
+		uint32_t state2 = 0;
+		const char *lane1 = data + CRC32C_LANE_BYTES;
+		const char *lane2 = data + 2 * CRC32C_LANE_BYTES;
+		for (idx_t offset = 0; offset < CRC32C_LANE_BYTES; offset += sizeof(uint64_t)) {
+			state = ExtendWord(state, LoadWord(data + offset));
+			state1 = ExtendWord(state1, LoadWord(lane1 + offset));
+			state2 = ExtendWord(state2, LoadWord(lane2 + offset));
+		}
+		state = ShiftOverLane(tables, ShiftOverLane(tables, state) ^ state1) ^ state2;
+		data += 3 * CRC32C_LANE_BYTES;
+		length -= 3 * CRC32C_LANE_BYTES;
+	}
+	for (; length >= sizeof(uint64_t); data += sizeof(uint64_t), length -= sizeof(uint64_t)) {
+		state = ExtendWord(state, LoadWord(data));
+	}
+	for (; length > 0; ++data, --length) {
+		state = ExtendByte(state, *data);
+	}
+	return state;
+}
+
+#endif
+
+} // namespace
+
+uint32_t Crc32cPortable(const char *data, idx_t length, uint32_t crc) {
+	return ~ExtendPortable(GetCrc32cTables(), ~crc, data, length);
+}
+
+#ifdef CACHE_HTTPFS_CRC32C_TARGET
+
+uint32_t Crc32c(const char *data, idx_t length, uint32_t crc) {
+	if (!IsHardwareCrc32cSupported()) {
+		return Crc32cPortable(data, length, crc);
+	}
+	return ~ExtendHardware(GetCrc32cTables(), ~crc, data, length);
+}
+
+bool IsHardwareCrc32cSupported() {
+	static const bool is_supported = IsHardwareCrc32cSupportedImpl();
+	return is_supported;
+}
+
+#else
+
+uint32_t Crc32c(const char *data, idx_t length, uint32_t crc) {
+	return Crc32cPortable(data, length, crc);
+}
+
+bool IsHardwareCrc32cSupported() {
+	return false;
+}
+
+#endif
+
+} // namespace duckdb
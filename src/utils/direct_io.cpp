@@ -0,0 +1,349 @@
+#include "direct_io.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "no_destructor.hpp"
+#include "size_literals.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(__linux__) || defined(__FreeBSD__)
+#define CACHE_HTTPFS_HAS_DIRECT_IO 1
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+
+namespace {
+
+// Allocate [size] bytes aligned for direct IO, which should be released via [FreeAligned].
+char *AllocateAligned(idx_t size) {
+#ifdef _WIN32
+	void *data = _aligned_malloc(size, DIRECT_IO_ALIGNMENT);
+	if (data == nullptr) {
+		throw std::bad_alloc();
+	}
+#else
+	void *data = nullptr;
+	if (posix_memalign(&data, DIRECT_IO_ALIGNMENT, size) != 0) {
+		throw std::bad_alloc();
+	}
+#endif
+	return static_cast<char *>(data);
+}
+
+void FreeAligned(char *data) {
+#ifdef _WIN32
+	_aligned_free(data);
+#else
+	free(data);
+#endif
+}
+
+} // namespace
+
+AlignedBufferPool::Buffer::~Buffer() {
+	Release();
+}
+
+AlignedBufferPool::Buffer::Buffer(Buffer &&other) noexcept
+    : pool(other.pool), data(other.data), capacity(other.capacity) {
+	other.pool = nullptr;
+	other.data = nullptr;
+	other.capacity = 0;
+}
+
+AlignedBufferPool::Buffer &AlignedBufferPool::Buffer::operator=(Buffer &&other) noexcept {
+	if (this != &other) {
+		Release();
+		pool = other.pool;
+		data = other.data;
+		capacity = other.capacity;
+		other.pool = nullptr;
+		other.data = nullptr;
+		other.capacity = 0;
+	}
+	return *this;
+}
+
+void AlignedBufferPool::Buffer::Release() {
+	if (pool != nullptr && data != nullptr) {
+		pool->Release(data, capacity);
+	}
+	pool = nullptr;
+	data = nullptr;
+	capacity = 0;
+}
+
+AlignedBufferPool::AlignedBufferPool(idx_t max_idle_bytes_p) : max_idle_bytes(max_idle_bytes_p) {
+}
+
+AlignedBufferPool::~AlignedBufferPool() {
+	for (const auto &cur_buffer : idle_buffers) {
+		FreeAligned(cur_buffer.data);
+	}
+}
+
+AlignedBufferPool::Buffer AlignedBufferPool::Acquire(idx_t size) {
+	const idx_t capacity = AlignUpForDirectIo(std::max<idx_t>(size, 1));
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		// Prefer the most recently released buffer, whose memory is more likely to be hot.
+		for (auto iter = idle_buffers.rbegin(); iter != idle_buffers.rend(); ++iter) {
+			if (iter->capacity < capacity) {
+				continue;
+			}
+			Buffer buffer {this, iter->data, iter->capacity};
+			idle_bytes -= iter->capacity;
+			idle_buffers.erase(std::next(iter).base());
+			return buffer;
+		}
+	}
+	return Buffer {this, AllocateAligned(capacity), capacity};
+}
+
+void AlignedBufferPool::Release(char *data, idx_t capacity) {
+	{
+		std::lock_guard<std::mutex> lck(mu);
+		if (idle_bytes + capacity <= max_idle_bytes) {
+			idle_buffers.emplace_back(IdleBuffer {
+			    .data = data,
+			    .capacity = capacity,
+			});
+			idle_bytes += capacity;
+			return;
+		}
+	}
+	FreeAligned(data);
+}
+
+idx_t AlignedBufferPool::GetIdleBytes() const {
+	std::lock_guard<std::mutex> lck(mu);
+	return idle_bytes;
+}
+
+} // namespace duckdb
+
+#ifdef CACHE_HTTPFS_HAS_DIRECT_IO
+
+namespace duckdb {
+
+namespace {
+
+// Max number of bytes for one buffer to stage unaligned user buffers, larger IO is split into multiple rounds, so
+// memory for direct IO is bounded by concurrency rather than IO size.
+const idx_t DIRECT_IO_MAX_STAGING_BYTES = 1_MiB;
+
+// Max number of bytes held by idle staging buffers.
+const idx_t DIRECT_IO_BUFFER_POOL_MAX_IDLE_BYTES = 32_MiB;
+
+// Permission for files created by direct IO.
+constexpr mode_t DIRECT_IO_FILE_MODE = 0644;
+
+AlignedBufferPool &GetDirectIoBufferPool() {
+	static NoDestructor<AlignedBufferPool> buffer_pool {DIRECT_IO_BUFFER_POOL_MAX_IDLE_BYTES};
+	return *buffer_pool;
+}
+
+bool IsAligned(const char *buffer) {
+	return reinterpret_cast<uintptr_t>(buffer) % DIRECT_IO_ALIGNMENT == 0;
+}
+
+// Open [filepath] with direct IO, or with buffered IO if the filesystem doesn't support direct IO. Return -1 with errno
+// set on failure.
+int OpenFile(const std::string &filepath, int flags) {
+	const int fd = open(filepath.c_str(), flags | O_DIRECT | O_CLOEXEC, DIRECT_IO_FILE_MODE);
+	if (fd >= 0 || errno != EINVAL) {
+		return fd;
+	}
+	// The file could have been created before direct IO gets rejected, so exclusive creation is not required.
+	return open(filepath.c_str(), (flags & ~O_EXCL) | O_CLOEXEC, DIRECT_IO_FILE_MODE);
+}
+
+// Switch [fd] to buffered IO, for unaligned access.
+void DisableDirectIo(int fd, const std::string &filepath) {
+	const int flags = fcntl(fd, F_GETFL);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags & ~O_DIRECT) != 0) {
+		throw IOException("Fails to disable direct IO for file %s because %s", filepath, strerror(errno));
+	}
+}
+
+// Drop cached pages in [offset, offset + length) of [fd], which is best effort.
+void DropPageCache(int fd, idx_t offset, idx_t length) {
+	posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+}
+
+// Read up to [length] bytes at [offset] into [buffer], return the number of bytes read, which is less than [length]
+// only at end of file.
+idx_t ReadFully(int fd, char *buffer, idx_t length, idx_t offset, const std::string &filepath) {
+	idx_t bytes_read = 0;
+	while (bytes_read < length) {
+		const ssize_t ret = pread(fd, buffer + bytes_read, length - bytes_read, offset + bytes_read);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw IOException("Fails to read file %s because %s", filepath, strerror(errno));
+		}
+		if (ret == 0) {
+			break;
+		}
+		bytes_read += static_cast<idx_t>(ret);
+	}
+	return bytes_read;
+}
+
+void WriteFully(int fd, const char *data, idx_t length, idx_t offset, const std::string &filepath) {
+	idx_t bytes_written = 0;
+	while (bytes_written < length) {
+		const ssize_t ret = pwrite(fd, data + bytes_written, length - bytes_written, offset + bytes_written);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw IOException("Fails to write file %s because %s", filepath, strerror(errno));
+		}
+		bytes_written += static_cast<idx_t>(ret);
+	}
+}
+
+// Read the aligned prefix of [length] bytes into [buffer], which is staged through aligned buffers if [buffer] itself
+// is not aligned.
+idx_t ReadAlignedPrefix(int fd, char *buffer, idx_t length, const std::string &filepath) {
+	if (IsAligned(buffer)) {
+		return ReadFully(fd, buffer, length, /*offset=*/0, filepath);
+	}
+	auto staging_buffer = GetDirectIoBufferPool().Acquire(std::min(length, DIRECT_IO_MAX_STAGING_BYTES));
+	idx_t bytes_read = 0;
+	while (bytes_read < length) {
+		const idx_t cur_length = std::min(staging_buffer.GetCapacity(), length - bytes_read);
+		const idx_t cur_bytes_read = ReadFully(fd, staging_buffer.GetData(), cur_length, bytes_read, filepath);
+		std::memcpy(buffer + bytes_read, staging_buffer.GetData(), cur_bytes_read);
+		bytes_read += cur_bytes_read;
+		if (cur_bytes_read < cur_length) {
+			break;
+		}
+	}
+	return bytes_read;
+}
+
+void WriteAlignedPrefix(int fd, const char *data, idx_t length, const std::string &filepath) {
+	if (IsAligned(data)) {
+		WriteFully(fd, data, length, /*offset=*/0, filepath);
+		return;
+	}
+	auto staging_buffer = GetDirectIoBufferPool().Acquire(std::min(length, DIRECT_IO_MAX_STAGING_BYTES));
+	idx_t bytes_written = 0;
+	while (bytes_written < length) {
+		const idx_t cur_length = std::min(staging_buffer.GetCapacity(), length - bytes_written);
+		std::memcpy(staging_buffer.GetData(), data + bytes_written, cur_length);
+		WriteFully(fd, staging_buffer.GetData(), cur_length, bytes_written, filepath);
+		bytes_written += cur_length;
+	}
+}
+
+} // namespace
+
+bool IsDirectIoSupported() {
+	return true;
+}
+
+int64_t DirectIoReadFile(const std::string &filepath, char *buffer, idx_t length, char *trailer,
+                         idx_t trailer_length) {
+	const int fd = OpenFile(filepath, O_RDONLY);
+	if (fd < 0) {
+		if (errno == ENOENT) {
+			return -1;
+		}
+		throw IOException("Fails to open file %s because %s", filepath, strerror(errno));
+	}
+
+	idx_t bytes_read = 0;
+	try {
+		const idx_t aligned_length = AlignDownForDirectIo(length);
+		if (aligned_length > 0) {
+			bytes_read = ReadAlignedPrefix(fd, buffer, aligned_length, filepath);
+		}
+		// Unaligned tail and trailer go through page cache, unless the file ends before them.
+		if (bytes_read == aligned_length && aligned_length < length + trailer_length) {
+			DisableDirectIo(fd, filepath);
+			bytes_read += ReadFully(fd, buffer + aligned_length, length - aligned_length, aligned_length, filepath);
+			if (bytes_read == length && trailer_length > 0) {
+				bytes_read += ReadFully(fd, trailer, trailer_length, length, filepath);
+			}
+			DropPageCache(fd, aligned_length, length + trailer_length - aligned_length);
+		}
+	} catch (...) {
+		close(fd);
+		throw;
+	}
+	close(fd);
+	return static_cast<int64_t>(bytes_read);
+}
+
+void DirectIoWriteFile(const std::string &filepath, const char *data, idx_t length, bool sync, const char *trailer,
+                       idx_t trailer_length) {
+	const int fd = OpenFile(filepath, O_WRONLY | O_CREAT | O_EXCL);
+	if (fd < 0) {
+		throw IOException("Fails to create file %s because %s", filepath, strerror(errno));
+	}
+
+	try {
+		const idx_t aligned_length = AlignDownForDirectIo(length);
+		const bool has_buffered_tail = aligned_length < length + trailer_length;
+		if (aligned_length > 0) {
+			WriteAlignedPrefix(fd, data, aligned_length, filepath);
+		}
+		if (has_buffered_tail) {
+			DisableDirectIo(fd, filepath);
+			WriteFully(fd, data + aligned_length, length - aligned_length, aligned_length, filepath);
+			WriteFully(fd, trailer, trailer_length, length, filepath);
+		}
+		if (sync && fsync(fd) != 0) {
+			throw IOException("Fails to sync file %s because %s", filepath, strerror(errno));
+		}
+		// Dirty pages are not dropped until they're written back, so it only takes effect for synced tails.
+		if (has_buffered_tail) {
+			DropPageCache(fd, aligned_length, length + trailer_length - aligned_length);
+		}
+	} catch (...) {
+		close(fd);
+		unlink(filepath.c_str());
+		throw;
+	}
+	close(fd);
+}
+
+} // namespace duckdb
+
+#else
+
+namespace duckdb {
+
+bool IsDirectIoSupported() {
+	return false;
+}
+
+int64_t DirectIoReadFile(const std::string &filepath, char *buffer, idx_t length, char *trailer,
+                         idx_t trailer_length) {
+	throw NotImplementedException("Direct IO is not supported on current platform");
+}
+
+void DirectIoWriteFile(const std::string &filepath, const char *data, idx_t length, bool sync, const char *trailer,
+                       idx_t trailer_length) {
+	throw NotImplementedException("Direct IO is not supported on current platform");
+}
+
+} // namespace duckdb
+
+#endif
@@ -1,9 +1,13 @@
 #include "filesystem_utils.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <ctime>
 
+#include <fcntl.h>
 #include <sys/statvfs.h>
+#include <unistd.h>
 
 #include "cache_filesystem_config.hpp"
 #include "duckdb/common/file_system.hpp"
@@ -34,17 +38,50 @@ void EvictStaleCacheFiles(FileSystem &local_filesystem, const string &cache_dire
 	    });
 }
 
+namespace {
+
+// List all files under the given local filesystem [folder] recursively, with paths relative to [folder].
+void ListFilesRecursively(FileSystem &local_filesystem, const std::string &folder, const std::string &relative_dir,
+                          vector<std::string> &file_paths) {
+	const std::string cur_folder = relative_dir.empty() ? folder : StringUtil::Format("%s/%s", folder, relative_dir);
+	local_filesystem.ListFiles(cur_folder, [&](const string &fname, bool is_dir) {
+		const std::string relative_path =
+		    relative_dir.empty() ? fname : StringUtil::Format("%s/%s", relative_dir, fname);
+		if (is_dir) {
+			ListFilesRecursively(local_filesystem, folder, relative_path, file_paths);
+			return;
+		}
+		file_paths.emplace_back(relative_path);
+	});
+}
+
+} // namespace
+
 int GetFileCountUnder(const std::string &folder) {
-	int file_count = 0;
-	LocalFileSystem::CreateLocal()->ListFiles(
-	    folder, [&file_count](const string & /*unused*/, bool /*unused*/) { ++file_count; });
-	return file_count;
+	return static_cast<int>(GetSortedFilesUnder(folder).size());
+}
+
+idx_t GetFileSizeUnder(const std::string &folder) {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	vector<std::string> file_paths;
+	ListFilesRecursively(*local_filesystem, folder, /*relative_dir=*/"", file_paths);
+	idx_t total_file_size = 0;
+	for (const auto &cur_file_path : file_paths) {
+		// Files could be deleted concurrently, tolerate non-existent file.
+		auto file_handle = local_filesystem->OpenFile(StringUtil::Format("%s/%s", folder, cur_file_path),
+		                                              FileOpenFlags::FILE_FLAGS_READ |
+		                                                  FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (file_handle == nullptr) {
+			continue;
+		}
+		total_file_size += static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle));
+	}
+	return total_file_size;
 }
 
 vector<std::string> GetSortedFilesUnder(const std::string &folder) {
 	vector<std::string> file_names;
-	LocalFileSystem::CreateLocal()->ListFiles(
-	    folder, [&file_names](const string &fname, bool /*unused*/) { file_names.emplace_back(fname); });
+	ListFilesRecursively(*LocalFileSystem::CreateLocal(), folder, /*relative_dir=*/"", file_names);
 	std::sort(file_names.begin(), file_names.end());
 	return file_names;
 }
@@ -87,4 +124,52 @@ bool CanCacheOnDisk(const std::string &path) {
 	return overall_fs_bytes * MIN_DISK_SPACE_PERCENTAGE_FOR_CACHE <= avai_fs_bytes.GetIndex();
 }
 
+void SyncFileSystem(const std::string &path) {
+#if defined(__linux__)
+	const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY);
+	if (fd == -1) {
+		throw IOException("Fails to open %s for filesystem sync because %s", path, strerror(errno));
+	}
+	const int ret_code = syncfs(fd);
+	const int sync_errno = errno;
+	close(fd);
+	if (ret_code != 0) {
+		throw IOException("Fails to sync filesystem for %s because %s", path, strerror(sync_errno));
+	}
+#else
+	sync();
+#endif
+}
+
+bool MatchGlobPattern(const std::string &path, const std::string &pattern) {
+	idx_t path_idx = 0;
+	idx_t pattern_idx = 0;
+	// Positions for the last `*` in pattern and its matched path, to backtrack on mismatch.
+	idx_t star_pattern_idx = std::string::npos;
+	idx_t star_path_idx = 0;
+	while (path_idx < path.length()) {
+		if (pattern_idx < pattern.length() && (pattern[pattern_idx] == '?' || pattern[pattern_idx] == path[path_idx])) {
+			++path_idx;
+			++pattern_idx;
+			continue;
+		}
+		if (pattern_idx < pattern.length() && pattern[pattern_idx] == '*') {
+			star_pattern_idx = pattern_idx++;
+			star_path_idx = path_idx;
+			continue;
+		}
+		// Let the last `*` match one more character.
+		if (star_pattern_idx != std::string::npos) {
+			pattern_idx = star_pattern_idx + 1;
+			path_idx = ++star_path_idx;
+			continue;
+		}
+		return false;
+	}
+	while (pattern_idx < pattern.length() && pattern[pattern_idx] == '*') {
+		++pattern_idx;
+	}
+	return pattern_idx == pattern.length();
+}
+
 } // namespace duckdb
@@ -0,0 +1,22 @@
+// CRC32C (Castagnoli) checksum, computed with SSE4.2 or ARMv8 CRC instructions when available, and a table-driven
+// implementation otherwise.
+
+#pragma once
+
+#include <cstdint>
+
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+// Compute CRC32C for [length] bytes of [data]. [crc] is the checksum of preceding data, so checksum for discontiguous
+// buffers could be computed incrementally, for example, `Crc32c(b, len_b, Crc32c(a, len_a))`.
+uint32_t Crc32c(const char *data, idx_t length, uint32_t crc = 0);
+
+// Compute CRC32C without hardware instructions, which is exposed for testing.
+uint32_t Crc32cPortable(const char *data, idx_t length, uint32_t crc = 0);
+
+// Return whether CRC32C is computed with hardware instructions on current machine.
+bool IsHardwareCrc32cSupported();
+
+} // namespace duckdb
@@ -0,0 +1,115 @@
+// Local file IO bypassing kernel page cache (i.e. O_DIRECT), so file content doesn't get cached again by the kernel on
+// top of caches maintained by the process itself.
+//
+// Direct IO requires buffers, offsets and lengths to be aligned to the logical block size of the device, so the aligned
+// prefix of a file goes through buffers from [AlignedBufferPool], and the unaligned tail (along with trailing metadata
+// if any) falls back to buffered IO, whose pages are dropped from page cache afterwards. Filesystems which don't
+// support direct IO (i.e. tmpfs on old kernels) fall back to buffered IO as well.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// Alignment for buffers, file offsets and lengths of direct IO, which is a multiple of logical block size for common
+// devices.
+inline constexpr idx_t DIRECT_IO_ALIGNMENT = 4096;
+
+// Round [size] up to a multiple of [DIRECT_IO_ALIGNMENT].
+inline idx_t AlignUpForDirectIo(idx_t size) {
+	return (size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+}
+
+// Round [size] down to a multiple of [DIRECT_IO_ALIGNMENT].
+inline idx_t AlignDownForDirectIo(idx_t size) {
+	return size / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+}
+
+// A pool of buffers aligned to [DIRECT_IO_ALIGNMENT], which are reused across IO operations instead of allocated and
+// freed for each of them. Idle buffers are kept up to [max_idle_bytes], released buffers beyond that are freed, so
+// memory held by the pool is bounded.
+//
+// Thread-safe.
+class AlignedBufferPool {
+public:
+	// A buffer acquired from the pool, which is returned to the pool on destruction.
+	class Buffer {
+	public:
+		Buffer() = default;
+		Buffer(AlignedBufferPool *pool_p, char *data_p, idx_t capacity_p)
+		    : pool(pool_p), data(data_p), capacity(capacity_p) {
+		}
+		~Buffer();
+
+		Buffer(const Buffer &) = delete;
+		Buffer &operator=(const Buffer &) = delete;
+		Buffer(Buffer &&other) noexcept;
+		Buffer &operator=(Buffer &&other) noexcept;
+
+		char *GetData() const {
+			return data;
+		}
+		// Number of usable bytes, which is a multiple of [DIRECT_IO_ALIGNMENT].
+		idx_t GetCapacity() const {
+			return capacity;
+		}
+
+	private:
+		void Release();
+
+		AlignedBufferPool *pool = nullptr;
+		char *data = nullptr;
+		idx_t capacity = 0;
+	};
+
+	explicit AlignedBufferPool(idx_t max_idle_bytes_p);
+	~AlignedBufferPool();
+
+	// Disable copy and move.
+	AlignedBufferPool(const AlignedBufferPool &) = delete;
+	AlignedBufferPool &operator=(const AlignedBufferPool &) = delete;
+
+	// Acquire a buffer with at least [size] bytes.
+	Buffer Acquire(idx_t size);
+
+	// Get number of bytes held by idle buffers.
+	idx_t GetIdleBytes() const;
+
+private:
+	struct IdleBuffer {
+		char *data = nullptr;
+		idx_t capacity = 0;
+	};
+
+	// Put [data] back to the pool, or free it if the pool is full.
+	void Release(char *data, idx_t capacity);
+
+	const idx_t max_idle_bytes;
+	mutable std::mutex mu;
+	// Buffers ready for reuse, the most recently released at the back.
+	vector<IdleBuffer> idle_buffers;
+	idx_t idle_bytes = 0;
+};
+
+// Return whether direct IO is supported on current platform.
+bool IsDirectIoSupported();
+
+// Read up to [length] bytes of [filepath] from offset 0 into [buffer] bypassing page cache, followed by up to
+// [trailer_length] bytes into [trailer] if given; return the number of bytes read into both buffers, which is less than
+// requested if the file is shorter; return -1 if the file doesn't exist. Throw IOException on other failures.
+int64_t DirectIoReadFile(const std::string &filepath, char *buffer, idx_t length, char *trailer = nullptr,
+                         idx_t trailer_length = 0);
+
+// Create [filepath] exclusively and write [length] bytes of [data] into it bypassing page cache, followed by
+// [trailer_length] bytes of [trailer] if given; the file is synced if [sync]. On failure the file is removed and
+// IOException is thrown.
+void DirectIoWriteFile(const std::string &filepath, const char *data, idx_t length, bool sync,
+                       const char *trailer = nullptr, idx_t trailer_length = 0);
+
+} // namespace duckdb
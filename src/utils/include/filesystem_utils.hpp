@@ -15,11 +15,14 @@ namespace duckdb {
 // space detected, which happens rarely thus not a big concern.
 void EvictStaleCacheFiles(FileSystem &local_filesystem, const string &cache_directory);
 
-// Get the number of files under the given local filesystem [folder].
+// Get the number of files under the given local filesystem [folder], including those in its subdirectories.
 int GetFileCountUnder(const std::string &folder);
 
-// Get all files under the given local filesystem [folder] in alphabetically
-// ascending order.
+// Get overall bytes of files under the given local filesystem [folder], including those in its subdirectories.
+idx_t GetFileSizeUnder(const std::string &folder);
+
+// Get all files under the given local filesystem [folder] and its subdirectories in alphabetically
+// ascending order, with paths relative to [folder].
 vector<std::string> GetSortedFilesUnder(const std::string &folder);
 
 // Get all disk space in bytes for the filesystem indicated by the given [path].
@@ -28,4 +31,12 @@ idx_t GetOverallFileSystemDiskSpace(const std::string &path);
 // Return whether we could cache content in the filesystem specified by the given [path].
 bool CanCacheOnDisk(const std::string &path);
 
+// Flush all pending writes for the filesystem indicated by the given [path] to disk. On platforms without
+// per-filesystem sync, all filesystems are synced.
+void SyncFileSystem(const std::string &path);
+
+// Return whether the given [path] matches glob [pattern], which supports `*` (any sequence of characters) and `?` (any
+// single character) wildcards.
+bool MatchGlobPattern(const std::string &path, const std::string &pattern);
+
 } // namespace duckdb
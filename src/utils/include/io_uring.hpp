@@ -0,0 +1,61 @@
+// Batched local file IO based on io_uring, implemented with raw syscalls so no extra dependency is required.
+//
+// Each batch of files goes through a few stages (i.e. open, read or write, sync, close, rename), and each stage of all
+// files is issued in one submission and reaped in batch, so IO for N files costs a few syscalls rather than a few per
+// file, and concurrency doesn't depend on the number of threads.
+//
+// Every thread owns its own ring, which is created lazily on first use. io_uring is only available on Linux with kernel
+// 5.12 or above, and could be forbidden by seccomp (i.e. inside containers); callers should check availability first
+// and fall back to blocking IO otherwise.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+struct IoUringReadRequest {
+	// File to read from offset 0.
+	std::string filepath;
+	// Buffer to read into, which holds at least [length] bytes.
+	char *buffer = nullptr;
+	idx_t length = 0;
+	// Optional buffer for [trailer_length] bytes right after the first [length] bytes, which are read in the same
+	// operation, so trailing metadata doesn't require a separate read or copy.
+	char *trailer = nullptr;
+	idx_t trailer_length = 0;
+	// Number of bytes read into both buffers, which is less than [length] + [trailer_length] if the file is shorter; or
+	// negative errno on failure, for example, -ENOENT if the file doesn't exist.
+	int64_t result = 0;
+};
+
+struct IoUringWriteRequest {
+	// File to write [data] into, which is created exclusively and atomically moved to [filepath] after write, so
+	// readers never see a partially written file.
+	std::string temp_filepath;
+	std::string filepath;
+	const char *data = nullptr;
+	idx_t length = 0;
+	// Optional [trailer_length] bytes written right after [data] in the same operation.
+	const char *trailer = nullptr;
+	idx_t trailer_length = 0;
+	// 0 on success; or negative errno on failure, in which case the temporary file is removed.
+	int64_t result = 0;
+};
+
+// Return whether io_uring and all operations required by batched file IO are supported, which is probed only once.
+bool IsIoUringAvailable();
+
+// Read all [requests] on the calling thread, failures are reported via request results rather than thrown. io_uring is
+// required to be available.
+void IoUringReadFiles(vector<IoUringReadRequest> &requests);
+
+// Write all [requests] on the calling thread, files are synced before they're moved if [sync]. Failures are reported
+// via request results rather than thrown. io_uring is required to be available.
+void IoUringWriteFiles(vector<IoUringWriteRequest> &requests, bool sync);
+
+} // namespace duckdb
@@ -0,0 +1,46 @@
+// Read-only memory mapping for a whole local file, which serves reads by copying from mapped memory instead of issuing
+// read syscalls into intermediate buffers.
+//
+// A mapping stays valid after its file gets deleted (disk space is only reclaimed after unmap), but not if the file
+// gets truncated, so it's only suitable for files which are immutable once visible.
+
+#pragma once
+
+#include <string>
+
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+namespace duckdb {
+
+class MappedFile {
+public:
+	// Map [filepath] read-only, return nullptr if the file doesn't exist. Throw IOException on other failures.
+	static unique_ptr<MappedFile> Open(const std::string &filepath);
+
+	~MappedFile();
+
+	// Disable copy and move.
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	// Get the start address for file content, which is nullptr for empty files.
+	const char *GetData() const {
+		return data;
+	}
+	idx_t GetSize() const {
+		return size;
+	}
+
+private:
+	MappedFile(const char *data_p, idx_t size_p) : data(data_p), size(size_p) {
+	}
+
+	const char *data = nullptr;
+	idx_t size = 0;
+};
+
+// Return whether memory mapping is supported on current platform.
+bool IsMmapSupported();
+
+} // namespace duckdb
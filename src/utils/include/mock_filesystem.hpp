@@ -27,6 +27,9 @@ public:
 		close_callback();
 	}
 
+	// File offset for stream reads.
+	idx_t file_offset = 0;
+
 private:
 	std::function<void()> close_callback;
 	std::function<void()> dtor_callback;
@@ -54,7 +57,14 @@ public:
 		++get_file_size_invocation;
 		return file_size;
 	}
+	time_t GetLastModifiedTime(FileHandle &handle) override {
+		return 0;
+	}
 	void Seek(FileHandle &handle, idx_t location) override {
+		handle.Cast<MockFileHandle>().file_offset = location;
+	}
+	idx_t SeekPosition(FileHandle &handle) override {
+		return handle.Cast<MockFileHandle>().file_offset;
 	}
 	std::string GetName() const override {
 		return "mock filesystem";
@@ -8,6 +8,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <optional>
@@ -18,6 +19,7 @@
 #include <mutex>
 
 #include "duckdb/common/helper.hpp"
+#include "duckdb/common/unique_ptr.hpp"
 #include "duckdb/common/vector.hpp"
 #include "map_utils.hpp"
 #include "time_utils.hpp"
@@ -31,12 +33,18 @@ public:
 	using mapped_type = shared_ptr<Val>;
 	using hasher = KeyHash;
 	using key_equal = KeyEqual;
+	// Returns the weight of a cached value, which is used to cap the overall weight of cache entries.
+	using Weigher = std::function<size_t(const Val &)>;
 
 	// @param max_entries_p: A `max_entries` of 0 means that there is no limit on the number of entries in the cache.
 	// @param timeout_millisec_p: Timeout in milliseconds for entries, exceeding which invalidates the cache entries; 0
 	// means no timeout.
-	SharedLruCache(size_t max_entries_p, uint64_t timeout_millisec_p)
-	    : max_entries(max_entries_p), timeout_millisec(timeout_millisec_p) {
+	// @param max_total_weight_p: Max overall weight for all entries measured by `weigher_p`; 0 means that there is no
+	// limit on the overall weight.
+	SharedLruCache(size_t max_entries_p, uint64_t timeout_millisec_p, size_t max_total_weight_p = 0,
+	               Weigher weigher_p = nullptr)
+	    : max_entries(max_entries_p), timeout_millisec(timeout_millisec_p), max_total_weight(max_total_weight_p),
+	      weigher(std::move(weigher_p)) {
 	}
 
 	// Disable copy and move.
@@ -47,19 +55,29 @@ public:
 
 	// Insert `value` with key `key`. This will replace any previous entry with the same key.
 	void Put(Key key, shared_ptr<Val> value) {
-		lru_list.emplace_front(key);
+		// Drop the previous entry, so its LRU list node and weight don't linger.
+		Delete(key);
+
+		const size_t weight = weigher ? weigher(*value) : 0;
+		// A value which exceeds weight limit by itself would evict everything else, so skip caching it at all.
+		if (max_total_weight > 0 && weight > max_total_weight) {
+			return;
+		}
+		lru_list.emplace_front(std::move(key));
 		Entry new_entry {
 		    .value = std::move(value),
 		    .timestamp = static_cast<uint64_t>(GetSteadyNowMilliSecSinceEpoch()),
+		    .weight = weight,
 		    .lru_iterator = lru_list.begin(),
 		};
 		auto key_cref = std::cref(lru_list.front());
 		entry_map[key_cref] = std::move(new_entry);
+		total_weight += weight;
 
-		if (max_entries > 0 && lru_list.size() > max_entries) {
-			const auto &stale_key = lru_list.back();
-			entry_map.erase(stale_key);
-			lru_list.pop_back();
+		// Evict least recently used entries until both entry count and overall weight are within limit.
+		while ((max_entries > 0 && lru_list.size() > max_entries) ||
+		       (max_total_weight > 0 && total_weight > max_total_weight)) {
+			DeleteImpl(entry_map.find(lru_list.back()));
 		}
 	}
 
@@ -99,6 +117,7 @@ public:
 	void Clear() {
 		entry_map.clear();
 		lru_list.clear();
+		total_weight = 0;
 	}
 
 	// Clear cache entry by its key functor.
@@ -119,6 +138,14 @@ public:
 	size_t MaxEntries() const {
 		return max_entries;
 	}
+	size_t MaxTotalWeight() const {
+		return max_total_weight;
+	}
+
+	// Get the overall weight for all entries inside of the cache.
+	size_t TotalWeight() const {
+		return total_weight;
+	}
 
 	// Get all keys inside of the cache; the order of keys returned is not deterministic.
 	vector<Key> Keys() const {
@@ -142,6 +169,9 @@ private:
 		// 2. It's updated at replace update operations.
 		uint64_t timestamp;
 
+		// Weight of the value measured by weigher.
+		size_t weight;
+
 		// A list iterator pointing to the entry's position in the LRU list.
 		typename std::list<Key>::iterator lru_iterator;
 	};
@@ -151,8 +181,11 @@ private:
 
 	// Delete key-value pairs indicated by the given entry map iterator [iter] from cache.
 	void DeleteImpl(typename EntryMap::iterator iter) {
-		lru_list.erase(iter->second.lru_iterator);
+		total_weight -= iter->second.weight;
+		auto lru_iterator = iter->second.lru_iterator;
+		// Erase map entry before list node, since map key references the key owned by the list node.
 		entry_map.erase(iter);
+		lru_list.erase(lru_iterator);
 	}
 
 	// The maximum number of entries in the cache. A value of 0 means there is no limit on entry count.
@@ -161,6 +194,15 @@ private:
 	// The timeout in seconds for cache entries; entries with exceeding timeout would be invalidated.
 	const uint64_t timeout_millisec;
 
+	// The maximum overall weight of entries in the cache. A value of 0 means there is no limit on weight.
+	const size_t max_total_weight;
+
+	// Used to measure weight for cache values, only invoked when specified.
+	const Weigher weigher;
+
+	// The overall weight of entries in the cache.
+	size_t total_weight = 0;
+
 	// All keys are stored as refernce (`std::reference_wrapper`), and the ownership lies in `lru_list`.
 	EntryMap entry_map;
 
@@ -181,12 +223,16 @@ public:
 	using mapped_type = typename lru_impl::mapped_type;
 	using hasher = typename lru_impl::hasher;
 	using key_equal = typename lru_impl::key_equal;
+	using Weigher = typename lru_impl::Weigher;
 
 	// @param max_entries_p: A `max_entries` of 0 means that there is no limit on the number of entries in the cache.
 	// @param timeout_millisec_p: Timeout in milliseconds for entries, exceeding which invalidates the cache entries; 0
 	// means no timeout.
-	ThreadSafeSharedLruCache(size_t max_entries, uint64_t timeout_millisec)
-	    : internal_cache(max_entries, timeout_millisec) {
+	// @param max_total_weight_p: Max overall weight for all entries measured by `weigher_p`; 0 means that there is no
+	// limit on the overall weight.
+	ThreadSafeSharedLruCache(size_t max_entries, uint64_t timeout_millisec, size_t max_total_weight = 0,
+	                         Weigher weigher = nullptr)
+	    : internal_cache(max_entries, timeout_millisec, max_total_weight, std::move(weigher)) {
 	}
 
 	// Disable copy and move.
@@ -232,6 +278,15 @@ public:
 	size_t MaxEntries() const {
 		return internal_cache.MaxEntries();
 	}
+	size_t MaxTotalWeight() const {
+		return internal_cache.MaxTotalWeight();
+	}
+
+	// Get the overall weight for all entries inside of the cache.
+	size_t TotalWeight() const {
+		std::lock_guard<std::mutex> lock(mu);
+		return internal_cache.TotalWeight();
+	}
 
 	// Get all keys inside of the cache; the order of keys returned is not deterministic.
 	vector<Key> Keys() const {
@@ -313,4 +368,137 @@ private:
 template <typename K, typename V, typename KeyHash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
 using ThreadSafeSharedLruConstCache = ThreadSafeSharedLruCache<K, const V, KeyHash, KeyEqual>;
 
+// Thread-safe implementation, which splits entries into independent LRU shards by key hash; each shard has its own
+// mutex, limits and eviction, so concurrent accesses on different keys rarely contend with each other.
+//
+// Entry count and overall weight limits are evenly split among shards, so eviction is approximately LRU.
+template <typename Key, typename Val, typename KeyHash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ThreadSafeShardedSharedLruCache {
+public:
+	using shard_impl = ThreadSafeSharedLruCache<Key, Val, KeyHash, KeyEqual>;
+	using key_type = typename shard_impl::key_type;
+	using mapped_type = typename shard_impl::mapped_type;
+	using hasher = typename shard_impl::hasher;
+	using key_equal = typename shard_impl::key_equal;
+	using Weigher = typename shard_impl::Weigher;
+
+	// @param shard_count: Number of LRU shards, which is capped by `max_entries` so that each shard holds at least one
+	// entry.
+	// @param max_entries_p: A `max_entries` of 0 means that there is no limit on the number of entries in the cache.
+	// @param timeout_millisec_p: Timeout in milliseconds for entries, exceeding which invalidates the cache entries; 0
+	// means no timeout.
+	// @param max_total_weight_p: Max overall weight for all entries measured by `weigher_p`; 0 means that there is no
+	// limit on the overall weight.
+	ThreadSafeShardedSharedLruCache(size_t shard_count, size_t max_entries, uint64_t timeout_millisec,
+	                                size_t max_total_weight = 0, Weigher weigher = nullptr) {
+		if (shard_count == 0) {
+			shard_count = 1;
+		}
+		if (max_entries > 0 && shard_count > max_entries) {
+			shard_count = max_entries;
+		}
+		const size_t max_entries_per_shard = (max_entries + shard_count - 1) / shard_count;
+		const size_t max_total_weight_per_shard = (max_total_weight + shard_count - 1) / shard_count;
+		shards.reserve(shard_count);
+		for (size_t idx = 0; idx < shard_count; ++idx) {
+			shards.emplace_back(
+			    make_uniq<shard_impl>(max_entries_per_shard, timeout_millisec, max_total_weight_per_shard, weigher));
+		}
+	}
+
+	// Disable copy and move.
+	ThreadSafeShardedSharedLruCache(const ThreadSafeShardedSharedLruCache &) = delete;
+	ThreadSafeShardedSharedLruCache &operator=(const ThreadSafeShardedSharedLruCache &) = delete;
+
+	~ThreadSafeShardedSharedLruCache() = default;
+
+	// Insert `value` with key `key`. This will replace any previous entry with the same key.
+	void Put(Key key, shared_ptr<Val> value) {
+		auto &shard = GetShard(key);
+		shard.Put(std::move(key), std::move(value));
+	}
+
+	// Delete the entry with key `key`. Return true if the entry was found for `key`, false if the entry was not found.
+	// In both cases, there is no entry with key `key` existed after the call.
+	bool Delete(const Key &key) {
+		return GetShard(key).Delete(key);
+	}
+
+	// Look up the entry with key `key`.
+	// Return nullptr if `key` doesn't exist in cache.
+	shared_ptr<Val> Get(const Key &key) {
+		return GetShard(key).Get(key);
+	}
+
+	// Clear the cache.
+	void Clear() {
+		for (auto &cur_shard : shards) {
+			cur_shard->Clear();
+		}
+	}
+
+	// Clear cache entry by its key functor.
+	template <typename KeyFilter>
+	void Clear(KeyFilter &&key_filter) {
+		for (auto &cur_shard : shards) {
+			cur_shard->Clear(key_filter);
+		}
+	}
+
+	// Accessors for cache parameters.
+	size_t ShardCount() const {
+		return shards.size();
+	}
+	size_t MaxEntries() const {
+		return shards.front()->MaxEntries() * shards.size();
+	}
+	size_t MaxTotalWeight() const {
+		return shards.front()->MaxTotalWeight() * shards.size();
+	}
+
+	// Get the overall weight for all entries inside of the cache.
+	size_t TotalWeight() const {
+		size_t total_weight = 0;
+		for (const auto &cur_shard : shards) {
+			total_weight += cur_shard->TotalWeight();
+		}
+		return total_weight;
+	}
+
+	// Get all keys inside of the cache; the order of keys returned is not deterministic.
+	vector<Key> Keys() const {
+		vector<Key> keys;
+		for (const auto &cur_shard : shards) {
+			auto cur_keys = cur_shard->Keys();
+			keys.insert(keys.end(), std::make_move_iterator(cur_keys.begin()), std::make_move_iterator(cur_keys.end()));
+		}
+		return keys;
+	}
+
+	// Get or creation for cached key-value pairs.
+	//
+	// WARNING: Currently factory cannot have exception thrown.
+	shared_ptr<Val> GetOrCreate(const Key &key, std::function<shared_ptr<Val>(const Key &)> factory) {
+		return GetShard(key).GetOrCreate(key, std::move(factory));
+	}
+
+private:
+	shard_impl &GetShard(const Key &key) {
+		// Hash values are mixed before picking shard, so shard index doesn't correlate with bucket index inside of
+		// each shard, and weak hash functions (i.e. identity hash for integers) still spread evenly.
+		uint64_t hash_value = static_cast<uint64_t>(KeyHash {}(key));
+		hash_value ^= hash_value >> 33;
+		hash_value *= 0xff51afd7ed558ccdULL;
+		hash_value ^= hash_value >> 33;
+		return *shards[hash_value % shards.size()];
+	}
+
+	vector<unique_ptr<shard_impl>> shards;
+};
+
+// Same interfaces as `ThreadSafeShardedSharedLruCache`, but all cached values are `const` specified to avoid concurrent
+// updates.
+template <typename K, typename V, typename KeyHash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+using ThreadSafeShardedSharedLruConstCache = ThreadSafeShardedSharedLruCache<K, const V, KeyHash, KeyEqual>;
+
 } // namespace duckdb
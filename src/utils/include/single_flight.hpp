@@ -0,0 +1,123 @@
+// SingleFlightGroup deduplicates concurrent in-flight work for the same key: the first requester (leader) performs the
+// work, while later requesters for the same key wait for the leader to finish and share its result, instead of
+// repeating the work.
+//
+// Different from [ThreadSafeSharedLruCache::GetOrCreate], the group only tracks ongoing work and doesn't hold any
+// result after completion, and leader/waiter roles are decided up-front, so a requester is able to batch all the work
+// it leads before waiting for others.
+//
+// Example usage:
+// SingleFlightGroup<string, string> group;
+// auto join_res = group.Join(key);
+// if (join_res.is_leader) {
+//   auto val = make_shared_ptr<string>(DoWork());
+//   group.Complete(key, [&]() { return val; });
+// } else {
+//   auto val = group.Wait(*join_res.flight);
+//   // nullptr indicates the leader fails, requester could retry by itself.
+// }
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+template <typename Key, typename Val, typename KeyHash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class SingleFlightGroup {
+public:
+	// An ongoing work for one key.
+	struct Flight {
+		std::condition_variable cv;
+		// Whether the leader has completed the work.
+		bool done = false;
+		// Result shared with waiters, nullptr indicates failure.
+		shared_ptr<Val> val;
+		// Number of requesters waiting for the result.
+		size_t waiter_count = 0;
+	};
+
+	struct JoinResult {
+		shared_ptr<Flight> flight;
+		// Leader is responsible to [Complete] the flight.
+		bool is_leader = false;
+	};
+
+	SingleFlightGroup() = default;
+	SingleFlightGroup(const SingleFlightGroup &) = delete;
+	SingleFlightGroup &operator=(const SingleFlightGroup &) = delete;
+
+	// Join the ongoing flight for [key], or start a new one with current requester as leader.
+	JoinResult Join(const Key &key) {
+		std::lock_guard<std::mutex> lck(mu);
+		auto iter = flights.find(key);
+		if (iter != flights.end()) {
+			++iter->second->waiter_count;
+			return JoinResult {iter->second, /*is_leader=*/false};
+		}
+		auto flight = make_shared_ptr<Flight>();
+		flights.emplace(key, flight);
+		return JoinResult {std::move(flight), /*is_leader=*/true};
+	}
+
+	// Called by leader to complete the flight for [key], and wake up all waiters.
+	// [factory] is only invoked out of critical section when there're waiters, which returns the result to share;
+	// nullptr indicates failure.
+	void Complete(const Key &key, const std::function<shared_ptr<Val>()> &factory) {
+		shared_ptr<Flight> flight;
+		{
+			std::lock_guard<std::mutex> lck(mu);
+			auto iter = flights.find(key);
+			D_ASSERT(iter != flights.end());
+			flight = std::move(iter->second);
+			// No new waiters could join after erasure, so waiter count is stable from now on.
+			flights.erase(iter);
+			if (flight->waiter_count == 0) {
+				return;
+			}
+		}
+
+		shared_ptr<Val> val;
+		try {
+			val = factory();
+		} catch (...) {
+			Publish(*flight, /*val=*/nullptr);
+			throw;
+		}
+		Publish(*flight, std::move(val));
+	}
+
+	// Block until the [flight] completes, return its result, or nullptr if the leader fails.
+	shared_ptr<Val> Wait(Flight &flight) {
+		std::unique_lock<std::mutex> lck(mu);
+		flight.cv.wait(lck, [&flight]() { return flight.done; });
+		return flight.val;
+	}
+
+	// Get the number of ongoing flights.
+	size_t GetFlightCount() const {
+		std::lock_guard<std::mutex> lck(mu);
+		return flights.size();
+	}
+
+private:
+	void Publish(Flight &flight, shared_ptr<Val> val) {
+		{
+			std::lock_guard<std::mutex> lck(mu);
+			flight.val = std::move(val);
+			flight.done = true;
+		}
+		flight.cv.notify_all();
+	}
+
+	mutable std::mutex mu;
+	std::unordered_map<Key, shared_ptr<Flight>, KeyHash, KeyEqual> flights;
+};
+
+} // namespace duckdb
@@ -5,6 +5,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 #include <type_traits>
 #include <utility>
@@ -16,6 +17,8 @@ class ThreadPool {
 public:
 	ThreadPool();
 	explicit ThreadPool(size_t thread_num);
+	// @param thread_name: name for all worker threads, empty string means not set.
+	ThreadPool(size_t thread_num, std::string thread_name);
 
 	ThreadPool(const ThreadPool &) = delete;
 	ThreadPool &operator=(const ThreadPool &) = delete;
@@ -29,12 +32,24 @@ public:
 	// Block until the threadpool is dead, or all enqueued tasks finish.
 	void Wait();
 
+	// Get the number of worker threads.
+	size_t GetThreadCount() const {
+		return workers_.size();
+	}
+	// Get the number of jobs which have been enqueued but not picked up by any worker, aka queue depth.
+	size_t GetPendingJobCount() const;
+	// Get the number of workers which are executing jobs.
+	size_t GetBusyThreadCount() const;
+	// Get the number of jobs finished since the threadpool started.
+	size_t GetCompletedJobCount() const;
+
 private:
 	using Job = std::function<void(void)>;
 
 	size_t idle_num_ = 0;
+	size_t completed_num_ = 0;
 	bool stopped_ = false;
-	std::mutex mutex_;
+	mutable std::mutex mutex_;
 	std::condition_variable new_job_cv_;
 	std::condition_variable job_completion_cv_;
 	std::queue<Job> jobs_;
@@ -0,0 +1,18 @@
+// Block compression with zstd, which is vendored by duckdb.
+
+#pragma once
+
+#include "duckdb/common/typedefs.hpp"
+
+namespace duckdb {
+
+// Compress [length] bytes of [data] with zstd at [level] into [compressed], which holds [capacity] bytes. Return the
+// number of compressed bytes, or 0 if compressed content doesn't fit in [capacity], so callers bail out of
+// incompressible data without allocating for the worst case.
+idx_t ZstdCompress(const char *data, idx_t length, int level, char *compressed, idx_t capacity);
+
+// Decompress [compressed_length] bytes of zstd frame [compressed] into [buffer], return whether it decompresses into
+// exactly [length] bytes; corrupted frames are reported as failure rather than thrown.
+bool ZstdDecompress(const char *compressed, idx_t compressed_length, char *buffer, idx_t length);
+
+} // namespace duckdb
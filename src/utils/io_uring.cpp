@@ -0,0 +1,536 @@
+#include "io_uring.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+// Renames are submitted via io_uring, whose opcode is only declared by kernel headers for 5.12 and above.
+#if defined(IORING_FEAT_NATIVE_WORKERS)
+#define CACHE_HTTPFS_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifdef CACHE_HTTPFS_HAS_IO_URING
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace duckdb {
+
+namespace {
+
+// Max number of operations in one submission, larger batches are split.
+constexpr unsigned IO_URING_QUEUE_DEPTH = 64;
+
+// Permission for files created by batched writes.
+constexpr unsigned IO_URING_FILE_MODE = 0644;
+
+class IoUring {
+public:
+	IoUring() = default;
+	~IoUring();
+
+	// Disable copy and move.
+	IoUring(const IoUring &) = delete;
+	IoUring &operator=(const IoUring &) = delete;
+
+	// Set up a ring with [entries] submission queue entries, return nullptr if io_uring is not supported.
+	static unique_ptr<IoUring> Create(unsigned entries);
+
+	// Return whether all [opcodes] are supported by the kernel.
+	bool SupportsOps(const vector<uint8_t> &opcodes) const;
+
+	// Issue [count] operations, each of which is prepared by [prepare] with its index, and wait for all completions.
+	// Completion results are stored in [results] by operation index; operations not completed when submission fails
+	// are left as -ECANCELED.
+	template <typename PrepareFunc>
+	void Run(idx_t count, PrepareFunc &&prepare, vector<int64_t> &results);
+
+private:
+	int ring_fd = -1;
+	void *sq_ring = MAP_FAILED;
+	size_t sq_ring_size = 0;
+	void *cq_ring = MAP_FAILED;
+	size_t cq_ring_size = 0;
+	io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+	size_t sqes_size = 0;
+	unsigned sq_entries = 0;
+
+	// Pointers into the rings shared with kernel.
+	unsigned *sq_tail = nullptr;
+	unsigned *sq_mask = nullptr;
+	unsigned *sq_array = nullptr;
+	unsigned *cq_head = nullptr;
+	unsigned *cq_tail = nullptr;
+	unsigned *cq_mask = nullptr;
+	io_uring_cqe *cqes = nullptr;
+};
+
+IoUring::~IoUring() {
+	if (sqes != MAP_FAILED) {
+		munmap(sqes, sqes_size);
+	}
+	if (cq_ring != MAP_FAILED && cq_ring != sq_ring) {
+		munmap(cq_ring, cq_ring_size);
+	}
+	if (sq_ring != MAP_FAILED) {
+		munmap(sq_ring, sq_ring_size);
+	}
+	if (ring_fd >= 0) {
+		close(ring_fd);
+	}
+}
+
+unique_ptr<IoUring> IoUring::Create(unsigned entries) {
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	auto ring = make_uniq<IoUring>();
+	ring->ring_fd = fd;
+	ring->sq_entries = params.sq_entries;
+	ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single_mmap) {
+		ring->sq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+		ring->cq_ring_size = ring->sq_ring_size;
+	}
+
+	ring->sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+	                     IORING_OFF_SQ_RING);
+	if (ring->sq_ring == MAP_FAILED) {
+		return nullptr;
+	}
+	ring->cq_ring = single_mmap ? ring->sq_ring
+	                            : mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+	                                   fd, IORING_OFF_CQ_RING);
+	if (ring->cq_ring == MAP_FAILED) {
+		return nullptr;
+	}
+	ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+	ring->sqes = static_cast<io_uring_sqe *>(
+	    mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+	if (ring->sqes == MAP_FAILED) {
+		return nullptr;
+	}
+
+	auto *sq_ptr = static_cast<char *>(ring->sq_ring);
+	auto *cq_ptr = static_cast<char *>(ring->cq_ring);
+	ring->sq_tail = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.tail);
+	ring->sq_mask = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.ring_mask);
+	ring->sq_array = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.array);
+	ring->cq_head = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.head);
+	ring->cq_tail = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.tail);
+	ring->cq_mask = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.ring_mask);
+	ring->cqes = reinterpret_cast<io_uring_cqe *>(cq_ptr + params.cq_off.cqes);
+	return ring;
+}
+
+bool IoUring::SupportsOps(const vector<uint8_t> &opcodes) const {
+	constexpr unsigned PROBE_OP_COUNT = 256;
+	vector<char> probe_buffer(sizeof(io_uring_probe) + PROBE_OP_COUNT * sizeof(io_uring_probe_op), 0);
+	auto *probe = reinterpret_cast<io_uring_probe *>(probe_buffer.data());
+	if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, PROBE_OP_COUNT) < 0) {
+		return false;
+	}
+	for (const auto cur_opcode : opcodes) {
+		if (cur_opcode > probe->last_op || (probe->ops[cur_opcode].flags & IO_URING_OP_SUPPORTED) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename PrepareFunc>
+void IoUring::Run(idx_t count, PrepareFunc &&prepare, vector<int64_t> &results) {
+	results.assign(count, -ECANCELED);
+	for (idx_t batch_start = 0; batch_start < count;) {
+		const idx_t batch_size = std::min<idx_t>(count - batch_start, sq_entries);
+
+		// Only the owner thread produces submission entries, so tail is read without synchronization.
+		unsigned tail = *sq_tail;
+		for (idx_t idx = batch_start; idx < batch_start + batch_size; ++idx) {
+			const unsigned slot = tail & *sq_mask;
+			io_uring_sqe &sqe = sqes[slot];
+			memset(&sqe, 0, sizeof(sqe));
+			prepare(sqe, idx);
+			sqe.user_data = idx;
+			sq_array[slot] = slot;
+			++tail;
+		}
+		__atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+		idx_t pending_submission = batch_size;
+		idx_t completion_count = 0;
+		while (completion_count < batch_size) {
+			const auto ret = syscall(__NR_io_uring_enter, ring_fd, static_cast<unsigned>(pending_submission),
+			                         static_cast<unsigned>(batch_size - completion_count), IORING_ENTER_GETEVENTS,
+			                         nullptr, 0);
+			if (ret < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw IOException("Fails to submit io_uring operations because %s", strerror(errno));
+			}
+			pending_submission -= static_cast<idx_t>(ret);
+
+			unsigned head = *cq_head;
+			const unsigned cur_cq_tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+			for (; head != cur_cq_tail; ++head) {
+				const io_uring_cqe &cqe = cqes[head & *cq_mask];
+				results[cqe.user_data] = cqe.res;
+				++completion_count;
+			}
+			__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+		}
+		batch_start += batch_size;
+	}
+}
+
+// Get the ring owned by calling thread. A ring left inconsistent by submission failure is discarded by caller.
+unique_ptr<IoUring> &GetThreadLocalIoUring() {
+	thread_local unique_ptr<IoUring> io_uring;
+	if (io_uring == nullptr) {
+		io_uring = IoUring::Create(IO_URING_QUEUE_DEPTH);
+		if (io_uring == nullptr) {
+			throw IOException("Fails to set up io_uring because %s", strerror(errno));
+		}
+	}
+	return io_uring;
+}
+
+// Buffers for one file, which are file content and optional trailer.
+using FileIovecs = std::array<iovec, 2>;
+
+// Fill [iovecs] with [length] bytes of [buffer] and optional [trailer_length] bytes of [trailer], return the number of
+// buffers used.
+unsigned FillIovecs(const char *buffer, idx_t length, const char *trailer, idx_t trailer_length, FileIovecs &iovecs) {
+	iovecs[0].iov_base = const_cast<char *>(buffer);
+	iovecs[0].iov_len = length;
+	if (trailer_length == 0) {
+		return 1;
+	}
+	iovecs[1].iov_base = const_cast<char *>(trailer);
+	iovecs[1].iov_len = trailer_length;
+	return 2;
+}
+
+// Complete a short read or write at [offset] with blocking IO, where file content from offset 0 is scattered into or
+// gathered from [iovecs]. Return the overall number of bytes transferred, or negative errno on failure.
+template <typename IoFunc>
+int64_t CompleteIoSync(const FileIovecs &iovecs, unsigned iovec_count, idx_t offset, IoFunc &&io_func) {
+	idx_t segment_start = 0;
+	for (unsigned idx = 0; idx < iovec_count; ++idx) {
+		const idx_t segment_end = segment_start + iovecs[idx].iov_len;
+		auto *segment = static_cast<char *>(iovecs[idx].iov_base);
+		while (offset < segment_end) {
+			const auto ret = io_func(segment + (offset - segment_start), segment_end - offset, offset);
+			if (ret < 0 && errno == EINTR) {
+				continue;
+			}
+			if (ret < 0) {
+				return -errno;
+			}
+			if (ret == 0) {
+				return static_cast<int64_t>(offset);
+			}
+			offset += static_cast<idx_t>(ret);
+		}
+		segment_start = segment_end;
+	}
+	return static_cast<int64_t>(offset);
+}
+
+int64_t CompleteReadSync(int fd, const FileIovecs &iovecs, unsigned iovec_count, idx_t offset) {
+	return CompleteIoSync(iovecs, iovec_count, offset, [fd](char *buffer, idx_t length, idx_t cur_offset) {
+		return pread(fd, buffer, length, static_cast<off_t>(cur_offset));
+	});
+}
+
+int64_t CompleteWriteSync(int fd, const FileIovecs &iovecs, unsigned iovec_count, idx_t offset) {
+	return CompleteIoSync(iovecs, iovec_count, offset, [fd](char *data, idx_t length, idx_t cur_offset) {
+		return pwrite(fd, data, length, static_cast<off_t>(cur_offset));
+	});
+}
+
+// Close files successfully opened as per [open_results], used on failure before they're closed via io_uring.
+void CloseOpenedFiles(const vector<int64_t> &open_results) {
+	for (const auto cur_result : open_results) {
+		if (cur_result >= 0) {
+			close(static_cast<int>(cur_result));
+		}
+	}
+}
+
+// Remove temporary files for all write [requests], used on failure. Temporary files are uniquely named, and those
+// already renamed no longer exist.
+void RemoveTempFiles(const vector<IoUringWriteRequest> &requests) {
+	for (const auto &cur_request : requests) {
+		unlink(cur_request.temp_filepath.c_str());
+	}
+}
+
+void ReadFilesImpl(IoUring &io_uring, vector<IoUringReadRequest> &requests) {
+	vector<int64_t> open_results;
+	vector<idx_t> opened_indices;
+	// Opened files are closed before rethrow; once close is submitted, which files got closed is unknown on failure,
+	// so they're not closed again.
+	try {
+		io_uring.Run(
+		    requests.size(),
+		    [&requests](io_uring_sqe &sqe, idx_t idx) {
+			    sqe.opcode = IORING_OP_OPENAT;
+			    sqe.fd = AT_FDCWD;
+			    sqe.addr = reinterpret_cast<uint64_t>(requests[idx].filepath.c_str());
+			    sqe.open_flags = O_RDONLY | O_CLOEXEC;
+		    },
+		    open_results);
+
+		// Only opened files are read and closed.
+		for (idx_t idx = 0; idx < requests.size(); ++idx) {
+			if (open_results[idx] < 0) {
+				requests[idx].result = open_results[idx];
+				continue;
+			}
+			opened_indices.emplace_back(idx);
+		}
+
+		// Buffers are referenced by submissions, so they're kept alive until all reads complete.
+		vector<FileIovecs> iovecs(opened_indices.size());
+		vector<unsigned> iovec_counts(opened_indices.size());
+		for (idx_t idx = 0; idx < opened_indices.size(); ++idx) {
+			const auto &cur_request = requests[opened_indices[idx]];
+			iovec_counts[idx] = FillIovecs(cur_request.buffer, cur_request.length, cur_request.trailer,
+			                               cur_request.trailer_length, iovecs[idx]);
+		}
+		vector<int64_t> read_results;
+		io_uring.Run(
+		    opened_indices.size(),
+		    [&](io_uring_sqe &sqe, idx_t idx) {
+			    sqe.opcode = IORING_OP_READV;
+			    sqe.fd = static_cast<int>(open_results[opened_indices[idx]]);
+			    sqe.addr = reinterpret_cast<uint64_t>(iovecs[idx].data());
+			    sqe.len = iovec_counts[idx];
+			    sqe.off = 0;
+		    },
+		    read_results);
+		for (idx_t idx = 0; idx < opened_indices.size(); ++idx) {
+			auto &cur_request = requests[opened_indices[idx]];
+			cur_request.result = read_results[idx];
+			if (cur_request.result > 0 &&
+			    static_cast<idx_t>(cur_request.result) < cur_request.length + cur_request.trailer_length) {
+				cur_request.result = CompleteReadSync(static_cast<int>(open_results[opened_indices[idx]]),
+				                                      iovecs[idx], iovec_counts[idx],
+				                                      static_cast<idx_t>(cur_request.result));
+			}
+		}
+	} catch (...) {
+		CloseOpenedFiles(open_results);
+		throw;
+	}
+
+	vector<int64_t> close_results;
+	io_uring.Run(
+	    opened_indices.size(),
+	    [&](io_uring_sqe &sqe, idx_t idx) {
+		    sqe.opcode = IORING_OP_CLOSE;
+		    sqe.fd = static_cast<int>(open_results[opened_indices[idx]]);
+	    },
+	    close_results);
+}
+
+void WriteFilesImpl(IoUring &io_uring, vector<IoUringWriteRequest> &requests, bool sync) {
+	vector<int64_t> open_results;
+	vector<idx_t> opened_indices;
+	// Opened files are closed and temporary files are removed before rethrow; once close is submitted, which files got
+	// closed is unknown on failure, so they're not closed again.
+	try {
+		io_uring.Run(
+		    requests.size(),
+		    [&requests](io_uring_sqe &sqe, idx_t idx) {
+			    sqe.opcode = IORING_OP_OPENAT;
+			    sqe.fd = AT_FDCWD;
+			    sqe.addr = reinterpret_cast<uint64_t>(requests[idx].temp_filepath.c_str());
+			    sqe.len = IO_URING_FILE_MODE;
+			    sqe.open_flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+		    },
+		    open_results);
+
+		for (idx_t idx = 0; idx < requests.size(); ++idx) {
+			if (open_results[idx] < 0) {
+				requests[idx].result = open_results[idx];
+				continue;
+			}
+			opened_indices.emplace_back(idx);
+		}
+
+		vector<FileIovecs> iovecs(opened_indices.size());
+		vector<unsigned> iovec_counts(opened_indices.size());
+		for (idx_t idx = 0; idx < opened_indices.size(); ++idx) {
+			const auto &cur_request = requests[opened_indices[idx]];
+			iovec_counts[idx] = FillIovecs(cur_request.data, cur_request.length, cur_request.trailer,
+			                               cur_request.trailer_length, iovecs[idx]);
+		}
+		vector<int64_t> write_results;
+		io_uring.Run(
+		    opened_indices.size(),
+		    [&](io_uring_sqe &sqe, idx_t idx) {
+			    sqe.opcode = IORING_OP_WRITEV;
+			    sqe.fd = static_cast<int>(open_results[opened_indices[idx]]);
+			    sqe.addr = reinterpret_cast<uint64_t>(iovecs[idx].data());
+			    sqe.len = iovec_counts[idx];
+			    sqe.off = 0;
+		    },
+		    write_results);
+		for (idx_t idx = 0; idx < opened_indices.size(); ++idx) {
+			auto &cur_request = requests[opened_indices[idx]];
+			const idx_t total_length = cur_request.length + cur_request.trailer_length;
+			int64_t bytes_written = write_results[idx];
+			if (bytes_written >= 0 && static_cast<idx_t>(bytes_written) < total_length) {
+				bytes_written = CompleteWriteSync(static_cast<int>(open_results[opened_indices[idx]]), iovecs[idx],
+				                                  iovec_counts[idx], static_cast<idx_t>(bytes_written));
+			}
+			if (bytes_written < 0) {
+				cur_request.result = bytes_written;
+			} else {
+				cur_request.result = static_cast<idx_t>(bytes_written) == total_length ? 0 : -EIO;
+			}
+		}
+
+		if (sync) {
+			vector<int64_t> sync_results;
+			io_uring.Run(
+			    opened_indices.size(),
+			    [&](io_uring_sqe &sqe, idx_t idx) {
+				    sqe.opcode = IORING_OP_FSYNC;
+				    sqe.fd = static_cast<int>(open_results[opened_indices[idx]]);
+			    },
+			    sync_results);
+			for (idx_t idx = 0; idx < opened_indices.size(); ++idx) {
+				auto &cur_request = requests[opened_indices[idx]];
+				if (cur_request.result == 0 && sync_results[idx] < 0) {
+					cur_request.result = sync_results[idx];
+				}
+			}
+		}
+	} catch (...) {
+		CloseOpenedFiles(open_results);
+		RemoveTempFiles(requests);
+		throw;
+	}
+
+	try {
+		vector<int64_t> close_results;
+		io_uring.Run(
+		    opened_indices.size(),
+		    [&](io_uring_sqe &sqe, idx_t idx) {
+			    sqe.opcode = IORING_OP_CLOSE;
+			    sqe.fd = static_cast<int>(open_results[opened_indices[idx]]);
+		    },
+		    close_results);
+
+		// Written files are moved to their target position, while temporary files for failed writes are removed.
+		vector<idx_t> written_indices;
+		for (const auto cur_idx : opened_indices) {
+			if (requests[cur_idx].result == 0) {
+				written_indices.emplace_back(cur_idx);
+				continue;
+			}
+			unlink(requests[cur_idx].temp_filepath.c_str());
+		}
+		vector<int64_t> rename_results;
+		io_uring.Run(
+		    written_indices.size(),
+		    [&](io_uring_sqe &sqe, idx_t idx) {
+			    const auto &cur_request = requests[written_indices[idx]];
+			    sqe.opcode = IORING_OP_RENAMEAT;
+			    sqe.fd = AT_FDCWD;
+			    sqe.addr = reinterpret_cast<uint64_t>(cur_request.temp_filepath.c_str());
+			    sqe.len = static_cast<uint32_t>(AT_FDCWD);
+			    sqe.addr2 = reinterpret_cast<uint64_t>(cur_request.filepath.c_str());
+			    sqe.rename_flags = 0;
+		    },
+		    rename_results);
+		for (idx_t idx = 0; idx < written_indices.size(); ++idx) {
+			auto &cur_request = requests[written_indices[idx]];
+			if (rename_results[idx] < 0) {
+				cur_request.result = rename_results[idx];
+				unlink(cur_request.temp_filepath.c_str());
+			}
+		}
+	} catch (...) {
+		RemoveTempFiles(requests);
+		throw;
+	}
+}
+
+} // namespace
+
+bool IsIoUringAvailable() {
+	static const bool is_available = []() {
+		auto io_uring = IoUring::Create(IO_URING_QUEUE_DEPTH);
+		if (io_uring == nullptr) {
+			return false;
+		}
+		return io_uring->SupportsOps({IORING_OP_OPENAT, IORING_OP_READV, IORING_OP_WRITEV, IORING_OP_FSYNC,
+		                              IORING_OP_CLOSE, IORING_OP_RENAMEAT});
+	}();
+	return is_available;
+}
+
+void IoUringReadFiles(vector<IoUringReadRequest> &requests) {
+	auto &io_uring = GetThreadLocalIoUring();
+	try {
+		ReadFilesImpl(*io_uring, requests);
+	} catch (...) {
+		io_uring.reset();
+		throw;
+	}
+}
+
+void IoUringWriteFiles(vector<IoUringWriteRequest> &requests, bool sync) {
+	auto &io_uring = GetThreadLocalIoUring();
+	try {
+		WriteFilesImpl(*io_uring, requests, sync);
+	} catch (...) {
+		io_uring.reset();
+		throw;
+	}
+}
+
+} // namespace duckdb
+
+#else
+
+namespace duckdb {
+
+bool IsIoUringAvailable() {
+	return false;
+}
+
+void IoUringReadFiles(vector<IoUringReadRequest> &requests) {
+	throw NotImplementedException("io_uring is not supported on current platform");
+}
+
+void IoUringWriteFiles(vector<IoUringWriteRequest> &requests, bool sync) {
+	throw NotImplementedException("io_uring is not supported on current platform");
+}
+
+} // namespace duckdb
+
+#endif
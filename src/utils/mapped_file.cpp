@@ -0,0 +1,88 @@
+#include "mapped_file.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace duckdb {
+
+namespace {
+
+// Pre-fault the whole mapping on creation if supported, so later copies don't page fault one page after another.
+#ifdef MAP_POPULATE
+constexpr int MAPPED_FILE_MMAP_FLAGS = MAP_PRIVATE | MAP_POPULATE;
+#else
+constexpr int MAPPED_FILE_MMAP_FLAGS = MAP_PRIVATE;
+#endif
+
+} // namespace
+
+unique_ptr<MappedFile> MappedFile::Open(const std::string &filepath) {
+	const int fd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		if (errno == ENOENT) {
+			return nullptr;
+		}
+		throw IOException("Fails to open file %s because %s", filepath, strerror(errno));
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		const int err = errno;
+		close(fd);
+		throw IOException("Fails to stat file %s because %s", filepath, strerror(err));
+	}
+	const idx_t file_size = static_cast<idx_t>(file_stat.st_size);
+	// Zero-length mapping is not allowed.
+	if (file_size == 0) {
+		close(fd);
+		return unique_ptr<MappedFile>(new MappedFile(nullptr, 0));
+	}
+
+	// Mapping holds its own reference to the file, so the descriptor is not needed afterwards.
+	void *addr = mmap(nullptr, file_size, PROT_READ, MAPPED_FILE_MMAP_FLAGS, fd, /*offset=*/0);
+	const int err = errno;
+	close(fd);
+	if (addr == MAP_FAILED) {
+		throw IOException("Fails to map file %s because %s", filepath, strerror(err));
+	}
+	return unique_ptr<MappedFile>(new MappedFile(static_cast<const char *>(addr), file_size));
+}
+
+MappedFile::~MappedFile() {
+	if (data != nullptr) {
+		munmap(const_cast<char *>(data), size);
+	}
+}
+
+bool IsMmapSupported() {
+	return true;
+}
+
+} // namespace duckdb
+
+#else
+
+namespace duckdb {
+
+unique_ptr<MappedFile> MappedFile::Open(const std::string &filepath) {
+	throw NotImplementedException("Memory mapping is not supported on current platform");
+}
+
+MappedFile::~MappedFile() {
+}
+
+bool IsMmapSupported() {
+	return false;
+}
+
+} // namespace duckdb
+
+#endif
@@ -10,10 +10,16 @@ namespace duckdb {
 ThreadPool::ThreadPool() : ThreadPool(GetCpuCoreCount()) {
 }
 
-ThreadPool::ThreadPool(size_t thread_num) : idle_num_(thread_num) {
+ThreadPool::ThreadPool(size_t thread_num) : ThreadPool(thread_num, /*thread_name=*/"") {
+}
+
+ThreadPool::ThreadPool(size_t thread_num, std::string thread_name) : idle_num_(thread_num) {
 	workers_.reserve(thread_num);
 	for (size_t ii = 0; ii < thread_num; ++ii) {
-		workers_.emplace_back([this]() {
+		workers_.emplace_back([this, thread_name]() {
+			if (!thread_name.empty()) {
+				SetThreadName(thread_name);
+			}
 			for (;;) {
 				Job cur_job;
 				{
@@ -33,6 +39,7 @@ ThreadPool::ThreadPool(size_t thread_num) : idle_num_(thread_num) {
 				{
 					std::unique_lock<std::mutex> lck(mutex_);
 					++idle_num_;
+					++completed_num_;
 					job_completion_cv_.notify_one();
 				}
 			}
@@ -53,6 +60,21 @@ void ThreadPool::Wait() {
 	});
 }
 
+size_t ThreadPool::GetPendingJobCount() const {
+	std::lock_guard<std::mutex> lck(mutex_);
+	return jobs_.size();
+}
+
+size_t ThreadPool::GetBusyThreadCount() const {
+	std::lock_guard<std::mutex> lck(mutex_);
+	return workers_.size() - idle_num_;
+}
+
+size_t ThreadPool::GetCompletedJobCount() const {
+	std::lock_guard<std::mutex> lck(mutex_);
+	return completed_num_;
+}
+
 ThreadPool::~ThreadPool() noexcept {
 	{
 		std::lock_guard<std::mutex> lck(mutex_);
@@ -0,0 +1,51 @@
+#include "zstd_compression.hpp"
+
+#include <memory>
+
+#include "zstd.h"
+
+namespace duckdb {
+
+namespace {
+
+struct ZstdCompressContextDeleter {
+	void operator()(duckdb_zstd::ZSTD_CCtx *context) const {
+		duckdb_zstd::ZSTD_freeCCtx(context);
+	}
+};
+struct ZstdDecompressContextDeleter {
+	void operator()(duckdb_zstd::ZSTD_DCtx *context) const {
+		duckdb_zstd::ZSTD_freeDCtx(context);
+	}
+};
+
+// Contexts hold hundreds of KiB of working memory, which are reused by all blocks (de)compressed on the same thread.
+duckdb_zstd::ZSTD_CCtx &GetThreadLocalCompressContext() {
+	thread_local std::unique_ptr<duckdb_zstd::ZSTD_CCtx, ZstdCompressContextDeleter> context {
+	    duckdb_zstd::ZSTD_createCCtx()};
+	return *context;
+}
+duckdb_zstd::ZSTD_DCtx &GetThreadLocalDecompressContext() {
+	thread_local std::unique_ptr<duckdb_zstd::ZSTD_DCtx, ZstdDecompressContextDeleter> context {
+	    duckdb_zstd::ZSTD_createDCtx()};
+	return *context;
+}
+
+} // namespace
+
+idx_t ZstdCompress(const char *data, idx_t length, int level, char *compressed, idx_t capacity) {
+	const size_t res =
+	    duckdb_zstd::ZSTD_compressCCtx(&GetThreadLocalCompressContext(), compressed, capacity, data, length, level);
+	if (duckdb_zstd::ZSTD_isError(res)) {
+		return 0;
+	}
+	return static_cast<idx_t>(res);
+}
+
+bool ZstdDecompress(const char *compressed, idx_t compressed_length, char *buffer, idx_t length) {
+	const size_t res = duckdb_zstd::ZSTD_decompressDCtx(&GetThreadLocalDecompressContext(), buffer, length, compressed,
+	                                                    compressed_length);
+	return !duckdb_zstd::ZSTD_isError(res) && res == length;
+}
+
+} // namespace duckdb
@@ -0,0 +1,63 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "cache_file_identity.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+constexpr idx_t SHA256_HEX_LENGTH = 64;
+
+} // namespace
+
+TEST_CASE("Intern same path test", "[cache file identity]") {
+	auto identity = InternCacheFileIdentity("s3://bucket/dir/file.parquet");
+	auto same_identity = InternCacheFileIdentity("s3://bucket/dir/file.parquet");
+	REQUIRE(identity == same_identity);
+	REQUIRE(identity->path == "s3://bucket/dir/file.parquet");
+	REQUIRE(identity->path_id == same_identity->path_id);
+}
+
+TEST_CASE("Intern different paths test", "[cache file identity]") {
+	auto identity = InternCacheFileIdentity("s3://bucket/dir/file.parquet");
+	auto other_identity = InternCacheFileIdentity("s3://bucket/other_dir/file.parquet");
+	REQUIRE(identity->path_id != other_identity->path_id);
+
+	// Remote files with the same filename under different directories get different cache filename prefixes.
+	REQUIRE(identity->cache_fname_prefix != other_identity->cache_fname_prefix);
+	for (const auto &cur_identity : {identity, other_identity}) {
+		const auto &prefix = cur_identity->cache_fname_prefix;
+		REQUIRE(prefix.length() == SHA256_HEX_LENGTH + std::string {"-file.parquet"}.length());
+		REQUIRE(StringUtil::EndsWith(prefix, "-file.parquet"));
+		REQUIRE(prefix.find_first_not_of("0123456789abcdef") == SHA256_HEX_LENGTH);
+	}
+}
+
+TEST_CASE("Release identity test", "[cache file identity]") {
+	const idx_t identity_count = GetInternedCacheFileIdentityCount();
+	auto identity = InternCacheFileIdentity("s3://bucket/dir/released_file.parquet");
+	REQUIRE(GetInternedCacheFileIdentityCount() == identity_count + 1);
+	const std::string cache_fname_prefix = identity->cache_fname_prefix;
+
+	identity.reset();
+	REQUIRE(GetInternedCacheFileIdentityCount() == identity_count);
+
+	// Identity interned again after release keeps the same cache filename prefix.
+	identity = InternCacheFileIdentity("s3://bucket/dir/released_file.parquet");
+	REQUIRE(identity->cache_fname_prefix == cache_fname_prefix);
+}
+
+TEST_CASE("Cache filename prefix without intern test", "[cache file identity]") {
+	const std::string cache_fname_prefix = GetCacheFnamePrefix("s3://bucket/dir/uninterned_file.parquet");
+	auto identity = InternCacheFileIdentity("s3://bucket/dir/uninterned_file.parquet");
+	REQUIRE(identity->cache_fname_prefix == cache_fname_prefix);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
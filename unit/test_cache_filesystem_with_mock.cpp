@@ -2,16 +2,20 @@
 #include "catch.hpp"
 
 #include <string>
+#include <thread>
 
 #include "cache_filesystem.hpp"
 #include "cache_filesystem_config.hpp"
+#include "cache_reader_manager.hpp"
 #include "duckdb/common/local_file_system.hpp"
+#include "io_executor.hpp"
 #include "mock_filesystem.hpp"
 
 using namespace duckdb; // NOLINT
 
 namespace {
 const std::string TEST_FILENAME = "filename";
+const std::string TEST_PARQUET_FILENAME = "filename.parquet";
 const std::string TEST_GLOB_NAME = "*"; // Need to contain glob characters.
 constexpr int64_t TEST_FILESIZE = 26;
 constexpr int64_t TEST_CHUNK_SIZE = 5;
@@ -66,9 +70,13 @@ void TestReadWithMockFileSystem() {
 		[[maybe_unused]] auto &another_mock_handle =
 		    another_handle->Cast<CacheFileSystemHandle>().internal_file_handle->Cast<MockFileHandle>();
 
+		// Fully cached read is served on the caller thread, without dispatching to IO executor.
+		IoExecutor::Get().GetThreadPool()->Wait();
+		const auto io_task_count = IoExecutor::Get().GetStats().completed_task_count;
 		std::string buffer(TEST_FILESIZE, '\0');
 		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), TEST_FILESIZE, /*location=*/0);
 		REQUIRE(buffer == std::string(TEST_FILESIZE, 'a'));
+		REQUIRE(IoExecutor::Get().GetStats().completed_task_count == io_task_count);
 
 		mock_filesystem_ptr->ClearReadOperations();
 		auto read_operations = mock_filesystem_ptr->GetSortedReadOperations();
@@ -95,11 +103,132 @@ void TestReadWithMockFileSystem() {
 	REQUIRE(dtor_invocation == 2);
 }
 
+void TestRemoteRequestCoalescing() {
+	auto mock_filesystem = make_uniq<MockFileSystem>([]() {}, []() {});
+	mock_filesystem->SetFileSize(TEST_FILESIZE);
+	auto *mock_filesystem_ptr = mock_filesystem.get();
+	auto cache_filesystem = make_uniq<CacheFileSystem>(std::move(mock_filesystem));
+	auto handle = cache_filesystem->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+	CacheReaderManager::Get().ClearCache();
+
+	// Uncached read, with every two consecutive blocks merged into one remote request.
+	{
+		std::string buffer(TEST_FILESIZE, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), TEST_FILESIZE, /*location=*/0);
+		REQUIRE(buffer == std::string(TEST_FILESIZE, 'a'));
+
+		auto read_operations = mock_filesystem_ptr->GetSortedReadOperations();
+		REQUIRE(read_operations.size() == 3);
+		REQUIRE(read_operations[0] == MockFileSystem::ReadOper {0, 10});
+		REQUIRE(read_operations[1] == MockFileSystem::ReadOper {10, 10});
+		REQUIRE(read_operations[2] == MockFileSystem::ReadOper {20, 6});
+	}
+
+	// Clear cache, and only cache the second block.
+	CacheReaderManager::Get().ClearCache();
+	mock_filesystem_ptr->ClearReadOperations();
+	{
+		std::string buffer(3, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), /*nr_bytes=*/3, /*location=*/6);
+		REQUIRE(buffer == std::string(3, 'a'));
+	}
+
+	// Cached block splits uncached blocks into non-consecutive ranges.
+	mock_filesystem_ptr->ClearReadOperations();
+	{
+		std::string buffer(TEST_FILESIZE - 2, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), TEST_FILESIZE - 2, /*location=*/1);
+		REQUIRE(buffer == std::string(TEST_FILESIZE - 2, 'a'));
+
+		auto read_operations = mock_filesystem_ptr->GetSortedReadOperations();
+		REQUIRE(read_operations.size() == 3);
+		REQUIRE(read_operations[0] == MockFileSystem::ReadOper {0, 5});
+		REQUIRE(read_operations[1] == MockFileSystem::ReadOper {10, 10});
+		REQUIRE(read_operations[2] == MockFileSystem::ReadOper {20, 6});
+	}
+}
+
+void TestSequentialReadAhead() {
+	auto mock_filesystem = make_uniq<MockFileSystem>([]() {}, []() {});
+	mock_filesystem->SetFileSize(TEST_FILESIZE);
+	auto *mock_filesystem_ptr = mock_filesystem.get();
+	auto cache_filesystem = make_uniq<CacheFileSystem>(std::move(mock_filesystem));
+	CacheReaderManager::Get().ClearCache();
+
+	// Two sequential stream reads trigger read-ahead for the next two blocks.
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		std::string buffer(TEST_CHUNK_SIZE, '\0');
+		REQUIRE(cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), TEST_CHUNK_SIZE) ==
+		        TEST_CHUNK_SIZE);
+		REQUIRE(cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), TEST_CHUNK_SIZE) ==
+		        TEST_CHUNK_SIZE);
+		REQUIRE(buffer == std::string(TEST_CHUNK_SIZE, 'a'));
+	}
+
+	// File handle destruction waits for ongoing read-ahead.
+	auto read_operations = mock_filesystem_ptr->GetSortedReadOperations();
+	REQUIRE(read_operations.size() == 4);
+	for (idx_t idx = 0; idx < 4; ++idx) {
+		REQUIRE(read_operations[idx] == MockFileSystem::ReadOper {idx * TEST_CHUNK_SIZE, TEST_CHUNK_SIZE});
+	}
+
+	// Blocks read ahead are served from cache.
+	mock_filesystem_ptr->ClearReadOperations();
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		std::string buffer(2 * TEST_CHUNK_SIZE, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), 2 * TEST_CHUNK_SIZE,
+		                       /*location=*/2 * TEST_CHUNK_SIZE);
+		REQUIRE(buffer == std::string(2 * TEST_CHUNK_SIZE, 'a'));
+	}
+	REQUIRE(mock_filesystem_ptr->GetSortedReadOperations().empty());
+}
+
+void TestFooterPrefetch() {
+	auto mock_filesystem = make_uniq<MockFileSystem>([]() {}, []() {});
+	mock_filesystem->SetFileSize(TEST_FILESIZE);
+	auto *mock_filesystem_ptr = mock_filesystem.get();
+	auto cache_filesystem = make_uniq<CacheFileSystem>(std::move(mock_filesystem));
+	CacheReaderManager::Get().ClearCache();
+
+	// Footer region is prefetched on file open, file handle destruction waits for ongoing prefetch.
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_PARQUET_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+	}
+	auto read_operations = mock_filesystem_ptr->GetSortedReadOperations();
+	REQUIRE(read_operations.size() == 3);
+	REQUIRE(read_operations[0] == MockFileSystem::ReadOper {15, 5});
+	REQUIRE(read_operations[1] == MockFileSystem::ReadOper {20, 5});
+	REQUIRE(read_operations[2] == MockFileSystem::ReadOper {25, 1});
+
+	// Footer length and footer content reads are served from cache.
+	mock_filesystem_ptr->ClearReadOperations();
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_PARQUET_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		std::string buffer(8, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), /*nr_bytes=*/8,
+		                       /*location=*/TEST_FILESIZE - 8);
+		REQUIRE(buffer == std::string(8, 'a'));
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), /*nr_bytes=*/8,
+		                       /*location=*/TEST_FILESIZE - 16);
+		REQUIRE(buffer == std::string(8, 'a'));
+	}
+	REQUIRE(mock_filesystem_ptr->GetSortedReadOperations().empty());
+
+	// Non-parquet files don't prefetch footer.
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+	}
+	REQUIRE(mock_filesystem_ptr->GetSortedReadOperations().empty());
+}
+
 } // namespace
 
 TEST_CASE("Test disk cache reader with mock filesystem", "[mock filesystem test]") {
 	*g_test_cache_type = *ON_DISK_CACHE_TYPE;
 	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = TEST_CHUNK_SIZE;
 	g_max_file_handle_cache_entry = 1;
 	LocalFileSystem::CreateLocal()->RemoveDirectory(*g_on_disk_cache_directory);
 	TestReadWithMockFileSystem();
@@ -108,11 +237,133 @@ TEST_CASE("Test disk cache reader with mock filesystem", "[mock filesystem test]
 TEST_CASE("Test in-memory cache reader with mock filesystem", "[mock filesystem test]") {
 	*g_test_cache_type = *IN_MEM_CACHE_TYPE;
 	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = TEST_CHUNK_SIZE;
 	g_max_file_handle_cache_entry = 1;
 	LocalFileSystem::CreateLocal()->RemoveDirectory(*g_on_disk_cache_directory);
 	TestReadWithMockFileSystem();
 }
 
+TEST_CASE("Test remote request coalescing with mock filesystem", "[mock filesystem test]") {
+	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = 2 * TEST_CHUNK_SIZE;
+	for (const auto &cur_cache_type : {*ON_DISK_CACHE_TYPE, *IN_MEM_CACHE_TYPE}) {
+		*g_test_cache_type = cur_cache_type;
+		LocalFileSystem::CreateLocal()->RemoveDirectory(*g_on_disk_cache_directory);
+		TestRemoteRequestCoalescing();
+	}
+	g_max_remote_request_size = DEFAULT_MAX_REMOTE_REQUEST_SIZE;
+}
+
+TEST_CASE("Test sequential read-ahead with mock filesystem", "[mock filesystem test]") {
+	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = TEST_CHUNK_SIZE;
+	for (const auto &cur_cache_type : {*ON_DISK_CACHE_TYPE, *IN_MEM_CACHE_TYPE}) {
+		*g_test_cache_type = cur_cache_type;
+		LocalFileSystem::CreateLocal()->RemoveDirectory(*g_on_disk_cache_directory);
+		TestSequentialReadAhead();
+	}
+}
+
+TEST_CASE("Test footer prefetch with mock filesystem", "[mock filesystem test]") {
+	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = TEST_CHUNK_SIZE;
+	g_footer_prefetch_size = 10;
+	for (const auto &cur_cache_type : {*ON_DISK_CACHE_TYPE, *IN_MEM_CACHE_TYPE}) {
+		*g_test_cache_type = cur_cache_type;
+		LocalFileSystem::CreateLocal()->RemoveDirectory(*g_on_disk_cache_directory);
+		TestFooterPrefetch();
+	}
+	g_footer_prefetch_size = DEFAULT_FOOTER_PREFETCH_SIZE;
+}
+
+TEST_CASE("Test concurrent reads and read-ahead with one IO thread", "[mock filesystem test]") {
+	constexpr int64_t file_size = 40 * TEST_CHUNK_SIZE;
+	constexpr idx_t reader_count = 8;
+	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = TEST_CHUNK_SIZE;
+	g_footer_prefetch_size = 4 * TEST_CHUNK_SIZE;
+	g_io_thread_count = 1;
+	IoExecutor::Get().SetThreadCount(1);
+
+	// Readers stream the same file concurrently, so read-ahead tasks on the only IO thread race with readers for the
+	// same blocks; prefetch never waits for blocks led by readers, otherwise their fetches queue behind it.
+	for (const auto &cur_cache_type : {*ON_DISK_CACHE_TYPE, *IN_MEM_CACHE_TYPE}) {
+		*g_test_cache_type = cur_cache_type;
+		LocalFileSystem::CreateLocal()->RemoveDirectory(*g_on_disk_cache_directory);
+		auto mock_filesystem = make_uniq<MockFileSystem>([]() {}, []() {});
+		mock_filesystem->SetFileSize(file_size);
+		auto cache_filesystem = make_uniq<CacheFileSystem>(std::move(mock_filesystem));
+		CacheReaderManager::Get().ClearCache();
+
+		vector<std::thread> reader_threads;
+		vector<int> read_results(reader_count, 0);
+		for (idx_t idx = 0; idx < reader_count; ++idx) {
+			reader_threads.emplace_back([&cache_filesystem, &read_results, idx]() {
+				auto handle = cache_filesystem->OpenFile(TEST_PARQUET_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+				std::string buffer(TEST_CHUNK_SIZE, '\0');
+				bool is_content_matched = true;
+				for (int64_t offset = 0; offset < file_size; offset += TEST_CHUNK_SIZE) {
+					cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), TEST_CHUNK_SIZE);
+					is_content_matched = is_content_matched && buffer == std::string(TEST_CHUNK_SIZE, 'a');
+				}
+				// Multi-block read dispatches remote requests to the IO thread.
+				std::string whole_file(file_size, '\0');
+				cache_filesystem->Read(*handle, const_cast<char *>(whole_file.data()), file_size, /*location=*/0);
+				read_results[idx] = is_content_matched && whole_file == std::string(file_size, 'a');
+			});
+		}
+		for (auto &cur_thread : reader_threads) {
+			cur_thread.join();
+		}
+		for (int cur_result : read_results) {
+			REQUIRE(cur_result == 1);
+		}
+	}
+
+	g_footer_prefetch_size = DEFAULT_FOOTER_PREFETCH_SIZE;
+	g_io_thread_count = DEFAULT_IO_THREAD_COUNT;
+	IoExecutor::Get().SetThreadCount(GetIoThreadCount());
+}
+
+TEST_CASE("Test footer blocks retention in in-memory cache", "[mock filesystem test]") {
+	constexpr int64_t file_size = 100;
+	*g_test_cache_type = *IN_MEM_CACHE_TYPE;
+	g_cache_block_size = TEST_CHUNK_SIZE;
+	g_max_remote_request_size = TEST_CHUNK_SIZE;
+	g_footer_prefetch_size = 2 * TEST_CHUNK_SIZE;
+	// In-memory cache is budgeted by buffer capacity; footer region holds 2 blocks.
+	const idx_t block_capacity = std::string(TEST_CHUNK_SIZE, '\0').capacity();
+	g_max_in_mem_cache_bytes = 8 * block_capacity;
+	CacheReaderManager::Get().Reset();
+
+	auto mock_filesystem = make_uniq<MockFileSystem>([]() {}, []() {});
+	mock_filesystem->SetFileSize(file_size);
+	auto *mock_filesystem_ptr = mock_filesystem.get();
+	auto cache_filesystem = make_uniq<CacheFileSystem>(std::move(mock_filesystem));
+
+	// Prefetch footer, then read all column data, which exceeds in-memory cache capacity.
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_PARQUET_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		std::string buffer(file_size - 2 * TEST_CHUNK_SIZE, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), file_size - 2 * TEST_CHUNK_SIZE,
+		                       /*location=*/0);
+	}
+
+	// Footer blocks are not evicted by column data.
+	mock_filesystem_ptr->ClearReadOperations();
+	{
+		auto handle = cache_filesystem->OpenFile(TEST_PARQUET_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		std::string buffer(2 * TEST_CHUNK_SIZE, '\0');
+		cache_filesystem->Read(*handle, const_cast<char *>(buffer.data()), 2 * TEST_CHUNK_SIZE,
+		                       /*location=*/file_size - 2 * TEST_CHUNK_SIZE);
+	}
+	REQUIRE(mock_filesystem_ptr->GetSortedReadOperations().empty());
+
+	g_footer_prefetch_size = DEFAULT_FOOTER_PREFETCH_SIZE;
+	g_max_in_mem_cache_bytes = DEFAULT_MAX_IN_MEM_CACHE_BYTES;
+	CacheReaderManager::Get().Reset();
+}
+
 TEST_CASE("Test clear cache", "[mock filesystem test]") {
 	g_max_file_handle_cache_entry = 1;
 
@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#include "cache_read_chunk.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr idx_t TEST_BLOCK_SIZE = 5;
+constexpr idx_t TEST_FILE_SIZE = 26;
+const std::string TEST_FILE_CONTENT = "abcdefghijklmnopqrstuvwxyz";
+} // namespace
+
+TEST_CASE("Split request into chunks test", "[cache read chunk]") {
+	// Request covers the first, middle and last chunk.
+	{
+		std::string buffer(11, '\0');
+		auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/2,
+		                                       /*requested_bytes_to_read=*/11, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+		REQUIRE(chunks.size() == 3);
+
+		REQUIRE(chunks[0].aligned_start_offset == 0);
+		REQUIRE(chunks[0].requested_start_offset == 2);
+		REQUIRE(chunks[0].bytes_to_copy == 3);
+		REQUIRE(!chunks[0].IsFullyRequested());
+
+		REQUIRE(chunks[1].aligned_start_offset == 5);
+		REQUIRE(chunks[1].requested_start_addr == buffer.data() + 3);
+		REQUIRE(chunks[1].bytes_to_copy == 5);
+		REQUIRE(chunks[1].IsFullyRequested());
+
+		REQUIRE(chunks[2].aligned_start_offset == 10);
+		REQUIRE(chunks[2].requested_start_addr == buffer.data() + 8);
+		REQUIRE(chunks[2].bytes_to_copy == 3);
+		REQUIRE(!chunks[2].IsFullyRequested());
+	}
+
+	// Request ends at block boundary, no empty chunk should be created.
+	{
+		std::string buffer(10, '\0');
+		auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/0,
+		                                       /*requested_bytes_to_read=*/10, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+		REQUIRE(chunks.size() == 2);
+		REQUIRE(chunks[1].aligned_start_offset == 5);
+		REQUIRE(chunks[1].bytes_to_copy == 5);
+	}
+
+	// Request for the last part of the file, whose chunk is smaller than block size.
+	{
+		std::string buffer(3, '\0');
+		auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/23,
+		                                       /*requested_bytes_to_read=*/3, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+		REQUIRE(chunks.size() == 2);
+		REQUIRE(chunks[1].aligned_start_offset == 25);
+		REQUIRE(chunks[1].chunk_size == 1);
+		REQUIRE(chunks[1].IsFullyRequested());
+	}
+
+	// Empty request.
+	{
+		auto chunks = SplitIntoCacheReadChunks(/*buffer=*/nullptr, /*requested_start_offset=*/0,
+		                                       /*requested_bytes_to_read=*/0, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+		REQUIRE(chunks.empty());
+	}
+}
+
+TEST_CASE("Copy chunk to requested memory test", "[cache read chunk]") {
+	std::string buffer(11, '\0');
+	auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/2,
+	                                       /*requested_bytes_to_read=*/11, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+	for (auto &cur_chunk : chunks) {
+		char *addr = cur_chunk.GetAddressToReadTo();
+		TEST_FILE_CONTENT.copy(addr, cur_chunk.chunk_size, cur_chunk.aligned_start_offset);
+		cur_chunk.CopyBufferToRequestedMemory();
+	}
+	REQUIRE(buffer == TEST_FILE_CONTENT.substr(2, 11));
+}
+
+TEST_CASE("Coalesce chunks test", "[cache read chunk]") {
+	std::string buffer(TEST_FILE_SIZE, '\0');
+	auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/0,
+	                                       /*requested_bytes_to_read=*/TEST_FILE_SIZE, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+	REQUIRE(chunks.size() == 6);
+
+	// The second chunk is not included, so it breaks consecutive chunks.
+	vector<CacheReadChunk *> chunk_ptrs {&chunks[0], &chunks[2], &chunks[3], &chunks[4], &chunks[5]};
+	auto ranges = CoalesceCacheReadChunks(chunk_ptrs, /*max_request_size=*/2 * TEST_BLOCK_SIZE);
+	REQUIRE(ranges.size() == 3);
+	REQUIRE(ranges[0].start_offset == 0);
+	REQUIRE(ranges[0].size == 5);
+	REQUIRE(ranges[1].start_offset == 10);
+	REQUIRE(ranges[1].size == 10);
+	REQUIRE(ranges[1].chunks.size() == 2);
+	REQUIRE(ranges[2].start_offset == 20);
+	REQUIRE(ranges[2].size == 6);
+
+	// Max request size smaller than block size, each chunk forms its own range.
+	ranges = CoalesceCacheReadChunks(chunk_ptrs, /*max_request_size=*/1);
+	REQUIRE(ranges.size() == chunk_ptrs.size());
+}
+
+TEST_CASE("Execute ranges test", "[cache read chunk]") {
+	// Request starts and ends at unaligned offset, so first and last chunks are partially requested.
+	std::string buffer(TEST_FILE_SIZE - 3, '\0');
+	auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/2,
+	                                       /*requested_bytes_to_read=*/TEST_FILE_SIZE - 3, TEST_FILE_SIZE,
+	                                       TEST_BLOCK_SIZE);
+	vector<CacheReadChunk *> chunk_ptrs;
+	for (auto &cur_chunk : chunks) {
+		chunk_ptrs.emplace_back(&cur_chunk);
+	}
+	auto ranges = CoalesceCacheReadChunks(chunk_ptrs, /*max_request_size=*/2 * TEST_BLOCK_SIZE);
+	REQUIRE(ranges.size() == 3);
+
+	std::atomic<idx_t> executed_range_count {0};
+	ExecuteRemoteReadRanges(ranges, [&executed_range_count](RemoteReadRange &range) {
+		TEST_FILE_CONTENT.copy(range.GetAddressToReadTo(), range.size, range.start_offset);
+		range.CopyBufferToRequestedMemory();
+		for (const auto *cur_chunk : range.chunks) {
+			const std::string chunk_data {range.GetChunkData(*cur_chunk), cur_chunk->chunk_size};
+			REQUIRE(chunk_data == TEST_FILE_CONTENT.substr(cur_chunk->aligned_start_offset, cur_chunk->chunk_size));
+		}
+		++executed_range_count;
+	});
+	REQUIRE(executed_range_count.load() == ranges.size());
+	REQUIRE(buffer == TEST_FILE_CONTENT.substr(2, TEST_FILE_SIZE - 3));
+}
+
+TEST_CASE("Execute ranges with failure test", "[cache read chunk]") {
+	std::string buffer(TEST_FILE_SIZE, '\0');
+	auto chunks = SplitIntoCacheReadChunks(const_cast<char *>(buffer.data()), /*requested_start_offset=*/0,
+	                                       /*requested_bytes_to_read=*/TEST_FILE_SIZE, TEST_FILE_SIZE, TEST_BLOCK_SIZE);
+	vector<CacheReadChunk *> chunk_ptrs;
+	for (auto &cur_chunk : chunks) {
+		chunk_ptrs.emplace_back(&cur_chunk);
+	}
+	auto ranges = CoalesceCacheReadChunks(chunk_ptrs, /*max_request_size=*/TEST_BLOCK_SIZE);
+	REQUIRE(ranges.size() == chunks.size());
+
+	// All ranges are executed even if some of them fail, and the failure is propagated afterwards.
+	std::atomic<idx_t> executed_range_count {0};
+	auto read_range = [&executed_range_count](RemoteReadRange &range) {
+		++executed_range_count;
+		if (range.start_offset == 0) {
+			throw std::runtime_error("remote read failure");
+		}
+	};
+	REQUIRE_THROWS_AS(ExecuteRemoteReadRanges(ranges, read_range), std::runtime_error);
+	REQUIRE(executed_range_count.load() == ranges.size());
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
@@ -0,0 +1,119 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "cache_write_back_queue.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr idx_t TEST_THREAD_COUNT = 2;
+constexpr idx_t TEST_MAX_BATCH_COUNT = 3;
+} // namespace
+
+TEST_CASE("Write and flush test", "[cache write back queue]") {
+	std::mutex mu;
+	std::map<std::string, std::string> written_files;
+	CacheWriteBackQueue queue {TEST_THREAD_COUNT, TEST_MAX_BATCH_COUNT,
+	                           [&](const vector<CacheWriteBackQueue::PendingWrite> &pending_writes) {
+		                           std::lock_guard<std::mutex> lck(mu);
+		                           for (const auto &cur_pending_write : pending_writes) {
+			                           written_files[cur_pending_write.cache_file] = *cur_pending_write.content;
+		                           }
+	                           }};
+
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		REQUIRE(queue.Submit(std::to_string(idx), make_shared_ptr<const std::string>(std::to_string(idx)),
+		                     /*max_pending_bytes=*/100));
+	}
+	queue.Flush();
+	REQUIRE(queue.GetPendingBytes() == 0);
+	REQUIRE(written_files.size() == 10);
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		REQUIRE(written_files[std::to_string(idx)] == std::to_string(idx));
+	}
+}
+
+TEST_CASE("Pending content and memory cap test", "[cache write back queue]") {
+	std::promise<void> unblock_promise;
+	auto unblock_future = unblock_promise.get_future().share();
+	CacheWriteBackQueue queue {
+	    TEST_THREAD_COUNT, TEST_MAX_BATCH_COUNT,
+	    [unblock_future](const vector<CacheWriteBackQueue::PendingWrite> & /*unused*/) { unblock_future.wait(); }};
+
+	// Pending content is accessible before it's written.
+	REQUIRE(queue.Submit("file1", make_shared_ptr<const std::string>(6, 'a'), /*max_pending_bytes=*/10));
+	auto pending_content = queue.GetPendingContent("file1");
+	REQUIRE(pending_content != nullptr);
+	REQUIRE(*pending_content == std::string(6, 'a'));
+	REQUIRE(queue.GetPendingContent("file2") == nullptr);
+
+	// Writes for the same cache file are merged.
+	REQUIRE(queue.Submit("file1", make_shared_ptr<const std::string>(6, 'a'), /*max_pending_bytes=*/10));
+	REQUIRE(queue.GetPendingBytes() == 6);
+
+	// Writes exceeding memory cap are dropped.
+	REQUIRE(!queue.Submit("file2", make_shared_ptr<const std::string>(6, 'b'), /*max_pending_bytes=*/10));
+	REQUIRE(queue.GetDroppedCount() == 1);
+	REQUIRE(queue.GetPendingContent("file2") == nullptr);
+
+	unblock_promise.set_value();
+	queue.Flush();
+	REQUIRE(queue.GetPendingContent("file1") == nullptr);
+	REQUIRE(queue.Submit("file2", make_shared_ptr<const std::string>(6, 'b'), /*max_pending_bytes=*/10));
+}
+
+TEST_CASE("Write failure test", "[cache write back queue]") {
+	CacheWriteBackQueue queue {TEST_THREAD_COUNT, TEST_MAX_BATCH_COUNT,
+	                           [](const vector<CacheWriteBackQueue::PendingWrite> &pending_writes) {
+		                           throw IOException("Fails to write %s", pending_writes[0].cache_file);
+	                           }};
+	REQUIRE(queue.Submit("file", make_shared_ptr<const std::string>("content"), /*max_pending_bytes=*/100));
+	queue.Flush();
+	REQUIRE(queue.GetPendingBytes() == 0);
+	REQUIRE(queue.GetPendingContent("file") == nullptr);
+}
+
+TEST_CASE("Batched write test", "[cache write back queue]") {
+	std::promise<void> started_promise;
+	std::promise<void> unblock_promise;
+	auto unblock_future = unblock_promise.get_future().share();
+	vector<vector<std::string>> written_batches;
+	// Only one writer thread, so batches are written one after another.
+	CacheWriteBackQueue queue {/*thread_count=*/1, TEST_MAX_BATCH_COUNT,
+	                           [&](const vector<CacheWriteBackQueue::PendingWrite> &pending_writes) {
+		                           vector<std::string> cur_batch;
+		                           for (const auto &cur_pending_write : pending_writes) {
+			                           cur_batch.emplace_back(cur_pending_write.cache_file);
+		                           }
+		                           written_batches.emplace_back(std::move(cur_batch));
+		                           if (written_batches.size() == 1) {
+			                           started_promise.set_value();
+			                           unblock_future.wait();
+		                           }
+	                           }};
+
+	// Writes submitted while the writer is blocked are backed up, which are written in batches of at most max batch
+	// count in submission order.
+	REQUIRE(queue.Submit("file0", make_shared_ptr<const std::string>("a"), /*max_pending_bytes=*/100));
+	started_promise.get_future().wait();
+	for (idx_t idx = 1; idx <= 4; ++idx) {
+		REQUIRE(queue.Submit(StringUtil::Format("file%llu", idx), make_shared_ptr<const std::string>("a"),
+		                     /*max_pending_bytes=*/100));
+	}
+	unblock_promise.set_value();
+	queue.Flush();
+	REQUIRE(written_batches == vector<vector<std::string>> {{"file0"}, {"file1", "file2", "file3"}, {"file4"}});
+	REQUIRE(queue.GetPendingBytes() == 0);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
@@ -0,0 +1,48 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "crc32c.hpp"
+
+#include <random>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+TEST_CASE("Checksum for known values", "[crc32c test]") {
+	const std::string content = "123456789";
+	REQUIRE(Crc32c(content.data(), content.length()) == 0xE3069283);
+	REQUIRE(Crc32cPortable(content.data(), content.length()) == 0xE3069283);
+	REQUIRE(Crc32c(content.data(), /*length=*/0) == 0);
+
+	const std::string zeros(32, '\0');
+	REQUIRE(Crc32c(zeros.data(), zeros.length()) == 0x8A9136AA);
+}
+
+// Content long enough to go through interleaved lanes, at unaligned start addresses and with unaligned lengths.
+TEST_CASE("Hardware checksum matches portable implementation", "[crc32c test]") {
+	std::mt19937 generator {/*seed=*/0};
+	std::string content(16 * 1024 + 7, '\0');
+	for (auto &cur_char : content) {
+		cur_char = static_cast<char>(generator());
+	}
+	for (const idx_t start : {0, 1, 3}) {
+		for (const idx_t length : {1, 7, 8, 1000, 3 * 1024, 3 * 1024 + 9, 16 * 1024}) {
+			REQUIRE(Crc32c(content.data() + start, length) == Crc32cPortable(content.data() + start, length));
+		}
+	}
+}
+
+TEST_CASE("Incremental checksum", "[crc32c test]") {
+	const std::string content = "hello world, incremental checksum";
+	const uint32_t expected = Crc32c(content.data(), content.length());
+	for (idx_t split = 0; split <= content.length(); ++split) {
+		const uint32_t prefix_crc = Crc32c(content.data(), split);
+		REQUIRE(Crc32c(content.data() + split, content.length() - split, prefix_crc) == expected);
+		REQUIRE(Crc32cPortable(content.data() + split, content.length() - split, prefix_crc) == expected);
+	}
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
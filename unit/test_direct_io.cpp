@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "direct_io.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <cstdint>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+const auto TEST_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_direct_io";
+
+std::string GetTestFilepath(idx_t idx) {
+	return StringUtil::Format("%s/file-%llu", TEST_DIRECTORY, idx);
+}
+std::string GetTestContent(idx_t size) {
+	std::string content(size, '\0');
+	for (idx_t idx = 0; idx < size; ++idx) {
+		content[idx] = static_cast<char>('a' + idx % 26);
+	}
+	return content;
+}
+} // namespace
+
+TEST_CASE("Aligned buffer pool test", "[direct io test]") {
+	AlignedBufferPool buffer_pool {/*max_idle_bytes=*/2 * DIRECT_IO_ALIGNMENT};
+
+	// Buffers are aligned, with capacity rounded up to alignment.
+	char *first_data = nullptr;
+	{
+		auto buffer = buffer_pool.Acquire(1);
+		REQUIRE(reinterpret_cast<uintptr_t>(buffer.GetData()) % DIRECT_IO_ALIGNMENT == 0);
+		REQUIRE(buffer.GetCapacity() == DIRECT_IO_ALIGNMENT);
+		first_data = buffer.GetData();
+	}
+	REQUIRE(buffer_pool.GetIdleBytes() == DIRECT_IO_ALIGNMENT);
+
+	// Released buffer is reused.
+	{
+		auto buffer = buffer_pool.Acquire(DIRECT_IO_ALIGNMENT);
+		REQUIRE(buffer.GetData() == first_data);
+		REQUIRE(buffer_pool.GetIdleBytes() == 0);
+	}
+
+	// Buffers released beyond idle capacity are freed.
+	{
+		auto first_buffer = buffer_pool.Acquire(DIRECT_IO_ALIGNMENT);
+		auto second_buffer = buffer_pool.Acquire(DIRECT_IO_ALIGNMENT + 1);
+		REQUIRE(second_buffer.GetCapacity() == 2 * DIRECT_IO_ALIGNMENT);
+	}
+	REQUIRE(buffer_pool.GetIdleBytes() <= 2 * DIRECT_IO_ALIGNMENT);
+}
+
+TEST_CASE("Write and read files test", "[direct io test]") {
+	if (!IsDirectIoSupported()) {
+		return;
+	}
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_DIRECTORY);
+
+	// Files with and without aligned prefix and unaligned tail, read into aligned and unaligned buffers.
+	const vector<idx_t> file_sizes {1, DIRECT_IO_ALIGNMENT - 1, DIRECT_IO_ALIGNMENT, DIRECT_IO_ALIGNMENT + 1,
+	                                3 * DIRECT_IO_ALIGNMENT + 5};
+	for (idx_t idx = 0; idx < file_sizes.size(); ++idx) {
+		const auto content = GetTestContent(file_sizes[idx]);
+		DirectIoWriteFile(GetTestFilepath(idx), content.data(), content.length(), /*sync=*/idx % 2 == 0);
+
+		AlignedBufferPool buffer_pool {/*max_idle_bytes=*/0};
+		auto aligned_buffer = buffer_pool.Acquire(content.length());
+		REQUIRE(DirectIoReadFile(GetTestFilepath(idx), aligned_buffer.GetData(), content.length()) ==
+		        static_cast<int64_t>(content.length()));
+		REQUIRE(std::string(aligned_buffer.GetData(), content.length()) == content);
+
+		std::string unaligned_buffer(content.length() + 1, '\0');
+		REQUIRE(DirectIoReadFile(GetTestFilepath(idx), &unaligned_buffer[1], content.length()) ==
+		        static_cast<int64_t>(content.length()));
+		REQUIRE(unaligned_buffer.substr(1) == content);
+	}
+
+	// Reading beyond the file end returns actual file size.
+	{
+		const auto content = GetTestContent(DIRECT_IO_ALIGNMENT + 1);
+		std::string buffer(2 * DIRECT_IO_ALIGNMENT + 1, '\0');
+		REQUIRE(DirectIoReadFile(GetTestFilepath(3), &buffer[0], buffer.length()) ==
+		        static_cast<int64_t>(content.length()));
+		REQUIRE(buffer.substr(0, content.length()) == content);
+	}
+
+	// Trailer is written right after data, and read into its own buffer.
+	{
+		const auto content = GetTestContent(DIRECT_IO_ALIGNMENT);
+		const std::string trailer = "trailer";
+		const auto filepath = StringUtil::Format("%s/file-with-trailer", TEST_DIRECTORY);
+		DirectIoWriteFile(filepath, content.data(), content.length(), /*sync=*/false, trailer.data(),
+		                  trailer.length());
+
+		AlignedBufferPool buffer_pool {/*max_idle_bytes=*/0};
+		auto buffer = buffer_pool.Acquire(content.length());
+		std::string trailer_buffer(trailer.length(), '\0');
+		REQUIRE(DirectIoReadFile(filepath, buffer.GetData(), content.length(), &trailer_buffer[0],
+		                         trailer_buffer.length()) == static_cast<int64_t>(content.length() + trailer.length()));
+		REQUIRE(std::string(buffer.GetData(), content.length()) == content);
+		REQUIRE(trailer_buffer == trailer);
+
+		// Shorter file doesn't fill the trailer.
+		REQUIRE(DirectIoReadFile(GetTestFilepath(2), buffer.GetData(), content.length(), &trailer_buffer[0],
+		                         trailer_buffer.length()) == static_cast<int64_t>(content.length()));
+	}
+
+	// Reading non-existent file.
+	{
+		std::string buffer(1, '\0');
+		REQUIRE(DirectIoReadFile(StringUtil::Format("%s/non-existent", TEST_DIRECTORY), &buffer[0], 1) == -1);
+	}
+
+	// Files are created exclusively.
+	{
+		const auto content = GetTestContent(1);
+		REQUIRE_THROWS(DirectIoWriteFile(GetTestFilepath(0), content.data(), content.length(), /*sync=*/false));
+	}
+
+	local_filesystem->RemoveDirectory(TEST_DIRECTORY);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
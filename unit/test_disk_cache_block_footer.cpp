@@ -0,0 +1,114 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "disk_cache_block_footer.hpp"
+
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+const std::string TEST_PAYLOAD = "hello world";
+const RemoteFileIdentity TEST_REMOTE_IDENTITY {
+    .file_size = 1024,
+    .last_modified = 1700000000,
+    .version_hash = 42,
+};
+
+std::string EncodeTestFooter() {
+	std::string footer(DISK_CACHE_BLOCK_FOOTER_SIZE, '\0');
+	EncodeDiskCacheBlockFooter(TEST_PAYLOAD.data(), TEST_PAYLOAD.length(), TEST_REMOTE_IDENTITY, &footer[0]);
+	return footer;
+}
+} // namespace
+
+TEST_CASE("Encode and decode footer", "[disk cache block footer test]") {
+	const auto footer = EncodeTestFooter();
+	DiskCacheBlockFooter decoded;
+	REQUIRE(DecodeDiskCacheBlockFooter(footer.data(), decoded));
+	REQUIRE(decoded.payload_length == TEST_PAYLOAD.length());
+	REQUIRE(decoded.remote_file_size == TEST_REMOTE_IDENTITY.file_size);
+	REQUIRE(decoded.remote_last_modified == TEST_REMOTE_IDENTITY.last_modified);
+	REQUIRE(decoded.remote_version_hash == TEST_REMOTE_IDENTITY.version_hash);
+	REQUIRE(IsValidDiskCacheBlock(TEST_PAYLOAD.data(), TEST_PAYLOAD.length(), footer.data(), TEST_REMOTE_IDENTITY));
+
+	// Any torn byte in footer is detected.
+	for (idx_t idx = 0; idx < footer.length(); ++idx) {
+		auto torn_footer = footer;
+		torn_footer[idx] ^= 0x01;
+		REQUIRE(!DecodeDiskCacheBlockFooter(torn_footer.data(), decoded));
+	}
+
+	// Garbage is not a footer.
+	const std::string garbage(DISK_CACHE_BLOCK_FOOTER_SIZE, 'a');
+	REQUIRE(!DecodeDiskCacheBlockFooter(garbage.data(), decoded));
+}
+
+TEST_CASE("Validate cache block", "[disk cache block footer test]") {
+	const auto footer = EncodeTestFooter();
+
+	// Corrupted payload.
+	auto corrupted_payload = TEST_PAYLOAD;
+	corrupted_payload[0] = 'j';
+	REQUIRE(IsDiskCacheBlockFooterMatched(footer.data(), corrupted_payload.length(), TEST_REMOTE_IDENTITY));
+	REQUIRE(!IsValidDiskCacheBlock(corrupted_payload.data(), corrupted_payload.length(), footer.data(),
+	                               TEST_REMOTE_IDENTITY));
+
+	// Unexpected payload length.
+	REQUIRE(!IsDiskCacheBlockFooterMatched(footer.data(), TEST_PAYLOAD.length() - 1, TEST_REMOTE_IDENTITY));
+
+	// Remote file has changed.
+	for (idx_t idx = 0; idx < 3; ++idx) {
+		auto changed_identity = TEST_REMOTE_IDENTITY;
+		if (idx == 0) {
+			++changed_identity.file_size;
+		} else if (idx == 1) {
+			++changed_identity.last_modified;
+		} else {
+			++changed_identity.version_hash;
+		}
+		REQUIRE(changed_identity != TEST_REMOTE_IDENTITY);
+		REQUIRE(!IsDiskCacheBlockFooterMatched(footer.data(), TEST_PAYLOAD.length(), changed_identity));
+		REQUIRE(!IsValidDiskCacheBlock(TEST_PAYLOAD.data(), TEST_PAYLOAD.length(), footer.data(), changed_identity));
+	}
+}
+
+TEST_CASE("Validate compressed cache block", "[disk cache block footer test]") {
+	// Stored bytes stand for compressed payload, which is shorter than raw payload.
+	const std::string stored = "hello";
+	std::string footer(DISK_CACHE_BLOCK_FOOTER_SIZE, '\0');
+	EncodeDiskCacheBlockFooter(stored.data(), stored.length(), DiskCacheBlockCodec::kZstd, TEST_PAYLOAD.length(),
+	                           TEST_REMOTE_IDENTITY, &footer[0]);
+
+	DiskCacheBlockFooter decoded;
+	REQUIRE(DecodeDiskCacheBlockFooter(footer.data(), decoded));
+	REQUIRE(decoded.codec == static_cast<uint8_t>(DiskCacheBlockCodec::kZstd));
+	REQUIRE(decoded.payload_length == TEST_PAYLOAD.length());
+	REQUIRE(GetRemoteFileIdentity(decoded) == TEST_REMOTE_IDENTITY);
+	REQUIRE(IsDiskCacheBlockStoredLengthMatched(decoded, stored.length()));
+	REQUIRE(!IsDiskCacheBlockStoredLengthMatched(decoded, TEST_PAYLOAD.length()));
+	REQUIRE(IsDiskCacheBlockFooterMatched(footer.data(), TEST_PAYLOAD.length(), TEST_REMOTE_IDENTITY));
+	REQUIRE(IsValidDiskCacheBlock(stored.data(), stored.length(), footer.data(), TEST_PAYLOAD.length(),
+	                              TEST_REMOTE_IDENTITY));
+
+	// Compressed block is not a raw block.
+	REQUIRE(!IsValidDiskCacheBlock(stored.data(), stored.length(), footer.data(), TEST_REMOTE_IDENTITY));
+
+	// Corrupted stored bytes.
+	auto corrupted_stored = stored;
+	corrupted_stored[0] = 'j';
+	REQUIRE(!IsValidDiskCacheBlock(corrupted_stored.data(), corrupted_stored.length(), footer.data(),
+	                               TEST_PAYLOAD.length(), TEST_REMOTE_IDENTITY));
+
+	// Raw block is only valid if it's stored as is.
+	const auto raw_footer = EncodeTestFooter();
+	REQUIRE(IsValidDiskCacheBlock(TEST_PAYLOAD.data(), TEST_PAYLOAD.length(), raw_footer.data(), TEST_PAYLOAD.length(),
+	                              TEST_REMOTE_IDENTITY));
+	REQUIRE(!IsValidDiskCacheBlock(TEST_PAYLOAD.data(), TEST_PAYLOAD.length() - 1, raw_footer.data(),
+	                               TEST_PAYLOAD.length(), TEST_REMOTE_IDENTITY));
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
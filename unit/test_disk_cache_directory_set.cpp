@@ -0,0 +1,153 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "disk_cache_directory_set.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <algorithm>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+constexpr idx_t TEST_CACHE_FILE_COUNT = 10000;
+// Never rejoin rotation within a test case.
+constexpr int64_t TEST_REJOIN_INTERVAL_MILLISEC = 3600 * 1000;
+
+vector<std::string> GetTestDirectories(idx_t directory_count) {
+	vector<std::string> directories;
+	for (idx_t idx = 0; idx < directory_count; ++idx) {
+		directories.emplace_back(StringUtil::Format("/mnt/nvme%llu/cache", idx));
+	}
+	return directories;
+}
+
+std::string GetTestCacheFname(idx_t idx) {
+	return StringUtil::Format("hash-file.parquet-%llu-65536", idx * 65536);
+}
+
+// Get the number of test cache files placed on each directory.
+vector<idx_t> GetPlacement(const DiskCacheDirectorySet &directory_set) {
+	vector<idx_t> cache_file_counts(directory_set.GetDirectoryCount(), 0);
+	for (idx_t idx = 0; idx < TEST_CACHE_FILE_COUNT; ++idx) {
+		++cache_file_counts[directory_set.PickDirectory(GetTestCacheFname(idx))];
+	}
+	return cache_file_counts;
+}
+
+} // namespace
+
+TEST_CASE("Single directory test", "[disk cache directory set]") {
+	DiskCacheDirectorySet directory_set {GetTestDirectories(1), /*weights_p=*/ {}, TEST_REJOIN_INTERVAL_MILLISEC};
+	REQUIRE(directory_set.PickDirectory(GetTestCacheFname(0)) == 0);
+
+	// The only directory is still picked when it's out of rotation.
+	directory_set.TakeOutOfRotation(0);
+	REQUIRE(!directory_set.IsInRotation(0));
+	REQUIRE(directory_set.PickDirectory(GetTestCacheFname(0)) == 0);
+
+	REQUIRE(directory_set.GetCapacityBytes(0, /*overall_capacity_bytes=*/100) == 100);
+	REQUIRE(directory_set.GetCapacityBytes(0, /*overall_capacity_bytes=*/0) == 0);
+}
+
+TEST_CASE("Even placement test", "[disk cache directory set]") {
+	DiskCacheDirectorySet directory_set {GetTestDirectories(4), /*weights_p=*/ {}, TEST_REJOIN_INTERVAL_MILLISEC};
+	const auto cache_file_counts = GetPlacement(directory_set);
+	for (idx_t cur_count : cache_file_counts) {
+		REQUIRE(cur_count > TEST_CACHE_FILE_COUNT / 4 * 9 / 10);
+		REQUIRE(cur_count < TEST_CACHE_FILE_COUNT / 4 * 11 / 10);
+	}
+
+	// Placement is deterministic, and doesn't depend on directory order.
+	auto reversed_directories = GetTestDirectories(4);
+	std::reverse(reversed_directories.begin(), reversed_directories.end());
+	DiskCacheDirectorySet reversed_directory_set {reversed_directories, /*weights_p=*/ {},
+	                                              TEST_REJOIN_INTERVAL_MILLISEC};
+	for (idx_t idx = 0; idx < TEST_CACHE_FILE_COUNT; ++idx) {
+		const auto cache_fname = GetTestCacheFname(idx);
+		REQUIRE(directory_set.GetDirectories()[directory_set.PickDirectory(cache_fname)] ==
+		        reversed_directories[reversed_directory_set.PickDirectory(cache_fname)]);
+	}
+}
+
+TEST_CASE("Weighted placement test", "[disk cache directory set]") {
+	DiskCacheDirectorySet directory_set {GetTestDirectories(2), /*weights_p=*/ {3.0, 1.0},
+	                                     TEST_REJOIN_INTERVAL_MILLISEC};
+	const auto cache_file_counts = GetPlacement(directory_set);
+	REQUIRE(cache_file_counts[0] > TEST_CACHE_FILE_COUNT * 3 / 4 * 9 / 10);
+	REQUIRE(cache_file_counts[0] < TEST_CACHE_FILE_COUNT * 3 / 4 * 11 / 10);
+
+	REQUIRE(directory_set.GetCapacityBytes(0, /*overall_capacity_bytes=*/400) == 300);
+	REQUIRE(directory_set.GetCapacityBytes(1, /*overall_capacity_bytes=*/400) == 100);
+}
+
+TEST_CASE("Consistent placement on directory addition test", "[disk cache directory set]") {
+	DiskCacheDirectorySet directory_set {GetTestDirectories(4), /*weights_p=*/ {}, TEST_REJOIN_INTERVAL_MILLISEC};
+	DiskCacheDirectorySet extended_directory_set {GetTestDirectories(5), /*weights_p=*/ {},
+	                                              TEST_REJOIN_INTERVAL_MILLISEC};
+
+	// Only cache files placed on the new directory move.
+	idx_t moved_count = 0;
+	for (idx_t idx = 0; idx < TEST_CACHE_FILE_COUNT; ++idx) {
+		const auto cache_fname = GetTestCacheFname(idx);
+		const idx_t extended_directory_idx = extended_directory_set.PickDirectory(cache_fname);
+		if (extended_directory_idx == 4) {
+			++moved_count;
+			continue;
+		}
+		REQUIRE(extended_directory_idx == directory_set.PickDirectory(cache_fname));
+	}
+	REQUIRE(moved_count > TEST_CACHE_FILE_COUNT / 5 * 9 / 10);
+	REQUIRE(moved_count < TEST_CACHE_FILE_COUNT / 5 * 11 / 10);
+}
+
+TEST_CASE("Rotation test", "[disk cache directory set]") {
+	DiskCacheDirectorySet directory_set {GetTestDirectories(3), /*weights_p=*/ {}, TEST_REJOIN_INTERVAL_MILLISEC};
+	vector<idx_t> placement;
+	for (idx_t idx = 0; idx < TEST_CACHE_FILE_COUNT; ++idx) {
+		placement.emplace_back(directory_set.PickDirectory(GetTestCacheFname(idx)));
+	}
+
+	// Cache files on the directory out of rotation are placed elsewhere, while others stay.
+	directory_set.TakeOutOfRotation(1);
+	REQUIRE(!directory_set.IsInRotation(1));
+	for (idx_t idx = 0; idx < TEST_CACHE_FILE_COUNT; ++idx) {
+		const idx_t cur_directory_idx = directory_set.PickDirectory(GetTestCacheFname(idx));
+		REQUIRE(cur_directory_idx != 1);
+		if (placement[idx] != 1) {
+			REQUIRE(cur_directory_idx == placement[idx]);
+		}
+	}
+
+	// All directories are out of rotation, cache files are placed as if they're all in rotation.
+	directory_set.TakeOutOfRotation(0);
+	directory_set.TakeOutOfRotation(2);
+	for (idx_t idx = 0; idx < TEST_CACHE_FILE_COUNT; ++idx) {
+		REQUIRE(directory_set.PickDirectory(GetTestCacheFname(idx)) == placement[idx]);
+	}
+
+	// Directory rejoins rotation after rejoin interval.
+	DiskCacheDirectorySet rejoin_directory_set {GetTestDirectories(3), /*weights_p=*/ {},
+	                                            /*rejoin_interval_millisec_p=*/0};
+	rejoin_directory_set.TakeOutOfRotation(1);
+	REQUIRE(rejoin_directory_set.IsInRotation(1));
+}
+
+TEST_CASE("Find directory test", "[disk cache directory set]") {
+	DiskCacheDirectorySet directory_set {{"/mnt/cache", "/mnt/cache/nested", "/"}, /*weights_p=*/ {},
+	                                     TEST_REJOIN_INTERVAL_MILLISEC};
+	REQUIRE(directory_set.FindDirectory("/mnt/cache/ab/cd/abcd-file-0-10").GetIndex() == 0);
+	REQUIRE(directory_set.FindDirectory("/mnt/cache/nested/ab/cd/abcd-file-0-10").GetIndex() == 1);
+	REQUIRE(directory_set.FindDirectory("/mnt/cache2/ab/cd/abcd-file-0-10").GetIndex() == 2);
+
+	DiskCacheDirectorySet non_root_directory_set {GetTestDirectories(2), /*weights_p=*/ {},
+	                                              TEST_REJOIN_INTERVAL_MILLISEC};
+	REQUIRE(!non_root_directory_set.FindDirectory("/mnt/nvme2/cache/ab/cd/abcd-file-0-10").IsValid());
+	REQUIRE(!non_root_directory_set.FindDirectory("/mnt/nvme0/cache").IsValid());
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
@@ -11,6 +11,9 @@
 #include "catch.hpp"
 
 #include "cache_filesystem_config.hpp"
+#include "cache_reader_manager.hpp"
+#include "disk_cache_block_footer.hpp"
+#include "disk_cache_lru_index.hpp"
 #include "disk_cache_reader.hpp"
 #include "duckdb/common/local_file_system.hpp"
 #include "duckdb/common/string_util.hpp"
@@ -19,6 +22,11 @@
 #include "filesystem_utils.hpp"
 #include "scope_guard.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <unordered_set>
 #include <utime.h>
 
 using namespace duckdb; // NOLINT
@@ -35,12 +43,26 @@ const auto TEST_FILE_CONTENT = []() {
 }();
 const auto TEST_FILENAME = StringUtil::Format("/tmp/%s", UUID::ToString(UUID::GenerateRandomUUID()));
 const auto TEST_ON_DISK_CACHE_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_cache";
+
+// Cache files are written in background, wait for all pending writes before checking cache directory.
+void FlushCacheWrites() {
+	CacheReaderManager::Get().GetCacheReader()->Flush();
+}
+
+// Remove [cache_directory] after pending writes left by previous test cases finish, otherwise they could land into the
+// directory after removal.
+void RemoveCacheDirectory(const string &cache_directory) {
+	for (auto *cur_cache_reader : CacheReaderManager::Get().GetCacheReaders()) {
+		cur_cache_reader->Flush();
+	}
+	LocalFileSystem::CreateLocal()->RemoveDirectory(cache_directory);
+}
 } // namespace
 
 // Test default directory works for uncached read.
 TEST_CASE("Test on default cache directory", "[on-disk cache filesystem test]") {
 	// Cleanup default cache directory before test.
-	LocalFileSystem::CreateLocal()->RemoveDirectory(*DEFAULT_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(*DEFAULT_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// Uncached read.
@@ -54,6 +76,7 @@ TEST_CASE("Test on default cache directory", "[on-disk cache filesystem test]")
 		REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, bytes_to_read));
 	}
 
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(*DEFAULT_ON_DISK_CACHE_DIRECTORY) > 0);
 }
 
@@ -67,7 +90,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk the first meanwhil
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -103,7 +126,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk the first and last
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -138,7 +161,7 @@ TEST_CASE("Test on disk cache filesystem with request for the last part of the f
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read
@@ -152,6 +175,7 @@ TEST_CASE("Test on disk cache filesystem with request for the last part of the f
 
 		REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, bytes_to_read));
 	}
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 1);
 
 	// Second cached read.
@@ -164,6 +188,7 @@ TEST_CASE("Test on disk cache filesystem with request for the last part of the f
 		                    start_offset);
 		REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, bytes_to_read));
 	}
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 1);
 }
 
@@ -177,7 +202,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk the first, middle
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -213,7 +238,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk first and last one
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -248,7 +273,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk at last of file",
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -263,6 +288,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk at last of file",
 	}
 
 	// Check cache files count.
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 2);
 
 	// Second cached read, partial cached and another part uncached.
@@ -277,6 +303,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk at last of file",
 	}
 
 	// Get all cache files and check file count.
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 3);
 }
 
@@ -289,7 +316,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk at middle of file"
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -304,6 +331,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk at middle of file"
 	}
 
 	// Get all cache files and check file count.
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 1);
 
 	// Second cached read, partial cached and another part uncached.
@@ -318,6 +346,7 @@ TEST_CASE("Test on disk cache filesystem with requested chunk at middle of file"
 	}
 
 	// Get all cache files and check file count.
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 4);
 }
 
@@ -330,7 +359,7 @@ TEST_CASE("Test on disk cache filesystem no new cache file after a full cache",
 		ResetGlobalConfig();
 	};
 
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 
 	// First uncached read.
@@ -345,6 +374,7 @@ TEST_CASE("Test on disk cache filesystem no new cache file after a full cache",
 	}
 
 	// Get all cache files.
+	FlushCacheWrites();
 	auto cache_files1 = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
 
 	// Second cached read.
@@ -359,12 +389,726 @@ TEST_CASE("Test on disk cache filesystem no new cache file after a full cache",
 	}
 
 	// Get all cache files and check unchanged.
+	FlushCacheWrites();
 	auto cache_files2 = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
 	REQUIRE(cache_files1 == cache_files2);
 }
 
+TEST_CASE("Test on disk cache capacity", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	constexpr uint64_t test_disk_cache_bytes = 3 * (test_block_size + DISK_CACHE_BLOCK_FOOTER_SIZE);
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	g_cache_block_size = test_block_size;
+	g_max_disk_cache_bytes = test_disk_cache_bytes;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	// Rebuild disk cache index from an empty cache directory.
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+	// Read the whole file, whose cache files exceed disk cache capacity.
+	{
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(TEST_FILE_SIZE, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), TEST_FILE_SIZE,
+		                    /*location=*/0);
+		REQUIRE(content == TEST_FILE_CONTENT);
+	}
+
+	// Least recently used cache files have been evicted, so disk usage stays under capacity.
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	FlushCacheWrites();
+	const auto cache_files = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+	REQUIRE(!cache_files.empty());
+	uint64_t cache_bytes = 0;
+	for (const auto &cur_cache_file : cache_files) {
+		auto file_handle =
+		    local_filesystem->OpenFile(StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cur_cache_file),
+		                               FileOpenFlags::FILE_FLAGS_READ);
+		cache_bytes += local_filesystem->GetFileSize(*file_handle);
+	}
+	REQUIRE(cache_bytes <= test_disk_cache_bytes);
+
+	// Blocks are fetched and cached concurrently, so which of them survive eviction is not deterministic; a surviving
+	// block, whose offset is encoded in cache filename, is still accessible from local cache.
+	{
+		const auto tokens = StringUtil::Split(cache_files.front(), '-');
+		REQUIRE(tokens.size() >= 2);
+		const uint64_t start_offset = std::stoull(tokens[tokens.size() - 2]);
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(1, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), /*nr_bytes=*/1,
+		                    start_offset);
+		REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, 1));
+	}
+	FlushCacheWrites();
+	REQUIRE(GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY) == cache_files);
+}
+
+TEST_CASE("Test on synchronous cache write", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	g_cache_block_size = test_block_size;
+	g_disk_cache_write_back_max_bytes = 0;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+	// Cache files are visible right after read, without waiting for background writes.
+	auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+	string content(TEST_FILE_SIZE, '\0');
+	disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), TEST_FILE_SIZE,
+	                    /*location=*/0);
+	REQUIRE(content == TEST_FILE_CONTENT);
+	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 6);
+}
+
+TEST_CASE("Test on disk cache durability mode", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	for (const auto &cur_durability : *ALL_DISK_CACHE_DURABILITY_MODES) {
+		*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+		g_cache_block_size = test_block_size;
+		*g_disk_cache_durability = cur_durability;
+		SCOPE_EXIT {
+			ResetGlobalConfig();
+		};
+
+		RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+		CacheReaderManager::Get().Reset();
+		auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+		// First uncached read, and second cached read.
+		for (idx_t read_idx = 0; read_idx < 2; ++read_idx) {
+			auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+			string content(TEST_FILE_SIZE, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    TEST_FILE_SIZE, /*location=*/0);
+			REQUIRE(content == TEST_FILE_CONTENT);
+			FlushCacheWrites();
+			REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 6);
+		}
+	}
+}
+
+TEST_CASE("Test on disk cache IO engine", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	for (const auto &cur_io_engine : *ALL_DISK_CACHE_IO_ENGINES) {
+		*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+		g_cache_block_size = test_block_size;
+		*g_disk_cache_io_engine = cur_io_engine;
+		// Blocks of one request are written together, so they're batched under io_uring engine.
+		g_disk_cache_write_back_max_bytes = 0;
+		SCOPE_EXIT {
+			ResetGlobalConfig();
+		};
+
+		RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+		CacheReaderManager::Get().Reset();
+		auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+		// First uncached read, and second cached read.
+		for (idx_t read_idx = 0; read_idx < 2; ++read_idx) {
+			auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+			string content(TEST_FILE_SIZE, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    TEST_FILE_SIZE, /*location=*/0);
+			REQUIRE(content == TEST_FILE_CONTENT);
+			REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 6);
+		}
+
+		// Truncated cache file is discarded and re-cached. Cache files are only left truncated by crash, so the reader
+		// restarts without mappings for cache files.
+		auto local_filesystem = LocalFileSystem::CreateLocal();
+		const auto cache_files = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+		const auto cache_filepath = StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cache_files[0]);
+		CacheReaderManager::Get().Reset();
+		disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		{
+			auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_WRITE);
+			file_handle->Truncate(/*new_size=*/1);
+		}
+		{
+			auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+			string content(TEST_FILE_SIZE, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    TEST_FILE_SIZE, /*location=*/0);
+			REQUIRE(content == TEST_FILE_CONTENT);
+		}
+		REQUIRE(GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY) == cache_files);
+		auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_READ);
+		REQUIRE(static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle)) ==
+		        StringUtil::ToUnsigned(cache_files[0].substr(cache_files[0].rfind('-') + 1)) +
+		            DISK_CACHE_BLOCK_FOOTER_SIZE);
+	}
+}
+
+// Memory mappings outlive their cache files, so mappings for evicted cache files are not reused.
+TEST_CASE("Test on mmap IO engine with evicted cache files", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	g_cache_block_size = test_block_size;
+	g_max_disk_cache_bytes = 3 * (test_block_size + DISK_CACHE_BLOCK_FOOTER_SIZE);
+	*g_disk_cache_io_engine = *MMAP_DISK_CACHE_IO_ENGINE;
+	g_disk_cache_write_back_max_bytes = 0;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	auto read_block = [&](idx_t block_idx) {
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		const uint64_t start_offset = block_idx * test_block_size + 1;
+		string content(2, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+		                    content.length(), start_offset);
+		REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, content.length()));
+	};
+	auto is_block_cached = [&](idx_t block_idx) {
+		const auto suffix = StringUtil::Format("-%llu-%llu", block_idx * test_block_size, test_block_size);
+		for (const auto &cur_cache_file : GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY)) {
+			if (StringUtil::EndsWith(cur_cache_file, suffix)) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// Cache the first block, and serve it from memory mapping.
+	read_block(0);
+	read_block(0);
+	REQUIRE(is_block_cached(0));
+
+	// Later blocks evict the first one.
+	for (idx_t block_idx = 1; block_idx <= 3; ++block_idx) {
+		read_block(block_idx);
+	}
+	REQUIRE(!is_block_cached(0));
+
+	// Mapping for the evicted cache file is dropped, so the block is fetched and cached again.
+	read_block(0);
+	REQUIRE(is_block_cached(0));
+}
+
+// Cache files left truncated (i.e. by crash before sync) are discarded and re-cached.
+TEST_CASE("Test on corrupted cache file", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	g_cache_block_size = test_block_size;
+	*g_disk_cache_durability = *NONE_DISK_CACHE_DURABILITY;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+	// Cache the first block.
+	{
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(test_block_size, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), test_block_size,
+		                    /*location=*/0);
+		REQUIRE(content == TEST_FILE_CONTENT.substr(0, test_block_size));
+	}
+	FlushCacheWrites();
+	const auto cache_files = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+	REQUIRE(cache_files.size() == 1);
+
+	// Truncate the cache file.
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto cache_filepath = StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cache_files[0]);
+	{
+		auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_WRITE);
+		file_handle->Truncate(/*new_size=*/1);
+	}
+
+	// Read again, which gets correct content, and cache file gets re-created.
+	{
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(test_block_size, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), test_block_size,
+		                    /*location=*/0);
+		REQUIRE(content == TEST_FILE_CONTENT.substr(0, test_block_size));
+	}
+	FlushCacheWrites();
+	REQUIRE(GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY) == cache_files);
+	auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_READ);
+	REQUIRE(local_filesystem->GetFileSize(*file_handle) == test_block_size + DISK_CACHE_BLOCK_FOOTER_SIZE);
+}
+
+// Cache files whose payload doesn't match its checksum (i.e. torn write or bit rot) are discarded and re-cached.
+TEST_CASE("Test on cache file with corrupted payload", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	for (const auto &cur_io_engine : *ALL_DISK_CACHE_IO_ENGINES) {
+		*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+		g_cache_block_size = test_block_size;
+		*g_disk_cache_io_engine = cur_io_engine;
+		g_disk_cache_write_back_max_bytes = 0;
+		SCOPE_EXIT {
+			ResetGlobalConfig();
+		};
+
+		RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+		CacheReaderManager::Get().Reset();
+		auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		auto read_first_block = [&]() {
+			auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+			string content(test_block_size, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    test_block_size, /*location=*/0);
+			REQUIRE(content == TEST_FILE_CONTENT.substr(0, test_block_size));
+		};
+		read_first_block();
+		const auto cache_files = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+		REQUIRE(cache_files.size() == 1);
+
+		// Flip the first payload byte in place, after the reader restarts without mappings for cache files.
+		auto local_filesystem = LocalFileSystem::CreateLocal();
+		const auto cache_filepath = StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cache_files[0]);
+		CacheReaderManager::Get().Reset();
+		disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		{
+			auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_WRITE);
+			char corrupted_byte = 'z';
+			local_filesystem->Write(*file_handle, &corrupted_byte, /*nr_bytes=*/1, /*location=*/0);
+		}
+
+		// Corrupted payload is not served, and the cache file gets re-created with correct payload.
+		read_first_block();
+		REQUIRE(GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY) == cache_files);
+		auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_READ);
+		string cached_payload(test_block_size, '\0');
+		local_filesystem->Read(*file_handle, const_cast<char *>(cached_payload.data()), test_block_size,
+		                       /*location=*/0);
+		REQUIRE(cached_payload == TEST_FILE_CONTENT.substr(0, test_block_size));
+	}
+}
+
+// Cache files are indexed from their footers, files without a valid footer (i.e. written in an older format) are
+// discarded on index rebuild.
+TEST_CASE("Test on cache files without footer", "[on-disk cache filesystem test]") {
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto shard_directory = StringUtil::Format("%s/ab/cd", TEST_ON_DISK_CACHE_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	local_filesystem->CreateDirectory(StringUtil::Format("%s/ab", TEST_ON_DISK_CACHE_DIRECTORY));
+	local_filesystem->CreateDirectory(shard_directory);
+	// Raw content is longer than a footer, so its tail gets decoded.
+	const string raw_content(2 * DISK_CACHE_BLOCK_FOOTER_SIZE, 'a');
+	const auto cache_filepath =
+	    StringUtil::Format("%s/abcd-file-0-%llu", shard_directory, static_cast<idx_t>(raw_content.length()));
+	{
+		auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                                  FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		local_filesystem->Write(*file_handle, const_cast<char *>(raw_content.data()), raw_content.length(),
+		                        /*location=*/0);
+	}
+
+	// Cache reader is initialized on file open, and its index is rebuilt on first access.
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+	REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetCacheEntriesInfo().empty());
+	REQUIRE(!local_filesystem->FileExists(cache_filepath));
+}
+
+TEST_CASE("Test on cache files migrated from flat layout", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	g_cache_block_size = test_block_size;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+	// Cache all blocks, whose cache files are placed under shard directories.
+	{
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(TEST_FILE_SIZE, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), TEST_FILE_SIZE,
+		                    /*location=*/0);
+		REQUIRE(content == TEST_FILE_CONTENT);
+	}
+	FlushCacheWrites();
+	const auto cache_files = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+	REQUIRE(cache_files.size() == 6);
+
+	// Move cache files right under cache directory, as they're placed in flat layout.
+	for (const auto &cur_cache_file : cache_files) {
+		REQUIRE(StringUtil::Split(cur_cache_file, "/").size() == 3);
+		const auto sharded_filepath = StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cur_cache_file);
+		const auto flat_filepath =
+		    StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, StringUtil::GetFileName(cur_cache_file));
+		REQUIRE(std::rename(sharded_filepath.data(), flat_filepath.data()) == 0);
+	}
+
+	// Rebuild disk cache index, which migrates cache files back to shard directories and serves reads from them.
+	CacheReaderManager::Get().Reset();
+	disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	{
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(TEST_FILE_SIZE, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), TEST_FILE_SIZE,
+		                    /*location=*/0);
+		REQUIRE(content == TEST_FILE_CONTENT);
+	}
+	FlushCacheWrites();
+	REQUIRE(GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY) == cache_files);
+	REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetCacheEntriesInfo().size() == 6);
+}
+
+// Compressible blocks are stored compressed, while incompressible ones are stored raw.
+TEST_CASE("Test on disk cache compression", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 4096;
+	// The first block is compressible, and the second one is random bytes.
+	string test_file_content(2 * test_block_size, '\0');
+	std::mt19937_64 rng {/*seed=*/0};
+	for (idx_t idx = 0; idx < test_file_content.length(); ++idx) {
+		test_file_content[idx] = idx < test_block_size ? static_cast<char>('a' + idx % 26) : static_cast<char>(rng());
+	}
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto test_filename = StringUtil::Format("/tmp/%s", UUID::ToString(UUID::GenerateRandomUUID()));
+	{
+		auto file_handle = local_filesystem->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                                 FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		local_filesystem->Write(*file_handle, const_cast<char *>(test_file_content.data()),
+		                        test_file_content.length(), /*location=*/0);
+	}
+	SCOPE_EXIT {
+		local_filesystem->RemoveFile(test_filename);
+	};
+
+	for (const auto &cur_io_engine : *ALL_DISK_CACHE_IO_ENGINES) {
+		*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+		g_cache_block_size = test_block_size;
+		*g_disk_cache_io_engine = cur_io_engine;
+		*g_disk_cache_compression = *ZSTD_DISK_CACHE_COMPRESSION;
+		g_disk_cache_write_back_max_bytes = 0;
+		SCOPE_EXIT {
+			ResetGlobalConfig();
+		};
+
+		RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+		CacheReaderManager::Get().Reset();
+		auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		auto read_and_check = [&](idx_t start_offset, idx_t bytes_to_read) {
+			auto handle = disk_cache_fs->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_READ);
+			string content(bytes_to_read, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    bytes_to_read, start_offset);
+			REQUIRE(content == test_file_content.substr(start_offset, bytes_to_read));
+		};
+		auto get_cache_file_size = [&](const string &cache_file) {
+			auto file_handle = local_filesystem->OpenFile(
+			    StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cache_file), FileOpenFlags::FILE_FLAGS_READ);
+			return static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle));
+		};
+
+		// Uncached read stores the compressible block compressed, and the other one raw.
+		read_and_check(/*start_offset=*/0, test_file_content.length());
+		DiskCacheCompressionStats compression_stats;
+		REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetDiskCacheCompressionStats(compression_stats));
+		REQUIRE(compression_stats.written_block_count == 2);
+		REQUIRE(compression_stats.compressed_block_count == 1);
+		REQUIRE(compression_stats.raw_bytes == test_file_content.length());
+		REQUIRE(compression_stats.stored_bytes < test_file_content.length() - test_block_size / 2);
+
+		string compressed_cache_file;
+		string raw_cache_file;
+		for (const auto &cur_cache_file : GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY)) {
+			if (StringUtil::EndsWith(cur_cache_file, StringUtil::Format("-0-%llu", test_block_size))) {
+				compressed_cache_file = cur_cache_file;
+			} else {
+				raw_cache_file = cur_cache_file;
+			}
+		}
+		REQUIRE(get_cache_file_size(compressed_cache_file) < test_block_size / 2);
+		REQUIRE(get_cache_file_size(raw_cache_file) == test_block_size + DISK_CACHE_BLOCK_FOOTER_SIZE);
+
+		// Cached reads after the reader restarts, including partial reads on the compressed block.
+		CacheReaderManager::Get().Reset();
+		disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		read_and_check(/*start_offset=*/0, test_file_content.length());
+		read_and_check(/*start_offset=*/100, /*bytes_to_read=*/50);
+		read_and_check(/*start_offset=*/test_block_size - 10, /*bytes_to_read=*/20);
+		DiskCacheCompressionStats decompression_stats;
+		REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetDiskCacheCompressionStats(decompression_stats));
+		REQUIRE(decompression_stats.written_block_count == 0);
+		REQUIRE(decompression_stats.decompressed_block_count == 3);
+
+		// Corrupted compressed block is not served, and gets re-cached.
+		CacheReaderManager::Get().Reset();
+		disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		{
+			const auto cache_filepath =
+			    StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, compressed_cache_file);
+			auto file_handle = local_filesystem->OpenFile(cache_filepath, FileOpenFlags::FILE_FLAGS_WRITE);
+			char corrupted_byte = 'z';
+			local_filesystem->Write(*file_handle, &corrupted_byte, /*nr_bytes=*/1, /*location=*/1);
+		}
+		read_and_check(/*start_offset=*/0, test_block_size);
+		DiskCacheCompressionStats recache_stats;
+		REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetDiskCacheCompressionStats(recache_stats));
+		REQUIRE(recache_stats.written_block_count == 1);
+		REQUIRE(get_cache_file_size(compressed_cache_file) < test_block_size / 2);
+	}
+}
+
+// Compressed footer blocks keep their retention class in the LRU index.
+TEST_CASE("Test on disk cache compression for footer blocks", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 4096;
+	string test_file_content(2 * test_block_size, '\0');
+	for (idx_t idx = 0; idx < test_file_content.length(); ++idx) {
+		test_file_content[idx] = static_cast<char>('a' + idx % 26);
+	}
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto test_filename = StringUtil::Format("/tmp/%s.parquet", UUID::ToString(UUID::GenerateRandomUUID()));
+	{
+		auto file_handle = local_filesystem->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                                 FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		local_filesystem->Write(*file_handle, const_cast<char *>(test_file_content.data()),
+		                        test_file_content.length(), /*location=*/0);
+	}
+	SCOPE_EXIT {
+		local_filesystem->RemoveFile(test_filename);
+	};
+
+	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+	g_cache_block_size = test_block_size;
+	g_footer_prefetch_size = test_block_size;
+	*g_disk_cache_compression = *ZSTD_DISK_CACHE_COMPRESSION;
+	g_disk_cache_write_back_max_bytes = 0;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	{
+		auto handle = disk_cache_fs->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_READ);
+		string content(test_file_content.length(), '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+		                    test_file_content.length(), /*location=*/0);
+		REQUIRE(content == test_file_content);
+	}
+	FlushCacheWrites();
+
+	// Both blocks are stored compressed, and only the last one is a footer block.
+	const auto cache_files = GetSortedFilesUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+	REQUIRE(cache_files.size() == 2);
+	std::unordered_set<string> cache_filepaths;
+	idx_t footer_cache_file_size = 0;
+	for (const auto &cur_cache_file : cache_files) {
+		const auto cur_filepath = StringUtil::Format("%s/%s", TEST_ON_DISK_CACHE_DIRECTORY, cur_cache_file);
+		cache_filepaths.emplace(cur_filepath);
+		auto file_handle = local_filesystem->OpenFile(cur_filepath, FileOpenFlags::FILE_FLAGS_READ);
+		const auto cur_file_size = static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle));
+		REQUIRE(cur_file_size < test_block_size / 2);
+		if (StringUtil::EndsWith(cur_cache_file, StringUtil::Format("-%llu-%llu", test_block_size, test_block_size))) {
+			footer_cache_file_size = cur_file_size;
+		}
+	}
+	REQUIRE(footer_cache_file_size > 0);
+
+	// Retention class is persisted in the index journal, which is replayed after the reader shuts down.
+	CacheReaderManager::Get().Reset();
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, DISK_CACHE_EVICTION_LOW_WATERMARK_RATIO,
+	                             StringUtil::Format("%s.cache_httpfs_index", TEST_ON_DISK_CACHE_DIRECTORY)};
+	lru_index.LoadJournal(cache_filepaths);
+	REQUIRE(lru_index.GetCacheFileCount() == 2);
+	REQUIRE(lru_index.GetFooterBytes() == footer_cache_file_size);
+}
+
+TEST_CASE("Test on striped cache directories", "[on-disk cache filesystem test]") {
+	const string second_cache_directory = "/tmp/duckdb_test_cache_httpfs_cache_second";
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+		RemoveCacheDirectory(second_cache_directory);
+	};
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(second_cache_directory);
+	// Whitespaces and trailing slashes are tolerated.
+	*g_on_disk_cache_directory = StringUtil::Format("%s, %s/", TEST_ON_DISK_CACHE_DIRECTORY, second_cache_directory);
+	g_cache_block_size = 1;
+	g_max_disk_cache_bytes = 1_MiB;
+
+	CacheReaderManager::Get().Reset();
+	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	auto read_and_check = [&]() {
+		auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+		string content(TEST_FILE_SIZE, '\0');
+		disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), TEST_FILE_SIZE,
+		                    /*location=*/0);
+		REQUIRE(content == TEST_FILE_CONTENT);
+		FlushCacheWrites();
+	};
+
+	// Blocks are striped across both directories, each of which accounts for its own share of capacity.
+	read_and_check();
+	const int first_cache_file_count = GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY);
+	const auto second_cache_files = GetSortedFilesUnder(second_cache_directory);
+	REQUIRE(first_cache_file_count > 0);
+	REQUIRE(!second_cache_files.empty());
+	REQUIRE(first_cache_file_count + second_cache_files.size() == TEST_FILE_SIZE);
+	DataCacheUsage data_cache_usage;
+	REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetDataCacheUsage(data_cache_usage));
+	REQUIRE(data_cache_usage.capacity_bytes == 1_MiB);
+	REQUIRE(data_cache_usage.used_bytes == TEST_FILE_SIZE * (1 + DISK_CACHE_BLOCK_FOOTER_SIZE));
+	REQUIRE(CacheReaderManager::Get().GetCacheReader()->GetCacheEntriesInfo().size() == TEST_FILE_SIZE);
+
+	// Cached blocks are served from both directories after restart.
+	CacheReaderManager::Get().Reset();
+	disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	read_and_check();
+	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == first_cache_file_count);
+	REQUIRE(GetSortedFilesUnder(second_cache_directory) == second_cache_files);
+
+	// Block the shard directory in the second directory with a regular file, so the directory fails and is taken out
+	// of rotation; all blocks get cached in the first directory instead.
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(second_cache_directory);
+	CacheReaderManager::Get().Reset();
+	disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	{
+		auto local_filesystem = LocalFileSystem::CreateLocal();
+		local_filesystem->CreateDirectory(second_cache_directory);
+		const auto blocking_file =
+		    StringUtil::Format("%s/%s", second_cache_directory, second_cache_files[0].substr(0, 2));
+		local_filesystem->OpenFile(blocking_file,
+		                           FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	}
+	read_and_check();
+	read_and_check();
+	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == TEST_FILE_SIZE);
+}
+
+TEST_CASE("Test on disk cache layout", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	for (const auto &cur_layout : *ALL_DISK_CACHE_LAYOUTS) {
+		*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+		g_cache_block_size = test_block_size;
+		*g_disk_cache_layout = cur_layout;
+		SCOPE_EXIT {
+			ResetGlobalConfig();
+		};
+
+		RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+		CacheReaderManager::Get().Reset();
+		auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+
+		// First uncached read, and second cached read.
+		for (idx_t read_idx = 0; read_idx < 2; ++read_idx) {
+			auto handle = disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ);
+			string content(TEST_FILE_SIZE, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    TEST_FILE_SIZE, /*location=*/0);
+			REQUIRE(content == TEST_FILE_CONTENT);
+			FlushCacheWrites();
+		}
+
+		// All blocks are cached in one segment file under segment layout, and in one mirror file along with its bitmap
+		// file under mirror layout.
+		auto *cache_reader = CacheReaderManager::Get().GetCacheReader();
+		REQUIRE(cache_reader->GetCacheEntriesInfo().size() == 6);
+		int expected_file_count = 6;
+		if (cur_layout == *SEGMENT_DISK_CACHE_LAYOUT) {
+			expected_file_count = 1;
+		} else if (cur_layout == *MIRROR_DISK_CACHE_LAYOUT) {
+			expected_file_count = 2;
+		}
+		REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == expected_file_count);
+
+		// Clear cache for the file.
+		CacheReaderManager::Get().ClearCache(TEST_FILENAME);
+		REQUIRE(cache_reader->GetCacheEntriesInfo().empty());
+	}
+}
+
+// Cache files are keyed by remote file version, so an overwritten remote file never hits stale blocks.
+TEST_CASE("Test on overwritten remote file", "[on-disk cache filesystem test]") {
+	constexpr uint64_t test_block_size = 5;
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto test_filename = StringUtil::Format("/tmp/%s", UUID::ToString(UUID::GenerateRandomUUID()));
+	// Write [content] to test file, with last modification timestamp set to [last_modified].
+	auto write_test_file = [&](const string &content, time_t last_modified) {
+		auto file_handle = local_filesystem->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                                 FileOpenFlags::FILE_FLAGS_FILE_CREATE);
+		local_filesystem->Write(*file_handle, const_cast<char *>(content.data()), content.length(), /*location=*/0);
+		file_handle->Close();
+		struct utimbuf updated_time;
+		updated_time.actime = last_modified;
+		updated_time.modtime = last_modified;
+		REQUIRE(utime(test_filename.data(), &updated_time) == 0);
+	};
+	SCOPE_EXIT {
+		local_filesystem->RemoveFile(test_filename);
+	};
+
+	string overwritten_content = TEST_FILE_CONTENT;
+	std::reverse(overwritten_content.begin(), overwritten_content.end());
+	const time_t now = std::time(nullptr);
+
+	for (const auto &cur_layout : *ALL_DISK_CACHE_LAYOUTS) {
+		*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
+		g_cache_block_size = test_block_size;
+		*g_disk_cache_layout = cur_layout;
+		SCOPE_EXIT {
+			ResetGlobalConfig();
+		};
+
+		RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+		CacheReaderManager::Get().Reset();
+		auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+		auto read_and_check = [&](const string &expected_content) {
+			auto handle = disk_cache_fs->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_READ);
+			string content(TEST_FILE_SIZE, '\0');
+			disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())),
+			                    TEST_FILE_SIZE, /*location=*/0);
+			REQUIRE(content == expected_content);
+			FlushCacheWrites();
+		};
+
+		write_test_file(TEST_FILE_CONTENT, now - 3600);
+		read_and_check(TEST_FILE_CONTENT);
+		auto *cache_reader = CacheReaderManager::Get().GetCacheReader();
+		REQUIRE(cache_reader->GetCacheEntriesInfo().size() == 6);
+
+		// Overwrite remote file with content of the same size. Version is captured in metadata cache, so blocks of the
+		// new version are fetched once metadata cache entry expires.
+		write_test_file(overwritten_content, now);
+		disk_cache_fs->ClearCache(test_filename);
+		read_and_check(overwritten_content);
+		read_and_check(overwritten_content);
+
+		// Blocks of the stale version are left for eviction.
+		REQUIRE(cache_reader->GetCacheEntriesInfo().size() == 12);
+
+		// Clearing cache for the file removes blocks of all versions.
+		CacheReaderManager::Get().ClearCache(test_filename);
+		REQUIRE(cache_reader->GetCacheEntriesInfo().empty());
+	}
+}
+
 TEST_CASE("Test on reading non-existent file", "[on-disk cache filesystem test]") {
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 	auto disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 	REQUIRE_THROWS(disk_cache_fs->OpenFile("non-existent-file", FileOpenFlags::FILE_FLAGS_READ));
 }
@@ -405,7 +1149,7 @@ TEST_CASE("Test on insufficient disk space", "[on-disk cache filesystem test]")
 		ResetGlobalConfig();
 	};
 	*g_on_disk_cache_directory = TEST_ON_DISK_CACHE_DIRECTORY;
-	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
+	RemoveCacheDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
 
 	auto on_disk_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
 	auto handle = on_disk_cache_fs->OpenFile(TEST_FILENAME, FileOpenFlags::FILE_FLAGS_READ |
@@ -434,6 +1178,7 @@ TEST_CASE("Test on insufficient disk space", "[on-disk cache filesystem test]")
 	REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, bytes_to_read));
 
 	// At this point, stale cache file has already been deleted.
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 0);
 	REQUIRE(!LocalFileSystem::CreateLocal()->FileExists(old_cache_file));
 
@@ -442,6 +1187,7 @@ TEST_CASE("Test on insufficient disk space", "[on-disk cache filesystem test]")
 	on_disk_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), bytes_to_read,
 	                       start_offset);
 	REQUIRE(content == TEST_FILE_CONTENT.substr(start_offset, bytes_to_read));
+	FlushCacheWrites();
 	REQUIRE(GetFileCountUnder(TEST_ON_DISK_CACHE_DIRECTORY) == 1);
 }
 
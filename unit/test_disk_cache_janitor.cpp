@@ -0,0 +1,141 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "disk_cache_janitor.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "filesystem_utils.hpp"
+#include "time_utils.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+const std::string TEST_CACHE_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_janitor";
+constexpr double TEST_HIGH_WATERMARK_RATIO = 0.8;
+constexpr double TEST_LOW_WATERMARK_RATIO = 0.5;
+// Never run a pass unless woken up within a test case.
+constexpr int64_t TEST_INTERVAL_MILLISEC = 3600 * 1000;
+constexpr idx_t TEST_CAPACITY_BYTES = 100;
+constexpr idx_t TEST_CACHE_FILE_SIZE = 10;
+
+std::string GetTestCacheFile(idx_t idx) {
+	return StringUtil::Format("%s/%llu", TEST_CACHE_DIRECTORY, idx);
+}
+
+// Create [count] cache files in the test directory, and add them into [lru_index] from the least recently used one.
+void CreateTestCacheFiles(idx_t count, DiskCacheLruIndex &lru_index) {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_CACHE_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_CACHE_DIRECTORY);
+	for (idx_t idx = 0; idx < count; ++idx) {
+		const auto cache_file = GetTestCacheFile(idx);
+		{
+			auto file_handle = local_filesystem->OpenFile(
+			    cache_file, FileOpenFlags::FILE_FLAGS_WRITE | FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		}
+		REQUIRE(lru_index.AddCacheFile(cache_file, TEST_CACHE_FILE_SIZE, /*last_access_timestamp=*/idx).empty());
+	}
+}
+
+} // namespace
+
+TEST_CASE("Evict at high watermark test", "[disk cache janitor]") {
+	auto lru_index = make_shared_ptr<DiskCacheLruIndex>(TEST_CAPACITY_BYTES, TEST_LOW_WATERMARK_RATIO);
+	DiskCacheJanitor janitor {TEST_HIGH_WATERMARK_RATIO, /*max_removals_per_second_p=*/0, TEST_INTERVAL_MILLISEC};
+	janitor.AddDirectory(TEST_CACHE_DIRECTORY, lru_index);
+
+	// Used bytes don't exceed high watermark, nothing is evicted.
+	CreateTestCacheFiles(/*count=*/8, *lru_index);
+	janitor.Flush();
+	REQUIRE(GetFileCountUnder(TEST_CACHE_DIRECTORY) == 8);
+
+	// Used bytes exceed high watermark, least recently used cache files are evicted until low watermark.
+	CreateTestCacheFiles(/*count=*/9, *lru_index);
+	janitor.Flush();
+	REQUIRE(lru_index->GetUsedBytes() == 50);
+	REQUIRE(GetSortedFilesUnder(TEST_CACHE_DIRECTORY) == vector<std::string> {"4", "5", "6", "7", "8"});
+}
+
+TEST_CASE("Remove handed over cache files test", "[disk cache janitor]") {
+	auto lru_index = make_shared_ptr<DiskCacheLruIndex>(TEST_CAPACITY_BYTES, TEST_LOW_WATERMARK_RATIO);
+	DiskCacheJanitor janitor {TEST_HIGH_WATERMARK_RATIO, /*max_removals_per_second_p=*/0, TEST_INTERVAL_MILLISEC};
+	janitor.AddDirectory(TEST_CACHE_DIRECTORY, lru_index);
+	CreateTestCacheFiles(/*count=*/3, *lru_index);
+
+	// Cache files still tracked by index (i.e. cached again after eviction) are kept.
+	lru_index->RemoveCacheFile(GetTestCacheFile(0));
+	janitor.RemoveCacheFiles(TEST_CACHE_DIRECTORY, {GetTestCacheFile(0), GetTestCacheFile(1)});
+	janitor.Flush();
+	REQUIRE(GetSortedFilesUnder(TEST_CACHE_DIRECTORY) == vector<std::string> {"1", "2"});
+
+	// Cache files under untracked directories are still removed.
+	janitor.ClearDirectories();
+	janitor.RemoveCacheFiles(TEST_CACHE_DIRECTORY, {GetTestCacheFile(1)});
+	janitor.Flush();
+	REQUIRE(GetSortedFilesUnder(TEST_CACHE_DIRECTORY) == vector<std::string> {"2"});
+}
+
+TEST_CASE("Rate limited removal test", "[disk cache janitor]") {
+	auto lru_index = make_shared_ptr<DiskCacheLruIndex>(TEST_CAPACITY_BYTES, TEST_LOW_WATERMARK_RATIO);
+	DiskCacheJanitor janitor {TEST_HIGH_WATERMARK_RATIO, /*max_removals_per_second_p=*/2, TEST_INTERVAL_MILLISEC};
+	janitor.AddDirectory(TEST_CACHE_DIRECTORY, lru_index);
+	CreateTestCacheFiles(/*count=*/9, *lru_index);
+
+	// Four cache files are evicted, which take at least two windows to delete.
+	const int64_t start_millisec = GetSteadyNowMilliSecSinceEpoch();
+	janitor.Wake();
+	while (GetFileCountUnder(TEST_CACHE_DIRECTORY) > 5) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	REQUIRE(GetSteadyNowMilliSecSinceEpoch() - start_millisec >= 1000);
+	REQUIRE(lru_index->GetPendingDeletionBytes() == 0);
+}
+
+TEST_CASE("Flush without rate limit test", "[disk cache janitor]") {
+	auto lru_index = make_shared_ptr<DiskCacheLruIndex>(TEST_CAPACITY_BYTES, TEST_LOW_WATERMARK_RATIO);
+	DiskCacheJanitor janitor {TEST_HIGH_WATERMARK_RATIO, /*max_removals_per_second_p=*/1, TEST_INTERVAL_MILLISEC};
+	janitor.AddDirectory(TEST_CACHE_DIRECTORY, lru_index);
+	CreateTestCacheFiles(/*count=*/9, *lru_index);
+
+	// Flush deletes all four evicted cache files, without waiting for rate limit windows.
+	const int64_t start_millisec = GetSteadyNowMilliSecSinceEpoch();
+	janitor.Flush();
+	REQUIRE(GetSteadyNowMilliSecSinceEpoch() - start_millisec < 1000);
+	REQUIRE(GetFileCountUnder(TEST_CACHE_DIRECTORY) == 5);
+	REQUIRE(lru_index->GetPendingDeletionBytes() == 0);
+}
+
+TEST_CASE("Directory locked by another janitor test", "[disk cache janitor]") {
+	auto lru_index = make_shared_ptr<DiskCacheLruIndex>(TEST_CAPACITY_BYTES, TEST_LOW_WATERMARK_RATIO);
+	DiskCacheJanitor janitor {TEST_HIGH_WATERMARK_RATIO, /*max_removals_per_second_p=*/0, TEST_INTERVAL_MILLISEC};
+	janitor.AddDirectory(TEST_CACHE_DIRECTORY, lru_index);
+	CreateTestCacheFiles(/*count=*/3, *lru_index);
+
+	// Lock held on another open file description conflicts the same way as another process does.
+	const int fd = open(DiskCacheJanitor::GetLockFilepath(TEST_CACHE_DIRECTORY).data(), O_RDWR | O_CREAT, 0644);
+	REQUIRE(fd >= 0);
+	REQUIRE(flock(fd, LOCK_EX | LOCK_NB) == 0);
+	lru_index->RemoveCacheFile(GetTestCacheFile(0));
+	janitor.RemoveCacheFiles(TEST_CACHE_DIRECTORY, {GetTestCacheFile(0)});
+	janitor.Flush();
+	REQUIRE(GetFileCountUnder(TEST_CACHE_DIRECTORY) == 3);
+
+	// Skipped cache files are removed at the next pass after lock release.
+	close(fd);
+	janitor.Flush();
+	REQUIRE(GetSortedFilesUnder(TEST_CACHE_DIRECTORY) == vector<std::string> {"1", "2"});
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
@@ -0,0 +1,316 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "disk_cache_lru_index.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <unordered_set>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr double TEST_LOW_WATERMARK_RATIO = 0.5;
+const std::string TEST_JOURNAL_FILEPATH = "/tmp/duckdb_test_cache_httpfs_lru_index_journal";
+
+idx_t GetJournalFileSize() {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	auto file_handle = local_filesystem->OpenFile(TEST_JOURNAL_FILEPATH, FileOpenFlags::FILE_FLAGS_READ);
+	return static_cast<idx_t>(local_filesystem->GetFileSize(*file_handle));
+}
+} // namespace
+
+TEST_CASE("No capacity limit test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO};
+	for (idx_t idx = 0; idx < 100; ++idx) {
+		REQUIRE(lru_index.AddCacheFile(std::to_string(idx), /*file_size=*/10).empty());
+	}
+	REQUIRE(lru_index.GetUsedBytes() == 1000);
+	REQUIRE(lru_index.GetCacheFileCount() == 100);
+}
+
+TEST_CASE("Evict to low watermark test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/40, TEST_LOW_WATERMARK_RATIO};
+	for (idx_t idx = 0; idx < 4; ++idx) {
+		REQUIRE(lru_index.AddCacheFile(std::to_string(idx), /*file_size=*/10).empty());
+	}
+
+	// Access the least recently used file, so it's not evicted.
+	lru_index.TouchCacheFile("0");
+
+	// Exceeding capacity evicts least recently used files, until used bytes drop to low watermark.
+	const auto cache_files_to_evict = lru_index.AddCacheFile("4", /*file_size=*/10);
+	REQUIRE(cache_files_to_evict == vector<std::string> {"1", "2", "3"});
+	REQUIRE(lru_index.GetUsedBytes() == 20);
+	REQUIRE(lru_index.GetCacheFileCount() == 2);
+}
+
+TEST_CASE("Evict ahead of capacity test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/40, TEST_LOW_WATERMARK_RATIO};
+	for (idx_t idx = 0; idx < 4; ++idx) {
+		REQUIRE(lru_index.AddCacheFile(std::to_string(idx), /*file_size=*/10).empty());
+	}
+	REQUIRE(lru_index.HasCacheFile("0"));
+
+	// Eviction under capacity still drops used bytes to low watermark.
+	REQUIRE(lru_index.EvictCacheFiles() == vector<std::string> {"0", "1"});
+	REQUIRE(!lru_index.HasCacheFile("0"));
+	REQUIRE(lru_index.GetUsedBytes() == 20);
+	lru_index.MarkCacheFileDeleted("0");
+	lru_index.MarkCacheFileDeleted("1");
+	REQUIRE(lru_index.EvictCacheFiles().empty());
+
+	// No eviction without capacity limit.
+	lru_index.SetCapacityBytes(0);
+	REQUIRE(lru_index.EvictCacheFiles().empty());
+	REQUIRE(lru_index.GetCacheFileCount() == 2);
+}
+
+TEST_CASE("Pending deletion bytes test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/40, TEST_LOW_WATERMARK_RATIO};
+	for (idx_t idx = 0; idx < 4; ++idx) {
+		REQUIRE(lru_index.AddCacheFile(std::to_string(idx), /*file_size=*/10).empty());
+	}
+	REQUIRE(lru_index.EvictCacheFiles() == vector<std::string> {"0", "1"});
+	REQUIRE(lru_index.GetUsedBytes() == 20);
+	REQUIRE(lru_index.GetPendingDeletionBytes() == 20);
+
+	// Evicted cache files not deleted yet count against capacity, so more cache files are evicted.
+	REQUIRE(lru_index.AddCacheFile("4", /*file_size=*/10) == vector<std::string> {"2", "3"});
+	REQUIRE(lru_index.GetUsedBytes() == 10);
+	REQUIRE(lru_index.GetPendingDeletionBytes() == 40);
+
+	// Deleted or re-cached cache files no longer count.
+	lru_index.MarkCacheFileDeleted("0");
+	lru_index.MarkCacheFileDeleted("non-existent");
+	REQUIRE(lru_index.GetPendingDeletionBytes() == 30);
+	REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/10).empty());
+	REQUIRE(lru_index.GetUsedBytes() == 20);
+	REQUIRE(lru_index.GetPendingDeletionBytes() == 20);
+}
+
+TEST_CASE("Replace and remove cache file test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/40, TEST_LOW_WATERMARK_RATIO};
+	REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/10).empty());
+	REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/20).empty());
+	REQUIRE(lru_index.GetUsedBytes() == 20);
+	REQUIRE(lru_index.GetCacheFileCount() == 1);
+
+	lru_index.RemoveCacheFile("0");
+	lru_index.RemoveCacheFile("non-existent");
+	REQUIRE(lru_index.GetUsedBytes() == 0);
+
+	REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/10).empty());
+	lru_index.Clear();
+	REQUIRE(lru_index.GetUsedBytes() == 0);
+	REQUIRE(lru_index.GetCacheFileCount() == 0);
+}
+
+TEST_CASE("Oversized cache file test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/40, TEST_LOW_WATERMARK_RATIO};
+	REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/10).empty());
+
+	// The newly added file is kept even if it exceeds capacity by itself.
+	REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/50) == vector<std::string> {"0"});
+	REQUIRE(lru_index.GetUsedBytes() == 50);
+
+	// Capacity update takes effect at the next addition.
+	lru_index.SetCapacityBytes(100);
+	REQUIRE(lru_index.AddCacheFile("2", /*file_size=*/10).empty());
+	REQUIRE(lru_index.GetUsedBytes() == 60);
+}
+
+TEST_CASE("Remove cache files with prefix test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO};
+	REQUIRE(lru_index.AddCacheFile("a-0", /*file_size=*/10).empty());
+	REQUIRE(lru_index.AddCacheFile("ab-0", /*file_size=*/10).empty());
+	REQUIRE(lru_index.AddCacheFile("ab-1", /*file_size=*/10).empty());
+	REQUIRE(lru_index.AddCacheFile("b-0", /*file_size=*/10).empty());
+
+	REQUIRE(lru_index.RemoveCacheFilesWithPrefix("ab-") == vector<std::string> {"ab-0", "ab-1"});
+	REQUIRE(lru_index.RemoveCacheFilesWithPrefix("c").empty());
+	REQUIRE(lru_index.GetCacheFiles() == vector<std::string> {"a-0", "b-0"});
+	REQUIRE(lru_index.GetUsedBytes() == 20);
+}
+
+TEST_CASE("Remove stale cache files test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO};
+	REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/10).empty());
+	REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/10).empty());
+
+	// Nothing is stale before all accesses.
+	REQUIRE(lru_index.RemoveStaleCacheFiles(/*stale_timestamp=*/0).empty());
+	// All cache files are stale after all accesses.
+	const auto cache_files_to_evict = lru_index.RemoveStaleCacheFiles(std::time(nullptr) + 1);
+	REQUIRE(cache_files_to_evict == vector<std::string> {"0", "1"});
+	REQUIRE(lru_index.GetCacheFileCount() == 0);
+	REQUIRE(lru_index.GetUsedBytes() == 0);
+}
+
+TEST_CASE("Add cache files with access timestamp test", "[disk cache lru index]") {
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO};
+	REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/10).empty());
+	REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/10, /*last_access_timestamp=*/100).empty());
+	REQUIRE(lru_index.AddCacheFile("2", /*file_size=*/10, /*last_access_timestamp=*/50).empty());
+
+	// Cache files restored with earlier access timestamps are placed as less recently used ones.
+	REQUIRE(lru_index.RemoveStaleCacheFiles(/*stale_timestamp=*/101) == vector<std::string> {"2", "1"});
+	REQUIRE(lru_index.GetCacheFiles() == vector<std::string> {"0"});
+}
+
+TEST_CASE("Reload from journal test", "[disk cache lru index]") {
+	std::remove(TEST_JOURNAL_FILEPATH.data());
+	const std::unordered_set<std::string> existing_cache_files {"0", "1", "2", "3"};
+	{
+		DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		lru_index.LoadJournal(existing_cache_files);
+		REQUIRE(lru_index.GetCacheFileCount() == 0);
+		for (idx_t idx = 0; idx < 4; ++idx) {
+			REQUIRE(lru_index.AddCacheFile(std::to_string(idx), /*file_size=*/10 * (idx + 1)).empty());
+		}
+		lru_index.RemoveCacheFile("3");
+		lru_index.TouchCacheFile("0");
+	}
+
+	// Sizes and access recency are restored, and cache files not existing anymore are dropped.
+	{
+		DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		lru_index.LoadJournal(std::unordered_set<std::string> {"0", "1", "3"});
+		REQUIRE(lru_index.GetCacheFiles() == vector<std::string> {"0", "1"});
+		REQUIRE(lru_index.GetUsedBytes() == 30);
+
+		// The least recently used cache file is evicted first.
+		lru_index.SetCapacityBytes(30);
+		REQUIRE(lru_index.AddCacheFile("4", /*file_size=*/1) == vector<std::string> {"1"});
+	}
+
+	// Records appended after load are replayed.
+	{
+		DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		lru_index.LoadJournal(std::unordered_set<std::string> {"0", "1", "4"});
+		REQUIRE(lru_index.GetCacheFiles() == vector<std::string> {"0", "4"});
+		REQUIRE(lru_index.GetUsedBytes() == 11);
+
+		// Clearance empties the journal.
+		lru_index.Clear();
+	}
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+	lru_index.LoadJournal(existing_cache_files);
+	REQUIRE(lru_index.GetCacheFileCount() == 0);
+}
+
+TEST_CASE("Persist accesses in batch test", "[disk cache lru index]") {
+	std::remove(TEST_JOURNAL_FILEPATH.data());
+	constexpr idx_t cache_file_count = 1024;
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+	lru_index.LoadJournal(std::unordered_set<std::string> {});
+	for (idx_t idx = 0; idx < cache_file_count; ++idx) {
+		REQUIRE(lru_index.AddCacheFile(std::to_string(idx), /*file_size=*/10).empty());
+	}
+	const idx_t journal_size = GetJournalFileSize();
+
+	// Accesses are buffered in memory, until enough cache files are touched.
+	for (idx_t idx = 0; idx + 1 < cache_file_count; ++idx) {
+		lru_index.TouchCacheFile(std::to_string(idx));
+	}
+	REQUIRE(GetJournalFileSize() == journal_size);
+	lru_index.TouchCacheFile(std::to_string(cache_file_count - 1));
+	REQUIRE(GetJournalFileSize() > journal_size);
+}
+
+TEST_CASE("Torn journal record test", "[disk cache lru index]") {
+	std::remove(TEST_JOURNAL_FILEPATH.data());
+	const std::unordered_set<std::string> existing_cache_files {"0", "1"};
+	{
+		DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		lru_index.LoadJournal(existing_cache_files);
+		REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/10).empty());
+		REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/10).empty());
+	}
+
+	// Tear the last record, which is dropped on reload.
+	{
+		auto local_filesystem = LocalFileSystem::CreateLocal();
+		auto file_handle = local_filesystem->OpenFile(TEST_JOURNAL_FILEPATH, FileOpenFlags::FILE_FLAGS_WRITE);
+		file_handle->Truncate(local_filesystem->GetFileSize(*file_handle) - 1);
+	}
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+	lru_index.LoadJournal(existing_cache_files);
+	REQUIRE(lru_index.GetCacheFiles() == vector<std::string> {"0"});
+}
+
+TEST_CASE("Shared journal test", "[disk cache lru index]") {
+	std::remove(TEST_JOURNAL_FILEPATH.data());
+	const std::unordered_set<std::string> existing_cache_files {"0", "1", "2"};
+	{
+		// Two indexes on one journal behave like two processes sharing a cache directory.
+		DiskCacheLruIndex lru_index1 {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		DiskCacheLruIndex lru_index2 {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		lru_index1.LoadJournal(existing_cache_files);
+		REQUIRE(lru_index1.AddCacheFile("0", /*file_size=*/10).empty());
+
+		// Checkpoint on load replaces the journal, which is reopened by the other index on its next append.
+		lru_index2.LoadJournal(existing_cache_files);
+		REQUIRE(lru_index1.AddCacheFile("1", /*file_size=*/10).empty());
+		REQUIRE(lru_index2.AddCacheFile("2", /*file_size=*/10).empty());
+	}
+
+	// Records appended by both indexes are replayed.
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+	lru_index.LoadJournal(existing_cache_files);
+	REQUIRE(lru_index.GetCacheFiles() == vector<std::string> {"0", "1", "2"});
+}
+
+TEST_CASE("Footer retention test", "[disk cache lru index]") {
+	// Footer blocks are retained up to a quarter of capacity.
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/100, TEST_LOW_WATERMARK_RATIO};
+	REQUIRE(lru_index.AddCacheFile("f0", /*file_size=*/10, CacheFileRetention::kFooter).empty());
+	for (idx_t idx = 0; idx < 9; ++idx) {
+		REQUIRE(lru_index.AddCacheFile(StringUtil::Format("d%llu", idx), /*file_size=*/10).empty());
+	}
+
+	// The least recently used footer block is kept, while data blocks are evicted.
+	REQUIRE(lru_index.AddCacheFile("d9", /*file_size=*/10) ==
+	        vector<std::string> {"d0", "d1", "d2", "d3", "d4", "d5"});
+	REQUIRE(lru_index.HasCacheFile("f0"));
+	REQUIRE(lru_index.GetFooterBytes() == 10);
+	for (idx_t idx = 0; idx < 6; ++idx) {
+		lru_index.MarkCacheFileDeleted(StringUtil::Format("d%llu", idx));
+	}
+
+	// Footer blocks exceeding their share are evicted ahead of data blocks.
+	REQUIRE(lru_index.AddCacheFile("f1", /*file_size=*/10, CacheFileRetention::kFooter).empty());
+	REQUIRE(lru_index.AddCacheFile("f2", /*file_size=*/10, CacheFileRetention::kFooter).empty());
+	REQUIRE(lru_index.EvictCacheFiles() == vector<std::string> {"f0", "d6"});
+	REQUIRE(lru_index.GetFooterBytes() == 20);
+	REQUIRE(lru_index.GetUsedBytes() == 50);
+}
+
+TEST_CASE("Reload footer blocks from journal test", "[disk cache lru index]") {
+	std::remove(TEST_JOURNAL_FILEPATH.data());
+	const std::unordered_set<std::string> existing_cache_files {"0", "1"};
+	{
+		DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+		lru_index.LoadJournal(existing_cache_files);
+		REQUIRE(lru_index.AddCacheFile("0", /*file_size=*/10, CacheFileRetention::kFooter).empty());
+		REQUIRE(lru_index.AddCacheFile("1", /*file_size=*/20).empty());
+		lru_index.TouchCacheFile("0");
+	}
+
+	// Retention class is restored, so the footer block is still retained over the data block.
+	DiskCacheLruIndex lru_index {/*capacity_bytes_p=*/0, TEST_LOW_WATERMARK_RATIO, TEST_JOURNAL_FILEPATH};
+	lru_index.LoadJournal(existing_cache_files);
+	REQUIRE(lru_index.GetFooterBytes() == 10);
+	REQUIRE(lru_index.GetUsedBytes() == 30);
+	lru_index.SetCapacityBytes(40);
+	REQUIRE(lru_index.AddCacheFile("2", /*file_size=*/20) == vector<std::string> {"1"});
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	std::remove(TEST_JOURNAL_FILEPATH.data());
+	return result;
+}
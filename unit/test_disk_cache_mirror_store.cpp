@@ -0,0 +1,182 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "disk_cache_mirror_store.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "filesystem_utils.hpp"
+
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+const std::string TEST_MIRROR_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_mirror_store";
+constexpr idx_t TEST_BLOCK_SIZE = 10;
+// Test object is of 35 bytes, so its last block is of 5 bytes.
+constexpr idx_t TEST_OBJECT_SIZE = 35;
+
+void RecreateTestDirectory() {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_MIRROR_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_MIRROR_DIRECTORY);
+}
+
+std::string GetTestObject(const std::string &mirror_key) {
+	std::string content(TEST_OBJECT_SIZE, '\0');
+	for (idx_t idx = 0; idx < TEST_OBJECT_SIZE; ++idx) {
+		content[idx] = static_cast<char>('a' + (idx + mirror_key.length()) % 26);
+	}
+	return content;
+}
+
+void WriteTestBlock(DiskCacheMirrorStore &mirror_store, const std::string &mirror_key, idx_t block_idx) {
+	const auto content = GetTestObject(mirror_key);
+	const idx_t block_offset = block_idx * TEST_BLOCK_SIZE;
+	const idx_t block_length = MinValue<idx_t>(TEST_BLOCK_SIZE, TEST_OBJECT_SIZE - block_offset);
+	mirror_store.WriteBlock(mirror_key, block_offset, content.data() + block_offset, block_length, /*sync=*/false);
+}
+
+// Return whether [length] bytes at [offset] for [mirror_key] could be read, and match the test object.
+bool ReadTestRange(DiskCacheMirrorStore &mirror_store, const std::string &mirror_key, idx_t offset, idx_t length) {
+	std::string content(length, '\0');
+	if (!mirror_store.Read(mirror_key, offset, length, &content[0])) {
+		return false;
+	}
+	return content == GetTestObject(mirror_key).substr(offset, length);
+}
+
+} // namespace
+
+TEST_CASE("Mirror file name test", "[disk cache mirror store]") {
+	REQUIRE(DiskCacheMirrorStore::IsMirrorFile("hash-file.cache_httpfs_mirror"));
+	REQUIRE(DiskCacheMirrorStore::IsMirrorFile("hash-file.cache_httpfs_mirror_bitmap"));
+	REQUIRE(!DiskCacheMirrorStore::IsMirrorFile("0.cache_httpfs_segment"));
+	REQUIRE(!DiskCacheMirrorStore::IsMirrorFile("hash-file-0-10"));
+}
+
+TEST_CASE("Write and read test", "[disk cache mirror store]") {
+	RecreateTestDirectory();
+	DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE, /*capacity_bytes_p=*/0};
+	WriteTestBlock(mirror_store, "obj", /*block_idx=*/0);
+	WriteTestBlock(mirror_store, "obj", /*block_idx=*/1);
+	WriteTestBlock(mirror_store, "obj", /*block_idx=*/3);
+
+	// All blocks of an object are placed in one mirror file, along with its bitmap file.
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 2);
+	REQUIRE(mirror_store.GetUsedBytes() == 25);
+	REQUIRE(mirror_store.GetEntries().size() == 3);
+	REQUIRE(mirror_store.IsBlockCached("obj", /*block_offset=*/0));
+	REQUIRE(mirror_store.IsBlockCached("obj", /*block_offset=*/10));
+	REQUIRE(!mirror_store.IsBlockCached("obj", /*block_offset=*/20));
+	REQUIRE(mirror_store.IsBlockCached("obj", /*block_offset=*/30));
+	REQUIRE(!mirror_store.IsBlockCached("another-obj", /*block_offset=*/0));
+
+	// Consecutive cached blocks are read at once.
+	REQUIRE(ReadTestRange(mirror_store, "obj", /*offset=*/0, /*length=*/20));
+	REQUIRE(ReadTestRange(mirror_store, "obj", /*offset=*/30, /*length=*/5));
+	// Range covering uncached block is not read.
+	REQUIRE(!ReadTestRange(mirror_store, "obj", /*offset=*/0, /*length=*/30));
+	// Range beyond object size is not read.
+	REQUIRE(!ReadTestRange(mirror_store, "obj", /*offset=*/30, /*length=*/10));
+
+	// Fill the hole.
+	WriteTestBlock(mirror_store, "obj", /*block_idx=*/2);
+	REQUIRE(ReadTestRange(mirror_store, "obj", /*offset=*/0, TEST_OBJECT_SIZE));
+	REQUIRE(mirror_store.GetUsedBytes() == TEST_OBJECT_SIZE);
+}
+
+TEST_CASE("Reload mirror files test", "[disk cache mirror store]") {
+	RecreateTestDirectory();
+	{
+		DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE, /*capacity_bytes_p=*/0};
+		WriteTestBlock(mirror_store, "obj", /*block_idx=*/0);
+		WriteTestBlock(mirror_store, "obj", /*block_idx=*/3);
+	}
+
+	// Blocks are accessible after reload.
+	{
+		DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE, /*capacity_bytes_p=*/0};
+		REQUIRE(mirror_store.GetEntries().size() == 2);
+		REQUIRE(mirror_store.GetUsedBytes() == 15);
+		REQUIRE(ReadTestRange(mirror_store, "obj", /*offset=*/0, /*length=*/10));
+		REQUIRE(ReadTestRange(mirror_store, "obj", /*offset=*/30, /*length=*/5));
+		REQUIRE(!mirror_store.IsBlockCached("obj", /*block_offset=*/10));
+	}
+
+	// Mirror files written with another block size are discarded.
+	DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE * 2, /*capacity_bytes_p=*/0};
+	REQUIRE(mirror_store.GetEntries().empty());
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 0);
+}
+
+TEST_CASE("Evict blocks test", "[disk cache mirror store]") {
+	RecreateTestDirectory();
+	DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE, /*capacity_bytes_p=*/30};
+	WriteTestBlock(mirror_store, "obj1", /*block_idx=*/0);
+	for (idx_t idx = 0; idx < 3; ++idx) {
+		WriteTestBlock(mirror_store, "obj2", idx);
+	}
+
+	// The only block of obj1 is evicted, along with its mirror file; the first block of obj2 is evicted by hole
+	// punching.
+	REQUIRE(mirror_store.GetUsedBytes() == 20);
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 2);
+	REQUIRE(!mirror_store.IsBlockCached("obj1", /*block_offset=*/0));
+	REQUIRE(!mirror_store.IsBlockCached("obj2", /*block_offset=*/0));
+	REQUIRE(ReadTestRange(mirror_store, "obj2", /*offset=*/10, /*length=*/20));
+
+	// Accessed blocks are kept on eviction.
+	WriteTestBlock(mirror_store, "obj2", /*block_idx=*/3);
+	REQUIRE(ReadTestRange(mirror_store, "obj2", /*offset=*/10, /*length=*/10));
+	WriteTestBlock(mirror_store, "obj2", /*block_idx=*/0);
+	REQUIRE(mirror_store.IsBlockCached("obj2", /*block_offset=*/10));
+	REQUIRE(!mirror_store.IsBlockCached("obj2", /*block_offset=*/20));
+}
+
+TEST_CASE("Remove and clear test", "[disk cache mirror store]") {
+	RecreateTestDirectory();
+	DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE, /*capacity_bytes_p=*/0};
+	WriteTestBlock(mirror_store, "obj1", /*block_idx=*/0);
+	WriteTestBlock(mirror_store, "obj2", /*block_idx=*/0);
+	WriteTestBlock(mirror_store, "obj2", /*block_idx=*/1);
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 4);
+
+	mirror_store.Remove("obj2");
+	REQUIRE(mirror_store.GetEntries().size() == 1);
+	REQUIRE(mirror_store.GetUsedBytes() == 10);
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 2);
+	REQUIRE(!mirror_store.IsBlockCached("obj2", /*block_offset=*/0));
+
+	// Removed object could be cached again.
+	WriteTestBlock(mirror_store, "obj2", /*block_idx=*/1);
+	REQUIRE(ReadTestRange(mirror_store, "obj2", /*offset=*/10, /*length=*/10));
+	REQUIRE(!mirror_store.IsBlockCached("obj2", /*block_offset=*/0));
+
+	mirror_store.Clear();
+	REQUIRE(mirror_store.GetEntries().empty());
+	REQUIRE(mirror_store.GetUsedBytes() == 0);
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 0);
+}
+
+TEST_CASE("Remove by prefix test", "[disk cache mirror store]") {
+	RecreateTestDirectory();
+	DiskCacheMirrorStore mirror_store {TEST_MIRROR_DIRECTORY, TEST_BLOCK_SIZE, /*capacity_bytes_p=*/0};
+	WriteTestBlock(mirror_store, "obj-1", /*block_idx=*/0);
+	WriteTestBlock(mirror_store, "obj-2", /*block_idx=*/0);
+	WriteTestBlock(mirror_store, "other-1", /*block_idx=*/0);
+
+	mirror_store.RemoveByPrefix("obj-");
+	REQUIRE(mirror_store.GetEntries().size() == 1);
+	REQUIRE(GetFileCountUnder(TEST_MIRROR_DIRECTORY) == 2);
+	REQUIRE(!mirror_store.IsBlockCached("obj-1", /*block_offset=*/0));
+	REQUIRE(!mirror_store.IsBlockCached("obj-2", /*block_offset=*/0));
+	REQUIRE(ReadTestRange(mirror_store, "other-1", /*offset=*/0, /*length=*/10));
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_MIRROR_DIRECTORY);
+	return result;
+}
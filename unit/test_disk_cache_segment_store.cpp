@@ -0,0 +1,195 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "disk_cache_segment_store.hpp"
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "filesystem_utils.hpp"
+
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+const std::string TEST_SEGMENT_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_segment_store";
+constexpr idx_t TEST_BLOCK_SIZE = 10;
+// Every record takes 33 bytes (16-byte header, 7-byte key and 10-byte block), so a segment holds 3 records.
+constexpr idx_t TEST_SEGMENT_SIZE = 100;
+
+void RecreateTestDirectory() {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_SEGMENT_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_SEGMENT_DIRECTORY);
+}
+
+std::string GetTestKey(const std::string &fname, idx_t idx) {
+	return StringUtil::Format("%s-%llu", fname, idx);
+}
+
+std::string GetTestBlock(idx_t idx) {
+	return std::string(TEST_BLOCK_SIZE, static_cast<char>('a' + idx));
+}
+
+void AppendTestBlock(DiskCacheSegmentStore &segment_store, const std::string &key, idx_t idx) {
+	const auto block = GetTestBlock(idx);
+	segment_store.Append(key, block.data(), block.length(), /*sync=*/false);
+}
+
+// Return whether the block for [key] could be read, and matches the block appended with [idx].
+bool ReadTestBlock(const DiskCacheSegmentStore &segment_store, const std::string &key, idx_t idx) {
+	std::string content(TEST_BLOCK_SIZE, '\0');
+	if (!segment_store.Read(key, &content[0], TEST_BLOCK_SIZE)) {
+		return false;
+	}
+	return content == GetTestBlock(idx);
+}
+
+} // namespace
+
+TEST_CASE("Segment file name test", "[disk cache segment store]") {
+	REQUIRE(DiskCacheSegmentStore::IsSegmentFile("0.cache_httpfs_segment"));
+	REQUIRE(DiskCacheSegmentStore::IsSegmentFile("123.cache_httpfs_segment"));
+	REQUIRE(!DiskCacheSegmentStore::IsSegmentFile(".cache_httpfs_segment"));
+	REQUIRE(!DiskCacheSegmentStore::IsSegmentFile("a1.cache_httpfs_segment"));
+	REQUIRE(!DiskCacheSegmentStore::IsSegmentFile("hash-file-0-10"));
+}
+
+TEST_CASE("Append and read test", "[disk cache segment store]") {
+	RecreateTestDirectory();
+	DiskCacheSegmentStore segment_store {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+	for (idx_t idx = 0; idx < 7; ++idx) {
+		AppendTestBlock(segment_store, GetTestKey("file1", idx), idx);
+	}
+	REQUIRE(segment_store.GetEntryCount() == 7);
+	REQUIRE(segment_store.GetSegmentCount() == 3);
+	REQUIRE(segment_store.GetUsedBytes() == 7 * 33);
+	REQUIRE(GetFileCountUnder(TEST_SEGMENT_DIRECTORY) == 3);
+
+	for (idx_t idx = 0; idx < 7; ++idx) {
+		REQUIRE(segment_store.Contains(GetTestKey("file1", idx)));
+		REQUIRE(ReadTestBlock(segment_store, GetTestKey("file1", idx), idx));
+	}
+	REQUIRE(!segment_store.Contains(GetTestKey("file1", 7)));
+	REQUIRE(!ReadTestBlock(segment_store, GetTestKey("file1", 7), 7));
+
+	// Read with mismatched length is treated as cache miss.
+	std::string content(TEST_BLOCK_SIZE + 1, '\0');
+	REQUIRE(!segment_store.Read(GetTestKey("file1", 0), &content[0], content.length()));
+
+	// Append for an existing key replaces the block.
+	AppendTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/10);
+	REQUIRE(segment_store.GetEntryCount() == 7);
+	REQUIRE(ReadTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/10));
+}
+
+TEST_CASE("Reload segment files test", "[disk cache segment store]") {
+	RecreateTestDirectory();
+	{
+		DiskCacheSegmentStore segment_store {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+		for (idx_t idx = 0; idx < 4; ++idx) {
+			AppendTestBlock(segment_store, GetTestKey("file1", idx), idx);
+		}
+		// Later record overrides the earlier one on reload.
+		AppendTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/10);
+	}
+
+	// Blocks are accessible after reload.
+	{
+		DiskCacheSegmentStore segment_store {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+		REQUIRE(segment_store.GetEntryCount() == 4);
+		REQUIRE(segment_store.GetSegmentCount() == 2);
+		REQUIRE(ReadTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/10));
+		for (idx_t idx = 1; idx < 4; ++idx) {
+			REQUIRE(ReadTestBlock(segment_store, GetTestKey("file1", idx), idx));
+		}
+
+		// New blocks are appended to new segment files.
+		AppendTestBlock(segment_store, GetTestKey("file1", 4), /*idx=*/4);
+		REQUIRE(segment_store.GetSegmentCount() == 3);
+	}
+
+	// Tear the last record, which is dropped on reload.
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	{
+		auto file_handle = local_filesystem->OpenFile(
+		    StringUtil::Format("%s/2.cache_httpfs_segment", TEST_SEGMENT_DIRECTORY), FileOpenFlags::FILE_FLAGS_WRITE);
+		file_handle->Truncate(/*new_size=*/20);
+	}
+	DiskCacheSegmentStore segment_store {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+	REQUIRE(segment_store.GetEntryCount() == 4);
+	REQUIRE(!segment_store.Contains(GetTestKey("file1", 4)));
+}
+
+TEST_CASE("Segment created by another store test", "[disk cache segment store]") {
+	RecreateTestDirectory();
+	// Two stores on one directory behave like two processes sharing a cache directory, both start from segment id 0.
+	DiskCacheSegmentStore segment_store1 {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+	DiskCacheSegmentStore segment_store2 {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+	AppendTestBlock(segment_store1, GetTestKey("file1", 0), /*idx=*/0);
+	AppendTestBlock(segment_store2, GetTestKey("file2", 0), /*idx=*/1);
+
+	// The latter store takes the next segment id, instead of overwriting the existing segment file.
+	REQUIRE(GetSortedFilesUnder(TEST_SEGMENT_DIRECTORY) ==
+	        vector<std::string> {"0.cache_httpfs_segment", "1.cache_httpfs_segment"});
+	REQUIRE(ReadTestBlock(segment_store1, GetTestKey("file1", 0), /*idx=*/0));
+	REQUIRE(ReadTestBlock(segment_store2, GetTestKey("file2", 0), /*idx=*/1));
+}
+
+TEST_CASE("Evict oldest segments test", "[disk cache segment store]") {
+	RecreateTestDirectory();
+	DiskCacheSegmentStore segment_store {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/200};
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		AppendTestBlock(segment_store, GetTestKey("file1", idx), idx);
+	}
+
+	// Segments holding blocks [0, 6) have been evicted.
+	REQUIRE(segment_store.GetUsedBytes() <= 200);
+	REQUIRE(segment_store.GetSegmentCount() == 2);
+	REQUIRE(GetFileCountUnder(TEST_SEGMENT_DIRECTORY) == 2);
+	for (idx_t idx = 0; idx < 6; ++idx) {
+		REQUIRE(!segment_store.Contains(GetTestKey("file1", idx)));
+	}
+	for (idx_t idx = 6; idx < 10; ++idx) {
+		REQUIRE(ReadTestBlock(segment_store, GetTestKey("file1", idx), idx));
+	}
+}
+
+TEST_CASE("Remove and compaction test", "[disk cache segment store]") {
+	RecreateTestDirectory();
+	DiskCacheSegmentStore segment_store {TEST_SEGMENT_DIRECTORY, TEST_SEGMENT_SIZE, /*capacity_bytes_p=*/0};
+
+	// The first segment holds two blocks for file1 and one block for file2.
+	AppendTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/0);
+	AppendTestBlock(segment_store, GetTestKey("file1", 1), /*idx=*/1);
+	AppendTestBlock(segment_store, GetTestKey("file2", 0), /*idx=*/2);
+	// The second segment is active.
+	AppendTestBlock(segment_store, GetTestKey("file2", 1), /*idx=*/3);
+	REQUIRE(segment_store.GetSegmentCount() == 2);
+
+	// Live ratio of the first segment drops under threshold, so its live block gets moved to the active segment.
+	segment_store.RemoveByPrefix("file1");
+	segment_store.WaitForCompaction();
+	REQUIRE(segment_store.GetEntryCount() == 2);
+	REQUIRE(segment_store.GetSegmentCount() == 1);
+	REQUIRE(GetFileCountUnder(TEST_SEGMENT_DIRECTORY) == 1);
+	REQUIRE(segment_store.GetUsedBytes() == 2 * 33);
+	REQUIRE(!segment_store.Contains(GetTestKey("file1", 0)));
+	REQUIRE(!segment_store.Contains(GetTestKey("file1", 1)));
+	REQUIRE(ReadTestBlock(segment_store, GetTestKey("file2", 0), /*idx=*/2));
+	REQUIRE(ReadTestBlock(segment_store, GetTestKey("file2", 1), /*idx=*/3));
+
+	// Clear all blocks.
+	segment_store.Clear();
+	REQUIRE(segment_store.GetEntryCount() == 0);
+	REQUIRE(segment_store.GetUsedBytes() == 0);
+	REQUIRE(GetFileCountUnder(TEST_SEGMENT_DIRECTORY) == 0);
+	AppendTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/0);
+	REQUIRE(ReadTestBlock(segment_store, GetTestKey("file1", 0), /*idx=*/0));
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	LocalFileSystem::CreateLocal()->RemoveDirectory(TEST_SEGMENT_DIRECTORY);
+	return result;
+}
@@ -14,6 +14,7 @@
 #include "duckdb/main/database.hpp"
 #include "in_memory_cache_reader.hpp"
 #include "noop_cache_reader.hpp"
+#include "scope_guard.hpp"
 #include "temp_profile_collector.hpp"
 
 using namespace duckdb; // NOLINT
@@ -29,6 +30,16 @@ TEST_CASE("Filesystem config test", "[filesystem config]") {
 	REQUIRE(GetThreadCountForSubrequests(10) == 5);
 }
 
+TEST_CASE("On-disk cache directories config test", "[filesystem config]") {
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+	REQUIRE(GetOnDiskCacheDirectories() == vector<std::string> {*DEFAULT_ON_DISK_CACHE_DIRECTORY});
+
+	*g_on_disk_cache_directory = " /mnt/nvme0/cache/,/mnt/nvme1/cache,, /mnt/nvme0/cache ,/";
+	REQUIRE(GetOnDiskCacheDirectories() == vector<std::string> {"/mnt/nvme0/cache", "/mnt/nvme1/cache", "/"});
+}
+
 TEST_CASE("Filesystem cache config test", "[filesystem config]") {
 	DuckDB db {};
 	StandardBufferManager buffer_manager {*db.instance, "/tmp/cache_httpfs_fs_benchmark"};
@@ -47,6 +47,40 @@ TEST_CASE("Stale file deletion", "[utils test]") {
 	REQUIRE(fresh_files == vector<string> {fname1});
 }
 
+TEST_CASE("File size under directory", "[utils test]") {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const string directory = StringUtil::Format("%s/size", TEST_ON_DISK_CACHE_DIRECTORY);
+	const string sub_directory = StringUtil::Format("%s/sub", directory);
+	local_filesystem->CreateDirectory(directory);
+	local_filesystem->CreateDirectory(sub_directory);
+	REQUIRE(GetFileSizeUnder(directory) == 0);
+
+	const std::string CONTENT = "helloworld";
+	for (const auto &cur_directory : {directory, sub_directory}) {
+		auto file_handle = local_filesystem->OpenFile(StringUtil::Format("%s/file", cur_directory),
+		                                              FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                  FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		local_filesystem->Write(*file_handle, const_cast<char *>(CONTENT.data()), CONTENT.length(), /*location=*/0);
+	}
+	REQUIRE(GetFileSizeUnder(directory) == 2 * CONTENT.length());
+	REQUIRE(GetFileSizeUnder(StringUtil::Format("%s/non-existent", TEST_ON_DISK_CACHE_DIRECTORY)) == 0);
+	local_filesystem->RemoveDirectory(directory);
+}
+
+TEST_CASE("Glob pattern match", "[utils test]") {
+	REQUIRE(MatchGlobPattern("s3://bucket/file.parquet", "*.parquet"));
+	REQUIRE(MatchGlobPattern("s3://bucket/file.parquet", "s3://bucket/*"));
+	REQUIRE(MatchGlobPattern("s3://bucket/file-1.parquet", "s3://*/file-?.parquet"));
+	REQUIRE(MatchGlobPattern("", "*"));
+	REQUIRE(!MatchGlobPattern("s3://bucket/file.csv", "*.parquet"));
+	REQUIRE(!MatchGlobPattern("s3://bucket/file-10.parquet", "s3://*/file-?.parquet"));
+	REQUIRE(!MatchGlobPattern("s3://bucket/file.parquet", ""));
+}
+
+TEST_CASE("Filesystem sync", "[utils test]") {
+	REQUIRE_NOTHROW(SyncFileSystem(TEST_ON_DISK_CACHE_DIRECTORY));
+}
+
 int main(int argc, char **argv) {
 	auto local_filesystem = LocalFileSystem::CreateLocal();
 	local_filesystem->RemoveDirectory(TEST_ON_DISK_CACHE_DIRECTORY);
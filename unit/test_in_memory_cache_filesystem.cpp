@@ -11,6 +11,10 @@
 #include "in_memory_cache_reader.hpp"
 #include "scope_guard.hpp"
 
+#include <algorithm>
+#include <ctime>
+#include <utime.h>
+
 using namespace duckdb; // NOLINT
 
 namespace {
@@ -87,6 +91,103 @@ TEST_CASE("Test on concurrent access", "[in-memory cache filesystem test]") {
 	}
 }
 
+// Cache blocks are keyed by remote file version, so an overwritten remote file never hits stale blocks.
+TEST_CASE("Test on overwritten remote file", "[in-memory cache filesystem test]") {
+	g_cache_block_size = 5;
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+	};
+
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto test_filename = StringUtil::Format("/tmp/%s", UUID::ToString(UUID::GenerateRandomUUID()));
+	// Write [content] to test file, with last modification timestamp set to [last_modified].
+	auto write_test_file = [&](const string &content, time_t last_modified) {
+		auto file_handle = local_filesystem->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                                 FileOpenFlags::FILE_FLAGS_FILE_CREATE);
+		local_filesystem->Write(*file_handle, const_cast<char *>(content.data()), content.length(), /*location=*/0);
+		file_handle->Close();
+		struct utimbuf updated_time;
+		updated_time.actime = last_modified;
+		updated_time.modtime = last_modified;
+		REQUIRE(utime(test_filename.data(), &updated_time) == 0);
+	};
+	SCOPE_EXIT {
+		local_filesystem->RemoveFile(test_filename);
+	};
+
+	auto in_mem_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	auto read_and_check = [&](const string &expected_content) {
+		auto handle = in_mem_cache_fs->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_READ);
+		string content(TEST_FILE_SIZE, '\0');
+		in_mem_cache_fs->Read(*handle, const_cast<void *>(static_cast<const void *>(content.data())), TEST_FILE_SIZE,
+		                      /*location=*/0);
+		REQUIRE(content == expected_content);
+	};
+
+	const time_t now = std::time(nullptr);
+	write_test_file(TEST_FILE_CONTENT, now - 3600);
+	read_and_check(TEST_FILE_CONTENT);
+
+	// Overwrite remote file with content of the same size. Version is captured in metadata cache, so stale blocks are
+	// served until metadata cache entry expires.
+	string overwritten_content = TEST_FILE_CONTENT;
+	std::reverse(overwritten_content.begin(), overwritten_content.end());
+	write_test_file(overwritten_content, now);
+	read_and_check(TEST_FILE_CONTENT);
+
+	// Blocks of the new version are fetched once metadata is refreshed, while blocks of the stale version are left for
+	// eviction.
+	in_mem_cache_fs->ClearCache(test_filename);
+	read_and_check(overwritten_content);
+	read_and_check(overwritten_content);
+	const auto cache_entries_info = CacheReaderManager::Get().GetCacheReader()->GetCacheEntriesInfo();
+	REQUIRE(std::count_if(cache_entries_info.begin(), cache_entries_info.end(),
+	                      [&test_filename](const DataCacheEntryInfo &cur_cache_entry_info) {
+		                      return cur_cache_entry_info.remote_filename == test_filename;
+	                      }) == 12);
+}
+
+// Footer region takes a quarter of the budget, which is smaller than a block here.
+TEST_CASE("Test on footer blocks with small cache budget", "[in-memory cache filesystem test]") {
+	constexpr idx_t BLOCK_SIZE = 64;
+	constexpr idx_t FILE_SIZE = BLOCK_SIZE * 4;
+	g_cache_block_size = BLOCK_SIZE;
+	g_footer_prefetch_size = BLOCK_SIZE;
+	g_max_in_mem_cache_bytes = BLOCK_SIZE * 3;
+	CacheReaderManager::Get().Reset();
+	SCOPE_EXIT {
+		ResetGlobalConfig();
+		CacheReaderManager::Get().Reset();
+	};
+
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	const auto test_filename = StringUtil::Format("/tmp/%s.parquet", UUID::ToString(UUID::GenerateRandomUUID()));
+	{
+		const string content(FILE_SIZE, 'a');
+		auto file_handle = local_filesystem->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_WRITE |
+		                                                                 FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		local_filesystem->Write(*file_handle, const_cast<char *>(content.data()), content.length(), /*location=*/0);
+		file_handle->Close();
+	}
+	SCOPE_EXIT {
+		local_filesystem->RemoveFile(test_filename);
+	};
+
+	auto in_mem_cache_fs = make_uniq<CacheFileSystem>(LocalFileSystem::CreateLocal());
+	auto handle = in_mem_cache_fs->OpenFile(test_filename, FileOpenFlags::FILE_FLAGS_READ);
+	string content(BLOCK_SIZE, '\0');
+	in_mem_cache_fs->Read(*handle, const_cast<char *>(content.data()), BLOCK_SIZE, /*location=*/FILE_SIZE - BLOCK_SIZE);
+	REQUIRE(content == string(BLOCK_SIZE, 'a'));
+
+	// Footer block is cached in data region, since footer region doesn't fit a block.
+	const auto cache_entries_info = CacheReaderManager::Get().GetCacheReader()->GetCacheEntriesInfo();
+	REQUIRE(std::count_if(cache_entries_info.begin(), cache_entries_info.end(),
+	                      [&test_filename](const DataCacheEntryInfo &cur_cache_entry_info) {
+		                      return cur_cache_entry_info.remote_filename == test_filename &&
+		                             cur_cache_entry_info.start_offset == FILE_SIZE - BLOCK_SIZE;
+	                      }) == 1);
+}
+
 int main(int argc, char **argv) {
 	// Set global cache type for testing.
 	*g_test_cache_type = *IN_MEM_CACHE_TYPE;
@@ -0,0 +1,77 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+#include "io_executor.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr int kNumTask = 100;
+} // namespace
+
+TEST_CASE("IO task group wait test", "[io executor]") {
+	IoExecutor::Get().SetThreadCount(4);
+
+	std::atomic<int> finished_task_count {0};
+	IoTaskGroup io_tasks;
+	for (int idx = 0; idx < kNumTask; ++idx) {
+		io_tasks.Submit([&finished_task_count]() { ++finished_task_count; });
+	}
+	io_tasks.Wait();
+	REQUIRE(finished_task_count.load() == kNumTask);
+
+	const auto stats = IoExecutor::Get().GetStats();
+	REQUIRE(stats.thread_count == 4);
+	REQUIRE(stats.completed_task_count >= kNumTask);
+}
+
+TEST_CASE("IO task group exception propagation test", "[io executor]") {
+	std::atomic<int> finished_task_count {0};
+	IoTaskGroup io_tasks;
+	io_tasks.Submit([]() { throw std::runtime_error("io error"); });
+	for (int idx = 0; idx < kNumTask; ++idx) {
+		io_tasks.Submit([&finished_task_count]() { ++finished_task_count; });
+	}
+	REQUIRE_THROWS_AS(io_tasks.Wait(), std::runtime_error);
+	// All tasks have finished before exception propagates.
+	REQUIRE(finished_task_count.load() == kNumTask);
+}
+
+TEST_CASE("Nested IO task group test", "[io executor]") {
+	// Use a single thread, so nested wait deadlocks if nested tasks are not executed inline.
+	IoExecutor::Get().SetThreadCount(1);
+
+	std::atomic<int> finished_task_count {0};
+	IoTaskGroup io_tasks;
+	io_tasks.Submit([&finished_task_count]() {
+		IoTaskGroup nested_io_tasks;
+		for (int idx = 0; idx < kNumTask; ++idx) {
+			nested_io_tasks.Submit([&finished_task_count]() { ++finished_task_count; });
+		}
+		nested_io_tasks.Wait();
+	});
+	io_tasks.Wait();
+	REQUIRE(finished_task_count.load() == kNumTask);
+}
+
+TEST_CASE("Resize IO executor with ongoing tasks test", "[io executor]") {
+	IoExecutor::Get().SetThreadCount(2);
+
+	std::atomic<int> finished_task_count {0};
+	IoTaskGroup io_tasks;
+	for (int idx = 0; idx < kNumTask; ++idx) {
+		io_tasks.Submit([&finished_task_count]() { ++finished_task_count; });
+	}
+	IoExecutor::Get().SetThreadCount(3);
+	io_tasks.Wait();
+	REQUIRE(finished_task_count.load() == kNumTask);
+	REQUIRE(IoExecutor::Get().GetStats().thread_count == 3);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
@@ -0,0 +1,151 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "io_uring.hpp"
+
+#include <cerrno>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+const auto TEST_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_io_uring";
+constexpr idx_t TEST_FILE_COUNT = 100;
+
+std::string GetTestFilepath(idx_t idx) {
+	return StringUtil::Format("%s/file-%llu", TEST_DIRECTORY, idx);
+}
+std::string GetTestContent(idx_t idx) {
+	return std::string(idx + 1, static_cast<char>('a' + idx % 26));
+}
+} // namespace
+
+TEST_CASE("Write and read files test", "[io uring test]") {
+	// io_uring could be unavailable on current kernel or forbidden by seccomp, in which case callers fall back.
+	if (!IsIoUringAvailable()) {
+		return;
+	}
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_DIRECTORY);
+
+	// Write more files than the depth of one submission.
+	vector<std::string> contents;
+	vector<IoUringWriteRequest> write_requests;
+	for (idx_t idx = 0; idx < TEST_FILE_COUNT; ++idx) {
+		contents.emplace_back(GetTestContent(idx));
+	}
+	for (idx_t idx = 0; idx < TEST_FILE_COUNT; ++idx) {
+		write_requests.emplace_back(IoUringWriteRequest {
+		    .temp_filepath = GetTestFilepath(idx) + ".tmp",
+		    .filepath = GetTestFilepath(idx),
+		    .data = contents[idx].data(),
+		    .length = contents[idx].length(),
+		});
+	}
+	IoUringWriteFiles(write_requests, /*sync=*/true);
+	for (const auto &cur_request : write_requests) {
+		REQUIRE(cur_request.result == 0);
+		REQUIRE(!local_filesystem->FileExists(cur_request.temp_filepath));
+	}
+
+	// Read all files, along with a non-existent one, and one with fewer bytes than requested.
+	vector<std::string> buffers(TEST_FILE_COUNT + 2, std::string(TEST_FILE_COUNT + 1, '\0'));
+	vector<IoUringReadRequest> read_requests;
+	for (idx_t idx = 0; idx < TEST_FILE_COUNT; ++idx) {
+		read_requests.emplace_back(IoUringReadRequest {
+		    .filepath = GetTestFilepath(idx),
+		    .buffer = const_cast<char *>(buffers[idx].data()),
+		    .length = contents[idx].length(),
+		});
+	}
+	read_requests.emplace_back(IoUringReadRequest {
+	    .filepath = GetTestFilepath(TEST_FILE_COUNT),
+	    .buffer = const_cast<char *>(buffers[TEST_FILE_COUNT].data()),
+	    .length = 1,
+	});
+	read_requests.emplace_back(IoUringReadRequest {
+	    .filepath = GetTestFilepath(0),
+	    .buffer = const_cast<char *>(buffers[TEST_FILE_COUNT + 1].data()),
+	    .length = 2,
+	});
+	IoUringReadFiles(read_requests);
+	for (idx_t idx = 0; idx < TEST_FILE_COUNT; ++idx) {
+		REQUIRE(read_requests[idx].result == static_cast<int64_t>(contents[idx].length()));
+		REQUIRE(buffers[idx].substr(0, contents[idx].length()) == contents[idx]);
+	}
+	REQUIRE(read_requests[TEST_FILE_COUNT].result == -ENOENT);
+	REQUIRE(read_requests[TEST_FILE_COUNT + 1].result == 1);
+
+	// Writing to an existing temporary file fails, without affecting the target file.
+	vector<IoUringWriteRequest> conflict_requests;
+	conflict_requests.emplace_back(IoUringWriteRequest {
+	    .temp_filepath = GetTestFilepath(1),
+	    .filepath = GetTestFilepath(0),
+	    .data = contents[2].data(),
+	    .length = contents[2].length(),
+	});
+	IoUringWriteFiles(conflict_requests, /*sync=*/false);
+	REQUIRE(conflict_requests[0].result == -EEXIST);
+	REQUIRE(local_filesystem->FileExists(GetTestFilepath(0)));
+	REQUIRE(local_filesystem->FileExists(GetTestFilepath(1)));
+}
+
+TEST_CASE("Write and read files with trailer test", "[io uring test]") {
+	if (!IsIoUringAvailable()) {
+		return;
+	}
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_DIRECTORY);
+
+	// Trailer is written right after content.
+	const std::string content = "hello";
+	const std::string trailer = "world";
+	vector<IoUringWriteRequest> write_requests;
+	write_requests.emplace_back(IoUringWriteRequest {
+	    .temp_filepath = GetTestFilepath(0) + ".tmp",
+	    .filepath = GetTestFilepath(0),
+	    .data = content.data(),
+	    .length = content.length(),
+	    .trailer = trailer.data(),
+	    .trailer_length = trailer.length(),
+	});
+	IoUringWriteFiles(write_requests, /*sync=*/false);
+	REQUIRE(write_requests[0].result == 0);
+
+	// Read content and trailer into separate buffers, along with a request whose trailer goes beyond file end.
+	std::string content_buffer(content.length(), '\0');
+	std::string trailer_buffer(trailer.length(), '\0');
+	std::string short_content_buffer(content.length() + 2, '\0');
+	std::string short_trailer_buffer(trailer.length(), '\0');
+	vector<IoUringReadRequest> read_requests;
+	read_requests.emplace_back(IoUringReadRequest {
+	    .filepath = GetTestFilepath(0),
+	    .buffer = const_cast<char *>(content_buffer.data()),
+	    .length = content_buffer.length(),
+	    .trailer = const_cast<char *>(trailer_buffer.data()),
+	    .trailer_length = trailer_buffer.length(),
+	});
+	read_requests.emplace_back(IoUringReadRequest {
+	    .filepath = GetTestFilepath(0),
+	    .buffer = const_cast<char *>(short_content_buffer.data()),
+	    .length = short_content_buffer.length(),
+	    .trailer = const_cast<char *>(short_trailer_buffer.data()),
+	    .trailer_length = short_trailer_buffer.length(),
+	});
+	IoUringReadFiles(read_requests);
+	REQUIRE(read_requests[0].result == static_cast<int64_t>(content.length() + trailer.length()));
+	REQUIRE(content_buffer == content);
+	REQUIRE(trailer_buffer == trailer);
+	REQUIRE(read_requests[1].result == static_cast<int64_t>(content.length() + trailer.length()));
+	REQUIRE(short_content_buffer == content + trailer.substr(0, 2));
+	REQUIRE(short_trailer_buffer.substr(0, trailer.length() - 2) == trailer.substr(2));
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
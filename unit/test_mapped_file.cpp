@@ -0,0 +1,61 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "duckdb/common/local_file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "mapped_file.hpp"
+
+#include <cstdio>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+const auto TEST_DIRECTORY = "/tmp/duckdb_test_cache_httpfs_mapped_file";
+
+void WriteTestFile(const std::string &filepath, const std::string &content) {
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	auto file_handle = local_filesystem->OpenFile(filepath, FileOpenFlags::FILE_FLAGS_WRITE |
+	                                                            FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	local_filesystem->Write(*file_handle, const_cast<char *>(content.data()), content.length(), /*location=*/0);
+}
+} // namespace
+
+TEST_CASE("Map file test", "[mapped file test]") {
+	if (!IsMmapSupported()) {
+		return;
+	}
+	auto local_filesystem = LocalFileSystem::CreateLocal();
+	local_filesystem->RemoveDirectory(TEST_DIRECTORY);
+	local_filesystem->CreateDirectory(TEST_DIRECTORY);
+
+	// Map non-existent file.
+	REQUIRE(MappedFile::Open(StringUtil::Format("%s/non-existent", TEST_DIRECTORY)) == nullptr);
+
+	// Map empty file.
+	{
+		const auto filepath = StringUtil::Format("%s/empty", TEST_DIRECTORY);
+		WriteTestFile(filepath, "");
+		auto mapped_file = MappedFile::Open(filepath);
+		REQUIRE(mapped_file != nullptr);
+		REQUIRE(mapped_file->GetSize() == 0);
+	}
+
+	// Mapping stays valid after the file gets deleted.
+	{
+		const std::string content = "hello world";
+		const auto filepath = StringUtil::Format("%s/file", TEST_DIRECTORY);
+		WriteTestFile(filepath, content);
+		auto mapped_file = MappedFile::Open(filepath);
+		REQUIRE(mapped_file != nullptr);
+		REQUIRE(std::remove(filepath.data()) == 0);
+		REQUIRE(std::string(mapped_file->GetData(), mapped_file->GetSize()) == content);
+	}
+
+	local_filesystem->RemoveDirectory(TEST_DIRECTORY);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
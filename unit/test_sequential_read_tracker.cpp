@@ -0,0 +1,90 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "sequential_read_tracker.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr idx_t TEST_BLOCK_SIZE = 10;
+constexpr idx_t TEST_MAX_READ_AHEAD_BLOCK_COUNT = 8;
+constexpr idx_t TEST_FILE_SIZE = 1000;
+} // namespace
+
+TEST_CASE("Read-ahead disabled test", "[sequential read tracker]") {
+	SequentialReadTracker tracker {TEST_BLOCK_SIZE, /*max_read_ahead_block_count=*/0};
+	for (idx_t offset = 0; offset < 100; offset += TEST_BLOCK_SIZE) {
+		const auto range = tracker.RecordRead(offset, TEST_BLOCK_SIZE, TEST_FILE_SIZE);
+		REQUIRE(range.bytes_to_read == 0);
+	}
+}
+
+TEST_CASE("Random access test", "[sequential read tracker]") {
+	SequentialReadTracker tracker {TEST_BLOCK_SIZE, TEST_MAX_READ_AHEAD_BLOCK_COUNT};
+	REQUIRE(tracker.RecordRead(/*start_offset=*/500, /*bytes_to_read=*/5, TEST_FILE_SIZE).bytes_to_read == 0);
+	REQUIRE(tracker.RecordRead(/*start_offset=*/100, /*bytes_to_read=*/5, TEST_FILE_SIZE).bytes_to_read == 0);
+	REQUIRE(tracker.RecordRead(/*start_offset=*/300, /*bytes_to_read=*/5, TEST_FILE_SIZE).bytes_to_read == 0);
+	REQUIRE(tracker.GetReadAheadBlockCount() == 0);
+}
+
+TEST_CASE("Sequential access test", "[sequential read tracker]") {
+	SequentialReadTracker tracker {TEST_BLOCK_SIZE, TEST_MAX_READ_AHEAD_BLOCK_COUNT};
+
+	// Read-ahead starts on the second sequential read, from the next unread block.
+	REQUIRE(tracker.RecordRead(/*start_offset=*/0, /*bytes_to_read=*/5, TEST_FILE_SIZE).bytes_to_read == 0);
+	auto range = tracker.RecordRead(/*start_offset=*/5, /*bytes_to_read=*/10, TEST_FILE_SIZE);
+	REQUIRE(range.start_offset == 20);
+	REQUIRE(range.bytes_to_read == 2 * TEST_BLOCK_SIZE);
+
+	// Blocks read ahead are not consumed enough, no further read-ahead.
+	range = tracker.RecordRead(/*start_offset=*/15, /*bytes_to_read=*/10, TEST_FILE_SIZE);
+	REQUIRE(range.bytes_to_read == 0);
+
+	// Half of the window gets consumed, the next window is issued with doubled size.
+	range = tracker.RecordRead(/*start_offset=*/25, /*bytes_to_read=*/5, TEST_FILE_SIZE);
+	REQUIRE(range.start_offset == 40);
+	REQUIRE(range.bytes_to_read == 4 * TEST_BLOCK_SIZE);
+	REQUIRE(tracker.GetReadAheadBlockCount() == 4);
+
+	// Keep consuming, window is capped by the max block count.
+	idx_t offset = 30;
+	for (; offset < 500; offset += TEST_BLOCK_SIZE) {
+		tracker.RecordRead(offset, TEST_BLOCK_SIZE, TEST_FILE_SIZE);
+	}
+	REQUIRE(tracker.GetReadAheadBlockCount() == TEST_MAX_READ_AHEAD_BLOCK_COUNT);
+}
+
+TEST_CASE("Read-ahead capped by file size test", "[sequential read tracker]") {
+	SequentialReadTracker tracker {TEST_BLOCK_SIZE, TEST_MAX_READ_AHEAD_BLOCK_COUNT};
+	constexpr idx_t file_size = 35;
+	REQUIRE(tracker.RecordRead(/*start_offset=*/0, /*bytes_to_read=*/10, file_size).bytes_to_read == 0);
+	auto range = tracker.RecordRead(/*start_offset=*/10, /*bytes_to_read=*/10, file_size);
+	REQUIRE(range.start_offset == 20);
+	REQUIRE(range.bytes_to_read == 15);
+
+	// All blocks till the end of file have been read ahead.
+	REQUIRE(tracker.RecordRead(/*start_offset=*/20, /*bytes_to_read=*/10, file_size).bytes_to_read == 0);
+	REQUIRE(tracker.RecordRead(/*start_offset=*/30, /*bytes_to_read=*/5, file_size).bytes_to_read == 0);
+}
+
+TEST_CASE("Access pattern break shrinks window test", "[sequential read tracker]") {
+	SequentialReadTracker tracker {TEST_BLOCK_SIZE, TEST_MAX_READ_AHEAD_BLOCK_COUNT};
+	for (idx_t offset = 0; offset < 500; offset += TEST_BLOCK_SIZE) {
+		tracker.RecordRead(offset, TEST_BLOCK_SIZE, TEST_FILE_SIZE);
+	}
+	REQUIRE(tracker.GetReadAheadBlockCount() == TEST_MAX_READ_AHEAD_BLOCK_COUNT);
+
+	// Seek away with blocks read ahead unconsumed, so window shrinks.
+	REQUIRE(tracker.RecordRead(/*start_offset=*/0, TEST_BLOCK_SIZE, TEST_FILE_SIZE).bytes_to_read == 0);
+	REQUIRE(tracker.GetReadAheadBlockCount() == TEST_MAX_READ_AHEAD_BLOCK_COUNT / 2);
+
+	// A new sequential stream starts read-ahead with the shrunk window.
+	const auto range = tracker.RecordRead(/*start_offset=*/TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, TEST_FILE_SIZE);
+	REQUIRE(range.start_offset == 2 * TEST_BLOCK_SIZE);
+	REQUIRE(range.bytes_to_read == TEST_MAX_READ_AHEAD_BLOCK_COUNT / 2 * TEST_BLOCK_SIZE);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
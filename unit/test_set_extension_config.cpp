@@ -63,6 +63,40 @@ TEST_CASE("Test on correct config", "[extension config test]") {
 	// In-memory cache block count.
 	result = con.Query(StringUtil::Format("SET cache_httpfs_max_in_mem_cache_block_count=10"));
 	REQUIRE(!result->HasError());
+
+	// In-memory cache bytes.
+	result = con.Query(StringUtil::Format("SET cache_httpfs_max_in_mem_cache_bytes=1000"));
+	REQUIRE(!result->HasError());
+
+	// In-memory cache memory percentage.
+	result = con.Query(StringUtil::Format("SET cache_httpfs_max_in_mem_cache_memory_percentage=10"));
+	REQUIRE(!result->HasError());
+
+	// On-disk cache write-back bytes.
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_write_back_max_bytes=1000"));
+	REQUIRE(!result->HasError());
+
+	// On-disk cache durability mode.
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_durability='batched'"));
+	REQUIRE(!result->HasError());
+
+	// On-disk cache layout.
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_layout='segment'"));
+	REQUIRE(!result->HasError());
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_segment_size=1000000"));
+	REQUIRE(!result->HasError());
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_layout='mirror'"));
+	REQUIRE(!result->HasError());
+
+	// On-disk cache IO engine.
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_io_engine='io_uring'"));
+	REQUIRE(!result->HasError());
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_io_engine='direct'"));
+	REQUIRE(!result->HasError());
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_io_engine='mmap'"));
+	REQUIRE(!result->HasError());
+	result = con.Query(StringUtil::Format("SET cache_httpfs_disk_cache_max_mapped_bytes=1000000"));
+	REQUIRE(!result->HasError());
 }
 
 TEST_CASE("Test on changing extension config change default cache dir path setting", "[extension config test]") {
@@ -73,6 +107,8 @@ TEST_CASE("Test on changing extension config change default cache dir path setti
 
 	Connection con(db);
 	con.Query(StringUtil::Format("SET cache_httpfs_cache_directory ='%s'", TEST_ON_DISK_CACHE_DIRECTORY));
+	// Write cache files synchronously, so they could be checked right after query.
+	con.Query("SET cache_httpfs_disk_cache_write_back_max_bytes=0");
 	con.Query("CREATE TABLE integers AS SELECT i, i+1 as j FROM range(10) r(i)");
 	con.Query(StringUtil::Format("COPY integers TO '%s'", TEST_ON_DISK_CACHE_FILE));
 
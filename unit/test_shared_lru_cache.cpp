@@ -143,6 +143,124 @@ TEST_CASE("Put and get with timeout test", "[shared lru test]") {
 	REQUIRE(val == nullptr);
 }
 
+TEST_CASE("Put and get with weight limit test", "[shared lru test]") {
+	using CacheType = ThreadSafeSharedLruCache<std::string, std::string>;
+
+	CacheType cache {/*max_entries_p=*/0, /*timeout_millisec_p=*/0, /*max_total_weight_p=*/10,
+	                 /*weigher_p=*/[](const std::string &val) { return val.length(); }};
+	cache.Put("1", make_shared_ptr<std::string>(4, 'a'));
+	cache.Put("2", make_shared_ptr<std::string>(4, 'b'));
+	REQUIRE(cache.TotalWeight() == 8);
+
+	// Replacing an existing key only accounts for the new value.
+	cache.Put("2", make_shared_ptr<std::string>(5, 'b'));
+	REQUIRE(cache.TotalWeight() == 9);
+	REQUIRE(cache.Keys().size() == 2);
+
+	// Access key "1" so key "2" becomes least recently used, which gets evicted when weight exceeds limit.
+	REQUIRE(cache.Get("1") != nullptr);
+	cache.Put("3", make_shared_ptr<std::string>(3, 'c'));
+	REQUIRE(cache.TotalWeight() == 7);
+	REQUIRE(cache.Get("2") == nullptr);
+	REQUIRE(cache.Get("1") != nullptr);
+	REQUIRE(cache.Get("3") != nullptr);
+
+	// Value which exceeds overall weight limit by itself is not cached, and other entries are kept.
+	cache.Put("4", make_shared_ptr<std::string>(11, 'd'));
+	REQUIRE(cache.Get("4") == nullptr);
+	REQUIRE(cache.TotalWeight() == 7);
+
+	// Deletion and clear release weight.
+	REQUIRE(cache.Delete("3"));
+	REQUIRE(cache.TotalWeight() == 4);
+	cache.Clear();
+	REQUIRE(cache.TotalWeight() == 0);
+}
+
+TEST_CASE("Sharded cache put and get test", "[shared lru test]") {
+	using CacheType = ThreadSafeShardedSharedLruCache<std::string, std::string>;
+
+	CacheType cache {/*shard_count=*/4, /*max_entries_p=*/0, /*timeout_millisec_p=*/0};
+	REQUIRE(cache.ShardCount() == 4);
+
+	constexpr size_t kKeyCount = 100;
+	for (size_t idx = 0; idx < kKeyCount; ++idx) {
+		cache.Put(std::to_string(idx), make_shared_ptr<std::string>(std::to_string(idx)));
+	}
+	REQUIRE(cache.Keys().size() == kKeyCount);
+	for (size_t idx = 0; idx < kKeyCount; ++idx) {
+		auto val = cache.Get(std::to_string(idx));
+		REQUIRE(val != nullptr);
+		REQUIRE(*val == std::to_string(idx));
+	}
+
+	// Check deletion and clear.
+	REQUIRE(cache.Delete("0"));
+	REQUIRE(!cache.Delete("0"));
+	REQUIRE(cache.Get("0") == nullptr);
+	cache.Clear([](const std::string &key) { return key.length() == 1; });
+	REQUIRE(cache.Keys().size() == kKeyCount - 10);
+	cache.Clear();
+	REQUIRE(cache.Keys().empty());
+}
+
+TEST_CASE("Sharded cache limits test", "[shared lru test]") {
+	using CacheType = ThreadSafeShardedSharedLruCache<std::string, std::string>;
+
+	// Shard count is capped by max entry count.
+	{
+		CacheType cache {/*shard_count=*/16, /*max_entries_p=*/1, /*timeout_millisec_p=*/0};
+		REQUIRE(cache.ShardCount() == 1);
+		cache.Put("1", make_shared_ptr<std::string>("1"));
+		cache.Put("2", make_shared_ptr<std::string>("2"));
+		REQUIRE(cache.Get("1") == nullptr);
+		REQUIRE(cache.Get("2") != nullptr);
+	}
+
+	// Entry count and overall weight are capped by the evenly split limits.
+	{
+		CacheType cache {/*shard_count=*/4, /*max_entries_p=*/0, /*timeout_millisec_p=*/0,
+		                 /*max_total_weight_p=*/40,
+		                 /*weigher_p=*/[](const std::string &val) { return val.length(); }};
+		REQUIRE(cache.MaxTotalWeight() == 40);
+		for (size_t idx = 0; idx < 100; ++idx) {
+			cache.Put(std::to_string(idx), make_shared_ptr<std::string>(5, 'a'));
+		}
+		REQUIRE(cache.TotalWeight() <= 40);
+		REQUIRE(cache.Keys().size() * 5 == cache.TotalWeight());
+	}
+}
+
+TEST_CASE("Sharded cache concurrent GetOrCreate test", "[shared lru test]") {
+	using CacheType = ThreadSafeShardedSharedLruCache<std::string, std::string>;
+	CacheType cache {/*shard_count=*/8, /*max_entries_p=*/0, /*timeout_millisec_p=*/0};
+
+	std::atomic<int> factory_invocation {0};
+	auto factory = [&factory_invocation](const std::string &key) {
+		++factory_invocation;
+		return make_shared_ptr<std::string>(key);
+	};
+
+	constexpr size_t kFutureNum = 8;
+	constexpr size_t kKeyCount = 64;
+	std::vector<std::future<bool>> futures;
+	futures.reserve(kFutureNum);
+	for (size_t idx = 0; idx < kFutureNum; ++idx) {
+		futures.emplace_back(std::async(std::launch::async, [&cache, &factory]() {
+			bool all_matched = true;
+			for (size_t key_idx = 0; key_idx < kKeyCount; ++key_idx) {
+				auto val = cache.GetOrCreate(std::to_string(key_idx), factory);
+				all_matched = all_matched && *val == std::to_string(key_idx);
+			}
+			return all_matched;
+		}));
+	}
+	for (auto &fut : futures) {
+		REQUIRE(fut.get());
+	}
+	REQUIRE(factory_invocation.load() == kKeyCount);
+}
+
 int main(int argc, char **argv) {
 	int result = Catch::Session().run(argc, argv);
 	return result;
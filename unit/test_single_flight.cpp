@@ -0,0 +1,92 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "duckdb/common/vector.hpp"
+#include "single_flight.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr int kNumWaiters = 10;
+} // namespace
+
+TEST_CASE("Single flight leader election test", "[single flight]") {
+	SingleFlightGroup<std::string, std::string> group;
+	auto leader_res = group.Join("key");
+	REQUIRE(leader_res.is_leader);
+	auto waiter_res = group.Join("key");
+	REQUIRE(!waiter_res.is_leader);
+	REQUIRE(waiter_res.flight == leader_res.flight);
+	auto other_res = group.Join("other-key");
+	REQUIRE(other_res.is_leader);
+	REQUIRE(group.GetFlightCount() == 2);
+
+	group.Complete("key", []() { return make_shared_ptr<std::string>("val"); });
+	REQUIRE(*group.Wait(*waiter_res.flight) == "val");
+	group.Complete("other-key", []() { return make_shared_ptr<std::string>("other-val"); });
+	REQUIRE(group.GetFlightCount() == 0);
+
+	// Completed flight is not kept, so the next requester becomes leader again.
+	REQUIRE(group.Join("key").is_leader);
+}
+
+TEST_CASE("Single flight without waiters test", "[single flight]") {
+	SingleFlightGroup<std::string, std::string> group;
+	REQUIRE(group.Join("key").is_leader);
+	bool factory_invoked = false;
+	group.Complete("key", [&factory_invoked]() {
+		factory_invoked = true;
+		return make_shared_ptr<std::string>("val");
+	});
+	REQUIRE(!factory_invoked);
+	REQUIRE(group.GetFlightCount() == 0);
+}
+
+TEST_CASE("Single flight concurrent waiters test", "[single flight]") {
+	SingleFlightGroup<std::string, std::string> group;
+	REQUIRE(group.Join("key").is_leader);
+
+	std::atomic<int> succeeded_waiter_count {0};
+	vector<std::thread> waiters;
+	waiters.reserve(kNumWaiters);
+	for (int idx = 0; idx < kNumWaiters; ++idx) {
+		auto join_res = group.Join("key");
+		REQUIRE(!join_res.is_leader);
+		waiters.emplace_back([&group, &succeeded_waiter_count, flight = std::move(join_res.flight)]() {
+			auto val = group.Wait(*flight);
+			if (val != nullptr && *val == "val") {
+				++succeeded_waiter_count;
+			}
+		});
+	}
+
+	group.Complete("key", []() { return make_shared_ptr<std::string>("val"); });
+	for (auto &cur_waiter : waiters) {
+		cur_waiter.join();
+	}
+	REQUIRE(succeeded_waiter_count.load() == kNumWaiters);
+}
+
+TEST_CASE("Single flight leader failure test", "[single flight]") {
+	SingleFlightGroup<std::string, std::string> group;
+	REQUIRE(group.Join("key").is_leader);
+	auto first_waiter_res = group.Join("key");
+	auto second_waiter_res = group.Join("key");
+
+	// Leader fails to produce result, waiters are woken up with nullptr.
+	REQUIRE_THROWS_AS(group.Complete("key", []() -> shared_ptr<std::string> { throw std::runtime_error("failure"); }),
+	                  std::runtime_error);
+	REQUIRE(group.Wait(*first_waiter_res.flight) == nullptr);
+	REQUIRE(group.Wait(*second_waiter_res.flight) == nullptr);
+	REQUIRE(group.GetFlightCount() == 0);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}
@@ -0,0 +1,70 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "zstd_compression.hpp"
+
+#include <random>
+#include <string>
+
+using namespace duckdb; // NOLINT
+
+namespace {
+constexpr idx_t TEST_CONTENT_SIZE = 64 * 1024;
+constexpr int TEST_COMPRESSION_LEVEL = 1;
+
+std::string GetCompressibleContent() {
+	std::string content(TEST_CONTENT_SIZE, '\0');
+	for (idx_t idx = 0; idx < content.length(); ++idx) {
+		content[idx] = static_cast<char>('a' + idx % 26);
+	}
+	return content;
+}
+std::string GetIncompressibleContent() {
+	std::mt19937_64 rng {/*seed=*/0};
+	std::string content(TEST_CONTENT_SIZE, '\0');
+	for (auto &cur_char : content) {
+		cur_char = static_cast<char>(rng());
+	}
+	return content;
+}
+} // namespace
+
+TEST_CASE("Compress and decompress test", "[zstd compression test]") {
+	const auto content = GetCompressibleContent();
+	std::string compressed(content.length(), '\0');
+	const idx_t compressed_length = ZstdCompress(content.data(), content.length(), TEST_COMPRESSION_LEVEL,
+	                                             &compressed[0], compressed.length());
+	REQUIRE(compressed_length > 0);
+	REQUIRE(compressed_length < content.length() / 8);
+
+	std::string decompressed(content.length(), '\0');
+	REQUIRE(ZstdDecompress(compressed.data(), compressed_length, &decompressed[0], decompressed.length()));
+	REQUIRE(decompressed == content);
+
+	// Decompressed length differs from expected.
+	REQUIRE(!ZstdDecompress(compressed.data(), compressed_length, &decompressed[0], decompressed.length() - 1));
+	std::string longer_buffer(content.length() + 1, '\0');
+	REQUIRE(!ZstdDecompress(compressed.data(), compressed_length, &longer_buffer[0], longer_buffer.length()));
+
+	// Truncated or garbage frames.
+	REQUIRE(!ZstdDecompress(compressed.data(), compressed_length - 1, &decompressed[0], decompressed.length()));
+	REQUIRE(!ZstdDecompress(content.data(), compressed_length, &decompressed[0], decompressed.length()));
+}
+
+TEST_CASE("Compress incompressible content test", "[zstd compression test]") {
+	const auto content = GetIncompressibleContent();
+
+	// Compressed content doesn't fit in a buffer smaller than the input.
+	std::string compressed(content.length() - content.length() / 8, '\0');
+	REQUIRE(ZstdCompress(content.data(), content.length(), TEST_COMPRESSION_LEVEL, &compressed[0],
+	                     compressed.length()) == 0);
+
+	// Empty buffer never fits.
+	REQUIRE(ZstdCompress(content.data(), content.length(), TEST_COMPRESSION_LEVEL, /*compressed=*/nullptr,
+	                     /*capacity=*/0) == 0);
+}
+
+int main(int argc, char **argv) {
+	int result = Catch::Session().run(argc, argv);
+	return result;
+}